@@ -169,6 +169,13 @@ void TestGameActorProxy1::CreateActor()
    SetActor(*new TestGameActor1(*this));
 }
 
+void TestComponentGameActorProxy::CreateActor()
+{
+   TestGameActor1* actor = new TestGameActor1(*this);
+   actor->AddComponent(new TestActorComponent1());
+   SetActor(*actor);
+}
+
 void TestGameActorProxy1::ToggleTicks(const dtGame::Message& message)
 {
    if (ticksEnabled)
@@ -130,5 +130,12 @@ class DT_EXAMPLE_EXPORT TestGameActorProxy1 : public dtGame::GameActorProxy
       bool ticksEnabled;
 };
 
+/// A TestGameActorProxy1 whose actor is made with a TestActorComponent1, the way actors normally get their components.
+class DT_EXAMPLE_EXPORT TestComponentGameActorProxy : public TestGameActorProxy1
+{
+   protected:
+      virtual void CreateActor();
+};
+
 #endif
 
@@ -79,6 +79,9 @@ dtCore::RefPtr<dtDAL::ActorType> TestGameActorLibrary::TEST_ENVIRONMENT_GAME_ACT
 dtCore::RefPtr<dtDAL::ActorType> TestGameActorLibrary::TEST_GAME_PROPERTY_PROXY_TYPE(
       new dtDAL::ActorType("TestGamePropertyProxy", "ExampleActors", "Has an example of most property types"));
 
+dtCore::RefPtr<dtDAL::ActorType> TestGameActorLibrary::TEST_COMPONENT_GAME_ACTOR_PROXY_TYPE(
+      new dtDAL::ActorType("TestComponentActor", "ExampleActors", "An actor that is made with an actor component."));
+
 
 extern "C" DT_EXAMPLE_EXPORT dtDAL::ActorPluginRegistry* CreatePluginRegistry()
 {
@@ -113,4 +116,5 @@ void TestGameActorLibrary::RegisterActorTypes()
    mActorFactory->RegisterType<TestHLAObjectProxy> (TEST_HELICOPTER_GAME_ACTOR_PROXY_TYPE.get());      
    mActorFactory->RegisterType<TestGameEnvironmentActorProxy> (TEST_ENVIRONMENT_GAME_ACTOR_PROXY_TYPE.get());
    mActorFactory->RegisterType<TestGamePropertyProxy> (TEST_GAME_PROPERTY_PROXY_TYPE.get());
+   mActorFactory->RegisterType<TestComponentGameActorProxy> (TEST_COMPONENT_GAME_ACTOR_PROXY_TYPE.get());
 }
@@ -27,6 +27,7 @@
 #include <dtCore/refptr.h>
 #include <dtCore/observerptr.h> 
 #include <dtCore/deltadrawable.h>
+#include <dtCore/rayquerytree.h>
 
 #include <osg/Vec3>
 #include <osgUtil/IntersectVisitor>
@@ -187,6 +188,18 @@ namespace dtCore
          ///@return the scene being queried.
          const Scene* GetScene() const { return mScene; }
 
+         /**
+          * Sets a prebuilt tree to answer the queries from instead of running an IntersectVisitor.  The tree
+          * is only used if it was built from the query root's node, or the scene node if there is no query
+          * root, and Update is asked for the highest level of detail, since that is what the tree holds.
+          * Otherwise Update traverses the graph as usual.  The owner of the tree must keep it up to date.
+          * @see RayQueryTree::Update
+          */
+         void SetRayQueryTree(RayQueryTree* tree) { mRayQueryTree = tree; }
+
+         ///@return the tree the queries are answered from, or NULL if the scene graph is traversed.
+         RayQueryTree* GetRayQueryTree() { return mRayQueryTree.get(); }
+
          /// Create an isector if not made already, else makes one
          SingleISector& EnableAndGetISector(int nID);
 
@@ -231,8 +244,12 @@ namespace dtCore
             BatchIsector& operator=( const BatchIsector& ); 
             BatchIsector( const BatchIsector& );
 
+            /// Answers the queries from the ray query tree.
+            bool UpdateFromTree();
+
             Scene*                              mScene;           // the scene in which we start at
             dtCore::ObserverPtr<DeltaDrawable>  mQueryRoot;
+            dtCore::RefPtr<RayQueryTree>        mRayQueryTree;
             dtCore::RefPtr<SingleISector>       mISectors[32];    // all the isectors to be sent down in one batch call.
             const int                           mFixedArraySize;
 
@@ -23,15 +23,18 @@
 #define DELTA_FPSCOLLIDER
 
 #include <dtCore/export.h>
+#include <dtCore/refptr.h>
 #include <osg/Vec3>
 #include <osg/Matrix>
 
 #include <ode/contact.h>
+#include <ode/collision_space.h>
 #include <vector>
 
 namespace dtCore
 {
    class Scene;
+   class ODESpaceWrap;
 
 
    /**
@@ -160,6 +163,9 @@ namespace dtCore
          bool CollideTorso();
          bool CollideFeet();
 
+         ///Collides our space with the space, or spaces, we collide with.
+         void CollideWithSpaces(dNearCallback* callback);
+
          bool TestPosition(osg::Vec3& newPos, float dt);
 
          dGeomID mBBFeet;
@@ -202,6 +208,9 @@ namespace dtCore
          osg::Vec3 mGravity;
 
          dSpaceID mCollisionSpace;
+
+         ///The spaces of the scene we were created with, if any, so its static space is collided with too.
+         dtCore::RefPtr<dtCore::ODESpaceWrap> mSpaceWrapper;
    
    };
 }//namespace dtCore
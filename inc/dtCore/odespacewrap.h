@@ -31,6 +31,8 @@
 #include <ode/common.h>
 #include <ode/collision_space.h>
 
+#include <vector>
+
 namespace dtCore
 {
    class Transformable;
@@ -39,11 +41,61 @@ namespace dtCore
    /** Used to wrap up the functionality provided by the ODE Space.  Typically
     * not referenced directly by end users.  Contains most of the collision
     * detection functionality.
+    *
+    * Collidables go in one of two spaces.  The dynamic space, which GetSpaceID()
+    * returns, is where collidables are registered and is tested against itself.
+    * The static space is only tested against the dynamic space, so static
+    * collidables are never tested against each other.  The type of each space
+    * can be changed, and RunSelfTest() times each type against the current
+    * collidables.
     */
    class DT_CORE_EXPORT ODESpaceWrap : public osg::Referenced
    {
    public:
 
+      /// The broadphase an ODE space uses to find the pairs of geoms that might be touching.
+      enum SpaceType
+      {
+         SPACE_SIMPLE,         ///<Tests every pair, only good for a handful of geoms.
+         SPACE_HASH,           ///<A hash grid with cells at several sizes.  The default.
+         SPACE_QUADTREE,       ///<A fixed quadtree over an area, suits large numbers of static geoms.
+         SPACE_SWEEP_AND_PRUNE ///<Sorts the geoms along the axes, suits many geoms that move a little each step.
+      };
+
+      ///The settings a space is created from.
+      struct DT_CORE_EXPORT SpaceSettings
+      {
+         SpaceSettings();
+
+         SpaceType mType;
+
+         ///The smallest and largest hash cell sizes, as powers of two.
+         int mHashMinLevel;
+         int mHashMaxLevel;
+
+         ///The center and half size of the area covered by the quadtree, which splits on x and y.
+         osg::Vec3 mQuadTreeCenter;
+         osg::Vec3 mQuadTreeHalfExtents;
+         int mQuadTreeDepth;
+
+         ///The axes to sort on for sweep and prune, as one of the ODE dSAP_AXES values.
+         int mSweepAndPruneAxes;
+      };
+
+      ///The time and pair count for one space type from RunSelfTest().
+      struct DT_CORE_EXPORT SelfTestResult
+      {
+         SpaceSettings mSettings;
+         bool mStaticSpace; ///<True if the static space was timed against the dynamic space.
+         unsigned mNumPairs; ///<The number of pairs passed to the near callback per collide.
+         double mMilliseconds; ///<The average time per collide.
+      };
+
+      typedef std::vector<SelfTestResult> SelfTestResults;
+
+      ///The largest quadtree depth ComputeTunedSettings() will choose.
+      static const int MAX_TUNED_QUADTREE_DEPTH = 7;
+
       /** Default constructor.  Uses the supplied parameter to get the world ID
        * in order to create collision contact joints.
        * @param worldWrapper : Collision contact joints will be created in this
@@ -61,6 +113,53 @@ namespace dtCore
        */
       void UnRegisterCollidable(Transformable* collidable);
 
+      /** Moves a registered collidable into the static space, or back into the
+       * dynamic space.  Collidables in the static space are never tested against
+       * each other, so only use it for ones that don't move, or whose collisions
+       * with each other don't matter.
+       */
+      void SetCollidableStatic(Transformable& collidable, bool isStatic);
+
+      ///@return true if the collidable is in the static space.
+      bool IsCollidableStatic(const Transformable& collidable) const;
+
+      /** Replaces the dynamic space with one created from the given settings and
+       * moves all of its geoms into the new one.  The space ID changes, so anything
+       * that has kept GetSpaceID() must get it again.  Don't call this during Collide().
+       */
+      void SetSpaceSettings(const SpaceSettings& settings);
+      const SpaceSettings& GetSpaceSettings() const;
+
+      ///Same as SetSpaceSettings(), but for the static space.
+      void SetStaticSpaceSettings(const SpaceSettings& settings);
+      const SpaceSettings& GetStaticSpaceSettings() const;
+
+      /** Creates settings for the given type, tuned to the geoms currently in one
+       * of the spaces.  The hash levels cover the range of geom sizes, the quadtree
+       * covers the bounds of the geoms to a depth where the smallest blocks are about
+       * twice the typical geom size, and sweep and prune sorts on the axis the geoms
+       * are most spread out along first.
+       * @param forStaticSpace true to tune to the static space instead of the dynamic one.
+       */
+      SpaceSettings ComputeTunedSettings(SpaceType type, bool forStaticSpace) const;
+
+      /** Times the collide of each space with every space type, tuned to the geoms
+       * currently in it, and logs the results.  The static space is timed against
+       * the dynamic space, the same way Collide() tests it.  The geoms are moved into
+       * a temporary space while they are timed, and only the pairs are counted, so
+       * no contacts are made and no callbacks are called.  The geoms don't move
+       * during the test, so the times for the dynamic space will be low for types
+       * that only update what moved.  Don't call this during Collide().
+       * @param outResults filled with a result for each type, for each space that has geoms.
+       * @param numRuns the number of collides each time is averaged over.
+       */
+      void RunSelfTest(SelfTestResults& outResults, unsigned numRuns = 10);
+
+      /** Runs the self test and switches each space to the settings of the fastest type.
+       * @see RunSelfTest()
+       */
+      void AutoTune(unsigned numRuns = 10);
+
 
       /** Check the system for collision detections.  Will use the default
        * near collision detection method unless a user created one is supplied.
@@ -103,9 +202,15 @@ namespace dtCore
       ///Get the ODE contact join group ID
       dJointGroupID GetContactJoinGroupID() const;
 
-      ///Get the ODE space ID
+      ///Get the ODE space ID of the dynamic space
       dSpaceID GetSpaceID() const;
 
+      ///Get the ODE space ID of the static space
+      dSpaceID GetStaticSpaceID() const;
+
+      ///Creates an ODE space from the given settings, with cleanup disabled.
+      static dSpaceID CreateSpace(const SpaceSettings& settings);
+
    protected:
       virtual ~ODESpaceWrap();
 
@@ -113,7 +218,13 @@ namespace dtCore
       ///ODE collision callback
       static void DefaultNearCallback(void* data, dGeomID o1, dGeomID o2);
 
+      ///Replaces the given space with a new one with the given settings, moving the geoms.
+      static void ReplaceSpace(dSpaceID& space, const SpaceSettings& settings);
+
       dSpaceID mSpaceID;  ///< the current collision space ID
+      dSpaceID mStaticSpaceID; ///< the space for static collidables
+      SpaceSettings mSpaceSettings;
+      SpaceSettings mStaticSpaceSettings;
       dNearCallback* mUserNearCallback;   ///<The user-supplied collision callback func
       void* mUserNearCallbackData; ///< pointer to user-supplied data
 
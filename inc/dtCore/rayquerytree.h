@@ -0,0 +1,173 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2004-2005 MOVES Institute
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_RAYQUERYTREE
+#define DELTA_RAYQUERYTREE
+
+#include <vector>
+
+#include <dtCore/export.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+
+#include <osg/BoundingBox>
+#include <osg/Geode>
+#include <osg/Matrix>
+#include <osg/Node>
+#include <osg/Referenced>
+#include <osg/Vec3>
+#include <osgUtil/IntersectVisitor>
+
+namespace dtCore
+{
+   /**
+    * A bounding volume hierarchy over the triangles under a node, that answers line segment queries
+    * without walking the scene graph.  Each drawable gets its own tree of triangles in its local
+    * space, which is built once, and a small tree over the drawables is built on top of those from
+    * their world bounds.  Update only recomputes the transforms of drawables that have an osg::Transform
+    * in their path, once for each distinct path, and refits the boxes of the top tree above the
+    * drawables that moved, so moving parts of the graph never means touching their triangles.
+    * Refitting keeps the shape of the top tree, so call Build again if the parts move far apart.
+    *
+    * The triangles are read when the tree is built, from the active children and the highest level of
+    * detail, so this suits static geometry.  Call Build again if nodes are added, removed, or their
+    * vertices change.  Queries are const and may be run from several threads at once, but Build and
+    * Update may not be run at the same time as a query.
+    *
+    * @see BatchIsector::SetRayQueryTree
+    */
+   class DT_CORE_EXPORT RayQueryTree : public osg::Referenced
+   {
+      public:
+         typedef osgUtil::IntersectVisitor::HitList HitList;
+
+         /// The max number of triangles or drawables in a leaf of a tree.
+         static const unsigned LEAF_SIZE = 4;
+
+         RayQueryTree();
+
+         /**
+          * Builds the trees over all of the geometry under the given node.  Transforms are accumulated
+          * from the node down, including the node itself, the same as an IntersectVisitor applied to it.
+          */
+         void Build(osg::Node& root);
+
+         /// Drops all the geometry.
+         void Clear();
+
+         /**
+          * Refits the tree to transforms that have changed since it was built or last updated.
+          * @return true if anything had moved.
+          */
+         bool Update();
+
+         /// @return the node the tree was built from, or NULL if it hasn't been built or the node was deleted.
+         const osg::Node* GetRoot() const { return mRoot.get(); }
+
+         /**
+          * Finds the points where the line segment from start to end crosses the geometry.
+          * @param outHits filled with a hit for each crossing, sorted from start to end, like the
+          *                hit list an IntersectVisitor makes.  Points and normals are in world space.
+          * @return true if there were any hits.
+          */
+         bool Intersect(const osg::Vec3& start, const osg::Vec3& end, HitList& outHits) const;
+
+         /// @return the number of drawables the tree was built over.
+         unsigned GetNumDrawables() const { return unsigned(mInstances.size()); }
+
+         /// @return the total number of triangles the tree was built over.
+         unsigned GetNumTriangles() const;
+
+         /// @return the world bounds of everything in the tree.
+         const osg::BoundingBox& GetBound() const;
+
+      protected:
+         virtual ~RayQueryTree();
+
+      private:
+         /// A node of a tree, stored in a flat array.  A leaf holds mCount items from mFirst, otherwise
+         /// its children are at mFirst and mFirst + 1.
+         struct TreeNode
+         {
+            osg::BoundingBox mBound;
+            unsigned mFirst;
+            unsigned mCount;
+         };
+
+         /// A node path with a transform in it, shared by all the drawables under it.
+         struct MovingPath
+         {
+            osg::NodePath mNodePath;
+            osg::Matrix mMatrix;
+            std::vector<unsigned> mInstances;
+         };
+
+         /// The triangles of one drawable and the tree over them, in local space.
+         struct Instance
+         {
+            osg::NodePath mNodePath;
+            /// Holds the nodes in the path so they outlive being removed from the graph.
+            std::vector<osg::ref_ptr<osg::Node> > mNodePathRefs;
+            /// The leaf of the top tree this drawable is in.
+            unsigned mTopLeaf;
+            osg::ref_ptr<osg::Geode> mGeode;
+            osg::ref_ptr<osg::Drawable> mDrawable;
+            std::vector<osg::Vec3> mVertices;
+            std::vector<unsigned> mTriangles;
+            std::vector<TreeNode> mTree;
+            osg::Matrix mMatrix;
+            osg::Matrix mInverse;
+            osg::BoundingBox mWorldBound;
+         };
+
+         class GeometryCollector;
+
+         /// Builds the tree over the given items, reordering them so each leaf is contiguous.
+         static void BuildTree(std::vector<TreeNode>& tree, std::vector<unsigned>& items,
+                  const std::vector<osg::BoundingBox>& itemBounds);
+
+         static bool IntersectBox(const osg::BoundingBox& box, const osg::Vec3& start,
+                  const osg::Vec3& invDir, float maxRatio);
+
+         void SetInstanceMatrix(Instance& instance, const osg::Matrix& matrix);
+         void BuildTopTree();
+         void FindMovingPaths();
+
+         /// Recomputes the bounds of the given top tree leaf and its parents, until one doesn't change.
+         void RefitTopTree(unsigned leaf);
+
+         void IntersectInstance(const Instance& instance, const osg::Vec3& start, const osg::Vec3& end,
+                  HitList& outHits) const;
+
+         dtCore::ObserverPtr<osg::Node> mRoot;
+         std::vector<Instance> mInstances;
+         std::vector<MovingPath> mMovingPaths;
+         std::vector<unsigned> mInstanceOrder;
+         std::vector<TreeNode> mTopTree;
+         std::vector<unsigned> mTopTreeParents;
+
+         // Disallowed, the trees can be large.
+         RayQueryTree& operator=(const RayQueryTree&);
+         RayQueryTree(const RayQueryTree&);
+   };
+}
+
+#endif // DELTA_RAYQUERYTREE
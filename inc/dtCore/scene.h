@@ -121,6 +121,9 @@ namespace dtCore
       ///Add a DeltaDrawable to the Scene to be viewed.
       void AddDrawable(DeltaDrawable* drawable);
 
+      ///Adds several DeltaDrawables to the Scene at once, making room for all of them first.
+      void AddDrawables(const std::vector<DeltaDrawable*>& drawables);
+
       ///Remove a DeltaDrawable from the Scene
       void RemoveDrawable(DeltaDrawable* drawable);
 
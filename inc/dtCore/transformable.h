@@ -166,12 +166,32 @@ namespace dtCore
       /**
        * Get the current Transform of this Transformable.
        *
+       * The absolute matrix is cached, and only recalculated after this or a Transformable above it has
+       * moved, or has been moved in the hierarchy.  The cache is not used if there is any other
+       * transform node above, except for cameras, when it is calculated.  Changes made straight to the
+       * osg graph are only noticed if they change a Transformable's matrix node or the direct osg parent
+       * of one, so moving an osg group that sits between two Transformables is not picked up.
+       *
+       * Even though this is const, asking for ABS_CS fills in the cache on this and the Transformables
+       * above it, so absolute transforms must only be asked for from one thread at a time, normally the
+       * main thread.  In particular, code run on worker threads, such as ActorComponentSystem updates,
+       * may only ask for REL_CS.
+       *
        * @param xform The value will by assigned to this reference.
        * @param cs The coordinate system of the returned Transform. For absolute,
        * use ABS_CS, and for relative, us REL_CS.
        */
       virtual void GetTransform(Transform& xform, CoordSysEnum cs = ABS_CS) const;
 
+      /**
+       * @return a number that changes whenever the absolute transform of this may have changed since it
+       * was last asked for, so code that keeps a copy of the absolute transform can tell if it is still
+       * current without asking for it again.  Save the value before calling GetTransform, since asking
+       * for the transform may change it.  If the cache can't be used, it changes every time.  The same
+       * threading rules as asking for ABS_CS apply.
+       */
+      unsigned GetAbsoluteTransformVersion() const;
+
       ///Convenience function to return back the internal matrix transform node
       TransformableNode* GetMatrixNode();
 
@@ -465,6 +485,22 @@ namespace dtCore
       void Ctor();
       TransformableImpl* mImpl;
 
+      /// @return the world matrix of this, recalculating it only if it or a Transformable above it has moved.
+      const osg::Matrix& GetCachedAbsoluteMatrix() const;
+
+      /// Flags the cached world matrix of this and of every Transformable under it as out of date.
+      void MarkAbsoluteDirty() const;
+
+      /**
+       * Marks the cached world matrix dirty if the matrix node of this or of a Transformable above has changed.
+       * Only the matrix and the direct osg parent of each matrix node are checked, not any osg nodes between
+       * the parent and the next Transformable up.
+       */
+      void ValidateAbsoluteCache() const;
+
+      /// Calls MarkAbsoluteDirty on the Transformables at or under the given drawable.
+      static void MarkSubtreeAbsoluteDirty(const DeltaDrawable& drawable);
+
       ///little util to remove any of the rendered collision geometry
       void RemoveRenderedCollisionGeometry();
    };
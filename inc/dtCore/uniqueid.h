@@ -26,6 +26,7 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <string>
+#include <cstring>
 
 #include <iosfwd>
 
@@ -38,22 +39,82 @@ namespace dtUtil
 
 namespace dtCore
 {
-   ///Conforms to OSF DCE 1.1
+   /**
+    * Conforms to OSF DCE 1.1
+    *
+    * Ids in the canonical lowercase form, which includes every generated id, are stored as
+    * 16 bytes so that comparing, copying and hashing them don't touch strings.  Any other string
+    * is kept as is so that it round trips unchanged.  A binary id has no string at all, so copying
+    * one never allocates.  Its string form is only built when it is asked for, into a new string
+    * from ToString or into a caller's buffer from FormatString, so a const id can be read from
+    * several threads at once.
+    */
    class DT_CORE_EXPORT UniqueId
    {
       public:
+         /// The number of bytes in the binary form of an id.
+         static const unsigned NUM_BYTES = 16;
+
+         /// The number of characters in the string form of a binary id, not counting a terminating null.
+         static const unsigned STRING_LENGTH = 36;
+
+         /// Creates a new, unique id.
          UniqueId();
-         UniqueId(const UniqueId& toCopy) { mId = toCopy.mId; }
+         UniqueId(const UniqueId& toCopy);
 
-         explicit UniqueId(const std::string& stringId) : mId(stringId) {}
+         explicit UniqueId(const std::string& stringId);
          virtual ~UniqueId() {}
 
-         bool operator== ( const UniqueId& rhs ) const { return mId == rhs.mId; }
-         bool operator!= ( const UniqueId& rhs ) const { return mId != rhs.mId; }
-         bool operator< ( const UniqueId& rhs ) const  { return mId <  rhs.mId; }
-         bool operator> ( const UniqueId& rhs ) const  { return mId >  rhs.mId; }
+         bool operator== ( const UniqueId& rhs ) const
+         {
+            if (mIsBinary && rhs.mIsBinary)
+            {
+               return std::memcmp(mBytes, rhs.mBytes, NUM_BYTES) == 0;
+            }
+            return mIsBinary == rhs.mIsBinary && mId == rhs.mId;
+         }
+
+         bool operator!= ( const UniqueId& rhs ) const { return !(*this == rhs); }
+
+         /// Orders the same way as comparing the string forms would.
+         bool operator< ( const UniqueId& rhs ) const
+         {
+            if (mIsBinary && rhs.mIsBinary)
+            {
+               return std::memcmp(mBytes, rhs.mBytes, NUM_BYTES) < 0;
+            }
+            return ToString() < rhs.ToString();
+         }
+
+         bool operator> ( const UniqueId& rhs ) const  { return rhs < *this; }
+
+         /// @return the string form of the id.  This builds a new string for a binary id.
+         std::string ToString() const;
+
+         /**
+          * Writes the string form of a binary id into a buffer without allocating anything.
+          * @param buffer must hold STRING_LENGTH + 1 characters.  It is null terminated.
+          * @return false, leaving the buffer alone, if the id is only stored as a string.
+          */
+         bool FormatString(char* buffer) const;
+
+         /// @return true if this id is the empty string, which is used to mean "no id".
+         bool IsNull() const { return !mIsBinary && mId.empty(); }
 
-         const std::string& ToString() const;
+         /// @return true if this id is stored as 16 bytes rather than as a string.
+         bool IsBinary() const { return mIsBinary; }
+
+         /**
+          * @return the 16 bytes of the id in network order, or NULL if the id
+          *         isn't a canonical UUID and is only stored as a string.
+          */
+         const unsigned char* GetBytes() const { return mIsBinary ? mBytes : NULL; }
+
+         /// Sets the id from 16 bytes in network order.
+         void SetBytes(const unsigned char* bytes);
+
+         /// @return a hash of the id suitable for hashed containers.
+         size_t GetHash() const;
 
          /**
           * The assignment operator is public so that unique id's can be changed if they are
@@ -68,9 +129,21 @@ namespace dtCore
          UniqueId& operator=(const std::string& rhs);
 
     protected:
+         /// Parses the string into the binary form if it is canonical, or stores it as a string if not.
+         void SetFromString(const std::string& stringId);
+
+         unsigned char mBytes[NUM_BYTES];
+         bool mIsBinary;
+         /// The id if it isn't binary.  It is left empty for binary ids.
          std::string mId;
    };
 
+   /// Hash functor so that UniqueId can be used as a key in dtUtil::HashMap.
+   struct UniqueIdHash
+   {
+      size_t operator()(const UniqueId& id) const { return id.GetHash(); }
+   };
+
    ////////////////////////////////////////////////////
    /////////////  Stream Operators        /////////////
    ////////////////////////////////////////////////////
@@ -32,6 +32,7 @@ namespace dtDAL
 {
 
    class DataType;
+   class PropertyContainer;
 
    /**
     * The actor property class provides a get/set mechanism for
@@ -129,6 +130,13 @@ namespace dtDAL
          /// read the data from a data stream.
          virtual bool FromDataStream(dtUtil::DataStream& stream);
 
+         /**
+          * Marks this property dirty on the container it was added to, if any.  Every way of setting
+          * the value calls this, so the changes can be found without comparing values.
+          * @see PropertyContainer#MarkPropertyDirty
+          */
+         void MarkDirty();
+
       protected:
 
          /**
@@ -166,6 +174,13 @@ namespace dtDAL
           */
          bool mReadOnly;
 
+         friend class PropertyContainer;
+         ///The container this property was added to and its position there, for dirty tracking.
+         PropertyContainer* mOwner;
+         unsigned mOwnerIndex;
+         ///True if the property has changed since its owner last cleared its dirty properties.
+         bool mDirty;
+
          /**
           * hidden copy constructor
           */
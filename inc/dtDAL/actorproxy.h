@@ -228,6 +228,21 @@ namespace dtDAL
           */
          const ActorType& GetActorType() const;
 
+         /**
+          * @return the handle of a property of this proxy on its actor type, or
+          *         ActorType::INVALID_PROPERTY_HANDLE if the property doesn't belong to this proxy.
+          * @see ActorType#GetPropertyHandle
+          */
+         unsigned GetPropertyHandle(const ActorProperty& property) const;
+
+         /**
+          * Gets a property by its handle on this proxy's actor type.  This is an array lookup when
+          * the proxy uses its type's shared layout, otherwise the property is found by name.
+          * @return the property, or NULL if this proxy has no property with the handle.
+          */
+         ActorProperty* GetPropertyByHandle(unsigned handle);
+         const ActorProperty* GetPropertyByHandle(unsigned handle) const;
+
          /**
           * Gets the actor who's properties are modeled by this proxy.
           * @note
@@ -345,6 +360,9 @@ namespace dtDAL
           * library manager to create the clone and then iterates though the
           * current state of this proxy's property set and copies their values
           * to the newly created clone.
+          *
+          * When the clone shares this proxy's property layout, the properties are copied by
+          * position instead of being looked up by name.
           * @return The cloned actor proxy.
           */
          virtual dtCore::RefPtr<ActorProxy> Clone();
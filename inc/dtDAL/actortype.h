@@ -23,6 +23,14 @@
 
 #include <dtDAL/export.h>
 #include <dtDAL/objecttype.h>
+#include <dtDAL/propertylayout.h>
+#include <dtUtil/refstring.h>
+#include <dtUtil/hashmap.h>
+#include <dtCore/refptr.h>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+#include <map>
+#include <vector>
 
 namespace dtDAL
 {
@@ -51,6 +59,9 @@ namespace dtDAL
 
       typedef ActorProxy CreateType;
 
+      /// Returned by FindPropertyHandle when a name has no handle.
+      static const unsigned INVALID_PROPERTY_HANDLE = 0xFFFFFFFFU;
+
       /**
        * Constructs a new actor type object.
        */
@@ -65,6 +76,64 @@ namespace dtDAL
        */
       const ActorType* GetParentActorType() const;
 
+      /**
+       * Gets a small integer that identifies a property name on actors of this type.  Handles are
+       * numbered from 0 in the order the names are first seen, and never change, so they can be used
+       * to index arrays instead of looking properties up by name.  They are only meaningful within one
+       * process, so they must not be sent over the network.
+       * This is thread safe.
+       * @return the handle of the property name, adding one if the name doesn't have one yet.
+       */
+      unsigned GetPropertyHandle(const dtUtil::RefString& name) const;
+
+      /**
+       * Finds the handle of a property name without adding one.  This is how the names in updates
+       * from other processes are resolved to handles.  Names are interned, so this is usually a
+       * hash of the name's address.
+       * This is thread safe.
+       * @return the handle of the property name, or INVALID_PROPERTY_HANDLE if it doesn't have one.
+       */
+      unsigned FindPropertyHandle(const dtUtil::RefString& name) const;
+
+      /**
+       * Holds the lock on the property handles of a type, so the handles of several names can be found
+       * with one lock instead of one per name.  Keep it only as long as it takes to find the names.
+       */
+      class DT_DAL_EXPORT PropertyHandleLookup
+      {
+      public:
+         PropertyHandleLookup(const ActorType& actorType);
+
+         /// @see ActorType#FindPropertyHandle
+         unsigned Find(const dtUtil::RefString& name) const;
+
+      private:
+         const ActorType& mActorType;
+         OpenThreads::ScopedLock<OpenThreads::Mutex> mLock;
+
+         PropertyHandleLookup(const PropertyHandleLookup&);
+         PropertyHandleLookup& operator=(const PropertyHandleLookup&);
+      };
+
+      /// @return the name a handle was created for, or an empty string if the handle is invalid.
+      dtUtil::RefString GetPropertyHandleName(unsigned handle) const;
+
+      /// @return the number of property handles, which is one more than the largest handle.
+      unsigned GetNumPropertyHandles() const;
+
+      /**
+       * @return the property layout shared by the proxies of this type, or NULL if no proxy of
+       *         this type has been created yet.  This is thread safe.
+       */
+      dtCore::RefPtr<const PropertyLayout> GetPropertyLayout() const;
+
+      /**
+       * Sets the property layout shared by the proxies of this type, unless it already has one.
+       * The first proxy created sets it.
+       * @return the layout the type uses, which is the existing one if there was one.
+       */
+      dtCore::RefPtr<const PropertyLayout> SetPropertyLayout(const PropertyLayout& layout) const;
+
 
    protected:
 
@@ -72,6 +141,18 @@ namespace dtDAL
       virtual ~ActorType();
 
    private:
+      typedef std::map<dtUtil::RefString, unsigned> PropertyHandleMap;
+
+      /// FindPropertyHandle without the lock, which the caller must hold.
+      unsigned FindPropertyHandleLocked(const dtUtil::RefString& name) const;
+
+      /// The handles are created as proxies of this type are built, which may be on a loading thread.
+      mutable OpenThreads::Mutex mPropertyHandleMutex;
+      mutable PropertyHandleMap mPropertyHandles;
+      /// The handles keyed by the address of the interned name.
+      mutable dtUtil::HashMap<const std::string*, unsigned> mInternedPropertyHandles;
+      mutable std::vector<dtUtil::RefString> mPropertyHandleNames;
+      mutable dtCore::RefPtr<const PropertyLayout> mPropertyLayout;
    };
 }
 
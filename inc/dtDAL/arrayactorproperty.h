@@ -88,6 +88,7 @@ namespace dtDAL
       virtual void SetValue(const std::vector<T>& value)
       {
          mSetArrayFunc(value);
+         MarkDirty();
       }
 
       /**
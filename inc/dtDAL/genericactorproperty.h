@@ -98,7 +98,14 @@ namespace dtDAL
        */
       void SetValue(SetType value)
       {
-         !IsReadOnly() ? SetPropFunctor(value) : LOG_WARNING("SetValue has been called on a property that is read only.");
+         if (IsReadOnly())
+         {
+            LOG_WARNING("SetValue has been called on a property that is read only.");
+            return;
+         }
+
+         SetPropFunctor(value);
+         MarkDirty();
       }
 
       /**
@@ -36,6 +36,7 @@
 #include <xercesc/util/XercesDefs.hpp>
 #include <xercesc/framework/XMLFormatter.hpp>
 #include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/ContentHandler.hpp>
 
 namespace dtUtil
 {
@@ -54,6 +55,65 @@ namespace dtDAL
    class ArrayActorPropertyBase;
    class ContainerActorProperty;   
    
+   /**
+    * @class MapXMLEvents
+    * @brief the SAX events read from a map file, so a map can be read on one thread and built on another.
+    *
+    * Reading the file only uses xerces.  It doesn't log, look up files, or create any actors, so
+    * it may be done on a background thread.  A MapParser then builds the map from the events on
+    * the main thread, a few events at a time.  Attributes are not kept, because the map format
+    * doesn't use them.
+    */
+   class DT_DAL_EXPORT MapXMLEvents: public osg::Referenced
+   {
+      public:
+         /**
+          * Construct this on the main thread.  It finds the map schema, which Read needs.
+          * @param path the full path to the map file.
+          * @throws ExceptionEnum::ProjectException if the map schema can't be found.
+          */
+         MapXMLEvents(const std::string& path);
+
+         /**
+          * Reads the events from the map file.  This may be called on any thread.
+          * @return false if the file couldn't be read or isn't a valid map.  GetError says why.
+          */
+         bool Read();
+
+         const std::string& GetPath() const { return mPath; }
+
+         /// @return why Read failed.
+         const std::string& GetError() const { return mError; }
+
+         unsigned GetNumEvents() const { return unsigned(mEvents.size()); }
+
+         /// Sends the events from begin up to, but not including, end to the handler.
+         void Send(xercesc::ContentHandler& handler, unsigned begin, unsigned end) const;
+
+      protected:
+         virtual ~MapXMLEvents();
+
+      private:
+         class Recorder;
+
+         struct Event
+         {
+            enum Kind { START_DOCUMENT, END_DOCUMENT, START_ELEMENT, END_ELEMENT, CHARACTERS };
+
+            Kind mKind;
+            /// The null terminated local name of the element, or the characters.
+            std::vector<XMLCh> mText;
+         };
+
+         MapXMLEvents(const MapXMLEvents&);
+         MapXMLEvents& operator=(const MapXMLEvents&);
+
+         std::string mPath;
+         std::string mSchemaPath;
+         std::vector<Event> mEvents;
+         std::string mError;
+   };
+
    /**
     * @class MapParser
     * @brief front end class for converting an XML map into a map instance.
@@ -95,6 +155,23 @@ namespace dtDAL
           */
          const std::string ParseMapName(const std::string& path);
 
+         /**
+          * Starts building a map from events that have been read.  Call ContinueParse until it returns the map.
+          * While the map is being built, this parser must not be used to parse anything else.
+          */
+         void BeginParse(const MapXMLEvents& events);
+
+         /**
+          * Sends up to maxEvents more of the events passed to BeginParse to the content handler.
+          * As with Parse, store a dtCore::RefPtr to the map immediately.
+          * @return the map once all of the events have been sent, otherwise NULL.
+          * @throws MapLoadParseError if the events aren't a valid map.
+          */
+         Map* ContinueParse(unsigned maxEvents);
+
+         /// @return the fraction, from 0 to 1, of the events passed to BeginParse that have been sent.
+         float GetParseProgress() const;
+
          ///@return true if the map is currently being parsed.
          bool IsParsing() const { return mParsing; }
 
@@ -138,6 +215,8 @@ namespace dtDAL
          xercesc::SAX2XMLReader* mXercesParser;
          dtUtil::Log* mLogger;
          bool mParsing;
+         dtCore::RefPtr<const MapXMLEvents> mEvents;
+         unsigned mNextEvent;
    };
 
 
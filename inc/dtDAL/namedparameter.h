@@ -227,6 +227,12 @@ namespace dtDAL
           */
          unsigned int GetParameterCount() const {return mParameterList.size();}
 
+         /**
+          * @return a number that changes whenever a parameter is added or removed, so information
+          *         kept about the parameters can be checked to see if it's still current.
+          */
+         unsigned GetRevision() const { return mRevision; }
+
          /**
           * Sets the message parameter's value from the actor property's value
           */
@@ -241,6 +247,7 @@ namespace dtDAL
 
       private:
          ParameterList mParameterList;
+         unsigned mRevision;
    };
 
    template <class ParamType>
@@ -115,6 +115,9 @@ namespace dtDAL
          //internal handling for loading a map.
          Map& InternalLoadMap(const std::string& name,const std::string& fullPath, bool clearModified);
 
+         //the handling shared by all the ways of parsing a map after the parser is done.
+         static void FinishParsedMap(Map& map, MapParser& parser, bool clearModified);
+
          //internal handling of closing a sincle map.
          void InternalCloseMap(Map& map, bool unloadLibraries);
 
@@ -220,6 +223,33 @@ namespace dtDAL
           */
          Map& GetMap(const std::string& name);
 
+         /**
+          * @return true if the map with the given name is open.
+          */
+         bool IsMapOpen(const std::string& name) const;
+
+         /**
+          * @param name the name of the map as specified by the getMapNames() vector.
+          * @return the full path to the file of the map with the given name.
+          * @throws FileExceptionEnum::FileNotFound if the map does not exist.
+          * @throws ExceptionEnum::ProjectInvalidContext if the context is not set.
+          */
+         const std::string GetMapFilePath(const std::string& name) const;
+
+         /**
+          * Opens a map built by a parser other than the project's, as if GetMap had loaded it.
+          * This is how a map read in the background with MapXMLEvents is opened, after a MapParser
+          * has built it from the events.
+          * @param name the name of the map as specified by the getMapNames() vector.
+          * @param map the parsed map.
+          * @param parser the parser that built the map.  It has the libraries and actor types the map was missing.
+          * @return the opened map.  If a map with the name was opened while this one was being
+          *         parsed, that map is returned and this one is not used.
+          * @throws FileExceptionEnum::FileNotFound if the map does not exist.
+          * @throws ExceptionEnum::ProjectInvalidContext if the context is not set.
+          */
+         Map& OpenParsedMap(const std::string& name, Map& map, MapParser& parser);
+
          /**
           * returns the last backup save of the map with the given name.
           * @note if no backup is found, this call will NOT open the saved map, it will throw a file not
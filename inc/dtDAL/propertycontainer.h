@@ -29,6 +29,7 @@
 #include <dtCore/refptr.h>
 #include <dtDAL/export.h>
 #include <dtDAL/actorproperty.h>
+#include <dtDAL/propertylayout.h>
 #include <osg/Referenced>
 
 #include <map>
@@ -91,6 +92,22 @@ namespace dtDAL
        */
       const ActorProperty* GetProperty(const std::string& name) const;
 
+      /// @return the number of properties in the property list.
+      unsigned GetNumProperties() const { return unsigned(mProperties.size()); }
+
+      /// @return the property at a position in the property list.  The index is not checked.
+      ActorProperty* GetPropertyByIndex(unsigned index) { return mProperties[index].get(); }
+      const ActorProperty* GetPropertyByIndex(unsigned index) const { return mProperties[index].get(); }
+
+      /// @return the position of the property in the property list, or -1 if it isn't in this container.
+      int GetPropertyIndex(const ActorProperty& property) const
+      {
+         return property.mOwner == this ? int(property.mOwnerIndex) : -1;
+      }
+
+      /// @return the layout this container shares with others, or NULL if it indexes its own properties.
+      const PropertyLayout* GetSharedLayout() const { return mSharedLayout.get(); }
+
       /**
       * This function queries the proxy with any properties not
       * found in the property list. If a property was previously
@@ -110,21 +127,81 @@ namespace dtDAL
        */
       void CopyPropertiesFrom(const PropertyContainer& copyFrom);
 
+      /**
+       * Marks a property as changed since the dirty properties were last cleared.  The property
+       * setters call this, so it only needs to be called directly when a value is changed without
+       * going through its property.
+       */
+      void MarkPropertyDirty(const dtUtil::RefString& name);
+
+      /// Marks the property at the given position in the property list as changed.
+      void MarkPropertyDirty(unsigned index);
+
+      /// @return true if the property has changed since the dirty properties were last cleared.
+      bool IsPropertyDirty(const dtUtil::RefString& name) const;
+
+      /// @return true if any property has changed since the dirty properties were last cleared.
+      bool HasDirtyProperties() const { return !mDirtyIndices.empty(); }
+
+      /// @return the number of properties that have changed since the dirty properties were last cleared.
+      unsigned GetNumDirtyProperties() const { return unsigned(mDirtyIndices.size()); }
+
+      /**
+       * Fills a vector with the names of the dirty properties in the order they were marked.
+       * This costs time proportional to the number of dirty properties, not the number of properties.
+       */
+      void GetDirtyPropertyNames(std::vector<dtUtil::RefString>& toFill) const;
+
+      /// Clears the dirty flag of one property.
+      void ClearPropertyDirty(const dtUtil::RefString& name);
+
+      /// Clears the dirty flags of all the properties.
+      void ClearDirtyProperties();
+
    protected:
       virtual ~PropertyContainer();
 
       void RemoveProperty(const std::string& nameToRemove);
 
+      /**
+       * Called when a property is marked dirty while no other property is dirty, so subclasses
+       * can arrange for the changes to be handled.
+       */
+      virtual void OnPropertiesDirty() {}
+
+      /// Called after a property is added or removed, or the shared layout changes.
+      virtual void OnPropertyListChanged() {}
+
+      /**
+       * Finds properties using a layout shared with other containers instead of a name map of
+       * this container's own.  Properties added afterward are matched against the layout, so this
+       * may be called before the properties are added.  If the properties stop matching, because
+       * one is added out of order or removed, the container goes back to its own map.
+       * @param layout the layout to use, or NULL to go back to its own map.
+       */
+      void SetSharedLayout(const PropertyLayout* layout);
+
    private:
-      typedef std::map<dtUtil::RefString, dtCore::RefPtr<ActorProperty> > PropertyMapType;
+      typedef std::map<dtUtil::RefString, unsigned> PropertyMapType;
       typedef std::vector<dtCore::RefPtr<ActorProperty> > PropertyVectorType;
 
-      ///Map of properties.
+      /// @return the position of the named property, or -1 if there is no such property.
+      int FindPropertyIndex(const std::string& name) const;
+      void AppendProperty(ActorProperty& newProp);
+      /// Builds this container's own name map and stops using the shared layout.
+      void DetachSharedLayout();
+
+      ///Map of property names to their positions, only used when there is no shared layout.
       PropertyMapType mPropertyMap;
+      ///The layout shared with other containers, used instead of mPropertyMap.
+      dtCore::RefPtr<const PropertyLayout> mSharedLayout;
 
       ///vector of properties (for order).
       PropertyVectorType mProperties;
 
+      ///The positions of the dirty properties, so they can be found without checking every property.
+      std::vector<unsigned> mDirtyIndices;
+
    };
 
 }
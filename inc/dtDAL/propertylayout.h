@@ -0,0 +1,93 @@
+/* -*-c++-*-
+ * Delta3D
+ * Copyright 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_PROPERTYLAYOUT
+#define DELTA_PROPERTYLAYOUT
+
+#include <dtUtil/refstring.h>
+#include <dtDAL/export.h>
+#include <osg/Referenced>
+
+#include <map>
+#include <vector>
+
+namespace dtDAL
+{
+   class PropertyContainer;
+
+   /**
+    * The names and order of the properties in a property container, with the index to find them
+    * by name.  Every proxy of an actor type builds the same properties in the same order, so the
+    * type keeps one layout and its proxies share it instead of each keeping its own name map.
+    * A container uses a layout as long as its properties match the start of the layout.
+    * Only the lookup is shared; each proxy still creates its own properties and their accessors.
+    * Layouts are not changed once they are shared.
+    * @see PropertyContainer#SetSharedLayout
+    */
+   class DT_DAL_EXPORT PropertyLayout : public osg::Referenced
+   {
+   public:
+      static const unsigned INVALID_HANDLE = 0xFFFFFFFFU;
+
+      /// Records the names and order of the properties currently in a container.
+      PropertyLayout(const PropertyContainer& container);
+
+      unsigned GetNumProperties() const { return unsigned(mNames.size()); }
+
+      /// @return the name of the property at a position.  The index is not checked.
+      const dtUtil::RefString& GetPropertyName(unsigned index) const { return mNames[index]; }
+
+      /// @return the position of the named property, or -1 if the layout doesn't have it.
+      int FindPropertyIndex(const std::string& name) const;
+
+      /**
+       * Sets the actor type handle of the property at a position.  This is only done while the
+       * layout is being built.
+       * @see ActorType#GetPropertyHandle
+       */
+      void SetPropertyHandle(unsigned index, unsigned handle);
+
+      /// @return the handle of the property at a position, or INVALID_HANDLE if it wasn't set.
+      unsigned GetPropertyHandle(unsigned index) const { return mHandles[index]; }
+
+      /// @return the position of the property with a handle, or -1 if the layout doesn't have it.
+      int GetIndexOfHandle(unsigned handle) const
+      {
+         return handle < mIndexOfHandle.size() ? mIndexOfHandle[handle] : -1;
+      }
+
+   protected:
+      virtual ~PropertyLayout();
+
+   private:
+      typedef std::map<dtUtil::RefString, unsigned> IndexMap;
+
+      std::vector<dtUtil::RefString> mNames;
+      IndexMap mIndices;
+      std::vector<unsigned> mHandles;
+      std::vector<int> mIndexOfHandle;
+   };
+}
+
+#endif // DELTA_PROPERTYLAYOUT
@@ -29,6 +29,7 @@ namespace dtGame
 {
    class GameActor;
    class ActorComponentBase;
+   class ActorComponentSystem;
    class TickMessage;
 
    /**
@@ -132,10 +133,16 @@ namespace dtGame
       virtual ~ActorComponent();
 
    private: 
+      friend class ActorComponentSystem;
+      friend class ActorComponentBase;
 
       /** The ComponentBase this component is a part of */
       ActorComponentBase* mOwner;
 
+      /** The system updating this component, if any, and its position in the system's list */
+      ActorComponentSystem* mSystem;
+      unsigned mSystemIndex;
+
       /** type string of component */
       const ACType mType;
 
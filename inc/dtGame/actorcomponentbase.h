@@ -81,6 +81,9 @@ namespace dtGame
        */
       bool HasComponent(const ActorComponent::ACType& type) const;
 
+      /// @return the number of ActorComponents this holds.
+      unsigned GetNumComponents() const { return unsigned(mComponents.size()); }
+
       /**
        * Add an ActorComponent. Only one ActorComponent of a given type can be added.
        * @param component The ActorComponent to try to add
@@ -131,6 +134,9 @@ namespace dtGame
       virtual ~ActorComponentBase();
 
    private:
+
+      /// Hands a component to the ActorComponentSystem for its type, if the GameManager has one.
+      void AddToComponentSystem(ActorComponent& component);
       
       ActorComponentMap mComponents;
 
@@ -0,0 +1,135 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_ACTORCOMPONENTSYSTEM
+#define DELTA_ACTORCOMPONENTSYSTEM
+
+#include <dtGame/export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtGame/actorcomponent.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/workerpool.h>
+#include <vector>
+
+namespace dtGame
+{
+   class TickMessage;
+
+   /**
+    * Updates all the ActorComponents of one type together once a tick, instead of each component
+    * registering its own tick invokable.  While the system is in the GameManager, every component of its
+    * type on an actor in the GameManager is kept in one contiguous list, so an update can run straight
+    * through them.
+    *
+    * Subclasses implement UpdateComponents.  The list is split into chunks of GetChunkSize components,
+    * and UpdateComponents is called once per chunk.  If a WorkerPool is set, the chunks are run on its
+    * threads in parallel, so UpdateComponents must then only change the components it is given.
+    * It must not ask for absolute transforms either, since Transformable::GetTransform fills in a cache
+    * on the actor and its parents when asked for ABS_CS.  Relative transforms are safe to read.
+    *
+    * Only one system per component type may be added to a GameManager, since it is found by its name.
+    */
+   class DT_GAME_EXPORT ActorComponentSystem : public GMComponent
+   {
+   public:
+      typedef std::vector<dtCore::RefPtr<ActorComponent> > ComponentList;
+
+      /// The default number of components passed to each UpdateComponents call.
+      static const unsigned DEFAULT_CHUNK_SIZE = 256;
+
+      /// @return the GMComponent name of the system for a component type.
+      static std::string GetSystemName(const ActorComponent::ACType& type);
+
+      /// @return the system in the GameManager for a component type, or NULL if there isn't one.
+      static ActorComponentSystem* FindSystem(GameManager& gm, const ActorComponent::ACType& type);
+
+      /// @param type the type of the components this system updates.
+      ActorComponentSystem(const ActorComponent::ACType& type);
+
+      const ActorComponent::ACType& GetComponentType() const { return mComponentType; }
+
+      /// @return the components being updated, in no particular order.
+      const ComponentList& GetComponents() const { return mComponents; }
+      unsigned GetNumComponents() const { return unsigned(mComponents.size()); }
+
+      /// Sets the number of components passed to each UpdateComponents call.  0 passes them all at once.
+      void SetChunkSize(unsigned chunkSize) { mChunkSize = chunkSize; }
+      unsigned GetChunkSize() const { return mChunkSize; }
+
+      /// Sets the threads to update the chunks on, or NULL to update them all on the calling thread.
+      void SetWorkerPool(dtUtil::WorkerPool* pool) { mWorkerPool = pool; }
+      dtUtil::WorkerPool* GetWorkerPool() const { return mWorkerPool.get(); }
+
+      /// Updates all the components with a tick.  This is called for every TICK_LOCAL.
+      void Update(const TickMessage& tickMessage);
+
+      /// Calls Update for TICK_LOCAL messages.
+      virtual void ProcessMessage(const Message& message);
+
+      /**
+       * Adds a component to be updated.  ActorComponentBase calls this when a component of this type is
+       * added to an actor in the GameManager, so it doesn't normally need to be called.
+       */
+      void AddActorComponent(ActorComponent& component);
+
+      /// Stops updating a component.  Components added or removed during an update are changed after it finishes.
+      void RemoveActorComponent(ActorComponent& component);
+
+      /// Adds the components of the actors already in the GameManager.
+      virtual void OnAddedToGM();
+
+      /// Stops updating all the components.
+      virtual void OnRemovedFromGM();
+
+   protected:
+      virtual ~ActorComponentSystem();
+
+      /**
+       * Updates a range of components.  When a WorkerPool is set, this is called from several threads
+       * at once with different ranges, and must not ask for absolute transforms.
+       * @param tickMessage the tick being processed.
+       * @param components the first component of the range.
+       * @param count the number of components in the range.
+       */
+      virtual void UpdateComponents(const TickMessage& tickMessage,
+               const dtCore::RefPtr<ActorComponent>* components, unsigned count) = 0;
+
+   private:
+      class ChunkTask;
+
+      /// The index of a component that is waiting to be added.
+      static const unsigned INVALID_INDEX = 0xFFFFFFFFU;
+
+      void RemoveAt(unsigned index);
+
+      const ActorComponent::ACType mComponentType;
+      ComponentList mComponents;
+      unsigned mChunkSize;
+      dtCore::RefPtr<dtUtil::WorkerPool> mWorkerPool;
+
+      /// true while the components are being updated, so changes to the list wait.
+      bool mUpdating;
+      ComponentList mPendingAdds;
+      ComponentList mPendingRemovals;
+   };
+}
+
+#endif // DELTA_ACTORCOMPONENTSYSTEM
@@ -0,0 +1,184 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_ACTOR_SPATIAL_INDEX
+#define DELTA_ACTOR_SPATIAL_INDEX
+
+#include <dtUtil/hashmap.h>
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+#include <vector>
+
+namespace dtCore
+{
+   class Transformable;
+}
+
+namespace dtDAL
+{
+   class ActorProxy;
+   class ActorType;
+}
+
+// this is purposely not exported, should only be used by the GM
+namespace dtGame
+{
+   /**
+    * A hashed uniform grid over the transformable actors in the GameManager.  It backs the
+    * GameManager proximity queries so that they only visit the cells overlapping the query
+    * instead of every actor.
+    *
+    * Actor positions are sampled when an actor is inserted and again by Update().  The GameManager
+    * invalidates the index once per frame and the first query of the frame calls Update(), which
+    * only re-reads the positions of actors whose transform version changed, and only touches the
+    * cell lists of actors that moved to a different cell.
+    */
+   class ActorSpatialIndex
+   {
+   public:
+      /// The default edge length of a grid cell, in meters.
+      static const float DEFAULT_CELL_SIZE;
+
+      ActorSpatialIndex(float cellSize = DEFAULT_CELL_SIZE);
+      ~ActorSpatialIndex();
+
+      /**
+       * Changes the edge length of the grid cells and rebuckets all the indexed actors.
+       * A good value is roughly the radius of the most common query.
+       */
+      void SetCellSize(float cellSize);
+      float GetCellSize() const;
+
+      /**
+       * Adds an actor to the index.  Only actors whose drawable is a dtCore::Transformable are indexed.
+       * @return true if the actor was added.
+       */
+      bool Insert(dtDAL::ActorProxy& proxy);
+
+      /// Removes an actor from the index.  This is a no-op if the actor was never indexed.
+      void Remove(const dtDAL::ActorProxy& proxy);
+
+      /// Removes all actors from the index.
+      void Clear();
+
+      /// @return the number of actors in the index.
+      size_t GetNumActors() const;
+
+      /// Flags the positions as stale so the next query will call Update() first.
+      void Invalidate();
+
+      /// Re-reads the positions of the indexed actors whose transform changed and moves the ones that changed cells.
+      void Update();
+
+      /**
+       * Fills a vector with the actors whose position is within a sphere.
+       * @param center the center of the sphere.
+       * @param radius the radius of the sphere.
+       * @param toFill the vector to fill.  It is cleared first.
+       * @param type if not NULL, only actors whose type is, or inherits from, this type are returned.
+       */
+      void FindWithinRadius(const osg::Vec3& center, float radius,
+               std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL);
+
+      /**
+       * Fills a vector with the actors whose position is inside an axis aligned box.
+       * @param box the box to search.
+       * @param toFill the vector to fill.  It is cleared first.
+       * @param type if not NULL, only actors whose type is, or inherits from, this type are returned.
+       */
+      void FindWithinBox(const osg::BoundingBox& box,
+               std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL);
+
+      /**
+       * Fills a vector with the actors nearest a point, sorted nearest first.
+       * @param center the point to search from.
+       * @param count the maximum number of actors to return.
+       * @param maxRadius actors farther than this are never returned.
+       * @param toFill the vector to fill.  It is cleared first.
+       * @param type if not NULL, only actors whose type is, or inherits from, this type are returned.
+       */
+      void FindNearest(const osg::Vec3& center, unsigned count, float maxRadius,
+               std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL);
+
+   private:
+      struct CellCoord
+      {
+         int x, y, z;
+
+         bool operator==(const CellCoord& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z; }
+         bool operator!=(const CellCoord& rhs) const { return !(*this == rhs); }
+         bool operator<(const CellCoord& rhs) const
+         {
+            if (x != rhs.x) { return x < rhs.x; }
+            if (y != rhs.y) { return y < rhs.y; }
+            return z < rhs.z;
+         }
+      };
+
+      struct CellCoordHash
+      {
+         size_t operator()(const CellCoord& c) const
+         {
+            // large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            return size_t((unsigned(c.x) * 73856093U) ^ (unsigned(c.y) * 19349663U) ^ (unsigned(c.z) * 83492791U));
+         }
+      };
+
+      struct Entry
+      {
+         dtDAL::ActorProxy* mProxy;
+         dtCore::Transformable* mTransformable;
+         /// The absolute transform version of the transformable when the position was read.
+         unsigned mTransformVersion;
+         osg::Vec3 mPosition;
+         CellCoord mCell;
+      };
+
+      typedef std::vector<unsigned> IndexList;
+      typedef dtUtil::HashMap<CellCoord, IndexList, CellCoordHash> CellMap;
+      typedef dtUtil::HashMap<const dtDAL::ActorProxy*, unsigned> ProxyIndexMap;
+
+      CellCoord ToCell(const osg::Vec3& pos) const;
+      void ReadPosition(Entry& entry) const;
+      /// Recalculates the bounds from the entries if an entry was removed or moved since the last time.
+      void UpdateBounds();
+      void AddToCell(const CellCoord& cell, unsigned entryIndex);
+      void RemoveFromCell(const CellCoord& cell, unsigned entryIndex);
+      void ReplaceInCell(const CellCoord& cell, unsigned oldIndex, unsigned newIndex);
+
+      /// Calls the functor for every entry in a cell overlapping the given cell range.
+      template <typename EntryFunc>
+      void VisitCells(const CellCoord& minCell, const CellCoord& maxCell, EntryFunc& func);
+
+      float mCellSize;
+      float mInvCellSize;
+      bool mDirty;
+      bool mBoundsDirty;
+
+      std::vector<Entry> mEntries;
+      CellMap mCells;
+      ProxyIndexMap mProxyIndices;
+      /// The bounds of the indexed positions.  Used to terminate nearest searches.
+      osg::BoundingBox mBounds;
+   };
+}
+
+#endif // DELTA_ACTOR_SPATIAL_INDEX
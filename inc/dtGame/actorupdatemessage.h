@@ -50,6 +50,10 @@ namespace dtGame
          static const dtUtil::RefString PROTOTYPE_NAME_PARAMETER;
          static const dtUtil::RefString UPDATE_GROUP_PARAMETER;
 
+         /// An update parameter paired with the handle of its property.
+         typedef std::pair<unsigned, const MessageParameter*> ParameterHandle;
+         typedef std::vector<ParameterHandle> ParameterHandleList;
+
          /// Constructor
          ActorUpdateMessage();
          
@@ -148,6 +152,48 @@ namespace dtGame
           */
          void GetUpdateParameters(std::vector<const MessageParameter*> &toFill) const;
 
+         /**
+          * Records the property handle of an update parameter, so the property can be found by index
+          * rather than by name when the update is applied.  GameActorProxy::PopulateActorUpdate sets
+          * these, and components that build updates, such as network components, may set them too.
+          * All the handles in a message must come from the same actor type.  Setting one from another
+          * type discards the others.  Set each parameter's handle only once.
+          * @param actorType the actor type the handle came from.
+          * @param handle the property handle.
+          * @param param an update parameter in this message.
+          * @see dtDAL::ActorType#GetPropertyHandle
+          */
+         void SetUpdateParameterHandle(const dtDAL::ActorType& actorType, unsigned handle, const MessageParameter& param);
+
+         /**
+          * @return the update parameters paired with their property handles, or NULL unless every
+          *         update parameter has been given a handle from the given actor type since the last
+          *         parameter was added or removed.
+          */
+         const ParameterHandleList* GetUpdateParameterHandles(const dtDAL::ActorType& actorType) const;
+
+         /**
+          * Sets the handles of all of the update parameters by looking their names up on the actor type.
+          * Components that read updates from another process, where handles mean nothing, call this
+          * once the update parameters are all added.  It must be called on the thread the GM runs on.
+          * @return true if every update parameter has a handle on the type.  If not, no handles are set,
+          *         and the update is applied by property name.
+          * @see dtDAL::ActorType#FindPropertyHandle
+          */
+         bool ResolveUpdateParameterHandles(const dtDAL::ActorType& actorType);
+
+         /**
+          * @return the update parameters paired with their property handles on the given actor type.  Parameters
+          *         whose names have no handle on the type, such as properties added to just one actor, are paired
+          *         with dtDAL::ActorType::INVALID_PROPERTY_HANDLE.  If the handles haven't been set or resolved for
+          *         the type and the current parameters, they are looked up now, holding the type's lock once for
+          *         all of them, and kept for the next call.  It must be called on the thread the GM runs on.
+          */
+         const ParameterHandleList& FindUpdateParameterHandles(const dtDAL::ActorType& actorType) const;
+
+         /// Copies the message.  The handles are not copied since they refer to this message's parameters.
+         virtual void CopyDataTo(Message& msg) const;
+
          /**
           * Gets the actor type that this message is about
           * @return The actor type or NULL if the current name and category do not exist
@@ -182,7 +228,24 @@ namespace dtGame
 
       private:
 
+         // The message holds the references.  These just skip the name lookup in the accessors.
+         StringMessageParameter* mName;
+         StringMessageParameter* mActorTypeName;
+         StringMessageParameter* mActorTypeCategory;
+         StringMessageParameter* mPrototypeName;
          GroupMessageParameter* mUpdateParameters;
+
+         /// @return true if the handle list is for the given type and the current update parameters.
+         bool IsParameterHandleListCurrent(const dtDAL::ActorType& actorType) const;
+
+         /**
+          * The update parameters that have handles, the type the handles are from, the group revision when last set,
+          * and whether every parameter has a handle.  FindUpdateParameterHandles fills these in on a const message.
+          */
+         mutable ParameterHandleList mParameterHandles;
+         mutable const dtDAL::ActorType* mParameterHandleType;
+         mutable unsigned mParameterHandleRevision;
+         mutable bool mParameterHandlesComplete;
    };
 }
 
@@ -123,8 +123,10 @@ namespace dtGame
          /// Constructor
          TimerElapsedMessage() : Message()
          {
-            AddParameter(new StringMessageParameter("TimerName"));
-            AddParameter(new FloatMessageParameter("LateTime"));
+            mTimerName = new StringMessageParameter("TimerName");
+            mLateTime = new FloatMessageParameter("LateTime");
+            AddParameter(mTimerName);
+            AddParameter(mLateTime);
          }
 
          /**
@@ -155,6 +157,10 @@ namespace dtGame
          /// Destructor
          virtual ~TimerElapsedMessage() { }
 
+      private:
+         StringMessageParameter* mTimerName;
+         FloatMessageParameter* mLateTime;
+
    };
 
 
@@ -220,6 +226,7 @@ namespace dtGame
    {
       public:
          static const dtUtil::RefString PARAM_MAP_NAMES;
+         static const dtUtil::RefString PARAM_LOAD_PROGRESS;
 
          /// Constructor
          MapMessage();
@@ -235,10 +242,20 @@ namespace dtGame
           */
          void SetMapNames(const std::vector<std::string>& nameVec);
 
+         /**
+          * @return how much of the map loading is done, from 0 to 1.  It is 0 on the messages
+          *         sent before the actors are added and 1 on the messages sent after.
+          */
+         float GetLoadProgress() const;
+
+         /// Sets how much of the map loading is done, from 0 to 1.
+         void SetLoadProgress(float progress);
+
       protected:
          /// Destructor
          virtual ~MapMessage() { }
          dtCore::RefPtr<GroupMessageParameter> mMapNames;
+         dtCore::RefPtr<FloatMessageParameter> mLoadProgress;
    };
 
    class DT_GAME_EXPORT GameEventMessage : public Message
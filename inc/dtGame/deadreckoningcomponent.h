@@ -23,9 +23,13 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <dtCore/refptr.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/hashmap.h>
 #include <dtUtil/nodecollector.h>
+#include <dtUtil/workerpool.h>
 
 #include <dtGame/export.h>
 #include <dtGame/gmcomponent.h>
@@ -121,7 +125,215 @@ namespace dtGame
 
          /// @return the ground clamping utility class
          BaseGroundClamper& GetGroundClamper();
-         
+
+         /**
+          * Enables the batch dead reckoning path.  When enabled, every helper using VELOCITY_ONLY or
+          * VELOCITY_AND_ACCELERATION that did not receive an update this tick is extrapolated in one
+          * pass over contiguous arrays that are kept for all the registered helpers, see DRBatch.
+          * Only the entities whose dead reckoned values changed are handed to the ground clamper
+          * to be moved.
+          * Helpers that override DoDR should not be used with this enabled, since the batch
+          * bypasses it.  Defaults to false.
+          */
+         void SetUseBatchDeadReckoning(bool useBatch) { mUseBatchDR = useBatch; }
+         bool GetUseBatchDeadReckoning() const { return mUseBatchDR; }
+
+         /**
+          * Sets the pool used to split dead reckoning into chunks of BATCH_CHUNK_SIZE registered actors
+          * run in parallel.  The time bookkeeping, the batch kernel and DoDR run on the workers, so
+          * helpers that override DoDR must only change their own state and read their actor's
+          * relative transform.  Finding the actors, moving them, clamping and articulation stay on
+          * the calling thread, and so does everything while debug logging is on.
+          * If the ground clamper is a DefaultGroundClamper, it is given the pool too so its clamping
+          * queries run in parallel.  NULL, the default, runs everything on the calling thread.
+          */
+         void SetWorkerPool(dtUtil::WorkerPool* pool);
+         dtUtil::WorkerPool* GetWorkerPool() const { return mWorkerPool.get(); }
+
+         /**
+          * If the ground clamper is a DefaultGroundClamper, sets whether it answers its terrain queries
+          * from a ray query tree.  Otherwise this does nothing.
+          * @see DefaultGroundClamper::SetUseRayQueryTree
+          */
+         void SetUseRayQueryTree(bool useTree);
+
+         /// @return true if the ground clamper is a DefaultGroundClamper that uses a ray query tree.
+         bool GetUseRayQueryTree() const;
+
+         /// The number of batched entities handed to a worker thread at a time.
+         static const unsigned BATCH_CHUNK_SIZE = 256;
+
+         /**
+          * Adds a distance band.  Actors moved by this component that are at least minDistance from the
+          * eye point actor are fully dead reckoned, clamped and articulated only every updateInterval ticks.
+          * On the ticks in between, they are just carried along their velocity.  An actor uses the band with the
+          * largest minDistance it is beyond.  Adding a band with the same minDistance as an existing one
+          * replaces it.  Bands are ignored if there is no eye point actor, and actors that received an
+          * update are always fully dead reckoned.
+          */
+         void AddDistanceBand(float minDistance, unsigned updateInterval);
+
+         /// Removes all the distance bands so every actor is updated every tick.
+         void ClearDistanceBands();
+
+         unsigned GetNumDistanceBands() const { return unsigned(mDistanceBands.size()); }
+
+         /// @return the update interval the distance bands give for the distance, 1 if no band applies.
+         unsigned GetUpdateIntervalForDistance(float distance) const;
+
+         /**
+          * Sets the update interval for actors outside a cone of halfAngleDegrees around the direction
+          * the eye point actor faces, i.e. actors that are off screen.  The larger of this and the distance
+          * band interval is used.  1, the default, turns this off.
+          */
+         void SetOffScreenUpdateInterval(unsigned updateInterval, float halfAngleDegrees = 60.0f);
+         unsigned GetOffScreenUpdateInterval() const { return mOffScreenInterval; }
+         float GetOffScreenHalfAngle() const { return mOffScreenHalfAngle; }
+
+         /**
+          * Turns on publishing based on dead reckoning error.  Registered local actors that are published
+          * and only calculate their dead reckoning are dead reckoned exactly the way remote copies of them
+          * are.  When the transform remote copies converge to drifts from the real one past the max translation
+          * or rotation error, or the publish heartbeat has passed since the last publish, the real transform
+          * is stored in the helper as the last known values, and the dead reckoning properties are sent in
+          * a partial actor update.  The actor should keep its helper's velocity and acceleration up to date,
+          * but it no longer needs to send updates for its position on its own.  Defaults to false.
+          */
+         void SetPublishOnDeadReckoningError(bool publish) { mPublishOnDRError = publish; }
+         bool GetPublishOnDeadReckoningError() const { return mPublishOnDRError; }
+
+         /// Sets the distance between the real and dead reckoned position that causes a publish. Defaults to 0.5.
+         void SetMaxTranslationError(float maxError) { mMaxTranslationError = maxError; }
+         float GetMaxTranslationError() const { return mMaxTranslationError; }
+
+         /// Sets the angle in degrees between the real and dead reckoned rotation that causes a publish. Defaults to 3.
+         void SetMaxRotationError(float maxErrorDegrees);
+         float GetMaxRotationError() const { return mMaxRotationError; }
+
+         /// Sets the longest time in seconds to go without publishing, even if there is no error.  0 turns it off.  Defaults to 5.
+         void SetPublishHeartbeat(float seconds) { mPublishHeartbeat = seconds; }
+         float GetPublishHeartbeat() const { return mPublishHeartbeat; }
+
+         /**
+          * Structure-of-arrays copy of the helper state used by the batch dead reckoning path.
+          * Each array holds one entry per registered helper.  Entries are added and removed as
+          * helpers are registered and unregistered, so the arrays persist between ticks.  Only the
+          * values that change every tick are copied in for the active entries.  The rest are copied
+          * again only after the helper gets a dead reckoning update.
+          */
+         struct DT_GAME_EXPORT DRBatch
+         {
+            struct DT_GAME_EXPORT Vec3Array
+            {
+               std::vector<float> mX, mY, mZ;
+
+               void Clear() { mX.clear(); mY.clear(); mZ.clear(); }
+               void PushBack(const osg::Vec3& vec) { mX.push_back(vec.x()); mY.push_back(vec.y()); mZ.push_back(vec.z()); }
+               void Set(unsigned i, const osg::Vec3& vec) { mX[i] = vec.x(); mY[i] = vec.y(); mZ[i] = vec.z(); }
+               osg::Vec3 Get(unsigned i) const { return osg::Vec3(mX[i], mY[i], mZ[i]); }
+               /// Moves the last entry into position i and shortens the arrays by one.
+               void RemoveBySwap(unsigned i) { Set(i, Get(unsigned(mX.size()) - 1)); mX.pop_back(); mY.pop_back(); mZ.pop_back(); }
+            };
+
+            /// The batch index of a helper that is not in a batch.
+            static const unsigned INVALID_INDEX = 0xFFFFFFFFU;
+
+            /// What is done for an entry on the current tick, see mStep.
+            enum Step
+            {
+               /// The actor is not dead reckoned this tick.
+               STEP_NONE,
+               /// The actor is in the GM, and the step hasn't been worked out yet.
+               STEP_PENDING,
+               /// The actor is only carried along its velocity, see SetOffScreenUpdateInterval.
+               STEP_MOVE_BETWEEN_UPDATES,
+               /// The translation comes from the kernel.
+               STEP_BATCH,
+               /// The helper's DoDR is called.
+               STEP_DO_DR
+            };
+
+            /// Empties the arrays but keeps their capacity.
+            void Clear();
+
+            /**
+             * Adds an entry for the helper to the end of the arrays, copies its state in, and marks
+             * it active.  The helper remembers its position.
+             */
+            void Add(DeadReckoningHelper& helper, GameActor& gameActor);
+
+            /// Removes the entry of the helper, moving the last entry into its place.
+            void Remove(DeadReckoningHelper& helper);
+
+            /// Sets every entry to STEP_NONE, to be called at the start of a tick.
+            void BeginTick();
+
+            /// Sets the entry of the helper to STEP_PENDING, adding it if it isn't in the batch.
+            void SetPending(DeadReckoningHelper& helper, GameActor& gameActor);
+
+            /**
+             * Sets entry i to STEP_BATCH and copies in the values that change every tick.
+             * If the entry is stale, all the helper's state is copied again first.
+             */
+            void Activate(unsigned i);
+
+            /// Marks entry i so all its state is copied the next time it is activated.
+            void MarkStale(unsigned i);
+
+            /// Copies all the state of the helper into entry i.
+            void CopyState(unsigned i, DeadReckoningHelper& helper);
+
+            /// Sizes the output arrays to match the input.
+            void PrepareOutput();
+
+            /// Runs the extrapolation kernel on the entries from begin up to end.
+            void DeadReckon(unsigned begin, unsigned end);
+
+            /**
+             * Fills in mTransforms for the STEP_BATCH entries from begin up to end, dead reckoning the rotation
+             * and storing the result on the helpers of the entries flagged as changed.
+             * Only the helpers in the range are touched, so ranges may run in parallel.
+             */
+            void ApplyToHelpers(unsigned begin, unsigned end);
+
+            unsigned GetSize() const { return unsigned(mHelpers.size()); }
+
+            std::vector<DeadReckoningHelper*> mHelpers;
+            std::vector<GameActor*> mActors;
+
+            Vec3Array mLastTranslation;
+            Vec3Array mTransBeforeLastUpdate;
+            Vec3Array mCurrentTranslation;
+            Vec3Array mVelocity;
+            Vec3Array mVelocityBeforeLastUpdate;
+            /// zero for VELOCITY_ONLY
+            Vec3Array mAcceleration;
+            /// zero for VELOCITY_ONLY
+            Vec3Array mAngularVelocity;
+            std::vector<float> mElapsedTime;
+            std::vector<float> mEndSmoothingTime;
+            std::vector<unsigned char> mRotationResolved;
+            /// The Step of each entry on the current tick.
+            std::vector<unsigned char> mStep;
+            /// non-zero if the helper has changed since its state was last copied in.
+            std::vector<unsigned char> mStale;
+
+            /// Output of the kernel: the extrapolated translation.
+            Vec3Array mResult;
+            /// Output of the kernel: non-zero if the entity needed to be dead reckoned.
+            std::vector<unsigned char> mChanged;
+            /// Output of ApplyToHelpers or DoDR: the dead reckoned transform to clamp.
+            std::vector<dtCore::Transform> mTransforms;
+            /// The ground clamping type of each entry on the current tick.
+            std::vector<BaseGroundClamper::GroundClampingType*> mClampTypes;
+         };
+
+         /**
+          * Extrapolates the translation of every entity in the batch, filling in mResult and mChanged.
+          * This gives the same values as DoDR does for a helper that was not updated this tick.
+          */
+         static void DeadReckonBatch(DRBatch& batch);
+
       protected:
          virtual ~DeadReckoningComponent();
 
@@ -163,7 +375,8 @@ namespace dtGame
             const osg::Vec3& currLocation, const osg::Vec3& currentRate,
             float simTimeDelta, bool isPositional = false) const;
 
-         std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningHelper> > mRegisteredActors;
+         typedef dtUtil::HashMap<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningHelper>, dtCore::UniqueIdHash> HelperMap;
+         HelperMap mRegisteredActors;
          dtCore::RefPtr<dtGame::BaseGroundClamper> mGroundClamper;
          
          dtUtil::Log* mLogger;
@@ -172,6 +385,60 @@ namespace dtGame
 
          void TickRemote(const dtGame::TickMessage& tickMessage);
 
+      private:
+         class BatchTask;
+
+         /**
+          * Does the time bookkeeping for the STEP_PENDING entries from begin up to end and works out
+          * their steps, activating the ones the kernel will dead reckon.  Only the entries in the range
+          * are touched, so ranges may run in parallel.
+          */
+         void PrepareEntries(unsigned begin, unsigned end, const dtGame::TickMessage& tickMessage);
+
+         /// Calls DoDR for the STEP_DO_DR entries from begin up to end.  Ranges may run in parallel.
+         void DoDREntries(unsigned begin, unsigned end);
+
+         /// @return true if the helper may be dead reckoned by the batch kernel this tick.
+         bool IsBatchable(const DeadReckoningHelper& helper) const;
+
+         /// @return the update interval for the helper from the distance bands and the off screen interval.
+         unsigned GetUpdateInterval(const DeadReckoningHelper& helper) const;
+
+         /// Moves the actor along its velocity on a tick its full dead reckoning is skipped.
+         void MoveBetweenUpdates(DeadReckoningHelper& helper, GameActor& gameActor, float simTimeDelta);
+
+         /// Publishes the dead reckoning state of a local actor if its extrapolated transform has drifted too far.
+         void PublishIfOverError(DeadReckoningHelper& helper, GameActor& gameActor,
+                  const dtGame::TickMessage& tickMessage);
+
+         /// Ground clamps and moves the actor if needed, then does the articulations.
+         void FinishDR(DeadReckoningHelper& helper, GameActor& gameActor, dtCore::Transform& xform,
+                  BaseGroundClamper::GroundClampingType& groundClampingType, bool transformChanged,
+                  const dtGame::TickMessage& tickMessage);
+
+         DRBatch mBatch;
+         dtCore::RefPtr<dtUtil::WorkerPool> mWorkerPool;
+         bool mUseBatchDR;
+
+         /// Minimum distance squared and update interval, sorted by distance.
+         typedef std::vector<std::pair<float, unsigned> > DistanceBandList;
+         DistanceBandList mDistanceBands;
+         unsigned mOffScreenInterval;
+         float mOffScreenHalfAngle;
+         float mOffScreenCos;
+         /// Set up at the start of each tick from the eye point actor.
+         bool mUseUpdateIntervals;
+         osg::Vec3 mEyeForward;
+
+         bool mPublishOnDRError;
+         float mMaxTranslationError;
+         float mMaxRotationError;
+         /// cosine of half the max rotation error, compared with the quaternion dot product.
+         float mMaxRotationErrorCos;
+         float mPublishHeartbeat;
+         /// The helper properties sent when publishing on dead reckoning error.
+         std::vector<dtUtil::RefString> mDRPropertyNames;
+
    };
    
 }
@@ -30,6 +30,7 @@
 
 #include <dtCore/base.h>
 #include <dtCore/transform.h>
+#include <dtUtil/refstring.h>
 #include <dtGame/basegroundclamper.h>
 
 namespace dtDAL
@@ -69,6 +70,13 @@ namespace dtGame
          static const float DEFAULT_MAX_SMOOTHING_TIME_ROT;
          static const float DEFAULT_MAX_SMOOTHING_TIME_POS;
 
+         ///Names of the properties added by GetActorProperties that hold the state remote copies dead reckon from.
+         static const dtUtil::RefString PROPERTY_LAST_KNOWN_TRANSLATION;
+         static const dtUtil::RefString PROPERTY_LAST_KNOWN_ROTATION;
+         static const dtUtil::RefString PROPERTY_VELOCITY_VECTOR;
+         static const dtUtil::RefString PROPERTY_ACCELERATION_VECTOR;
+         static const dtUtil::RefString PROPERTY_ANGULAR_VELOCITY_VECTOR;
+
          class DT_GAME_EXPORT DeadReckoningDOF : public osg::Referenced
          {
             public:
@@ -148,6 +156,18 @@ namespace dtGame
          virtual bool DoDR(GameActor& gameActor, dtCore::Transform& xform,
                   dtUtil::Log* pLogger, BaseGroundClamper::GroundClampingType*& gcType);
 
+         /**
+          * Finishes a velocity dead reckoning step whose translation was extrapolated externally,
+          * i.e. by the batch kernel in the DeadReckoningComponent.  The rotation is dead reckoned as
+          * DoDR would and the translation is assigned to both the transform and the helper.
+          * @param xform the transform initialized to the current dead reckoned values.
+          * @param pos the extrapolated translation.
+          */
+         void ApplyBatchDeadReckoning(dtCore::Transform& xform, const osg::Vec3& pos);
+
+         /// @return the type of ground clamping DoDR selects for this helper.
+         BaseGroundClamper::GroundClampingType& GetGroundClampingType() const;
+
          /**
           * This is a utility function to make it easier to have a dead reckoned actor.  The actor
           * should then iterate through this vector and call AddActorProperty() with each element.
@@ -369,13 +389,24 @@ namespace dtGame
          float GetRotationElapsedTimeSinceUpdate() const { return mRotationElapsedTimeSinceUpdate; }
 
          void SetRotationResolved(bool resolved) { mRotationResolved=resolved; }
+         bool IsRotationResolved() const { return mRotationResolved; }
+
+         const osg::Vec3& GetTranslationBeforeLastUpdate() const { return mTransBeforeLastUpdate; }
+         const osg::Vec3& GetVelocityBeforeLastUpdate() const { return mVelocityBeforeLastUpdate; }
 
          /**
           * Computes the change in rotation based on the angular velocity. This is used by DeadReckonTheRotation().
           * @param deltaTime the time elapsed since the last measured attitude
           * @param result the resulting matrix.
           */
-         void ComputeRotationChangeWithAngularVelocity(double deltaTime, osg::Matrix& result);
+         void ComputeRotationChangeWithAngularVelocity(double deltaTime, osg::Matrix& result) const;
+
+         /**
+          * Computes the transform dead reckoning converges to once smoothing is done, that is, the last
+          * known values extrapolated by the time elapsed since the last update.
+          * @param xform filled with the extrapolated translation and rotation.
+          */
+         void GetExtrapolatedTransform(dtCore::Transform& xform) const;
 
          GroundClampingData& GetGroundClampingData() { return mGroundClampingData; }
          const GroundClampingData& GetGroundClampingData() const { return mGroundClampingData; }
@@ -481,6 +512,12 @@ namespace dtGame
          /// The update mode - whether to actually move the actor or to just calculate.
          UpdateMode* mUpdateMode;
 
+         /// Ticks left before the DeadReckoningComponent does a full update when it is using distance bands.
+         unsigned mTicksUntilDR;
+         /// The position of this helper in the DeadReckoningComponent batch arrays.
+         unsigned mBatchIndex;
+         friend class DeadReckoningComponent;
+
          bool mTranslationInitiated;
          bool mRotationInitiated;
          bool mUpdated;
@@ -25,9 +25,12 @@
 
 #include <dtGame/export.h>
 #include <dtGame/basegroundclamper.h>
+#include <dtGame/terrainheightcache.h>
 
 #include <dtCore/transform.h>
 #include <dtCore/batchisector.h>
+#include <dtCore/rayquerytree.h>
+#include <dtUtil/workerpool.h>
 
 #include <osg/Referenced>
 
@@ -145,6 +148,43 @@ namespace dtGame
           */
          unsigned GetClampBatchSize() const;
 
+         /**
+          * Sets the pool used to run the batched clamping queries.  With a pool set, queued clamps
+          * are held until FinishUp, then the intersection queries for each group of
+          * CLAMP_BATCH_SIZE are run in parallel, and the results are applied to the actors in
+          * order on the calling thread.  NULL, the default, runs a batch every time it fills up.
+          * The bounds of the terrain nodes are computed on the calling thread before the queries
+          * start, so the workers only read the terrain.  Nothing may change the terrain's scene
+          * graph while FinishUp runs the queries.
+          */
+         void SetWorkerPool(dtUtil::WorkerPool* pool) { mWorkerPool = pool; }
+         dtUtil::WorkerPool* GetWorkerPool() const { return mWorkerPool.get(); }
+
+         /// The number of clamps run in one batch intersection query.
+         static const unsigned CLAMP_BATCH_SIZE = 32;
+
+         /**
+          * Sets the cache of terrain heights to look single point and three point clamps up in before
+          * running an intersection query.  Lookups that miss fall back to the query and queue the
+          * missing heights, which are filled in by a batch query of their own when the clamp batch runs.
+          * Cached hits do not go through GetClosestHit, so only set this for terrain without overhangs,
+          * and call Clear on the cache if the terrain changes.  NULL, the default, always queries.
+          */
+         void SetHeightCache(TerrainHeightCache* cache) { mHeightCache = cache; }
+         TerrainHeightCache* GetHeightCache() const { return mHeightCache.get(); }
+
+         /**
+          * Sets whether to answer the clamping and height cache queries from a RayQueryTree built over the
+          * terrain actor's node instead of traversing the terrain for every batch.  The tree is built by the
+          * first query after this is set or the terrain actor changes, and is refit at most once between
+          * calls to FinishUp to any transforms in the terrain that moved.  The queries then always use the
+          * highest level of detail and ignore the eye point actor.  The triangles are only read when the
+          * tree is built, so call this again to rebuild it if the terrain's geometry changes.
+          * Defaults to false.
+          */
+         void SetUseRayQueryTree(bool useTree);
+         bool GetUseRayQueryTree() const { return mRayQueryTree.valid(); }
+
          /**
           * Calculates the bounding box for the given proxy, stores it in the data object, and populates the Vec3.
           * @param modelDimensions Capture the calculated box dimensions which is also set on data.
@@ -331,6 +371,29 @@ namespace dtGame
          dtCore::BatchIsector& GetGroundClampIsector();
 
       private:
+         class ClampQueryTask;
+
+         /// Adds a single point clamp to the batch, running the batch if it is full and there is no worker pool.
+         void QueueClamp(const dtCore::Transform& xform, dtDAL::TransformableActorProxy& proxy, GroundClampingData& data);
+
+         /// Runs the intersection query for the queued clamps from begin up to end.  This touches nothing but the isector.
+         bool RunClampQuery(dtCore::BatchIsector& isector, unsigned begin, unsigned end);
+
+         /// Moves the actors for the queued clamps from begin up to end using the hits in the isector.
+         void ApplyClampQuery(dtCore::BatchIsector& isector, unsigned begin, unsigned end);
+
+         /// Moves the given transform to the hit, orienting it to the normal if the data says to.
+         void ApplyClampHit(dtCore::Transform& xform, GroundClampingData& data,
+                  RuntimeData& runtimeData, const osg::Vec3& hit, osg::Vec3 normal);
+
+         /// Runs the intersection queries for the heights the height cache is missing.
+         void FillHeightCache();
+
+         /// Builds the ray query tree if the terrain changed, or refits it if it hasn't been since the last FinishUp.
+         void UpdateRayQueryTree();
+
+         /// @return true if the queries should use the highest level of detail rather than the eye point's.
+         bool GetUseHighestLevelOfDetail() const;
 
          typedef std::pair<dtDAL::TransformableActorProxy*, GroundClampingData*> ProxyAndData;
          typedef std::vector<std::pair<dtCore::Transform, ProxyAndData> > BatchVector;
@@ -339,6 +402,17 @@ namespace dtGame
 
          dtCore::RefPtr<dtCore::BatchIsector> mTripleIsector;
          dtCore::RefPtr<dtCore::BatchIsector> mIsector;
+
+         /// One isector per group of clamps run in parallel.
+         std::vector<dtCore::RefPtr<dtCore::BatchIsector> > mParallelIsectors;
+         dtCore::RefPtr<dtUtil::WorkerPool> mWorkerPool;
+
+         dtCore::RefPtr<TerrainHeightCache> mHeightCache;
+         std::vector<TerrainHeightCache::SampleRequest> mHeightSamples;
+
+         /// NULL unless the queries are answered from a tree.  It is given to all the isectors.
+         dtCore::RefPtr<dtCore::RayQueryTree> mRayQueryTree;
+         bool mRayQueryTreeRefit;
    };
 
 }
@@ -201,6 +201,9 @@ namespace dtGame
       static const std::string TICK_LOCAL_INVOKABLE;
       static const std::string TICK_REMOTE_INVOKABLE;
 
+      /// Passed as the phase to RegisterForTicks to have the GameManager pick one.
+      static const unsigned AUTO_TICK_PHASE = 0xFFFFFFFFU;
+
       /// Internal class to represent the ownership of an actor proxy
       class DT_GAME_EXPORT Ownership : public dtUtil::Enumeration
       {
@@ -334,6 +337,22 @@ namespace dtGame
        */
       virtual void NotifyPartialActorUpdate();
 
+      /**
+       * Sends an update with just the properties that have been set since the last update, then
+       * clears their dirty flags.  Sends nothing if no property is dirty.
+       * Note - This will do nothing if the actor is Remote.
+       * @see dtDAL::PropertyContainer#GetDirtyPropertyNames
+       */
+      virtual void NotifyDirtyActorUpdate();
+
+      /**
+       * Set this to have the game manager call NotifyDirtyActorUpdate once per tick, after the tick
+       * messages are processed, for each tick in which one of this actor's properties is set.
+       * It only applies to local actors that are in the game manager.  The default is false.
+       */
+      void SetPublishDirtyPropertiesOnTick(bool publish);
+      bool GetPublishDirtyPropertiesOnTick() const;
+
       /**
        * Override this and add whatever properties you want to go out when you call 
        * NotifyPartialActorUpdate(). Note - you should not use NotifyPartialActorUpdate() 
@@ -447,6 +466,18 @@ namespace dtGame
       void RegisterForMessages(const MessageType& type,
                const std::string& invokableName = PROCESS_MSG_INVOKABLE);
 
+      /**
+       * Registers to receive tick messages only every interval'th tick, with the delta times of the
+       * skipped ticks added into the message.  Use this for logic that doesn't need to run every frame.
+       * @param type MessageType::TICK_LOCAL or MessageType::TICK_REMOTE
+       * @param invokableName the invokable to call, usually TICK_LOCAL_INVOKABLE or TICK_REMOTE_INVOKABLE
+       * @param interval the number of ticks between invocations.
+       * @param phase the tick in the interval to be invoked on.  By default, the GameManager staggers the actors.
+       * @see dtGame::GameManager::RegisterForTicks
+       */
+      void RegisterForTicks(const MessageType& type, const std::string& invokableName,
+               unsigned interval, unsigned phase = AUTO_TICK_PHASE);
+
       /**
        * Registers to receive a specific type of message from the GM.  You will ONLY receive
        * messages about this other actor.  Use this when you want to track interactions with
@@ -564,6 +595,9 @@ namespace dtGame
        */
       void RemovePropertyFromLocalUpdateAcceptFilter(const dtUtil::RefString& propName);
 
+      /// Queues the dirty update with the game manager if publishing on tick is enabled.
+      virtual void OnPropertiesDirty();
+
    private:
 
       /**
@@ -606,8 +640,11 @@ namespace dtGame
       dtUtil::Log& mLogger;
       std::map<std::string, dtCore::RefPtr<Invokable> > mInvokables;
       std::multimap<const MessageType*, dtCore::RefPtr<Invokable> > mMessageHandlers;
+      /// Changes whenever an invokable is added or removed so the GameManager knows to look its invokables up again.
+      unsigned mInvokableRevision;
       std::set<dtUtil::RefString> mLocalUpdatePropertyAcceptList;
       bool mIsInGM;
+      bool mPublishDirtyPropertiesOnTick;
    };
 }
 
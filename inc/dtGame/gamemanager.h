@@ -37,7 +37,13 @@
 #include <dtCore/refptr.h>
 #include <dtCore/base.h>
 #include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
 
+#include <dtUtil/hashmap.h>
+
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+#include <cfloat>
 
 namespace dtUtil
 {
@@ -75,12 +81,15 @@ namespace dtGame
    class TickMessage;
    class GMStatistics;
    class GMImpl;
+   class TimerWheel;
 
    class DT_GAME_EXPORT GameManager : public dtCore::Base
    {
       DECLARE_MANAGEMENT_LAYER(GameManager)
 
       friend class GMStatistics;
+      friend class GMComponent;
+      friend class GameActorProxy;
 
       public:
          static const std::string CONFIG_STATISTICS_INTERVAL;
@@ -88,8 +97,12 @@ namespace dtGame
          static const std::string CONFIG_STATISTICS_OUTPUT_FILE;
 
          typedef std::vector<std::string> NameVector;
-         typedef std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> > GameActorMap;
-         typedef std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> > ActorMap;
+         typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy>, dtCore::UniqueIdHash > GameActorMap;
+         typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy>, dtCore::UniqueIdHash > ActorMap;
+
+         /// Identifies a timer set with SetTimer.  Handles are never reused.
+         typedef unsigned long long TimerHandle;
+         static const TimerHandle INVALID_TIMER_HANDLE = 0;
 
          class DT_GAME_EXPORT ComponentPriority : public dtUtil::Enumeration
          {
@@ -227,6 +240,21 @@ namespace dtGame
                proxy = dynamic_cast<T*>(baseProxy.get());
             }
 
+            /**
+             * Creates several actors from a prototype and adds them all to the game manager.  The
+             * prototype is looked up once, and all the actors are created before any are added, so
+             * if one can't be created, none are added.  They are then put in the GM and the scene
+             * together, before any of them enters the world.
+             * @param uniqueID the id of the prototype.
+             * @param count the number of actors to create.
+             * @param toFill the vector to fill with the new actors.  It is cleared first.
+             * @param isRemote true if the new actors are remote, see AddActor.
+             * @param publish true if the new actors should be published as they are added.
+             * @throws ExceptionEnum::INVALID_PARAMETER if there is no such prototype, or it is not a game actor.
+             */
+            void CreateActorsFromPrototype(const dtCore::UniqueId& uniqueID, unsigned count,
+                     std::vector<dtCore::RefPtr<GameActorProxy> >& toFill, bool isRemote = false, bool publish = false);
+
             /**
              * Wraps up several methods used to lookup and create actors from prototypes.
              * It attempts to create a new actor from a prototype by using the name.  Assumes only 1 match.
@@ -299,6 +327,22 @@ namespace dtGame
              */
             void SendMessage(const Message& message);
 
+            /**
+             * Thread safe version of SendNetworkMessage.  Any thread may call this without locking.
+             * The messages are moved onto the normal network message queue, in the order they were sent
+             * by each thread, at the start of the next PreFrame.
+             * @param The message to send
+             */
+            void SendNetworkMessageThreadSafe(const Message& message);
+
+            /**
+             * Thread safe version of SendMessage.  Any thread may call this without locking, so worker
+             * threads can hand results to the simulation directly.  The messages are moved onto the normal
+             * message queue, in the order they were sent by each thread, at the start of the next PreFrame.
+             * @param The message to process
+             */
+            void SendMessageThreadSafe(const Message& message);
+
             /**
              * Adds a component to the list of components the game mananger
              * will communicate with
@@ -386,12 +430,44 @@ namespace dtGame
             dtCore::RefPtr<dtGame::GameActorProxy> CreateRemoteGameActor(const dtDAL::ActorType& actorType);
 
             /**
-             * Creates an actor based on the actor type.
+             * Creates an actor based on the actor type.  If the type is pooled and the pool has an actor,
+             * that actor is returned with a new unique id instead, see SetActorPoolSize.
              * @param The actor type to create.
              * @throws dtDAL::ExceptionEnum::ObjectFactoryUnknownType
              */
             dtCore::RefPtr<dtDAL::ActorProxy> CreateActor(const dtDAL::ActorType& actorType);
 
+            /**
+             * Turns on pooling of game actors of a type.  When a deleted actor of the type is removed
+             * from the game manager, it is reset to the values of a new actor and kept in the pool
+             * instead of being destroyed.  CreateActor hands pooled actors back out before making new ones.
+             *
+             * Actors still referenced from outside the game manager when they are removed are not pooled.
+             * Pooled actors go through OnEnteredWorld and OnRemovedFromWorld more than once, and only
+             * their property values are reset, so only pool types whose state is all in their properties.
+             * Actors of types that are made with ActorComponents are never pooled, since their components
+             * are removed when they leave the world.
+             * The pools are emptied when the actors are deleted immediately or a map is closed.
+             * @param actorType the type to pool.
+             * @param maxPooled the most actors to keep in the pool.  0 turns pooling off for the type.
+             */
+            void SetActorPoolSize(const dtDAL::ActorType& actorType, unsigned maxPooled);
+
+            /// @return the most actors of a type kept in the pool, or 0 if the type isn't pooled.
+            unsigned GetActorPoolSize(const dtDAL::ActorType& actorType) const;
+
+            /// @return the number of actors of a type in the pool now.
+            unsigned GetNumPooledActors(const dtDAL::ActorType& actorType) const;
+
+            /// Destroys the pooled actors of all types.  The pool sizes are kept.
+            void ClearActorPools();
+
+            /// @return the number of times CreateActor found an actor in a pool.
+            unsigned GetNumActorPoolHits() const;
+
+            /// @return the number of times CreateActor had to create an actor of a pooled type because its pool was empty.
+            unsigned GetNumActorPoolMisses() const;
+
             /**
              * Creates an actor based on the actor type and store it in a ref pointer.
              * This method is templated so that the caller can create a ref pointer to the actual type of the proxy,
@@ -644,11 +720,58 @@ namespace dtGame
 
             /**
              * Fills a vector with the game proxys whose position is within the radius parameter
+             * of the origin.
              * @param radius The radius to search in
              * @param toFill The vector to fill
+             * @see #FindActorsWithinRadius(const osg::Vec3&, float, std::vector<dtDAL::ActorProxy*>&, const dtDAL::ActorType*)
              */
             void FindActorsWithinRadius(const float radius, std::vector<dtDAL::ActorProxy*>& toFill) const;
 
+            /**
+             * Fills a vector with the actors whose position is within a sphere.  Only actors with
+             * transformable drawables are considered.  This uses a spatial index rather than
+             * visiting every actor.  Positions are sampled once per frame, on the first spatial query.
+             * @param position The center of the sphere
+             * @param radius The radius to search in
+             * @param toFill The vector to fill.  It will be cleared before searching.
+             * @param type If not NULL, only actors of this type or a subtype are returned.
+             */
+            void FindActorsWithinRadius(const osg::Vec3& position, float radius,
+                     std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL) const;
+
+            /**
+             * Fills a vector with the actors whose position is inside an axis aligned box.
+             * @see #FindActorsWithinRadius(const osg::Vec3&, float, std::vector<dtDAL::ActorProxy*>&, const dtDAL::ActorType*)
+             * @param box The box to search in
+             * @param toFill The vector to fill.  It will be cleared before searching.
+             * @param type If not NULL, only actors of this type or a subtype are returned.
+             */
+            void FindActorsWithinBox(const osg::BoundingBox& box,
+                     std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL) const;
+
+            /**
+             * Fills a vector with the actors closest to a position, sorted nearest first.
+             * @see #FindActorsWithinRadius(const osg::Vec3&, float, std::vector<dtDAL::ActorProxy*>&, const dtDAL::ActorType*)
+             * @param position The position to search from
+             * @param count The maximum number of actors to return
+             * @param toFill The vector to fill.  It will be cleared before searching.
+             * @param type If not NULL, only actors of this type or a subtype are returned.
+             * @param maxRadius Actors farther away than this are never returned.
+             */
+            void FindNearestActors(const osg::Vec3& position, unsigned count,
+                     std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type = NULL,
+                     float maxRadius = FLT_MAX) const;
+
+            /**
+             * Sets the size of the cells in the spatial index used by the proximity queries.
+             * The best value is around the radius of the most common query.  The default is 100 meters.
+             * @param cellSize The edge length of a cell.  Must be > 0.
+             */
+            void SetSpatialIndexCellSize(float cellSize);
+
+            /// @return the size of the cells in the spatial index used by the proximity queries.
+            float GetSpatialIndexCellSize() const;
+
             /**
              * Returns the game actor proxy whose is matches the parameter
              * @param id The id of the proxy to find
@@ -723,6 +846,7 @@ namespace dtGame
              * If a map or maps is currently open, it will send INFO_MAP_UNLOAD_BEGIN.
              * Once that map or map set is closed, it will set INFO_MAP_UNLOADED
              * Right before it begins loading maps, it sends INFO_MAP_LOAD_BEGIN
+             * If adding the actors takes more than one frame, it sends INFO_MAP_LOAD_PROGRESS each frame until it is done.
              * When that finishes, it will send INFO_MAP_LOADED.
              * At the very end it sends INFO_MAP_CHANGED.
              *
@@ -742,6 +866,24 @@ namespace dtGame
              */
             void ChangeMapSet(const NameVector& mapNames, bool addBillboards = false);
 
+            /**
+             * Sets whether the XML of the maps passed to ChangeMapSet is read on a background thread.
+             * The maps are built, and their actors created and added to the GM, on the main thread
+             * within the map load frame budget.  This defaults to false, which parses the maps on the
+             * main thread in a single frame.
+             * @see dtDAL::MapXMLEvents
+             */
+            void SetLoadMapsInBackground(bool background);
+            bool GetLoadMapsInBackground() const;
+
+            /**
+             * Sets the most time, in milliseconds, to spend adding the actors of new maps to the GM each
+             * frame of a map change, and building maps read in the background.  The rest of the work is
+             * done in later frames.  This defaults to 0, which adds all the actors in one frame.
+             */
+            void SetMapLoadFrameBudget(float milliseconds);
+            float GetMapLoadFrameBudget() const;
+
             /**
              * Closes the open maps, if any, being used by the Game Manager.  All actors will be deleted whether maps are closed or not.
              *
@@ -760,8 +902,9 @@ namespace dtGame
              * @param time The time of the timer in seconds.
              * @param repeat True to repeat the timer, false if once only
              * @param realTime True if this time should use real time, or false if it should use simulation time.
+             * @return a handle that can be passed to ClearTimer to remove just this timer.
              */
-            void SetTimer(const std::string& name, const GameActorProxy* aboutActor, float time,
+            TimerHandle SetTimer(const std::string& name, const GameActorProxy* aboutActor, float time,
                      bool repeat = false, bool realTime = false);
 
             /**
@@ -772,6 +915,20 @@ namespace dtGame
              */
             void ClearTimer(const std::string& name, const GameActorProxy* proxy);
 
+            /**
+             * Removes the timer returned by SetTimer.  This is constant time, so it is the better choice
+             * when there are many timers with the same name.
+             * @param handle the handle returned when the timer was set.
+             * @return true if the timer was still set and was removed.
+             */
+            bool ClearTimer(TimerHandle handle);
+
+            /**
+             * @return true if the timer returned by SetTimer has not expired or been cleared.  Repeating
+             *    timers stay set until they are cleared.
+             */
+            bool IsTimerSet(TimerHandle handle) const;
+
             /**
              * Accessor to the scene member of the class
              * @return The scene
@@ -974,6 +1131,19 @@ namespace dtGame
              */
             void UnregisterForMessages(const MessageType& type, GameActorProxy& proxy, const std::string& invokableName);
 
+            /**
+             * Registers an actor invokable for tick messages like RegisterForMessages, but only invokes it on
+             * every interval'th tick.  The tick message it gets has the delta times of all the ticks since
+             * it was last invoked added together.  Unregister it with UnregisterForMessages.
+             * @param type MessageType::TICK_LOCAL or MessageType::TICK_REMOTE.
+             * @param interval the number of ticks between invocations.  0 and 1 mean every tick.
+             * @param phase which of the ticks in the interval the invokable is called on.  GameActorProxy::AUTO_TICK_PHASE
+             *    spreads the listeners with the same interval across the ticks, so they don't all run on the same frame.
+             * @throws ExceptionEnum::INVALID_PARAMETER if the type isn't a tick message type.
+             */
+            void RegisterForTicks(const MessageType& type, GameActorProxy& proxy, const std::string& invokableName,
+                     unsigned interval, unsigned phase = GameActorProxy::AUTO_TICK_PHASE);
+
             /**
              * @param type
              * @param targetActorId
@@ -1054,24 +1224,6 @@ namespace dtGame
 
          protected:
 
-            struct TimerInfo
-            {
-               std::string name;
-               dtCore::UniqueId aboutActor;
-               dtCore::Timer_t time;
-               bool repeat;
-               dtCore::Timer_t interval;
-
-               bool operator < (const TimerInfo& rhs) const
-               {
-                  if (time == rhs.time)
-                  {
-                     return this <& rhs;
-                  }
-                  return time < rhs.time;
-               }
-            };
-
             dtUtil::Log* mLogger;
 
             /**
@@ -1102,6 +1254,8 @@ namespace dtGame
             void PopulateTickMessage(TickMessage& tickMessage,
                      double deltaSimTime, double deltaRealTime, double simulationTime);
 
+            /// Moves the messages sent from other threads onto the main thread queues.
+            void DrainThreadSafeMessageQueues();
             /// Sends network messages to components until the queue is empty.
             void DoSendNetworkMessages();
             /// Sends messages until the queue is empty.
@@ -1110,27 +1264,78 @@ namespace dtGame
             void DoSendMessage(const Message& message);
             /// Sends a single message just to components.
             void DoSendMessageToComponents(const Message& message);
+            /// Flags the per message type component lists to be rebuilt.  Called when components or their interests change.
+            void InvalidateComponentDispatch();
             void InvokeGlobalInvokables(const Message& message);
             void InvokeForActorInvokables(const Message& message, GameActorProxy& aboutActor);
             void InvokeOtherActorInvokables(const Message& message);
             void RemoveDeletedActors();
 
          private:
+            /// Queues an actor to have NotifyDirtyActorUpdate called after the tick messages.
+            void QueueDirtyActorUpdate(GameActorProxy& gameActorProxy);
+            /// Sends the updates for the queued actors.  @return true if any were sent.
+            bool SendDirtyActorUpdates();
+            /// @return an actor from the pool of its type, ready to be added, or NULL if there isn't one.
+            dtCore::RefPtr<GameActorProxy> TakePooledActor(const dtDAL::ActorType& actorType);
+            /// Resets a removed actor and puts it in the pool of its type.  @return false if it wasn't pooled.
+            bool ReturnActorToPool(GameActorProxy& gameActorProxy);
+            /// Clones a prototype and sets up the clone to be a game actor made from it.
+            dtCore::RefPtr<dtDAL::ActorProxy> CloneActorFromPrototype(dtDAL::ActorProxy& prototype);
+            /// Adds several new game actors, putting all of them in the GM and the scene before any enters the world.
+            void AddActors(const std::vector<dtCore::RefPtr<GameActorProxy> >& actors, bool isRemote, bool publish);
+            /// @throws dtUtil::Exception if AddActor would not accept the actor with these arguments.
+            void CheckActorCanBeAdded(const GameActorProxy& gameActorProxy, bool isRemote, bool publish) const;
+            /// Sends the create message for an actor just put in the GM and lets it enter the world.
+            void ActorEnteredGM(GameActorProxy& gameActorProxy, bool publish);
+
             GMImpl* mGMImpl; // Pimple pattern for private data
 
-            std::set<TimerInfo>& GetSimulationTimerList() { return mSimulationTimers; }
+            /**
+             * An actor invokable registered to receive a message type.  The invokable is looked up by name
+             * when it is registered, and again only after the actor adds or removes an invokable.
+             */
+            struct InvokableListener
+            {
+               /// NULL if the listener was unregistered while messages were being invoked.
+               dtCore::RefPtr<GameActorProxy> mProxy;
+               std::string mInvokableName;
+               Invokable* mInvokable;
+               /// The invokable revision of the proxy when mInvokable was looked up.
+               unsigned mInvokableRevision;
+               /// The number of ticks between invocations, for listeners registered with RegisterForTicks.
+               unsigned mTickInterval;
+               /// The number of ticks to skip before the next invocation.
+               unsigned mTicksToSkip;
+               /// The delta times of the skipped ticks.
+               float mSkippedSimTime;
+               float mSkippedRealTime;
+            };
+            typedef std::vector<InvokableListener> InvokableListenerList;
 
-            /// Does the work of ClearTimer for each of the timer info sets.
-            void ClearTimerSingleSet(std::set<TimerInfo>& timerSet,
-                     const std::string& name, const GameActorProxy* proxy);
+            /**
+             * Adds the time of a tick to a listener with a tick interval.
+             * @return the tick message with the summed delta times if the listener should be invoked this tick, or NULL.
+             */
+            const Message* GetIntervalTickMessage(const Message& tick, InvokableListener& listener);
+            /// Calls the invokable of each listener in a list with the message.
+            void InvokeListeners(const Message& message, InvokableListenerList& listeners, bool isGlobal);
+            /// @return the invokable of a listener, looking it up again if the invokables on the actor changed.
+            Invokable* GetListenerInvokable(InvokableListener& listener);
+            void AddInvokableListener(InvokableListenerList& listeners, GameActorProxy& proxy, const std::string& invokableName);
+            /// Removes a listener, or just clears it if the listeners are being invoked.
+            void RemoveInvokableListener(InvokableListenerList& listeners, unsigned index);
+            /// Removes the listeners that were cleared while messages were being invoked.
+            void CompactInvokableListeners();
+            void ClearInvokableListeners();
 
             /**
              * Private helper method to process the timers. This is called from PreFrame
-             * @param listToProcess The timer list to process
+             * @param timers The timers to process
              * @param clockTime The time to use
-             * @note The clock time should correspond to the list to be processed
+             * @note The clock time should correspond to the timers to be processed
              */
-            void ProcessTimers(std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime);
+            void ProcessTimers(TimerWheel& timers, dtCore::Timer_t clockTime);
 
             /**
              * Removes the proxy from the scene
@@ -1157,14 +1362,12 @@ namespace dtGame
             bool mSendCreatesAndDeletes;
             bool mAddActorsToScene;
 
-            std::set<TimerInfo> mSimulationTimers, mRealTimeTimers;
-
-            typedef std::pair<dtCore::RefPtr<GameActorProxy>, std::string> ProxyInvokablePair;
-            typedef std::multimap<const MessageType*, ProxyInvokablePair > GlobalMessageListenerMap;
+            typedef dtUtil::HashMap<const MessageType*, InvokableListenerList> GlobalMessageListenerMap;
             GlobalMessageListenerMap mGlobalMessageListeners;
 
-            typedef std::multimap<dtCore::UniqueId, ProxyInvokablePair > ProxyInvokableMap;
-            typedef std::map<const MessageType*,  ProxyInvokableMap> ActorMessageListenerMap;
+            /// The about actor listeners are indexed by message type, then by the id of the actor the messages are about.
+            typedef dtUtil::HashMap<dtCore::UniqueId, InvokableListenerList, dtCore::UniqueIdHash> AboutActorListenerMap;
+            typedef dtUtil::HashMap<const MessageType*, AboutActorListenerMap> ActorMessageListenerMap;
             ActorMessageListenerMap mActorMessageListeners;
 
             std::vector<dtCore::RefPtr<GMComponent> > mComponentList;
@@ -23,12 +23,15 @@
 #define DELTA_GMCOMPONENT
 
 #include <string>
+#include <set>
+#include <vector>
 #include <dtGame/gamemanager.h>
 #include <dtCore/base.h>
 
 namespace dtGame
 {
    class Message;
+   class MessageType;
 
    class DT_GAME_EXPORT GMComponent : public dtCore::Base
    {
@@ -77,6 +80,43 @@ namespace dtGame
           */
          const GameManager::ComponentPriority& GetComponentPriority() const;
 
+         /**
+          * Adds a message type this component wants passed to ProcessMessage.  Once a component
+          * has any message type interests, the GameManager only calls ProcessMessage for those
+          * types, which saves a virtual call per component for every message it would have ignored.
+          * A component with no interests gets every message, so existing components need not call this.
+          * Network messages are still dispatched to every component.
+          * @param type the message type to receive.
+          */
+         void AddMessageTypeInterest(const MessageType& type);
+
+         /**
+          * Removes a message type interest.  Note that removing the last interest makes the
+          * component receive every message again.
+          * @param type the message type to stop receiving.
+          */
+         void RemoveMessageTypeInterest(const MessageType& type);
+
+         /// Removes all message type interests so the component receives every message.
+         void ClearMessageTypeInterests();
+
+         /**
+          * @return true if the GameManager should call ProcessMessage with messages of the given type.
+          */
+         bool IsInterestedInMessageType(const MessageType& type) const;
+
+         /**
+          * @return true if this component has no message type interests and so receives every message.
+          */
+         bool IsInterestedInAllMessageTypes() const;
+
+         /**
+          * Fills a vector with the message types this component is interested in.
+          * @param toFill the vector to fill.  It is cleared first.  It will be empty if the component
+          *               is interested in every message type.
+          */
+         void GetMessageTypeInterests(std::vector<const MessageType*>& toFill) const;
+
          /**
           * Called immediately after a component is added to the GM. Override this
           * to do init type behavior that needs access to the GameManager.
@@ -93,6 +133,13 @@ namespace dtGame
           */
          virtual void OnRemovedFromGM();
 
+         /**
+          * @return the name this component is traced under.  It is interned when the component is
+          *         created and again when it is added to the GameManager, so it stays valid after a rename.
+          * @see dtUtil::Tracer
+          */
+         const char* GetTraceName() const { return mTraceName; }
+
       private:
          friend class GameManager;
          /**
@@ -106,8 +153,13 @@ namespace dtGame
           */
          void SetComponentPriority(const GameManager::ComponentPriority& newPriority);
 
+         /// Tells the GameManager to rebuild its dispatch lists.
+         void MessageTypeInterestsChanged();
+
          GameManager* mParent;
          const GameManager::ComponentPriority* mPriority;
+         std::set<const MessageType*> mMessageTypeInterests;
+         const char* mTraceName;
 
          // -----------------------------------------------------------------------
          //  Unimplemented constructors and operators
@@ -27,7 +27,7 @@
 #include <dtCore/refptr.h>
 #include <osg/Referenced>
 #include <string>
-#include <map>
+#include <dtUtil/hashmap.h>
 
 // this is purposely not exported, should only be used by the GM
 namespace dtGame
@@ -141,13 +141,18 @@ namespace dtGame
          dtCore::Timer_t      mStatsCumGMProcessTime;
          float                mStatsCurFrameActorTotal; 
          float                mStatsCurFrameCompTotal; 
+         unsigned             mStatsNumPoolHits;                                    ///< actors handed out from the actor pools.
+         unsigned             mStatsNumPoolMisses;                                  ///< actors of pooled types created because the pool was empty.
+         unsigned             mStatsNumActorsPooled;                                ///< deleted actors put back in a pool.
+         unsigned             mStatsNumPoolDiscards;                                ///< deleted actors of pooled types that were destroyed instead.
          int                  mStatisticsInterval;                                  ///< how often we print the information out.
          std::string          mFilePathToPrintDebugInformation;                     ///< where the file is located at that we print out to
          bool                 mPrintFileToConsole;                                  ///< if the information goes to console or file
          bool                 mDoStatsOnTheComponents;                              ///< do we fill in the information for the components.
          bool                 mDoStatsOnTheActors;                                  ///< Do we fill in information for the actors
 
-         std::map<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation> > mDebugLoggerInformation; ///< hold onto all the information.
+         typedef dtUtil::HashMap<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation>, dtCore::UniqueIdHash> DebugInfoMap;
+         DebugInfoMap mDebugLoggerInformation; ///< hold onto all the information.
          ////////////////////////////////////////////////
    };
 }
@@ -25,6 +25,7 @@
 #include <string>
 #include <osg/Referenced>
 #include <dtDAL/functor.h>
+#include <dtUtil/refstring.h>
 #include <dtGame/message.h>
 
 namespace dtGame
@@ -77,7 +78,10 @@ namespace dtGame
          /**
           * @return the name of this invokable.
           */
-         const std::string& GetName() const { return mName; }
+         const std::string& GetName() const { return mName.Get(); }
+
+         /// @return the interned name, which lives as long as the process, for tracing.
+         const char* GetTraceName() const { return mName.c_str(); }
 
          /**
           * Invoke this.
@@ -88,7 +92,7 @@ namespace dtGame
          ///refenceced classes should always have protected desctructor
          virtual ~Invokable();
       private:
-         std::string mName;
+         dtUtil::RefString mName;
 
          dtCore::RefPtr<InvokableFunctorCallerBase> mCaller;
 
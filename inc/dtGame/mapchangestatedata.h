@@ -27,17 +27,33 @@
 
 #include <dtUtil/enumeration.h>
 #include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+#include <dtCore/timer.h>
 #include <dtGame/export.h> 
 #include <dtGame/gamemanager.h>
 
+namespace dtDAL
+{
+   class ActorProxy;
+   class Map;
+   class MapParser;
+}
+
 namespace dtGame
 {
    class MessageType;
+   class MapParseThread;
    
    /**
     * A helper class for changing the map on the GM.  In the future, it would be nice
     * to allow swapping out this class on the GM so people could override/add to the process to 
     * do loading screens and such.
+    *
+    * The XML of the maps may be read on a background thread, and the maps built, and their
+    * actors added to the GM, over several frames on the main thread with a time budget per frame.
+    * While the maps are loading, an INFO_MAP_LOAD_PROGRESS message is sent every frame.  Only the
+    * XML reading is done on the background thread, because creating actors and proxies is not
+    * thread safe.
     * 
     * @see dtGame::GameManager::ChangeMapSet for more information on the process.
     */
@@ -68,6 +84,25 @@ namespace dtGame
          };
       
          MapChangeStateData(dtGame::GameManager& gm);
+
+         /**
+          * Sets whether the XML of the new maps is read on a background thread.  The maps are
+          * built, and their actors created and added to the GM, on the main thread within the frame budget.
+          * @see dtDAL::MapXMLEvents
+          */
+         void SetLoadInBackground(bool background) { mLoadInBackground = background; }
+         bool GetLoadInBackground() const { return mLoadInBackground; }
+
+         /**
+          * Sets the most time, in milliseconds, to spend adding actors to the GM each frame.  When
+          * loading in the background, building the maps, which creates the actors, uses the budget too.
+          * At least one actor is added each frame.  0 means add all the actors in one frame.
+          */
+         void SetFrameBudget(float milliseconds) { mFrameBudget = milliseconds; }
+         float GetFrameBudget() const { return mFrameBudget; }
+
+         /// @return how much of the current load is done, from 0 to 1.
+         float GetLoadProgress() const;
                   
          const NameVector& GetOldMapNames() const { return mOldMapNames; }
          const NameVector& GetNewMapNames() const { return mNewMapNames; }
@@ -88,12 +123,41 @@ namespace dtGame
 
       protected:
 
-         //Takes an open map name and loads all the actors into the GM
-         void LoadSingleMapIntoGM(const std::string& mapName);
+         virtual ~MapChangeStateData();
+
+         // Adds the events and environment of an open map to the GM, and queues up its actors to be added.
+         void BeginLoadingMapIntoGM(dtDAL::Map& map);
+
+         // Adds one actor from a map to the GM.
+         void AddActorToGM(dtDAL::ActorProxy& proxy);
 
          // Opens all of the new maps in the new map vector. Returns true if successful
          bool OpenNewMaps();
 
+         // Starts parsing the new maps on a background thread. Returns true if successful
+         bool StartParsingNewMaps();
+
+         // Goes back to idle and sends an empty map changed message.
+         void FailLoad();
+
+         // Returns true if the time since startTime is over the frame budget.
+         bool IsFrameBudgetUsed(const dtCore::Timer& timer, dtCore::Timer_t startTime) const;
+
+         /**
+          * Gets the next new map once it is open.  When loading in the background, this builds the
+          * map from its events until it's done or the frame budget is used.
+          * @return the map or NULL if it isn't read or built yet.
+          * @throws dtUtil::Exception if the map failed to load.
+          */
+         dtDAL::Map* GetNextNewMap(const dtCore::Timer& timer, dtCore::Timer_t startTime);
+
+         // Adds the actors of the new maps until they are all added or the frame budget is used.
+         // Returns false if there are more actors to add.
+         bool ContinueLoadingMaps();
+
+         // Stops the parsing thread and clears the load data.
+         void EndLoad();
+
          // Closes all of the old maps in the old map vector.
          void CloseOldMaps();
 
@@ -106,10 +170,21 @@ namespace dtGame
          const MapChangeState* mCurrentState;
          bool mAddBillboards;
 
+         bool mLoadInBackground;
+         float mFrameBudget;
+
+         MapParseThread* mParseThread;
+         /// Builds the next new map from the events read on the parse thread.
+         dtCore::RefPtr<dtDAL::MapParser> mMapParser;
+         /// The index of the next new map to add to the GM.
+         unsigned mNextMap;
+         std::vector<dtCore::RefPtr<dtDAL::ActorProxy> > mActorsToAdd;
+         unsigned mNextActor;
+
          //disable copy constructor and operator = 
          MapChangeStateData(const MapChangeStateData& toCopy) {}
          MapChangeStateData& operator = (const MapChangeStateData& toAssign) { return *this; }
-         void SendMapMessage(const MessageType& type, const NameVector& names);
+         void SendMapMessage(const MessageType& type, const NameVector& names, float progress = 0.0f);
    };
 }
 
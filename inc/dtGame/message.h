@@ -22,14 +22,16 @@
 #ifndef DELTA_MESSAGE
 #define DELTA_MESSAGE
 
-#include <map>
+#include <vector>
 #include <limits.h>
 #include <dtDAL/exceptionenum.h>
 #include <dtDAL/serializeable.h>
 #include <dtUtil/exception.h>
 #include <dtGame/export.h>
+#include <dtGame/exceptionenum.h>
 #include <dtGame/machineinfo.h>
 #include <dtGame/messageparameter.h>
+#include <dtGame/messageparameterschema.h>
 
 namespace dtUtil
 {
@@ -77,6 +79,72 @@ namespace dtGame
           */
          bool FromDataStream(dtUtil::DataStream& stream);
 
+         /// Returned by GetParameterIndex when there is no parameter with the given name.
+         static const unsigned INVALID_PARAMETER_INDEX;
+
+         /**
+          * @return the number of parameters on this message.
+          */
+         unsigned GetNumParameters() const { return unsigned(mParameterList.size()); }
+
+         /**
+          * Finds the slot of a parameter.  Parameters are stored in one flat array ordered by name,
+          * so every message of a given class has the same layout.  Code that reads the same parameter
+          * from many messages can look the index up once and use GetParameterByIndex after that.
+          * Messages from the message factory look the name up in the schema of their type.
+          * @return the index of the named parameter or INVALID_PARAMETER_INDEX if none exists.
+          * @param name The name of the message parameter to find.
+          */
+         unsigned GetParameterIndex(const std::string& name) const;
+
+         /**
+          * @return the compiled parameter layout shared by the messages of this type, or NULL if
+          *         this message was not created by the message factory or has had parameters added since.
+          */
+         const MessageParameterSchema* GetParameterSchema() const { return mParameterSchema.get(); }
+
+         /**
+          * Shares the given schema with this message.
+          * @return false, and clears the schema, if the parameters of this message don't match it.
+          */
+         bool SetParameterSchema(const MessageParameterSchema* schema);
+
+         /**
+          * @return the parameter at the given index.
+          * @param index the index of the parameter.  It must be less than GetNumParameters().
+          * @see GetParameterIndex
+          */
+         MessageParameter* GetParameterByIndex(unsigned index) { return mParameterList[index].get(); }
+
+         /**
+          * @return the parameter at the given index.
+          * @param index the index of the parameter.  It must be less than GetNumParameters().
+          * @see GetParameterIndex
+          */
+         const MessageParameter* GetParameterByIndex(unsigned index) const { return mParameterList[index].get(); }
+
+         /**
+          * @return the value of the parameter at the given index.
+          * @param index the index of the parameter.  It must be less than GetNumParameters().
+          * @throws ExceptionEnum::INVALID_PARAMETER if the parameter doesn't hold a ValueType.
+          */
+         template <typename ValueType>
+         const ValueType& GetParameterValue(unsigned index) const
+         {
+            return GetGenericParameter<ValueType>(index).GetValue();
+         }
+
+         /**
+          * Sets the value of the parameter at the given index.
+          * @param index the index of the parameter.  It must be less than GetNumParameters().
+          * @throws ExceptionEnum::INVALID_PARAMETER if the parameter doesn't hold a ValueType.
+          */
+         template <typename ValueType>
+         void SetParameterValue(unsigned index, const ValueType& value)
+         {
+            const_cast<dtDAL::NamedGenericParameter<ValueType>&>(GetGenericParameter<ValueType>(index)).SetValue(value);
+         }
+
          /**
           * Non-const version of getter to return a message parameter by name.
           * @return the parameter specified or NULL of non exists.
@@ -196,6 +264,20 @@ namespace dtGame
           */
          void SetMessageType(const MessageType& msgType) { mMessageType = &msgType; }
 
+         template <typename ValueType>
+         const dtDAL::NamedGenericParameter<ValueType>& GetGenericParameter(unsigned index) const
+         {
+            const dtDAL::NamedGenericParameter<ValueType>* param =
+               dynamic_cast<const dtDAL::NamedGenericParameter<ValueType>*>(mParameterList[index].get());
+            if (param == NULL)
+            {
+               throw dtUtil::Exception(dtGame::ExceptionEnum::INVALID_PARAMETER, "Message parameter "
+                  + mParameterList[index]->GetName().Get() + " does not hold the requested value type.",
+                  __FILE__, __LINE__);
+            }
+            return *param;
+         }
+
          Message(const Message& rhs) { }
          Message& operator=(const Message& rhs) { return *this; }
          
@@ -204,7 +286,9 @@ namespace dtGame
          dtCore::RefPtr<const MachineInfo> mDestination;
          dtCore::UniqueId mSendingActorId, mAboutActorId;
          
-         std::map<std::string,dtCore::RefPtr<MessageParameter> > mParameterList;
+         /// sorted by name, which is also the order they are streamed in.
+         std::vector<dtCore::RefPtr<MessageParameter> > mParameterList;
+         dtCore::RefPtr<const MessageParameterSchema> mParameterSchema;
          
          dtCore::RefPtr<const Message> mCausingMessage;
     };
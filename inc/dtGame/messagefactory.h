@@ -28,10 +28,12 @@
 #include <dtCore/refptr.h>
 #include <dtUtil/objectfactory.h>
 #include <dtUtil/enumeration.h>
+#include <dtUtil/hashmap.h>
 #include <dtGame/export.h>
 #include <dtGame/messagetype.h>
 #include <dtGame/message.h>
 #include <dtGame/machineinfo.h>
+#include <OpenThreads/Mutex>
 
 namespace dtGame
 {
@@ -53,6 +55,9 @@ namespace dtGame
                virtual ~MessageFactoryException() {}
          };
 
+         /// The pool size used for the engine message types that are pooled by default.
+         static const unsigned DEFAULT_MESSAGE_POOL_SIZE;
+
          /// Constructor
          MessageFactory(const std::string& name, const MachineInfo& machine, const std::string& desc = "");
 
@@ -147,9 +152,52 @@ namespace dtGame
           */
          dtCore::RefPtr<Message> CloneMessage(const Message& msg) const;
 
+         /**
+          * Enables recycling of messages of the given type.  The factory holds on to up to maxPooled
+          * messages of the type, and CreateMessage reuses one that nothing else references anymore
+          * instead of allocating a new message and all of its parameters.
+          *
+          * A reused message is reset by copying a newly created message of the same type onto it with
+          * CopyDataTo, so only pool types whose message class keeps all of its data in parameters,
+          * or copies the rest in CopyDataTo.  The tick, system, timer elapsed, and actor updated
+          * message types are pooled by default.
+          *
+          * @param type the message type to pool.
+          * @param maxPooled the maximum number of messages to hold.  0 disables pooling for the type.
+          * @throws dtUtil::Exception with enum MessageFactoryException::TYPE_NOT_REGISTERED if the type is not registered.
+          */
+         void SetMessagePoolSize(const MessageType& type, unsigned maxPooled);
+
+         /// @return the maximum number of pooled messages of the given type, 0 if it is not pooled.
+         unsigned GetMessagePoolSize(const MessageType& type) const;
+
+         /// @return how many messages of the given type were reused from the pool.
+         unsigned long GetMessagePoolHits(const MessageType& type) const;
+
+         /**
+          * @return how many messages of the given type had to be allocated because every pooled message
+          *         was still referenced.  Only pooled types count misses.
+          */
+         unsigned long GetMessagePoolMisses(const MessageType& type) const;
+
+         /// Sets the hit and miss counters of all the pools back to 0.
+         void ResetMessagePoolCounters();
+
+         /**
+          * @return the parameter schema of the given type, or NULL if no message of the type has been
+          *         created yet.  It is compiled from the first message of the type CreateMessage makes.
+          * @see MessageParameterSchema
+          */
+         const MessageParameterSchema* GetParameterSchema(const MessageType& type) const;
+
       private:
+         class MessagePool;
+
          void ThrowIdException(const MessageType& type) const;
 
+         /// Gives the message the schema of its type, compiling it from the message if needed.  Call with mPoolMutex locked.
+         void AttachParameterSchema(const MessageType& type, Message& msg) const;
+
          std::string mName, mDescription;
 
          dtCore::RefPtr<const MachineInfo> mMachine;
@@ -157,6 +205,15 @@ namespace dtGame
          dtCore::RefPtr<dtUtil::ObjectFactory<const MessageType*, Message> > mMessageFactory;
 
          std::map<unsigned short, const MessageType*> mIdMap;
+
+         typedef dtUtil::HashMap<const MessageType*, dtCore::RefPtr<MessagePool> > MessagePoolMap;
+         MessagePoolMap mMessagePools;
+
+         typedef dtUtil::HashMap<const MessageType*, dtCore::RefPtr<const MessageParameterSchema> > SchemaMap;
+         mutable SchemaMap mParameterSchemas;
+
+         // CreateMessage may be called from network threads.  This also guards the schemas.
+         mutable OpenThreads::Mutex mPoolMutex;
    };
 
    template <typename T>
@@ -0,0 +1,85 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005, BMH Associates, Inc.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+#ifndef DELTA_MESSAGEPARAMETERSCHEMA
+#define DELTA_MESSAGEPARAMETERSCHEMA
+
+#include <string>
+#include <vector>
+
+#include <dtGame/export.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/refstring.h>
+
+#include <osg/Referenced>
+
+namespace dtDAL
+{
+   class DataType;
+}
+
+namespace dtGame
+{
+   class Message;
+
+   /**
+    * The parameter layout shared by every message of one message type.  The message factory
+    * compiles it from the first message of a type it creates and gives it to every message of
+    * that type after that, so finding a parameter by name is one hash lookup on a table built
+    * once per type, rather than a search of each message.  Slot i of the schema is parameter i
+    * of the message, so an index found here can be used with Message::GetParameterByIndex and
+    * Message::GetParameterValue on any message of the type.
+    */
+   class DT_GAME_EXPORT MessageParameterSchema : public osg::Referenced
+   {
+      public:
+         /// Compiles the schema from the parameters the given message has now.
+         explicit MessageParameterSchema(const Message& layout);
+
+         unsigned GetNumParameters() const { return unsigned(mNames.size()); }
+
+         /// @return the slot of the named parameter, or Message::INVALID_PARAMETER_INDEX.
+         unsigned GetIndex(const std::string& name) const;
+
+         const dtUtil::RefString& GetName(unsigned index) const { return mNames[index]; }
+         const dtDAL::DataType& GetDataType(unsigned index) const { return *mDataTypes[index]; }
+
+         /// @return true if the message has exactly these parameters in these slots.
+         bool Matches(const Message& msg) const;
+
+      protected:
+         virtual ~MessageParameterSchema();
+
+      private:
+         struct StringHash
+         {
+            size_t operator()(const std::string& key) const;
+         };
+
+         std::vector<dtUtil::RefString> mNames;
+         std::vector<const dtDAL::DataType*> mDataTypes;
+
+         /// Keyed by the address of the interned name, which is what the engine's name constants pass.
+         dtUtil::HashMap<const std::string*, unsigned> mInternedIndices;
+         dtUtil::HashMap<std::string, unsigned, StringHash> mIndices;
+   };
+}
+
+#endif /*DELTA_MESSAGEPARAMETERSCHEMA*/
@@ -63,6 +63,8 @@ namespace dtGame
          static const MessageType INFO_MAP_UNLOAD_BEGIN;
          static const MessageType INFO_MAP_CHANGE_BEGIN;
          static const MessageType INFO_MAP_CHANGED;
+         ///Sent each frame while the actors of new maps are added over more than one frame.
+         static const MessageType INFO_MAP_LOAD_PROGRESS;
 
 
          ///Message sent when a player enters the world.  The Actor deleted message can be used when the player leaves.
@@ -0,0 +1,151 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2007, Alion Science and Technology, BMH Operation.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+#ifndef DELTA_TERRAINHEIGHTCACHE
+#define DELTA_TERRAINHEIGHTCACHE
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <dtGame/export.h>
+
+#include <osg/Referenced>
+#include <osg/Vec2>
+#include <osg/Vec3>
+
+namespace dtGame
+{
+   /**
+    * A grid of terrain heights, filled in lazily from ground clamping ray hits, that the
+    * DefaultGroundClamper looks heights up in before it falls back to an intersection query.
+    * Heights are sampled at the corners of square cells, and a lookup inside a cell whose
+    * four corners are known is a bilinear interpolation.  The grid is split into square tiles
+    * that are allocated on first use, and the least recently used tile is dropped when more
+    * than the max number of tiles are needed, so the memory used is bounded.
+    *
+    * Only one height is kept per sample, so this only suits terrain without overhangs.  Areas that
+    * change at runtime should be added as dynamic areas, which are never cached.
+    */
+   class DT_GAME_EXPORT TerrainHeightCache : public osg::Referenced
+   {
+      public:
+         /// A grid corner that needs a height, and the z to look for it around.
+         struct SampleRequest
+         {
+            int mX, mY;
+            osg::Vec3 mPoint;
+         };
+
+         /**
+          * @param cellSize the distance between height samples.
+          * @param tileCells the number of cells along each side of a tile.
+          * @param maxTiles the max number of tiles allocated at once.
+          */
+         TerrainHeightCache(float cellSize = 2.0f, unsigned tileCells = 64, unsigned maxTiles = 64);
+
+         float GetCellSize() const { return mCellSize; }
+         unsigned GetTileCells() const { return mTileCells; }
+
+         void SetMaxTiles(unsigned maxTiles);
+         unsigned GetMaxTiles() const { return mMaxTiles; }
+
+         /// @return the number of tiles currently allocated.
+         unsigned GetNumTiles() const { return unsigned(mTiles.size()); }
+
+         /// Sets the max number of samples queued by lookups that miss before they are filled.
+         void SetMaxPendingSamples(unsigned maxSamples) { mMaxPendingSamples = maxSamples; }
+         unsigned GetMaxPendingSamples() const { return mMaxPendingSamples; }
+
+         /**
+          * Looks up the height and normal at the x and y of the given point.  If any corner of the
+          * cell it is in is unknown, the missing corners are queued as sample requests and
+          * false is returned.  If any corner is known to have no terrain, false is returned without
+          * queuing it again.  Points in a dynamic area always miss and queue nothing.
+          * @param point the point to look up.  Its z is used as the z to sample missing corners around.
+          * @param outHit the point on the terrain, if found.
+          * @param outNormal the terrain normal, if found.
+          * @return true if the height was in the cache.
+          */
+         bool GetHeight(const osg::Vec3& point, osg::Vec3& outHit, osg::Vec3& outNormal);
+
+         /// Sets the height of the grid corner x, y.
+         void SetSampleHeight(int x, int y, float height);
+
+         /**
+          * Records that the query for the grid corner x, y hit nothing, so it is not requested again.
+          * The query only looks a limited distance above and below the requested point, so call
+          * Clear if actors move to heights where it could now hit.
+          */
+         void SetSampleMissed(int x, int y);
+
+         /// Moves the queued sample requests into the given vector, leaving the queue empty.
+         void TakePendingSamples(std::vector<SampleRequest>& outSamples);
+         unsigned GetNumPendingSamples() const { return unsigned(mPendingSamples.size()); }
+
+         /// Adds a rectangle of the x-y plane where the terrain may change, so it must always be queried.
+         void AddDynamicArea(const osg::Vec2& minXY, const osg::Vec2& maxXY);
+         void ClearDynamicAreas();
+         bool IsInDynamicArea(float x, float y) const;
+
+         /// Drops all of the tiles and pending samples, such as when the terrain is changed.
+         void Clear();
+
+      protected:
+         virtual ~TerrainHeightCache();
+
+      private:
+         /// The coordinates of a tile or of a grid corner.
+         typedef std::pair<int, int> GridKey;
+
+         struct Tile
+         {
+            std::vector<float> mHeights;
+            unsigned mLastUsed;
+         };
+
+         /// @return the tile holding the given corner, allocating it if needed.
+         Tile& GetTile(const GridKey& key);
+
+         /// @return the tile key for a corner, and the index of the corner within the tile.
+         GridKey GetTileKey(int x, int y, unsigned& outIndex) const;
+
+         /// @return the height of a corner, or NaN.  Missing corners are queued.
+         float GetSample(int x, int y, const osg::Vec3& point);
+
+         void DropOldestTile();
+
+         typedef std::map<GridKey, Tile> TileMap;
+         TileMap mTiles;
+
+         std::vector<SampleRequest> mPendingSamples;
+         std::set<GridKey> mPendingSet;
+
+         std::vector<std::pair<osg::Vec2, osg::Vec2> > mDynamicAreas;
+
+         float mCellSize;
+         unsigned mTileCells;
+         unsigned mMaxTiles;
+         unsigned mMaxPendingSamples;
+         unsigned mLookupCount;
+   };
+}
+
+#endif /*DELTA_TERRAINHEIGHTCACHE*/
@@ -0,0 +1,202 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_TIMER_WHEEL
+#define DELTA_TIMER_WHEEL
+
+#include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/hashmap.h>
+#include <string>
+#include <vector>
+
+// this is purposely not exported, should only be used by the GM
+namespace dtGame
+{
+   /**
+    * A hierarchical timing wheel for the GameManager timers.  Times are in microseconds, the same
+    * units as the GameManager clocks.
+    *
+    * Timers are hashed into a slot by their expiration tick, so adding and cancelling a timer
+    * are constant time no matter how many timers are pending.  The first level has one slot per
+    * tick and each higher level covers a whole revolution of the level below it.  As the current
+    * tick reaches a higher level slot, its timers are cascaded down into finer slots.
+    * Timers keep their exact expiration time, so the tick size only affects bucketing,
+    * never when a timer fires.
+    *
+    * Timers are identified by a handle.  Handles are never reused, so a stale handle is
+    * harmlessly ignored.  The top bit of a handle is always clear so the GameManager can use it to
+    * tell its real time and simulation time wheels apart.  Timers may also be found by name for the
+    * name based GameManager API.
+    */
+   class TimerWheel
+   {
+   public:
+      typedef unsigned long long Handle;
+      static const Handle INVALID_HANDLE = 0;
+
+      /// The length of one tick of the wheel, in microseconds.
+      static const dtCore::Timer_t TICK_LENGTH = 1000;
+
+      /// The data of a timer that expired during a call to Advance.
+      struct ExpiredTimer
+      {
+         Handle mHandle;
+         std::string mName;
+         dtCore::UniqueId mAboutActor;
+         /// The time the timer was set to expire.
+         dtCore::Timer_t mTime;
+      };
+
+      TimerWheel();
+      ~TimerWheel();
+
+      /**
+       * Adds a timer.
+       * @param name the name of the timer.
+       * @param aboutActor the actor the timer is about, or a null id.
+       * @param expireTime when the timer should expire.
+       * @param repeat true to re-add the timer each time it expires.
+       * @param interval the time added to the expire time each time a repeating timer expires.
+       * @return the handle of the new timer.
+       */
+      Handle Add(const std::string& name, const dtCore::UniqueId& aboutActor,
+               dtCore::Timer_t expireTime, bool repeat, dtCore::Timer_t interval);
+
+      /**
+       * Removes a timer.
+       * @return true if the timer was pending and was removed.
+       */
+      bool Remove(Handle handle);
+
+      /**
+       * Removes all the timers with the given name.
+       * @param aboutActor if not NULL, only timers about this actor are removed.
+       * @return the number of timers removed.
+       */
+      unsigned Remove(const std::string& name, const dtCore::UniqueId* aboutActor);
+
+      /// @return true if the handle refers to a pending timer.
+      bool IsPending(Handle handle) const;
+
+      /// Removes all the timers.
+      void Clear();
+
+      /// @return the number of pending timers.
+      unsigned GetNumTimers() const;
+
+      /**
+       * Moves the wheel up to the given time and fills a vector with the timers that expired,
+       * ordered by their expiration time.  Repeating timers are rescheduled with the same handle,
+       * and will not expire more than once per call.
+       * @param clockTime the current time.
+       * @param expired the vector to fill.  It is cleared first.
+       */
+      void Advance(dtCore::Timer_t clockTime, std::vector<ExpiredTimer>& expired);
+
+   private:
+      enum
+      {
+         SLOT_BITS = 8,
+         NUM_SLOTS = 1 << SLOT_BITS,
+         SLOT_MASK = NUM_SLOTS - 1,
+         NUM_LEVELS = 4
+      };
+
+      static const unsigned NIL = 0xFFFFFFFFU;
+
+      struct Node
+      {
+         std::string mName;
+         dtCore::UniqueId mAboutActor;
+         dtCore::Timer_t mTime;
+         dtCore::Timer_t mInterval;
+         bool mRepeat;
+         /// Bumped every time the node is freed so old handles don't match.
+         unsigned mGeneration;
+         /// The slot list the node is in, or NIL if it isn't linked.
+         unsigned mSlot;
+         unsigned mPrev;
+         /// The next node in the slot list, or in the free list.
+         unsigned mNext;
+         /// The position of the node in its name list.
+         unsigned mNamePosition;
+         bool mInUse;
+      };
+
+      struct StringHash
+      {
+         size_t operator()(const std::string& str) const
+         {
+            // FNV-1a
+            size_t hash = 2166136261U;
+            for (std::string::const_iterator i = str.begin(); i != str.end(); ++i)
+            {
+               hash = (hash ^ size_t((unsigned char)*i)) * 16777619U;
+            }
+            return hash;
+         }
+      };
+
+      typedef std::vector<unsigned> IndexList;
+      typedef dtUtil::HashMap<std::string, IndexList, StringHash> NameMap;
+
+      /// Orders node indices by expiration time.
+      struct ExpireTimeLess;
+
+      /// @return the node index of a handle, or NIL if the handle is not pending.
+      unsigned FindNode(Handle handle) const;
+      Handle MakeHandle(unsigned index) const;
+
+      unsigned AllocateNode();
+      void FreeNode(unsigned index);
+
+      /// Puts a node in the slot for its expiration time, relative to the current tick.
+      void Schedule(unsigned index);
+      void Link(unsigned index, unsigned slot);
+      void Unlink(unsigned index);
+
+      void AddToNameList(unsigned index);
+      void RemoveFromNameList(unsigned index);
+
+      /// Moves the timers in a higher level slot into finer slots.
+      void Cascade(unsigned level);
+      /// Moves every timer back into the wheel after the current tick jumps.
+      void Rebuild(dtCore::Timer_t tick);
+      /// Unlinks the timers in a first level slot that expire at or before the clock time.
+      void CollectExpired(unsigned slot, dtCore::Timer_t clockTime, bool all);
+
+      std::vector<Node> mNodes;
+      unsigned mFreeList;
+      unsigned mNumTimers;
+
+      unsigned mSlots[NUM_LEVELS * NUM_SLOTS];
+      /// All the timers expiring before the current tick have been collected.
+      dtCore::Timer_t mCurrentTick;
+
+      NameMap mNames;
+
+      /// The nodes collected by the current Advance call.
+      IndexList mCollected;
+   };
+}
+
+#endif // DELTA_TIMER_WHEEL
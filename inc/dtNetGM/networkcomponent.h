@@ -35,6 +35,7 @@
 #include <dtGame/gmcomponent.h>
 #include <dtUtil/enumeration.h>
 #include <OpenThreads/ReentrantMutex>
+#include <dtUtil/lockfreequeue.h>
 #include <deque>
 
 // Forward declaration
@@ -359,12 +360,12 @@ namespace dtNetGM
 
       // Mutex
       OpenThreads::Mutex mMutex;
-      // mutex for accessing the GameManager message queue
-      OpenThreads::Mutex mBufferMutex;
    private:
       typedef std::deque<dtCore::RefPtr<const dtGame::Message> > MessageBufferType;
-      // local buffer to store messages received from the network.
-      MessageBufferType mMessageBuffer;
+      // messages received on the network threads, taken by the main thread on TICK_LOCAL.
+      dtUtil::LockFreeQueue<dtCore::RefPtr<const dtGame::Message> > mReceivedMessages;
+      // messages OnBeforeSendMessage said to WAIT on.  Only used on the main thread.
+      MessageBufferType mWaitingMessages;
       bool mMapChangeInProcess;
    };
 }
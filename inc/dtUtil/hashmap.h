@@ -0,0 +1,96 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_HASHMAP
+#define DELTA_HASHMAP
+
+#include <cstddef>
+#include <functional>
+
+#ifdef __GNUG__
+#  include <ext/hash_map>
+#elif defined(_MSC_VER)
+#  include <hash_map>
+#else
+#  include <map>
+#endif
+
+namespace dtUtil
+{
+   /**
+    * Default hash functor for dtUtil::HashMap.  Integral keys hash to their own value.
+    * Specialize this, or pass a different functor to HashMap, for other key types.
+    */
+   template <typename Key>
+   struct HashFunction
+   {
+      size_t operator()(const Key& key) const { return size_t(key); }
+   };
+
+   /// Pointers are aligned, so the low bits carry no information.
+   template <typename T>
+   struct HashFunction<T*>
+   {
+      size_t operator()(const T* key) const { return reinterpret_cast<size_t>(key) >> 3; }
+   };
+
+#if !defined(__GNUG__) && defined(_MSC_VER)
+   /**
+    * Adapts a plain hash functor to the traits interface stdext::hash_map expects.
+    * The key type must support operator <.
+    */
+   template <typename Key, typename HashFcn>
+   class HashCompare
+   {
+   public:
+      enum
+      {
+         bucket_size = 4,
+         min_buckets = 8
+      };
+
+      size_t operator()(const Key& key) const { return mHash(key); }
+      bool operator()(const Key& lhs, const Key& rhs) const { return lhs < rhs; }
+
+   private:
+      HashFcn mHash;
+   };
+#endif
+
+   /**
+    * Cross-platform hash map.  This wraps the non-standard hash_map each compiler provides so
+    * that code doesn't have to repeat the platform checks.  Compilers without one fall back
+    * to std::map, so keys should also support operator <.
+    */
+   template <typename Key, typename T, typename HashFcn = HashFunction<Key> >
+   class HashMap : public
+#ifdef __GNUG__
+      __gnu_cxx::hash_map<Key, T, HashFcn>
+#elif defined(_MSC_VER)
+      stdext::hash_map<Key, T, HashCompare<Key, HashFcn> >
+#else
+      std::map<Key, T>
+#endif
+   {
+   };
+}
+
+#endif // DELTA_HASHMAP
@@ -0,0 +1,148 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_LOCKFREEQUEUE
+#define DELTA_LOCKFREEQUEUE
+
+#include <OpenThreads/Atomic>
+#include <cstddef>
+
+namespace dtUtil
+{
+   /**
+    * An unbounded multiple producer, single consumer queue.  Any number of threads may push onto it
+    * without locking, and one thread at a time takes everything queued with PopAll.  Both operations
+    * are a compare and swap on the head of a linked list, so producers never block each other or the consumer.
+    * This suits handing work from worker threads to the main thread once a frame.
+    *
+    * Items are copied into a node allocated by the pushing thread and freed by the consuming thread.
+    */
+   template <typename T>
+   class LockFreeQueue
+   {
+   public:
+      LockFreeQueue()
+         : mHead(NULL)
+      {
+      }
+
+      ~LockFreeQueue()
+      {
+         Node* node = DetachAll();
+         while (node != NULL)
+         {
+            Node* next = node->mNext;
+            delete node;
+            node = next;
+         }
+      }
+
+      /// Adds an item to the end of the queue.  This may be called from any thread.
+      void Push(const T& item)
+      {
+         Node* node = new Node(item);
+         void* head = NULL;
+         do
+         {
+            head = mHead.get();
+            node->mNext = static_cast<Node*>(head);
+         }
+         while (!mHead.assign(node, head));
+      }
+
+      /// @return true if the queue was empty at the time of the call.
+      bool IsEmpty() const
+      {
+         return mHead.get() == NULL;
+      }
+
+      /**
+       * Removes every queued item and appends them to a container in the order they were pushed.
+       * Only one thread may call this at a time.
+       * @param toFill any container with push_back.  It is not cleared first.
+       * @return the number of items appended.
+       */
+      template <typename Container>
+      unsigned PopAll(Container& toFill)
+      {
+         // The list is newest first, so reverse it to get the push order.
+         Node* node = DetachAll();
+         Node* oldest = NULL;
+         while (node != NULL)
+         {
+            Node* next = node->mNext;
+            node->mNext = oldest;
+            oldest = node;
+            node = next;
+         }
+
+         unsigned count = 0;
+         while (oldest != NULL)
+         {
+            toFill.push_back(oldest->mItem);
+            Node* next = oldest->mNext;
+            delete oldest;
+            oldest = next;
+            ++count;
+         }
+         return count;
+      }
+
+   private:
+      struct Node
+      {
+         Node(const T& item)
+            : mItem(item)
+            , mNext(NULL)
+         {
+         }
+
+         T mItem;
+         Node* mNext;
+      };
+
+      /// Atomically takes the whole list, newest first.
+      Node* DetachAll()
+      {
+         void* head = NULL;
+         do
+         {
+            head = mHead.get();
+            if (head == NULL)
+            {
+               return NULL;
+            }
+         }
+         while (!mHead.assign(NULL, head));
+         return static_cast<Node*>(head);
+      }
+
+      OpenThreads::AtomicPtr mHead;
+
+      // -----------------------------------------------------------------------
+      //  Unimplemented constructors and operators
+      // -----------------------------------------------------------------------
+      LockFreeQueue(const LockFreeQueue&);
+      LockFreeQueue& operator=(const LockFreeQueue&);
+   };
+}
+
+#endif // DELTA_LOCKFREEQUEUE
@@ -0,0 +1,157 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_TRACER
+#define DELTA_TRACER
+
+#include <dtUtil/export.h>
+#include <iosfwd>
+#include <string>
+
+namespace dtUtil
+{
+   /**
+    * Records timed sections of code so the work inside a frame can be viewed on a timeline.
+    *
+    * Tracing is always compiled in, but is off until it is enabled.  When it is off, a
+    * TraceScope costs one check of a flag.  Each thread records into its own fixed size ring buffer,
+    * so recording never allocates after the first event on a thread.  Each buffer has its own lock,
+    * which only the thread recording into it and a trace being written ever take, so it is almost
+    * never contended.  When a buffer is full, the oldest events are overwritten.
+    *
+    * Timestamps are in nanoseconds since the tracer was first used.  Events are tagged with the
+    * frame number set by BeginFrame, which dtCore::System calls at the start of every step, so a
+    * window of frames can be written out in the Chrome trace event format.  The files can be
+    * opened with chrome://tracing or Perfetto.
+    *
+    * Writing a trace copies the events out of each buffer under that buffer's lock, so it is safe
+    * while other threads are recording.  Names are not copied, so they must outlive the trace.
+    */
+   class DT_UTIL_EXPORT Tracer
+   {
+   public:
+      /// The default number of events each thread buffer holds.
+      static const unsigned DEFAULT_EVENTS_PER_THREAD = 65536;
+
+      typedef unsigned long long Nanoseconds;
+
+      /// @return true if events are being recorded.
+      static bool IsEnabled() { return mEnabled; }
+      static void SetEnabled(bool enabled);
+
+      /// @return the number of nanoseconds since the tracer was first used.
+      static Nanoseconds GetTime();
+
+      /**
+       * Records an event on the buffer of the calling thread.
+       * @param name the name of the event.  It is not copied, so it must outlive the trace.  Use
+       *    a string literal or an interned name.
+       * @param category the category of the event.  The same lifetime rules as name apply.
+       */
+      static void AddEvent(const char* name, const char* category, Nanoseconds startTime, Nanoseconds endTime);
+
+      /// @return a copy of the string that lives as long as the process, for event names that aren't literals.
+      static const char* InternName(const std::string& name);
+
+      /**
+       * Starts a new frame.  This also starts and finishes the captures requested with CaptureFrames.
+       * A finished capture is copied out of the buffers under their locks and then written from the copy.
+       */
+      static void BeginFrame();
+      static unsigned GetFrameNumber();
+
+      /**
+       * Enables tracing for the next numFrames frames, then writes them to a Chrome trace file.
+       * Tracing goes back to its previous state when the capture is done.
+       */
+      static void CaptureFrames(unsigned numFrames, const std::string& fileName);
+      /// @return true if a capture requested with CaptureFrames is still running.
+      static bool IsCapturing();
+
+      /**
+       * Writes the recorded events in the Chrome trace event JSON format.
+       * @param firstFrame the first frame to write.
+       * @param lastFrame the last frame to write.
+       */
+      static void WriteChromeTrace(std::ostream& stream, unsigned firstFrame = 0, unsigned lastFrame = ~0U);
+
+      /// Writes the recorded events in a window of frames to a file.  @return false if the file couldn't be opened.
+      static bool WriteChromeTrace(const std::string& fileName, unsigned firstFrame = 0, unsigned lastFrame = ~0U);
+
+      /// Throws away all the recorded events.
+      static void Clear();
+
+      /// Sets the capacity of the thread buffers.  The buffers are emptied when this changes.
+      static void SetEventsPerThread(unsigned numEvents);
+      static unsigned GetEventsPerThread();
+
+   private:
+      static bool mEnabled;
+   };
+
+   /**
+    * Records the time from its construction to its destruction as a trace event.  Use the
+    * DT_TRACE_SCOPE macro rather than declaring these directly.
+    */
+   class DT_UTIL_EXPORT TraceScope
+   {
+   public:
+      /// @param name the event name.  It is not copied, see Tracer::AddEvent.
+      TraceScope(const char* name, const char* category = "delta3d")
+         : mName(NULL)
+         , mCategory(category)
+         , mStartTime(0)
+      {
+         if (Tracer::IsEnabled())
+         {
+            mName = name;
+            mStartTime = Tracer::GetTime();
+         }
+      }
+
+      /// Interns the name when tracing is enabled, so it may be used with temporary strings.
+      TraceScope(const std::string& name, const char* category = "delta3d");
+
+      ~TraceScope()
+      {
+         if (mName != NULL)
+         {
+            Tracer::AddEvent(mName, mCategory, mStartTime, Tracer::GetTime());
+         }
+      }
+
+   private:
+      const char* mName;
+      const char* mCategory;
+      Tracer::Nanoseconds mStartTime;
+   };
+}
+
+#define DT_TRACE_CONCAT_IMPL(a, b) a ## b
+#define DT_TRACE_CONCAT(a, b) DT_TRACE_CONCAT_IMPL(a, b)
+
+/// Traces the rest of the enclosing scope.
+#define DT_TRACE_SCOPE(name) dtUtil::TraceScope DT_TRACE_CONCAT(dtTraceScope, __LINE__)(name)
+
+/// Traces the rest of the enclosing scope under a category.
+#define DT_TRACE_SCOPE_CATEGORY(name, category) dtUtil::TraceScope DT_TRACE_CONCAT(dtTraceScope, __LINE__)(name, category)
+
+#endif // DELTA_TRACER
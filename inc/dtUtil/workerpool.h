@@ -0,0 +1,108 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#ifndef DELTA_WORKERPOOL
+#define DELTA_WORKERPOOL
+
+#include <dtUtil/export.h>
+#include <osg/Referenced>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/Condition>
+#include <vector>
+
+namespace dtUtil
+{
+   /**
+    * A fixed set of threads for splitting one job into pieces and running them in parallel.
+    * Run hands out the pieces of a job to the worker threads and the calling thread, and returns
+    * once every piece is finished, so it can be dropped into a frame without changing what runs
+    * before or after it.
+    *
+    * The threads sleep between jobs.  Pieces are handed out one at a time, so make them big enough
+    * that taking one is cheap compared to running it.
+    */
+   class DT_UTIL_EXPORT WorkerPool : public osg::Referenced
+   {
+   public:
+      /// A job split into numbered pieces.
+      class DT_UTIL_EXPORT Task
+      {
+      public:
+         virtual ~Task() {}
+
+         /**
+          * Runs one piece of the job.  This is called from several threads at once, with a different
+          * index on each, so it must only change data that belongs to its piece.  It must not throw.
+          */
+         virtual void Run(unsigned index) = 0;
+      };
+
+      /**
+       * Starts the worker threads.
+       * @param numThreads the number of threads to start.  0 starts one fewer than the number of processors,
+       *    since the thread calling Run does work too.
+       */
+      explicit WorkerPool(unsigned numThreads = 0);
+
+      /// @return the number of worker threads, not counting the thread calling Run.
+      unsigned GetNumThreads() const { return unsigned(mThreads.size()); }
+
+      /**
+       * Calls task.Run with every index from 0 to count - 1, spread across the workers and the
+       * calling thread, and waits for them all to finish.  Only one thread may call this at a time.
+       */
+      void Run(Task& task, unsigned count);
+
+   protected:
+      /// Stops and joins the worker threads.
+      virtual ~WorkerPool();
+
+   private:
+      class WorkerThread;
+      friend class WorkerThread;
+
+      /// The loop of each worker thread.
+      void WorkerLoop();
+      /// Runs pieces of the current job until there are none left.  The mutex must be locked.
+      void RunPieces();
+
+      std::vector<WorkerThread*> mThreads;
+
+      OpenThreads::Mutex mMutex;
+      OpenThreads::Condition mJobReady;
+      OpenThreads::Condition mJobDone;
+
+      Task* mTask;
+      unsigned mCount;
+      unsigned mNext;
+      /// The number of pieces being run right now.
+      unsigned mRunning;
+      /// Bumped for every job so the workers can tell a new one was posted.
+      unsigned mJobNumber;
+      bool mQuit;
+
+      // not copyable
+      WorkerPool(const WorkerPool&);
+      WorkerPool& operator=(const WorkerPool&);
+   };
+}
+
+#endif // DELTA_WORKERPOOL
@@ -63,6 +63,16 @@ namespace dtCore
          return false;
       }
 
+      // The tree only stands in for the traversal if it was built from the node that would be traversed.
+      if (mRayQueryTree.valid() && useHighestLvlOfDetail)
+      {
+         const osg::Node* root = mQueryRoot.valid() ? mQueryRoot->GetOSGNode() : mScene->GetSceneNode();
+         if (root != NULL && mRayQueryTree->GetRoot() == root)
+         {
+            return UpdateFromTree();
+         }
+      }
+
       osgUtil::IntersectVisitor intersectVisitor;
 
       if(useHighestLvlOfDetail)
@@ -109,6 +119,31 @@ namespace dtCore
       return false;
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   bool BatchIsector::UpdateFromTree()
+   {
+      bool anyHits = false;
+      for(int i = 0 ; i < mFixedArraySize; ++i)
+      {
+         SingleISector& single = *mISectors[i];
+         if(!single.GetIsOn())
+         {
+            continue;
+         }
+
+         single.ResetSingleISector();
+         if(mRayQueryTree->Intersect(single.mLineSegment->start(), single.mLineSegment->end(), single.mHitList))
+         {
+            anyHits = true;
+            if(single.mCheckClosestDrawables)
+            {
+               single.mClosestDrawable = MapNodePathToDrawable(single.mHitList[0].getNodePath());
+            }
+         }
+      }
+      return anyHits;
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    dtCore::DeltaDrawable *BatchIsector::MapNodePathToDrawable(osg::NodePath &nodePath)
    {
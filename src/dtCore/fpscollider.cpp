@@ -23,6 +23,8 @@
 #include <dtUtil/mathdefines.h>
 #include <dtCore/fpscollider.h>
 #include <dtCore/scene.h>
+#include <dtCore/odecontroller.h>
+#include <dtCore/odespacewrap.h>
 #include <ode/collision.h>
 
 namespace dtCore
@@ -59,6 +61,10 @@ namespace dtCore
    {
       pScene->GetGravity(mGravity);
       mCollisionSpace = pScene->GetSpaceID();
+      if (pScene->GetPhysicsController() != NULL)
+      {
+         mSpaceWrapper = pScene->GetPhysicsController()->GetSpaceWrapper();
+      }
       mSpaceID = dSimpleSpaceCreate(0);
       SetDimensions(pHeight, pRadius, k, theta);
    }
@@ -278,7 +284,7 @@ namespace dtCore
       mNormals.clear();
       mNumTorsoContactPoints = 0;
 
-      dSpaceCollide2((dGeomID)mCollisionSpace, (dGeomID)mSpaceID, this, NearCallbackTorso);
+      CollideWithSpaces(NearCallbackTorso);
 
       return mNumTorsoContactPoints > 0;
    }
@@ -289,12 +295,26 @@ namespace dtCore
       mNumFeetContactPoints = 0;
       mStartCollideFeet = true;
 
-      dSpaceCollide2((dGeomID)mCollisionSpace, (dGeomID)mSpaceID, this, NearCallbackFeet);
+      CollideWithSpaces(NearCallbackFeet);
 
       mStartCollideFeet = false;
       return mNumFeetContactPoints > 0;
    }
 
+   void FPSCollider::CollideWithSpaces(dNearCallback* callback)
+   {
+      if (mSpaceWrapper.valid())
+      {
+         // The space IDs change if the space settings are changed, so they are not kept.
+         dSpaceCollide2((dGeomID)mSpaceWrapper->GetSpaceID(), (dGeomID)mSpaceID, this, callback);
+         dSpaceCollide2((dGeomID)mSpaceWrapper->GetStaticSpaceID(), (dGeomID)mSpaceID, this, callback);
+      }
+      else
+      {
+         dSpaceCollide2((dGeomID)mCollisionSpace, (dGeomID)mSpaceID, this, callback);
+      }
+   }
+
 
    void FPSCollider::HandleCollideTorso(dGeomID pFeet, dGeomID pObject)
    {
@@ -5,16 +5,89 @@
 #include <ode/collision.h>
 #include <ode/objects.h>
 #include <dtCore/transformable.h>
+#include <dtUtil/log.h>
+#include <osg/BoundingBox>
+#include <osg/Timer>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+   //////////////////////////////////////////////////////////////////////////
+   const char* GetSpaceTypeName(dtCore::ODESpaceWrap::SpaceType type)
+   {
+      switch (type)
+      {
+      case dtCore::ODESpaceWrap::SPACE_SIMPLE:
+         return "simple";
+      case dtCore::ODESpaceWrap::SPACE_QUADTREE:
+         return "quadtree";
+      case dtCore::ODESpaceWrap::SPACE_SWEEP_AND_PRUNE:
+         return "sweep and prune";
+      default:
+         return "hash";
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void GetGeoms(dSpaceID space, std::vector<dGeomID>& outGeoms)
+   {
+      outGeoms.clear();
+      int numGeoms = dSpaceGetNumGeoms(space);
+      outGeoms.reserve(numGeoms);
+      for (int i = 0; i < numGeoms; ++i)
+      {
+         outGeoms.push_back(dSpaceGetGeom(space, i));
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void MoveGeoms(const std::vector<dGeomID>& geoms, dSpaceID from, dSpaceID to)
+   {
+      for (unsigned i = 0; i < geoms.size(); ++i)
+      {
+         dSpaceRemove(from, geoms[i]);
+         dSpaceAdd(to, geoms[i]);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void CountPairsCallback(void* data, dGeomID, dGeomID)
+   {
+      ++*static_cast<unsigned*>(data);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   int Log2(float value, bool roundUp)
+   {
+      float exponent = std::log(value) / std::log(2.0f);
+      return int(roundUp ? std::ceil(exponent) : std::floor(exponent));
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+dtCore::ODESpaceWrap::SpaceSettings::SpaceSettings()
+   : mType(SPACE_HASH)
+   , mHashMinLevel(-3) // the ODE defaults
+   , mHashMaxLevel(10)
+   , mQuadTreeCenter(0.0f, 0.0f, 0.0f)
+   , mQuadTreeHalfExtents(1000.0f, 1000.0f, 1000.0f)
+   , mQuadTreeDepth(6)
+   , mSweepAndPruneAxes(dSAP_AXES_XYZ)
+{
+}
 
 //////////////////////////////////////////////////////////////////////////
 dtCore::ODESpaceWrap::ODESpaceWrap(ODEWorldWrap* worldWrapper)
    : mSpaceID(0)
+   , mStaticSpaceID(0)
    , mUserNearCallback(NULL)
    , mContactJointGroupID(0)
    , mWorldWrapper(worldWrapper)
 {
-   mSpaceID = dHashSpaceCreate(0);
-   dSpaceSetCleanup(mSpaceID, 0);
+   mSpaceID = CreateSpace(mSpaceSettings);
+   mStaticSpaceID = CreateSpace(mStaticSpaceSettings);
 
    mContactJointGroupID = dJointGroupCreate(0);
 }
@@ -23,9 +96,78 @@ dtCore::ODESpaceWrap::ODESpaceWrap(ODEWorldWrap* worldWrapper)
 dtCore::ODESpaceWrap::~ODESpaceWrap()
 {
    dSpaceDestroy(mSpaceID);
+   dSpaceDestroy(mStaticSpaceID);
    dJointGroupDestroy(mContactJointGroupID);
 }
 
+//////////////////////////////////////////////////////////////////////////
+dSpaceID dtCore::ODESpaceWrap::CreateSpace(const SpaceSettings& settings)
+{
+   dSpaceID space = 0;
+
+   switch (settings.mType)
+   {
+   case SPACE_SIMPLE:
+      space = dSimpleSpaceCreate(0);
+      break;
+   case SPACE_QUADTREE:
+      {
+         dVector3 center = { settings.mQuadTreeCenter.x(), settings.mQuadTreeCenter.y(), settings.mQuadTreeCenter.z(), 0 };
+         dVector3 extents = { settings.mQuadTreeHalfExtents.x(), settings.mQuadTreeHalfExtents.y(), settings.mQuadTreeHalfExtents.z(), 0 };
+         space = dQuadTreeSpaceCreate(0, center, extents, std::max(settings.mQuadTreeDepth, 1));
+      }
+      break;
+   case SPACE_SWEEP_AND_PRUNE:
+      space = dSweepAndPruneSpaceCreate(0, settings.mSweepAndPruneAxes);
+      break;
+   default:
+      space = dHashSpaceCreate(0);
+      dHashSpaceSetLevels(space, settings.mHashMinLevel, std::max(settings.mHashMinLevel, settings.mHashMaxLevel));
+      break;
+   }
+
+   dSpaceSetCleanup(space, 0);
+   return space;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::ReplaceSpace(dSpaceID& space, const SpaceSettings& settings)
+{
+   std::vector<dGeomID> geoms;
+   GetGeoms(space, geoms);
+
+   dSpaceID newSpace = CreateSpace(settings);
+   MoveGeoms(geoms, space, newSpace);
+   dSpaceDestroy(space);
+   space = newSpace;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::SetSpaceSettings(const SpaceSettings& settings)
+{
+   mSpaceSettings = settings;
+   ReplaceSpace(mSpaceID, mSpaceSettings);
+}
+
+//////////////////////////////////////////////////////////////////////////
+const dtCore::ODESpaceWrap::SpaceSettings& dtCore::ODESpaceWrap::GetSpaceSettings() const
+{
+   return mSpaceSettings;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::SetStaticSpaceSettings(const SpaceSettings& settings)
+{
+   mStaticSpaceSettings = settings;
+   ReplaceSpace(mStaticSpaceID, mStaticSpaceSettings);
+}
+
+//////////////////////////////////////////////////////////////////////////
+const dtCore::ODESpaceWrap::SpaceSettings& dtCore::ODESpaceWrap::GetStaticSpaceSettings() const
+{
+   return mStaticSpaceSettings;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void dtCore::ODESpaceWrap::RegisterCollidable(Transformable* collidable)
 {
@@ -41,19 +183,223 @@ void dtCore::ODESpaceWrap::UnRegisterCollidable(Transformable* collidable)
 {
    if (collidable == NULL) { return; }
 
-   dSpaceRemove(mSpaceID, collidable->GetGeomID());
+   dGeomID geom = collidable->GetGeomID();
+   dSpaceID space = dGeomGetSpace(geom);
+   if (space == mSpaceID || space == mStaticSpaceID)
+   {
+      dSpaceRemove(space, geom);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::SetCollidableStatic(Transformable& collidable, bool isStatic)
+{
+   dGeomID geom = collidable.GetGeomID();
+   dSpaceID from = isStatic ? mSpaceID : mStaticSpaceID;
+   if (dGeomGetSpace(geom) == from)
+   {
+      dSpaceRemove(from, geom);
+      dSpaceAdd(isStatic ? mStaticSpaceID : mSpaceID, geom);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool dtCore::ODESpaceWrap::IsCollidableStatic(const Transformable& collidable) const
+{
+   return dGeomGetSpace(collidable.GetGeomID()) == mStaticSpaceID;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void dtCore::ODESpaceWrap::Collide()
 {
+   void* data = this;
+   dNearCallback* callback = DefaultNearCallback;
    if (mUserNearCallback)
    {
-      dSpaceCollide(mSpaceID, mUserNearCallbackData, mUserNearCallback);
+      data = mUserNearCallbackData;
+      callback = mUserNearCallback;
    }
-   else
+
+   dSpaceCollide(mSpaceID, data, callback);
+
+   // Static geoms are only tested against the dynamic ones, never against each other.
+   if (dSpaceGetNumGeoms(mStaticSpaceID) > 0 && dSpaceGetNumGeoms(mSpaceID) > 0)
    {
-      dSpaceCollide(mSpaceID, this, DefaultNearCallback);
+      dSpaceCollide2((dGeomID)mSpaceID, (dGeomID)mStaticSpaceID, data, callback);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+dtCore::ODESpaceWrap::SpaceSettings dtCore::ODESpaceWrap::ComputeTunedSettings(SpaceType type, bool forStaticSpace) const
+{
+   SpaceSettings settings;
+   settings.mType = type;
+
+   dSpaceID space = forStaticSpace ? mStaticSpaceID : mSpaceID;
+   osg::BoundingBox bounds;
+   osg::BoundingBox centers;
+   std::vector<float> sizes;
+
+   int numGeoms = dSpaceGetNumGeoms(space);
+   for (int i = 0; i < numGeoms; ++i)
+   {
+      dReal aabb[6];
+      dGeomGetAABB(dSpaceGetGeom(space, i), aabb);
+
+      // Planes and other infinite geoms say nothing about where the rest are.
+      bool finite = true;
+      for (int j = 0; j < 6; ++j)
+      {
+         finite = finite && aabb[j] > -dInfinity && aabb[j] < dInfinity;
+      }
+
+      if (finite)
+      {
+         osg::Vec3 minPoint(aabb[0], aabb[2], aabb[4]);
+         osg::Vec3 maxPoint(aabb[1], aabb[3], aabb[5]);
+         osg::Vec3 size = maxPoint - minPoint;
+         bounds.expandBy(minPoint);
+         bounds.expandBy(maxPoint);
+         centers.expandBy((minPoint + maxPoint) * 0.5f);
+
+         float largest = std::max(size.x(), std::max(size.y(), size.z()));
+         if (largest > 0.0f)
+         {
+            sizes.push_back(largest);
+         }
+      }
+   }
+
+   if (sizes.empty())
+   {
+      return settings;
+   }
+
+   std::sort(sizes.begin(), sizes.end());
+   float typicalSize = sizes[sizes.size() / 2];
+
+   settings.mHashMinLevel = Log2(sizes.front(), false);
+   settings.mHashMaxLevel = std::max(settings.mHashMinLevel, Log2(sizes.back(), true));
+
+   osg::Vec3 halfExtents = (bounds._max - bounds._min) * 0.5f;
+   settings.mQuadTreeCenter = bounds.center();
+   settings.mQuadTreeHalfExtents.set(std::max(halfExtents.x(), 1.0f), std::max(halfExtents.y(), 1.0f),
+            std::max(halfExtents.z(), 1.0f));
+
+   // Each level halves the block size, so stop at the last level with blocks at least twice the typical geom.
+   float blockSize = 2.0f * std::max(settings.mQuadTreeHalfExtents.x(), settings.mQuadTreeHalfExtents.y());
+   settings.mQuadTreeDepth = 1;
+   while (settings.mQuadTreeDepth < MAX_TUNED_QUADTREE_DEPTH && blockSize / float(1 << (settings.mQuadTreeDepth + 1)) >= 2.0f * typicalSize)
+   {
+      ++settings.mQuadTreeDepth;
+   }
+
+   // Sort on the axis the geoms are most spread along first.  The axes are packed the same way as the dSAP_AXES values.
+   osg::Vec3 spread = centers._max - centers._min;
+   int axes[3] = { 0, 1, 2 };
+   for (int i = 0; i < 2; ++i)
+   {
+      for (int j = 0; j < 2 - i; ++j)
+      {
+         if (spread[axes[j]] < spread[axes[j + 1]])
+         {
+            std::swap(axes[j], axes[j + 1]);
+         }
+      }
+   }
+   settings.mSweepAndPruneAxes = axes[0] | (axes[1] << 2) | (axes[2] << 4);
+
+   return settings;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::RunSelfTest(SelfTestResults& outResults, unsigned numRuns)
+{
+   static const SpaceType types[] = { SPACE_SIMPLE, SPACE_HASH, SPACE_QUADTREE, SPACE_SWEEP_AND_PRUNE };
+
+   outResults.clear();
+   numRuns = std::max(numRuns, 1U);
+
+   for (int s = 0; s < 2; ++s)
+   {
+      bool staticSpace = s == 1;
+      dSpaceID space = staticSpace ? mStaticSpaceID : mSpaceID;
+      if (dSpaceGetNumGeoms(space) == 0)
+      {
+         continue;
+      }
+
+      std::vector<dGeomID> geoms;
+      GetGeoms(space, geoms);
+
+      for (unsigned t = 0; t < sizeof(types) / sizeof(types[0]); ++t)
+      {
+         SelfTestResult result;
+         result.mSettings = ComputeTunedSettings(types[t], staticSpace);
+         result.mStaticSpace = staticSpace;
+
+         dSpaceID testSpace = CreateSpace(result.mSettings);
+         MoveGeoms(geoms, space, testSpace);
+
+         // The first collide builds whatever the space caches, so it is not timed.
+         osg::Timer_t start = 0;
+         for (unsigned i = 0; i <= numRuns; ++i)
+         {
+            if (i == 1)
+            {
+               start = osg::Timer::instance()->tick();
+            }
+
+            result.mNumPairs = 0;
+            if (staticSpace)
+            {
+               dSpaceCollide2((dGeomID)mSpaceID, (dGeomID)testSpace, &result.mNumPairs, CountPairsCallback);
+            }
+            else
+            {
+               dSpaceCollide(testSpace, &result.mNumPairs, CountPairsCallback);
+            }
+         }
+         result.mMilliseconds = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick()) / double(numRuns);
+
+         MoveGeoms(geoms, testSpace, space);
+         dSpaceDestroy(testSpace);
+
+         std::ostringstream ss;
+         ss << "Broadphase self test, " << (staticSpace ? "static" : "dynamic") << " space, "
+            << geoms.size() << " geoms, " << GetSpaceTypeName(types[t]) << " space: "
+            << result.mNumPairs << " pairs, " << result.mMilliseconds << " ms per collide.";
+         LOG_ALWAYS(ss.str());
+
+         outResults.push_back(result);
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtCore::ODESpaceWrap::AutoTune(unsigned numRuns)
+{
+   SelfTestResults results;
+   RunSelfTest(results, numRuns);
+
+   const SelfTestResult* fastest[2] = { NULL, NULL };
+   for (unsigned i = 0; i < results.size(); ++i)
+   {
+      const SelfTestResult*& best = fastest[results[i].mStaticSpace ? 1 : 0];
+      if (best == NULL || results[i].mMilliseconds < best->mMilliseconds)
+      {
+         best = &results[i];
+      }
+   }
+
+   if (fastest[0] != NULL)
+   {
+      SetSpaceSettings(fastest[0]->mSettings);
+   }
+
+   if (fastest[1] != NULL)
+   {
+      SetStaticSpaceSettings(fastest[1]->mSettings);
    }
 }
 
@@ -180,6 +526,12 @@ dSpaceID dtCore::ODESpaceWrap::GetSpaceID() const
    return mSpaceID;
 }
 
+//////////////////////////////////////////////////////////////////////////
+dSpaceID dtCore::ODESpaceWrap::GetStaticSpaceID() const
+{
+   return mStaticSpaceID;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void dtCore::ODESpaceWrap::SetDefaultCollisionCBFunc(const CollisionCBFunc& func)
 {
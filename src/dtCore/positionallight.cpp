@@ -33,7 +33,7 @@ public:
       mPositionalLight->GetTransform( trans, Transformable::ABS_CS );
 
       osg::Matrix absMatrix;
-      Transformable::GetAbsoluteMatrix( mPositionalLight->GetMatrixNode(), absMatrix );
+      trans.Get( absMatrix );
 
       osg::Light* osgLight = mPositionalLight->GetLightSource()->getLight();
 
@@ -0,0 +1,535 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2004-2005 MOVES Institute
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+#include <prefix/dtcoreprefix-src.h>
+
+#include <dtCore/rayquerytree.h>
+
+#include <osg/Drawable>
+#include <osg/NodeVisitor>
+#include <osg/Transform>
+#include <osg/TriangleFunctor>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace dtCore
+{
+   /// Deep enough for a balanced tree over any number of items that fit in memory.
+   static const unsigned MAX_TREE_DEPTH = 64;
+
+   /// The parent of the root of the top tree.
+   static const unsigned NO_PARENT = ~0U;
+
+   /////////////////////////////////////////////////////////////////////////////
+   struct TriangleGatherer
+   {
+      std::vector<osg::Vec3>* mVertices;
+
+      void operator()(const osg::Vec3& v1, const osg::Vec3& v2, const osg::Vec3& v3, bool)
+      {
+         mVertices->push_back(v1);
+         mVertices->push_back(v2);
+         mVertices->push_back(v3);
+      }
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   struct CompareCenters
+   {
+      const std::vector<osg::BoundingBox>* mBounds;
+      int mAxis;
+
+      bool operator()(unsigned a, unsigned b) const
+      {
+         return (*mBounds)[a].center()[mAxis] < (*mBounds)[b].center()[mAxis];
+      }
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   // GEOMETRY COLLECTOR
+   /////////////////////////////////////////////////////////////////////////////
+   class RayQueryTree::GeometryCollector : public osg::NodeVisitor
+   {
+   public:
+      GeometryCollector(std::vector<Instance>& instances)
+         : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN)
+         , mInstances(instances)
+      {
+      }
+
+      virtual void apply(osg::Geode& geode)
+      {
+         for (unsigned i = 0; i < geode.getNumDrawables(); ++i)
+         {
+            osg::Drawable* drawable = geode.getDrawable(i);
+            if (drawable == NULL)
+            {
+               continue;
+            }
+
+            mInstances.push_back(Instance());
+            Instance& instance = mInstances.back();
+
+            osg::TriangleFunctor<TriangleGatherer> gatherer;
+            gatherer.mVertices = &instance.mVertices;
+            drawable->accept(gatherer);
+
+            if (instance.mVertices.empty())
+            {
+               mInstances.pop_back();
+               continue;
+            }
+
+            instance.mNodePath = getNodePath();
+            instance.mNodePathRefs.assign(instance.mNodePath.begin(), instance.mNodePath.end());
+            instance.mGeode = &geode;
+            instance.mDrawable = drawable;
+         }
+      }
+
+   private:
+      std::vector<Instance>& mInstances;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   // RAY QUERY TREE
+   /////////////////////////////////////////////////////////////////////////////
+   const unsigned RayQueryTree::LEAF_SIZE;
+
+   /////////////////////////////////////////////////////////////////////////////
+   RayQueryTree::RayQueryTree()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   RayQueryTree::~RayQueryTree()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::Build(osg::Node& root)
+   {
+      Clear();
+      mRoot = &root;
+
+      GeometryCollector collector(mInstances);
+      root.accept(collector);
+
+      std::vector<osg::BoundingBox> triangleBounds;
+      for (unsigned i = 0; i < mInstances.size(); ++i)
+      {
+         Instance& instance = mInstances[i];
+
+         unsigned numTriangles = unsigned(instance.mVertices.size() / 3);
+         triangleBounds.resize(numTriangles);
+         instance.mTriangles.resize(numTriangles);
+         for (unsigned t = 0; t < numTriangles; ++t)
+         {
+            osg::BoundingBox& bound = triangleBounds[t];
+            bound.init();
+            bound.expandBy(instance.mVertices[t * 3]);
+            bound.expandBy(instance.mVertices[t * 3 + 1]);
+            bound.expandBy(instance.mVertices[t * 3 + 2]);
+            instance.mTriangles[t] = t;
+         }
+
+         BuildTree(instance.mTree, instance.mTriangles, triangleBounds);
+         SetInstanceMatrix(instance, osg::computeLocalToWorld(instance.mNodePath));
+      }
+
+      FindMovingPaths();
+      BuildTopTree();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::Clear()
+   {
+      mRoot = NULL;
+      mInstances.clear();
+      mMovingPaths.clear();
+      mInstanceOrder.clear();
+      mTopTree.clear();
+      mTopTreeParents.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RayQueryTree::Update()
+   {
+      // Drawables with no transform above them can't move, so only the paths with one are checked.
+      bool changed = false;
+      for (unsigned i = 0; i < mMovingPaths.size(); ++i)
+      {
+         MovingPath& path = mMovingPaths[i];
+         osg::Matrix matrix = osg::computeLocalToWorld(path.mNodePath);
+         if (matrix == path.mMatrix)
+         {
+            continue;
+         }
+
+         path.mMatrix = matrix;
+         for (unsigned j = 0; j < path.mInstances.size(); ++j)
+         {
+            Instance& instance = mInstances[path.mInstances[j]];
+            SetInstanceMatrix(instance, matrix);
+            RefitTopTree(instance.mTopLeaf);
+         }
+         changed = true;
+      }
+      return changed;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RayQueryTree::GetNumTriangles() const
+   {
+      unsigned count = 0;
+      for (unsigned i = 0; i < mInstances.size(); ++i)
+      {
+         count += unsigned(mInstances[i].mTriangles.size());
+      }
+      return count;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const osg::BoundingBox& RayQueryTree::GetBound() const
+   {
+      static const osg::BoundingBox emptyBound;
+      return mTopTree.empty() ? emptyBound : mTopTree[0].mBound;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::SetInstanceMatrix(Instance& instance, const osg::Matrix& matrix)
+   {
+      instance.mMatrix = matrix;
+      instance.mInverse.invert(instance.mMatrix);
+
+      const osg::BoundingBox& localBound = instance.mTree[0].mBound;
+      instance.mWorldBound.init();
+      for (unsigned i = 0; i < 8; ++i)
+      {
+         instance.mWorldBound.expandBy(localBound.corner(i) * instance.mMatrix);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::BuildTopTree()
+   {
+      std::vector<osg::BoundingBox> instanceBounds(mInstances.size());
+      mInstanceOrder.resize(mInstances.size());
+      for (unsigned i = 0; i < mInstances.size(); ++i)
+      {
+         instanceBounds[i] = mInstances[i].mWorldBound;
+         mInstanceOrder[i] = i;
+      }
+
+      BuildTree(mTopTree, mInstanceOrder, instanceBounds);
+
+      // Remember how to get from each drawable back up to the root so a move only refits its own branch.
+      mTopTreeParents.assign(mTopTree.size(), NO_PARENT);
+      for (unsigned n = 0; n < mTopTree.size(); ++n)
+      {
+         const TreeNode& node = mTopTree[n];
+         if (node.mCount == 0)
+         {
+            mTopTreeParents[node.mFirst] = n;
+            mTopTreeParents[node.mFirst + 1] = n;
+         }
+         else
+         {
+            for (unsigned i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+            {
+               mInstances[mInstanceOrder[i]].mTopLeaf = n;
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::FindMovingPaths()
+   {
+      for (unsigned i = 0; i < mInstances.size(); ++i)
+      {
+         const Instance& instance = mInstances[i];
+
+         bool hasTransform = false;
+         for (unsigned n = 0; n < instance.mNodePath.size() && !hasTransform; ++n)
+         {
+            hasTransform = instance.mNodePath[n]->asTransform() != NULL;
+         }
+
+         if (!hasTransform)
+         {
+            continue;
+         }
+
+         // The drawables of a geode are collected one after the other, so they share the last path.
+         if (mMovingPaths.empty() || mMovingPaths.back().mNodePath != instance.mNodePath)
+         {
+            mMovingPaths.push_back(MovingPath());
+            mMovingPaths.back().mNodePath = instance.mNodePath;
+            mMovingPaths.back().mMatrix = instance.mMatrix;
+         }
+         mMovingPaths.back().mInstances.push_back(i);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::RefitTopTree(unsigned leaf)
+   {
+      for (unsigned n = leaf; n != NO_PARENT; n = mTopTreeParents[n])
+      {
+         TreeNode& node = mTopTree[n];
+
+         osg::BoundingBox bound;
+         if (node.mCount > 0)
+         {
+            for (unsigned i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+            {
+               bound.expandBy(mInstances[mInstanceOrder[i]].mWorldBound);
+            }
+         }
+         else
+         {
+            bound.expandBy(mTopTree[node.mFirst].mBound);
+            bound.expandBy(mTopTree[node.mFirst + 1].mBound);
+         }
+
+         if (bound._min == node.mBound._min && bound._max == node.mBound._max)
+         {
+            break;
+         }
+         node.mBound = bound;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::BuildTree(std::vector<TreeNode>& tree, std::vector<unsigned>& items,
+            const std::vector<osg::BoundingBox>& itemBounds)
+   {
+      tree.clear();
+      if (items.empty())
+      {
+         return;
+      }
+
+      tree.reserve(2 * (items.size() / LEAF_SIZE + 1));
+
+      TreeNode root;
+      root.mFirst = 0;
+      root.mCount = unsigned(items.size());
+      tree.push_back(root);
+
+      // Each node starts out holding its items as if it were a leaf, and is split if it has too many.
+      // The nodes are split in the order they are added, so a node's index never changes.
+      for (unsigned n = 0; n < tree.size(); ++n)
+      {
+         unsigned first = tree[n].mFirst;
+         unsigned count = tree[n].mCount;
+
+         osg::BoundingBox bound;
+         osg::BoundingBox centers;
+         for (unsigned i = first; i < first + count; ++i)
+         {
+            bound.expandBy(itemBounds[items[i]]);
+            centers.expandBy(itemBounds[items[i]].center());
+         }
+         tree[n].mBound = bound;
+
+         if (count <= LEAF_SIZE)
+         {
+            continue;
+         }
+
+         // Split at the median along the axis the centers are spread the furthest.
+         osg::Vec3 extent = centers._max - centers._min;
+         CompareCenters compare;
+         compare.mBounds = &itemBounds;
+         compare.mAxis = extent.x() > extent.y() ? (extent.x() > extent.z() ? 0 : 2) : (extent.y() > extent.z() ? 1 : 2);
+
+         unsigned half = count / 2;
+         std::nth_element(items.begin() + first, items.begin() + first + half, items.begin() + first + count, compare);
+
+         TreeNode left, right;
+         left.mFirst = first;
+         left.mCount = half;
+         right.mFirst = first + half;
+         right.mCount = count - half;
+
+         tree[n].mFirst = unsigned(tree.size());
+         tree[n].mCount = 0;
+         tree.push_back(left);
+         tree.push_back(right);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RayQueryTree::IntersectBox(const osg::BoundingBox& box, const osg::Vec3& start,
+            const osg::Vec3& invDir, float maxRatio)
+   {
+      float tMin = 0.0f;
+      float tMax = maxRatio;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+         float t0 = (box._min[axis] - start[axis]) * invDir[axis];
+         float t1 = (box._max[axis] - start[axis]) * invDir[axis];
+         if (t0 > t1)
+         {
+            std::swap(t0, t1);
+         }
+         tMin = std::max(tMin, t0);
+         tMax = std::min(tMax, t1);
+         if (tMin > tMax)
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RayQueryTree::Intersect(const osg::Vec3& start, const osg::Vec3& end, HitList& outHits) const
+   {
+      outHits.clear();
+      if (mTopTree.empty())
+      {
+         return false;
+      }
+
+      osg::Vec3 dir = end - start;
+      osg::Vec3 invDir(1.0f / dir.x(), 1.0f / dir.y(), 1.0f / dir.z());
+
+      unsigned stack[MAX_TREE_DEPTH];
+      unsigned stackSize = 0;
+      stack[stackSize++] = 0;
+
+      while (stackSize > 0)
+      {
+         const TreeNode& node = mTopTree[stack[--stackSize]];
+         if (!IntersectBox(node.mBound, start, invDir, 1.0f))
+         {
+            continue;
+         }
+
+         if (node.mCount > 0)
+         {
+            for (unsigned i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+            {
+               const Instance& instance = mInstances[mInstanceOrder[i]];
+               if (IntersectBox(instance.mWorldBound, start, invDir, 1.0f))
+               {
+                  IntersectInstance(instance, start, end, outHits);
+               }
+            }
+         }
+         else
+         {
+            stack[stackSize++] = node.mFirst;
+            stack[stackSize++] = node.mFirst + 1;
+         }
+      }
+
+      std::sort(outHits.begin(), outHits.end());
+      return !outHits.empty();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RayQueryTree::IntersectInstance(const Instance& instance, const osg::Vec3& start,
+            const osg::Vec3& end, HitList& outHits) const
+   {
+      // The ratio along the segment is the same in local space, so the hits can be sorted together.
+      osg::Vec3 localStart = start * instance.mInverse;
+      osg::Vec3 dir = end * instance.mInverse - localStart;
+      osg::Vec3 invDir(1.0f / dir.x(), 1.0f / dir.y(), 1.0f / dir.z());
+
+      unsigned stack[MAX_TREE_DEPTH];
+      unsigned stackSize = 0;
+      stack[stackSize++] = 0;
+
+      while (stackSize > 0)
+      {
+         const TreeNode& node = instance.mTree[stack[--stackSize]];
+         if (!IntersectBox(node.mBound, localStart, invDir, 1.0f))
+         {
+            continue;
+         }
+
+         if (node.mCount == 0)
+         {
+            stack[stackSize++] = node.mFirst;
+            stack[stackSize++] = node.mFirst + 1;
+            continue;
+         }
+
+         for (unsigned i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+         {
+            unsigned triangle = instance.mTriangles[i];
+            const osg::Vec3& v0 = instance.mVertices[triangle * 3];
+            const osg::Vec3& v1 = instance.mVertices[triangle * 3 + 1];
+            const osg::Vec3& v2 = instance.mVertices[triangle * 3 + 2];
+
+            // Moller-Trumbore, from either side.
+            osg::Vec3 edge1 = v1 - v0;
+            osg::Vec3 edge2 = v2 - v0;
+            osg::Vec3 p = dir ^ edge2;
+            float det = edge1 * p;
+            if (std::abs(det) < FLT_EPSILON)
+            {
+               continue;
+            }
+
+            float invDet = 1.0f / det;
+            osg::Vec3 s = localStart - v0;
+            float u = (s * p) * invDet;
+            if (u < 0.0f || u > 1.0f)
+            {
+               continue;
+            }
+
+            osg::Vec3 q = s ^ edge1;
+            float v = (dir * q) * invDet;
+            if (v < 0.0f || u + v > 1.0f)
+            {
+               continue;
+            }
+
+            float ratio = (edge2 * q) * invDet;
+            if (ratio < 0.0f || ratio > 1.0f)
+            {
+               continue;
+            }
+
+            osg::Vec3 normal = edge1 ^ edge2;
+            normal = osg::Matrix::transform3x3(instance.mInverse, normal);
+            normal.normalize();
+
+            osgUtil::Hit hit;
+            hit._ratio = ratio;
+            hit._nodePath = instance.mNodePath;
+            hit._geode = instance.mGeode;
+            hit._drawable = instance.mDrawable;
+            hit._primitiveIndex = int(triangle);
+            hit._intersectPoint = (localStart + dir * ratio) * instance.mMatrix;
+            hit._intersectNormal = normal;
+            outHits.push_back(hit);
+         }
+      }
+   }
+}
@@ -254,6 +254,15 @@ void Scene::AddDrawable(DeltaDrawable* drawable)
    }
 }
 /////////////////////////////////////////////
+void Scene::AddDrawables(const std::vector<DeltaDrawable*>& drawables)
+{
+   mImpl->mAddedDrawables.reserve(mImpl->mAddedDrawables.size() + drawables.size());
+   for (size_t i = 0; i < drawables.size(); ++i)
+   {
+      AddDrawable(drawables[i]);
+   }
+}
+/////////////////////////////////////////////
 void Scene::RemoveDrawable(DeltaDrawable* drawable)
 {
    if (drawable == NULL)
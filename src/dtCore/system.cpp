@@ -23,6 +23,7 @@
 #include <dtCore/system.h>
 #include <dtUtil/log.h>
 #include <dtUtil/bits.h>
+#include <dtUtil/tracer.h>
 #include <dtCore/deltawin.h>
 
 #include <osgViewer/GraphicsWindow>
@@ -387,6 +388,9 @@ namespace dtCore
    ////////////////////////////////////////////////////////////////////////////////
    void System::SystemStep()
    {
+      dtUtil::Tracer::BeginFrame();
+      DT_TRACE_SCOPE_CATEGORY("System::SystemStep", "system");
+
       const Timer_t lastClockTime  = mTickClockTime;
       mTickClockTime = mClock.Tick();
 
@@ -558,6 +562,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_EVENT_TRAVERSAL))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_EVENT_TRAVERSAL.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_EVENT_TRAVERSAL, userData);
@@ -572,6 +577,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_POST_EVENT_TRAVERSAL))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_POST_EVENT_TRAVERSAL.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_POST_EVENT_TRAVERSAL, userData);
@@ -586,6 +592,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_PREFRAME))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_PRE_FRAME.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_PRE_FRAME, userData);
@@ -600,6 +607,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_FRAME_SYNCH))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_FRAME_SYNCH.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_FRAME_SYNCH, userData);
@@ -614,6 +622,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_CAMERA_SYNCH))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_CAMERA_SYNCH.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_CAMERA_SYNCH, userData);
@@ -628,6 +637,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_FRAME))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_FRAME.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_FRAME, userData );
@@ -642,6 +652,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_POSTFRAME))
       {
          mSystemImpl->StartStatTimer();
+         DT_TRACE_SCOPE_CATEGORY(MESSAGE_POST_FRAME.c_str(), "system");
 
          double userData[2] = { mSimDT, mRealDT };
          SendMessage(MESSAGE_POST_FRAME, userData);
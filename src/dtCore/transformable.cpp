@@ -22,6 +22,8 @@
 
 #if defined(OSG_VERSION_MAJOR) && defined(OSG_VERSION_MINOR) && OSG_VERSION_MAJOR == 1 && OSG_VERSION_MINOR == 0
 #include <osg/CameraNode>
+#else
+#include <osg/Camera>
 #endif
 
 #include <cassert>
@@ -86,6 +88,29 @@ namespace dtCore
       osg::Node*        _haltTraversalAtNode;
       osg::NodePathList _nodePaths;
    };
+
+   /**
+    * @return true if there is a transform, other than a camera, at or above the given node,
+    * or if the path up is not unique, so the world matrix of a node under it can't be cached.
+    */
+   static bool HasTransformAtOrAbove(const osg::Node* node)
+   {
+      while (node != NULL)
+      {
+         #if defined(OSG_VERSION_MAJOR) && defined(OSG_VERSION_MINOR) && OSG_VERSION_MAJOR == 1 && OSG_VERSION_MINOR == 0
+         bool isCamera = dynamic_cast<const osg::CameraNode*>(node) != NULL;
+         #else
+         bool isCamera = dynamic_cast<const osg::Camera*>(node) != NULL;
+         #endif
+
+         if (node->getNumParents() > 1 || (!isCamera && dynamic_cast<const osg::Transform*>(node) != NULL))
+         {
+            return true;
+         }
+         node = node->getNumParents() > 0 ? node->getParent(0) : NULL;
+      }
+      return false;
+   }
 }
 
 /////////////////////////////////////////////////////////////
@@ -102,6 +127,10 @@ namespace dtCore
       , mNode(&node)
       , mRenderingGeometry(false)
       , mRenderProxyNode(false)
+      , mAbsParentNode(NULL)
+      , mAbsParent(NULL)
+      , mAbsDirty(true)
+      , mAbsVersion(0)
       {
 
       }
@@ -131,6 +160,16 @@ namespace dtCore
       ///used for the rendering of the proxy node
       dtCore::RefPtr<PointAxis> mPointAxis;
 
+      /// The cached world matrix, and the local matrix, parent node and parent Transformable it was calculated from.
+      osg::Matrix mAbsMatrix;
+      osg::Matrix mAbsLocal;
+      const osg::Node* mAbsParentNode;
+      const DeltaDrawable* mAbsParent;
+
+      /// Set if the cached world matrix must be recalculated.  Everything under a dirty Transformable is dirty too.
+      bool mAbsDirty;
+      /// Incremented every time the cached world matrix is marked dirty or can't be cached.
+      unsigned mAbsVersion;
    };
 }
 /////////////////////////////////////////////////////////////
@@ -258,6 +297,7 @@ void Transformable::ReplaceMatrixNode(TransformableNode* matrixTransform)
 
    // Replace the node pointer
    mImpl->mNode = matrixTransform;
+   MarkAbsoluteDirty();
 
    // Preseve normal rescaling property
    SetNormalRescaling(normalRescaling);
@@ -334,9 +374,17 @@ void Transformable::SetTransform(const Transform& xform, CoordSysEnum cs)
       //if this has a parent
       if (!GetOSGNode()->getParents().empty())
       {
-         //get the parent's world position
+         //get the parent's world position, from its cache if the parent node is a Transformable's
          osg::Matrix parentMat;
-         GetAbsoluteMatrix(GetOSGNode()->getParent(0), parentMat);
+         const Transformable* parent = dynamic_cast<const Transformable*>(GetParent());
+         if (parent != NULL && GetOSGNode()->getParent(0) == parent->GetMatrixNode())
+         {
+            parentMat = parent->GetCachedAbsoluteMatrix();
+         }
+         else
+         {
+            GetAbsoluteMatrix(GetOSGNode()->getParent(0), parentMat);
+         }
 
          //calc the difference between xform and the parent's world position
          //child * parent^-1
@@ -356,6 +404,7 @@ void Transformable::SetTransform(const Transform& xform, CoordSysEnum cs)
      GetMatrixNode()->setMatrix(newMat);
    }
 
+   MarkAbsoluteDirty();
    PrePhysicsStepUpdate();
 }
 
@@ -366,9 +415,7 @@ void Transformable::GetTransform(Transform& xform, CoordSysEnum cs) const
 
    if(cs == ABS_CS)
    {
-      osg::Matrix newMat;
-      GetAbsoluteMatrix(mt, newMat);
-      xform.Set( newMat );
+      xform.Set(GetCachedAbsoluteMatrix());
    }
    else if(cs == REL_CS)
    {
@@ -377,6 +424,13 @@ void Transformable::GetTransform(Transform& xform, CoordSysEnum cs) const
 
 }
 
+////////////////////////////////////////////////////////////////////////////
+unsigned Transformable::GetAbsoluteTransformVersion() const
+{
+   ValidateAbsoluteCache();
+   return mImpl->mAbsVersion;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 Transformable::TransformableNode* Transformable::GetMatrixNode()
 {
@@ -399,6 +453,114 @@ const osg::Matrix& Transformable::GetMatrix() const
 void Transformable::SetMatrix(const osg::Matrix& mat)
 {
    mImpl->mNode->setMatrix(mat);
+   MarkAbsoluteDirty();
+}
+
+////////////////////////////////////////////////////////////////////////////
+const osg::Matrix& Transformable::GetCachedAbsoluteMatrix() const
+{
+   ValidateAbsoluteCache();
+
+   TransformableImpl& impl = *mImpl;
+   if (!impl.mAbsDirty)
+   {
+      return impl.mAbsMatrix;
+   }
+
+   const TransformableNode& node = *impl.mNode;
+   const osg::Node* osgParent = node.getNumParents() > 0 ? node.getParent(0) : NULL;
+   impl.mAbsLocal = node.getMatrix();
+   impl.mAbsParentNode = osgParent;
+   impl.mAbsParent = NULL;
+
+   bool cacheable = false;
+   const Transformable* parent = dynamic_cast<const Transformable*>(GetParent());
+   if (osgParent == NULL)
+   {
+      impl.mAbsMatrix = impl.mAbsLocal;
+      cacheable = true;
+   }
+   else if (node.getNumParents() == 1 && parent != NULL && osgParent == parent->GetMatrixNode())
+   {
+      impl.mAbsMatrix = impl.mAbsLocal * parent->GetCachedAbsoluteMatrix();
+      impl.mAbsParent = parent;
+      cacheable = !parent->mImpl->mAbsDirty;
+   }
+   else if (node.getNumParents() == 1 && parent == NULL && !HasTransformAtOrAbove(osgParent))
+   {
+      impl.mAbsMatrix = impl.mAbsLocal;
+      cacheable = true;
+   }
+   else
+   {
+      // Some other transform is above this one, so there is no telling when it moves.
+      GetAbsoluteMatrix(&node, impl.mAbsMatrix);
+   }
+
+   impl.mAbsDirty = !cacheable;
+   if (!cacheable)
+   {
+      ++impl.mAbsVersion;
+   }
+   return impl.mAbsMatrix;
+}
+
+////////////////////////////////////////////////////////////////////////////
+void Transformable::ValidateAbsoluteCache() const
+{
+   TransformableImpl& impl = *mImpl;
+   if (impl.mAbsDirty)
+   {
+      return;
+   }
+
+   // Catch the matrix node being changed or moved without going through this class.
+   const TransformableNode& node = *impl.mNode;
+   const osg::Node* osgParent = node.getNumParents() > 0 ? node.getParent(0) : NULL;
+   if (impl.mAbsParentNode != osgParent || impl.mAbsParent != GetParent() || impl.mAbsLocal != node.getMatrix())
+   {
+      MarkAbsoluteDirty();
+   }
+   else if (impl.mAbsParent != NULL)
+   {
+      // A clean matrix was only ever calculated from a Transformable parent, and if anything has
+      // changed above, this is marked dirty along with it.
+      static_cast<const Transformable*>(impl.mAbsParent)->ValidateAbsoluteCache();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////
+void Transformable::MarkAbsoluteDirty() const
+{
+   // Everything under a dirty Transformable is already dirty.
+   if (mImpl->mAbsDirty)
+   {
+      return;
+   }
+
+   mImpl->mAbsDirty = true;
+   ++mImpl->mAbsVersion;
+   for (unsigned i = 0; i < GetNumChildren(); ++i)
+   {
+      MarkSubtreeAbsoluteDirty(*GetChild(i));
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////
+void Transformable::MarkSubtreeAbsoluteDirty(const DeltaDrawable& drawable)
+{
+   const Transformable* transformable = dynamic_cast<const Transformable*>(&drawable);
+   if (transformable != NULL)
+   {
+      transformable->MarkAbsoluteDirty();
+   }
+   else
+   {
+      for (unsigned i = 0; i < drawable.GetNumChildren(); ++i)
+      {
+         MarkSubtreeAbsoluteDirty(*drawable.GetChild(i));
+      }
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -408,6 +570,7 @@ bool Transformable::AddChild(DeltaDrawable* child)
    if (DeltaDrawable::AddChild(child))
    {
       GetMatrixNode()->addChild(child->GetOSGNode());
+      MarkSubtreeAbsoluteDirty(*child);
       return true;
    }
    else
@@ -421,6 +584,7 @@ void Transformable::RemoveChild(DeltaDrawable* child)
 {
    GetMatrixNode()->removeChild(child->GetOSGNode());
    DeltaDrawable::RemoveChild(child);
+   MarkSubtreeAbsoluteDirty(*child);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -890,6 +1054,8 @@ bool Transformable::GetRenderCollisionGeometry() const
 /////////////////////////////////////////////////////////////
 void Transformable::AddedToScene(Scene* scene)
 {
+   MarkAbsoluteDirty();
+
    if(scene)
    {
       //remove us from our existing parent scene, if we already have one.
@@ -4,12 +4,149 @@
 
 namespace dtCore
 {
+   const unsigned UniqueId::NUM_BYTES;
+   const unsigned UniqueId::STRING_LENGTH;
+
+   static const char HEX_DIGITS[] = "0123456789abcdef";
+
+   ////////////////////////////////////////////////
+   /// @return the value of a lowercase hex digit or -1 if it isn't one.
+   static int HexValue(char c)
+   {
+      if (c >= '0' && c <= '9')
+      {
+         return c - '0';
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+         return c - 'a' + 10;
+      }
+      return -1;
+   }
+
+   ////////////////////////////////////////////////
+   /// @return true if the character at the index is a dash in the canonical UUID form.
+   static bool IsDashPosition(unsigned index)
+   {
+      return index == 8 || index == 13 || index == 18 || index == 23;
+   }
+
+   ////////////////////////////////////////////////
+   UniqueId::UniqueId(const UniqueId& toCopy)
+      : mIsBinary(toCopy.mIsBinary)
+      , mId(toCopy.mId)
+   {
+      std::memcpy(mBytes, toCopy.mBytes, NUM_BYTES);
+   }
+
+   ////////////////////////////////////////////////
+   UniqueId::UniqueId(const std::string& stringId)
+      : mIsBinary(false)
+   {
+      SetFromString(stringId);
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::SetFromString(const std::string& stringId)
+   {
+      mIsBinary = false;
+      std::memset(mBytes, 0, NUM_BYTES);
+
+      // 32 hex digits and 4 dashes
+      if (stringId.size() == STRING_LENGTH)
+      {
+         unsigned byteIndex = 0;
+         bool valid = true;
+         for (unsigned i = 0; i < STRING_LENGTH && valid; ++i)
+         {
+            if (IsDashPosition(i))
+            {
+               valid = stringId[i] == '-';
+               continue;
+            }
+
+            int high = HexValue(stringId[i]);
+            int low = HexValue(stringId[++i]);
+            valid = high >= 0 && low >= 0;
+            mBytes[byteIndex++] = (unsigned char)((high << 4) | low);
+         }
+
+         if (valid)
+         {
+            mIsBinary = true;
+            mId.clear();
+            return;
+         }
+
+         std::memset(mBytes, 0, NUM_BYTES);
+      }
+
+      mId = stringId;
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::SetBytes(const unsigned char* bytes)
+   {
+      std::memcpy(mBytes, bytes, NUM_BYTES);
+      mIsBinary = true;
+      mId.clear();
+   }
+
+   ////////////////////////////////////////////////
+   bool UniqueId::FormatString(char* buffer) const
+   {
+      if (!mIsBinary)
+      {
+         return false;
+      }
+
+      unsigned charIndex = 0;
+      for (unsigned i = 0; i < NUM_BYTES; ++i)
+      {
+         if (IsDashPosition(charIndex))
+         {
+            buffer[charIndex++] = '-';
+         }
+         buffer[charIndex++] = HEX_DIGITS[mBytes[i] >> 4];
+         buffer[charIndex++] = HEX_DIGITS[mBytes[i] & 0x0F];
+      }
+      buffer[charIndex] = '\0';
+      return true;
+   }
+
    ////////////////////////////////////////////////
-   const std::string& UniqueId::ToString() const
+   std::string UniqueId::ToString() const
    {
+      char buffer[STRING_LENGTH + 1];
+      if (FormatString(buffer))
+      {
+         return std::string(buffer, STRING_LENGTH);
+      }
       return mId;
    }
 
+   ////////////////////////////////////////////////
+   size_t UniqueId::GetHash() const
+   {
+      // FNV-1a
+      size_t hash = 2166136261U;
+      if (mIsBinary)
+      {
+         for (unsigned i = 0; i < NUM_BYTES; ++i)
+         {
+            hash = (hash ^ mBytes[i]) * 16777619U;
+         }
+      }
+      else
+      {
+         for (std::string::const_iterator i = mId.begin(); i != mId.end(); ++i)
+         {
+            hash = (hash ^ (unsigned char)(*i)) * 16777619U;
+         }
+      }
+      return hash;
+   }
+
    ////////////////////////////////////////////////
    UniqueId& UniqueId::operator=(const UniqueId& rhs)
    {
@@ -18,6 +155,8 @@ namespace dtCore
          return *this;
       }
 
+      mIsBinary = rhs.mIsBinary;
+      std::memcpy(mBytes, rhs.mBytes, NUM_BYTES);
       mId = rhs.mId;
       return *this;
    }
@@ -25,14 +164,22 @@ namespace dtCore
    ////////////////////////////////////////////////
    UniqueId& UniqueId::operator=(const std::string& rhs)
    {
-      mId = rhs;
+      SetFromString(rhs);
       return *this;
    }
 
    ////////////////////////////////////////////////
    std::ostream& operator << (std::ostream& o, const UniqueId& id)
    {
-      o << id.ToString();
+      char buffer[UniqueId::STRING_LENGTH + 1];
+      if (id.FormatString(buffer))
+      {
+         o << buffer;
+      }
+      else
+      {
+         o << id.ToString();
+      }
       return o;
    }
 
@@ -11,10 +11,8 @@ UniqueId::UniqueId()
    uuid_t uuid;
    uuid_generate( uuid );
 
-   char buffer[37];
-   uuid_unparse( uuid, buffer );
-
-   mId = std::string( buffer );
+   // uuid_t is already the 16 bytes in network order.
+   SetBytes( uuid );
 }
 
 //bool UniqueId::operator< ( const UniqueId& rhs ) const
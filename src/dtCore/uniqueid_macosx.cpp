@@ -28,13 +28,12 @@ std::string CFStringRefToStdString(CFStringRef stringRef)
 UniqueId::UniqueId()
 {
    CFUUIDRef uuid;
-   CFStringRef string;
    uuid = CFUUIDCreate( NULL );
-   string = CFUUIDCreateString(NULL, uuid);
 
-   mId = CFStringRefToStdString(string);
+   // CFUUIDBytes is the 16 bytes in network order.
+   CFUUIDBytes uuidBytes = CFUUIDGetUUIDBytes(uuid);
+   SetBytes(reinterpret_cast<const unsigned char*>(&uuidBytes));
 
-   if (string) CFRelease(string);
    CFRelease(uuid);
 }
 
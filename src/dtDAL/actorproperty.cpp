@@ -21,6 +21,7 @@
  */
 
 #include <dtDAL/actorproperty.h>
+#include <dtDAL/propertycontainer.h>
 #include <iostream>
 
 //For initial ToDataStream solution. Eventually this should be removed when all properties can do the work themselves.
@@ -39,6 +40,9 @@ namespace dtDAL
       , mDescription(desc)
       , mNumberPrecision(16)
       , mReadOnly(readOnly)
+      , mOwner(NULL)
+      , mOwnerIndex(0)
+      , mDirty(false)
    {
       groupName->empty() ? SetGroupName("Base") : SetGroupName(groupName);
    }
@@ -58,6 +62,15 @@ namespace dtDAL
       return mNumberPrecision;
    }
 
+   ////////////////////////////////////////
+   void ActorProperty::MarkDirty()
+   {
+      if (mOwner != NULL)
+      {
+         mOwner->MarkPropertyDirty(mOwnerIndex);
+      }
+   }
+
    ////////////////////////////////////////
    void ActorProperty::ToDataStream(dtUtil::DataStream& stream) const
    {
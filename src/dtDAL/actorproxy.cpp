@@ -23,6 +23,7 @@
 #include <dtUtil/log.h>
 #include <dtDAL/enginepropertytypes.h>
 #include <dtDAL/actorproperty.h>
+#include <dtDAL/actortype.h>
 #include <dtDAL/datatype.h>
 #include <dtDAL/librarymanager.h>
 #include <dtDAL/actorproxyicon.h>
@@ -75,7 +76,24 @@ namespace dtDAL
       // before proceeding.
       GetActorType();
       GetActor();
+
+      // the properties are matched against the type's layout as they are added, so a proxy that
+      // builds the same properties as the rest of its type never builds a name map of its own.
+      dtCore::RefPtr<const PropertyLayout> layout = actorType.GetPropertyLayout();
+      SetSharedLayout(layout.get());
       BuildPropertyMap();
+
+      if (!layout.valid())
+      {
+         dtCore::RefPtr<PropertyLayout> newLayout = new PropertyLayout(*this);
+         for (unsigned i = 0; i < newLayout->GetNumProperties(); ++i)
+         {
+            newLayout->SetPropertyHandle(i, actorType.GetPropertyHandle(newLayout->GetPropertyName(i)));
+         }
+         // another thread may have set one first, so use whichever the type kept.
+         layout = actorType.SetPropertyLayout(*newLayout);
+         SetSharedLayout(layout.get());
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////
@@ -232,6 +250,50 @@ namespace dtDAL
       return *mActorType;
    }
 
+   ///////////////////////////////////////////////////////////////////////////////////////
+   unsigned ActorProxy::GetPropertyHandle(const ActorProperty& property) const
+   {
+      int index = GetPropertyIndex(property);
+      if (index < 0)
+      {
+         return ActorType::INVALID_PROPERTY_HANDLE;
+      }
+
+      const PropertyLayout* layout = GetSharedLayout();
+      if (layout != NULL && layout->GetPropertyHandle(index) != PropertyLayout::INVALID_HANDLE)
+      {
+         return layout->GetPropertyHandle(index);
+      }
+
+      // the proxy has its own property list, so get the handle from the actor type by name.
+      return GetActorType().GetPropertyHandle(property.GetName());
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   ActorProperty* ActorProxy::GetPropertyByHandle(unsigned handle)
+   {
+      const ActorProxy* constThis = this;
+      return const_cast<ActorProperty*>(constThis->GetPropertyByHandle(handle));
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   const ActorProperty* ActorProxy::GetPropertyByHandle(unsigned handle) const
+   {
+      const PropertyLayout* layout = GetSharedLayout();
+      if (layout != NULL)
+      {
+         int index = layout->GetIndexOfHandle(handle);
+         if (index >= 0)
+         {
+            // the layout may have more properties than this proxy.
+            return unsigned(index) < GetNumProperties() ? GetPropertyByIndex(unsigned(index)) : NULL;
+         }
+      }
+
+      const dtUtil::RefString name = GetActorType().GetPropertyHandleName(handle);
+      return name->empty() ? NULL : GetProperty(name);
+   }
+
    ///////////////////////////////////////////////////////////////////////////////////////
    const ActorProxy::RenderMode& ActorProxy::GetRenderMode()
    {
@@ -20,9 +20,12 @@
  */
 #include <prefix/dtdalprefix-src.h>
 #include <dtDAL/actortype.h>
+#include <OpenThreads/ScopedLock>
 
 namespace dtDAL
 {
+   //////////////////////////////////////////////////////////////////////////
+   const unsigned ActorType::INVALID_PROPERTY_HANDLE;
 
    //////////////////////////////////////////////////////////////////////////
    ActorType::ActorType(const std::string& name,
@@ -38,6 +41,90 @@ namespace dtDAL
       return dynamic_cast<const ActorType*>(GetParentType());
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ActorType::GetPropertyHandle(const dtUtil::RefString& name) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      std::pair<PropertyHandleMap::iterator, bool> inserted =
+         mPropertyHandles.insert(std::make_pair(name, unsigned(mPropertyHandleNames.size())));
+      if (inserted.second)
+      {
+         mPropertyHandleNames.push_back(name);
+         mInternedPropertyHandles.insert(std::make_pair(&inserted.first->first.Get(), inserted.first->second));
+      }
+      return inserted.first->second;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ActorType::FindPropertyHandle(const dtUtil::RefString& name) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      return FindPropertyHandleLocked(name);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ActorType::FindPropertyHandleLocked(const dtUtil::RefString& name) const
+   {
+      dtUtil::HashMap<const std::string*, unsigned>::const_iterator interned = mInternedPropertyHandles.find(&name.Get());
+      if (interned != mInternedPropertyHandles.end())
+      {
+         return interned->second;
+      }
+
+      // the name wasn't interned in the same table, so compare the strings.
+      PropertyHandleMap::const_iterator found = mPropertyHandles.find(name);
+      return found == mPropertyHandles.end() ? INVALID_PROPERTY_HANDLE : found->second;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   ActorType::PropertyHandleLookup::PropertyHandleLookup(const ActorType& actorType)
+      : mActorType(actorType)
+      , mLock(actorType.mPropertyHandleMutex)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ActorType::PropertyHandleLookup::Find(const dtUtil::RefString& name) const
+   {
+      return mActorType.FindPropertyHandleLocked(name);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   dtUtil::RefString ActorType::GetPropertyHandleName(unsigned handle) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      if (handle >= mPropertyHandleNames.size())
+      {
+         return dtUtil::RefString();
+      }
+      return mPropertyHandleNames[handle];
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ActorType::GetNumPropertyHandles() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      return unsigned(mPropertyHandleNames.size());
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<const PropertyLayout> ActorType::GetPropertyLayout() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      return mPropertyLayout;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<const PropertyLayout> ActorType::SetPropertyLayout(const PropertyLayout& layout) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertyHandleMutex);
+      if (!mPropertyLayout.valid())
+      {
+         mPropertyLayout = &layout;
+      }
+      return mPropertyLayout;
+   }
+
    //////////////////////////////////////////////////////////////////////////
    ActorType::~ActorType() { }
 }
@@ -41,6 +41,9 @@ bool dtDAL::ArrayActorPropertyBase::FromString(const std::string& value)
       return false;
    }
 
+   // the elements are set through the element property, which doesn't belong to the container.
+   MarkDirty();
+
    std::string data = value;
 
    // First read the total size of the array.
@@ -53,6 +53,9 @@ namespace dtDAL
          return false;
       }
 
+      // the child properties don't belong to the container, so mark this one.
+      MarkDirty();
+
       std::string data = value;
       std::string token;
 
@@ -150,6 +150,7 @@ namespace dtDAL
       }
 
       SetPropFunctor(value);
+      MarkDirty();
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -341,6 +342,7 @@ namespace dtDAL
       }
 
       SetIdFunctor(value);
+      MarkDirty();
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -408,6 +410,7 @@ namespace dtDAL
          return;
       }
 
+      MarkDirty();
       mProxy->SetResource(GetName(), value);
       if (value == NULL)
          SetPropFunctor("");
@@ -67,7 +67,14 @@ namespace dtDAL
    ////////////////////////////////////////////////////////////////////////////
    void GroupActorProperty::SetValue(const NamedGroupParameter& value) 
    { 
-      !IsReadOnly() ? mSetPropFunctor(value) : LOG_WARNING("SetValue has been called on a property that is read only.");
+      if (IsReadOnly())
+      {
+         LOG_WARNING("SetValue has been called on a property that is read only.");
+         return;
+      }
+
+      mSetPropFunctor(value);
+      MarkDirty();
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,8 @@
 #include <cstdlib>
 #include <string>
 #include <cmath>
+#include <sstream>
+#include <algorithm>
 
 #ifdef _MSC_VER
 #   pragma warning(push)
@@ -36,6 +38,8 @@
 #include <xercesc/framework/LocalFileInputSource.hpp>
 #include <xercesc/internal/XMLGrammarPoolImpl.hpp>
 #include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
 
 #ifdef _MSC_VER
 #   pragma warning(pop)
@@ -79,6 +83,202 @@ namespace dtDAL
 
    static const std::string logName("mapxml.cpp");
 
+   /////////////////////////////////////////////////////////////////
+   static void SetMapReaderFeatures(SAX2XMLReader& reader)
+   {
+      reader.setFeature(XMLUni::fgSAX2CoreValidation, true);
+      reader.setFeature(XMLUni::fgXercesDynamic, false);
+
+      reader.setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
+      reader.setFeature(XMLUni::fgXercesSchema, true);
+      reader.setFeature(XMLUni::fgXercesSchemaFullChecking, true);
+      reader.setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+      reader.setFeature(XMLUni::fgXercesUseCachedGrammarInParse, true);
+      reader.setFeature(XMLUni::fgXercesCacheGrammarFromParse, true);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   // Uses only xerces, unlike XMLStringConverter, so it may be called from any thread.
+   static std::string TranscodeXMLString(const XMLCh* const str)
+   {
+      if (str == NULL)
+      {
+         return std::string();
+      }
+
+      char* chars = XMLString::transcode(str);
+      std::string result(chars);
+      XMLString::release(&chars);
+      return result;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   // The attributes sent with recorded elements.  The map format doesn't use any.
+   class EmptyAttributes: public Attributes
+   {
+      public:
+         virtual unsigned int getLength() const { return 0; }
+         virtual const XMLCh* getURI(const unsigned int index) const { return NULL; }
+         virtual const XMLCh* getLocalName(const unsigned int index) const { return NULL; }
+         virtual const XMLCh* getQName(const unsigned int index) const { return NULL; }
+         virtual const XMLCh* getType(const unsigned int index) const { return NULL; }
+         virtual const XMLCh* getValue(const unsigned int index) const { return NULL; }
+         virtual int getIndex(const XMLCh* const uri, const XMLCh* const localPart) const { return -1; }
+         virtual int getIndex(const XMLCh* const qName) const { return -1; }
+         virtual const XMLCh* getType(const XMLCh* const uri, const XMLCh* const localPart) const { return NULL; }
+         virtual const XMLCh* getType(const XMLCh* const qName) const { return NULL; }
+         virtual const XMLCh* getValue(const XMLCh* const uri, const XMLCh* const localPart) const { return NULL; }
+         virtual const XMLCh* getValue(const XMLCh* const qName) const { return NULL; }
+   };
+
+   /////////////////////////////////////////////////////////////////
+   // Records the events of a map file.  It runs off the main thread, so it must not log.
+   class MapXMLEvents::Recorder: public DefaultHandler
+   {
+      public:
+         Recorder(std::vector<MapXMLEvents::Event>& events)
+            : mEvents(events)
+         {
+         }
+
+         virtual void startDocument() { Add(Event::START_DOCUMENT, NULL, 0); }
+
+         virtual void endDocument() { Add(Event::END_DOCUMENT, NULL, 0); }
+
+         virtual void startElement(const XMLCh* const uri, const XMLCh* const localname,
+                  const XMLCh* const qname, const Attributes& attrs)
+         {
+            Add(Event::START_ELEMENT, localname, XMLString::stringLen(localname));
+         }
+
+         virtual void endElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname)
+         {
+            Add(Event::END_ELEMENT, localname, XMLString::stringLen(localname));
+         }
+
+         virtual void characters(const XMLCh* const chars, const unsigned int length)
+         {
+            Add(Event::CHARACTERS, chars, length);
+         }
+
+         /// Validation errors stop the read, as they stop MapContentHandler.
+         virtual void error(const SAXParseException& exc)
+         {
+            throw exc;
+         }
+
+      private:
+         void Add(Event::Kind kind, const XMLCh* const text, unsigned length)
+         {
+            mEvents.push_back(Event());
+            Event& event = mEvents.back();
+            event.mKind = kind;
+            event.mText.reserve(length + 1);
+            if (length > 0)
+            {
+               event.mText.assign(text, text + length);
+            }
+            event.mText.push_back(0);
+         }
+
+         std::vector<MapXMLEvents::Event>& mEvents;
+   };
+
+   /////////////////////////////////////////////////////////////////
+   MapXMLEvents::MapXMLEvents(const std::string& path)
+      : mPath(path)
+      , mSchemaPath(dtCore::FindFileInPathList("map.xsd"))
+   {
+      if (!dtUtil::FileUtils::GetInstance().FileExists(mSchemaPath))
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::ProjectException, "Unable to load required file \"map.xsd\", can not load map.", __FILE__, __LINE__);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   MapXMLEvents::~MapXMLEvents()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool MapXMLEvents::Read()
+   {
+      mEvents.clear();
+      mError.clear();
+
+      SAX2XMLReader* reader = NULL;
+      Recorder recorder(mEvents);
+      try
+      {
+         reader = XMLReaderFactory::createXMLReader();
+         SetMapReaderFeatures(*reader);
+
+         XMLCh* value = XMLString::transcode(mSchemaPath.c_str());
+         LocalFileInputSource inputSource(value);
+         XMLString::release(&value);
+         reader->loadGrammar(inputSource, Grammar::SchemaGrammarType, true);
+
+         reader->setContentHandler(&recorder);
+         reader->setErrorHandler(&recorder);
+         reader->parse(mPath.c_str());
+      }
+      catch (const OutOfMemoryException&)
+      {
+         mError = "Ran out of memory reading the map file.";
+      }
+      catch (const XMLException& ex)
+      {
+         mError = TranscodeXMLString(ex.getMessage());
+      }
+      catch (const SAXParseException& ex)
+      {
+         std::ostringstream ss;
+         ss << ex.getLineNumber() << ":" << ex.getColumnNumber() << " - " << TranscodeXMLString(ex.getMessage());
+         mError = ss.str();
+      }
+
+      delete reader;
+
+      if (!mError.empty())
+      {
+         mEvents.clear();
+         return false;
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void MapXMLEvents::Send(ContentHandler& handler, unsigned begin, unsigned end) const
+   {
+      static const XMLCh emptyString[] = { 0 };
+      EmptyAttributes attrs;
+
+      end = std::min(end, unsigned(mEvents.size()));
+      for (unsigned i = begin; i < end; ++i)
+      {
+         const Event& event = mEvents[i];
+         const XMLCh* const text = &event.mText[0];
+         switch (event.mKind)
+         {
+            case Event::START_DOCUMENT:
+               handler.startDocument();
+               break;
+            case Event::END_DOCUMENT:
+               handler.endDocument();
+               break;
+            case Event::START_ELEMENT:
+               handler.startElement(emptyString, text, text, attrs);
+               break;
+            case Event::END_ELEMENT:
+               handler.endElement(emptyString, text, text);
+               break;
+            case Event::CHARACTERS:
+               handler.characters(text, unsigned(event.mText.size() - 1));
+               break;
+         }
+      }
+   }
+
    /////////////////////////////////////////////////////////////////
 
    void MapParser::StaticInit()
@@ -283,6 +483,69 @@ namespace dtDAL
       }
    }
 
+   /////////////////////////////////////////////////////////////////
+   void MapParser::BeginParse(const MapXMLEvents& events)
+   {
+      mEvents = &events;
+      mNextEvent = 0;
+      mParsing = true;
+      mHandler->SetMapMode();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   Map* MapParser::ContinueParse(unsigned maxEvents)
+   {
+      if (!mEvents.valid())
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::MapLoadParsingError, "ContinueParse was called before BeginParse.", __FILE__, __LINE__);
+      }
+
+      const unsigned end = std::min(mNextEvent + maxEvents, mEvents->GetNumEvents());
+      try
+      {
+         mEvents->Send(*mHandler, mNextEvent, end);
+         mNextEvent = end;
+      }
+      catch (const SAXParseException&)
+      {
+         mHandler->ClearMap();
+         mEvents = NULL;
+         mParsing = false;
+         //this will already by logged by the content handler
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::MapLoadParsingError, "Error while parsing map file. See log for more information.", __FILE__, __LINE__);
+      }
+      catch (const dtUtil::Exception&)
+      {
+         mHandler->ClearMap();
+         mEvents = NULL;
+         mParsing = false;
+         throw;
+      }
+
+      if (mNextEvent < mEvents->GetNumEvents())
+      {
+         return NULL;
+      }
+
+      mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__,  __LINE__, "Parsing complete.\n");
+      dtCore::RefPtr<Map> mapRef = mHandler->GetMap();
+      mHandler->ClearMap();
+      mEvents = NULL;
+      mParsing = false;
+      return mapRef.release();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   float MapParser::GetParseProgress() const
+   {
+      if (!mEvents.valid() || mEvents->GetNumEvents() == 0)
+      {
+         return 0.0f;
+      }
+
+      return float(mNextEvent) / float(mEvents->GetNumEvents());
+   }
+
    /////////////////////////////////////////////////////////////////
    Map* MapParser::GetMapBeingParsed()
    {
@@ -309,20 +572,12 @@ namespace dtDAL
    MapParser::MapParser()
       : mHandler(new MapContentHandler())
       , mParsing(false)
+      , mNextEvent(0)
    {
       mLogger = &dtUtil::Log::GetInstance(logName);
 
       mXercesParser = XMLReaderFactory::createXMLReader();
-
-      mXercesParser->setFeature(XMLUni::fgSAX2CoreValidation, true);
-      mXercesParser->setFeature(XMLUni::fgXercesDynamic, false);
-
-      mXercesParser->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
-      mXercesParser->setFeature(XMLUni::fgXercesSchema, true);
-      mXercesParser->setFeature(XMLUni::fgXercesSchemaFullChecking, true);
-      mXercesParser->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
-      mXercesParser->setFeature(XMLUni::fgXercesUseCachedGrammarInParse, true);
-      mXercesParser->setFeature(XMLUni::fgXercesCacheGrammarFromParse, true);
+      SetMapReaderFeatures(*mXercesParser);
 
       std::string schemaFileName = dtCore::FindFileInPathList("map.xsd");
 
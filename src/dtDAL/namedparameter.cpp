@@ -213,6 +213,7 @@ namespace dtDAL
    ///////////////////////////////////////////////////////////////////////////////
    NamedGroupParameter::NamedGroupParameter(const dtUtil::RefString& name) :
       NamedParameter(dtDAL::DataType::GROUP, name, false)
+      , mRevision(0)
    {}
 
    void NamedGroupParameter::ToDataStream(dtUtil::DataStream& stream) const
@@ -391,6 +392,7 @@ namespace dtDAL
 
       //wipe out any existing parameters.  It's easier to just recreate them.
       mParameterList.clear();
+      ++mRevision;
 
       //copy parameters
       NamedGroupParameter::ParameterList::const_iterator i = gpm.mParameterList.begin();
@@ -439,6 +441,7 @@ namespace dtDAL
       {
          dtCore::RefPtr<NamedParameter> param = itor->second;
          mParameterList.erase(itor);
+         ++mRevision;
          return param;
       }
       return NULL;
@@ -451,6 +454,7 @@ namespace dtDAL
          throw dtUtil::Exception(ExceptionEnum::InvalidParameter,
          "Could not add new parameter: "+ newParam.GetName() +
          ". A parameter with that name already exists.", __FILE__, __LINE__);
+      ++mRevision;
    }
 
    ///////////////////////////////////////////////////////////////////////////////
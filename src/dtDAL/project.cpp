@@ -433,23 +433,7 @@ namespace dtDAL
 
          mOpenMaps.insert(std::make_pair(name, dtCore::RefPtr<Map>(map)));
 
-         //Clearing the modified flag must be done because setting the
-         //map properties at load will make the map look modified.
-         //it must be done before adding the missing libraries and proxy
-         //classes because clearing the modified flag clears those lists.
-         if (clearModified)
-         {
-            map->ClearModified();
-         }
-
-         // If the map has a temporary property, we should mark it modified.
-         if (mParser->HasDeprecatedProperty())
-         {
-            map->SetModified(true);
-         }
-
-         map->AddMissingLibraries(mParser->GetMissingLibraries());
-         map->AddMissingActorTypes(mParser->GetMissingActorTypes());
+         FinishParsedMap(*map, *mParser, clearModified);
       }
       catch (const dtUtil::Exception& e)
       {
@@ -463,6 +447,28 @@ namespace dtDAL
       return *map;
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::FinishParsedMap(Map& map, MapParser& parser, bool clearModified)
+   {
+      //Clearing the modified flag must be done because setting the
+      //map properties at load will make the map look modified.
+      //it must be done before adding the missing libraries and proxy
+      //classes because clearing the modified flag clears those lists.
+      if (clearModified)
+      {
+         map.ClearModified();
+      }
+
+      // If the map has a temporary property, we should mark it modified.
+      if (parser.HasDeprecatedProperty())
+      {
+         map.SetModified(true);
+      }
+
+      map.AddMissingLibraries(parser.GetMissingLibraries());
+      map.AddMissingActorTypes(parser.GetMissingActorTypes());
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    Map& Project::GetMap(const std::string& name)
    {
@@ -498,6 +504,64 @@ namespace dtDAL
       return map;
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   bool Project::IsMapOpen(const std::string& name) const
+   {
+      return mOpenMaps.find(name) != mOpenMaps.end();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::string Project::GetMapFilePath(const std::string& name) const
+   {
+      if (!mValidContext)
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::ProjectInvalidContext,
+         std::string("The context is not valid."), __FILE__, __LINE__);
+      }
+
+      std::map<std::string,std::string>::const_iterator mapIter = mMapList.find(name);
+
+      if (mapIter == mMapList.end())
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::ProjectFileNotFound,
+                std::string("Map named ") + name + " does not exist.", __FILE__, __LINE__);
+      }
+
+      return mContext + dtUtil::FileUtils::PATH_SEPARATOR + Project::MAP_DIRECTORY
+         + dtUtil::FileUtils::PATH_SEPARATOR + mapIter->second;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   Map& Project::OpenParsedMap(const std::string& name, Map& map, MapParser& parser)
+   {
+      if (!mValidContext)
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::ProjectInvalidContext,
+         std::string("The context is not valid."), __FILE__, __LINE__);
+      }
+
+      std::map<std::string, dtCore::RefPtr<Map> >::iterator openMapI = mOpenMaps.find(name);
+
+      //map was opened while this one was being parsed.
+      if (openMapI != mOpenMaps.end())
+      {
+         return *(openMapI->second);
+      }
+
+      std::map<std::string,std::string>::iterator mapIter = mMapList.find(name);
+
+      if (mapIter == mMapList.end())
+      {
+         throw dtUtil::Exception(dtDAL::ExceptionEnum::ProjectFileNotFound,
+                std::string("Map named ") + name + " does not exist.", __FILE__, __LINE__);
+      }
+
+      mOpenMaps.insert(std::make_pair(name, dtCore::RefPtr<Map>(&map)));
+      map.SetFileName(mapIter->second);
+      FinishParsedMap(map, parser, true);
+      return map;
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    Map& Project::OpenMapBackup(const std::string& name)
    {
@@ -23,10 +23,12 @@
  */
 
 #include <dtDAL/propertycontainer.h>
+#include <dtDAL/propertylayout.h>
 #include <dtDAL/exceptionenum.h>
 #include <dtUtil/exception.h>
 #include <dtUtil/log.h>
 
+#include <algorithm>
 #include <sstream>
 
 namespace dtDAL
@@ -49,6 +51,20 @@ namespace dtDAL
             "AddProperty cannot add a NULL property", __FILE__, __LINE__);
       }
 
+      if (mSharedLayout.valid())
+      {
+         // the names in the layout are unique, so a property that matches the next one can't be a duplicate.
+         unsigned index = unsigned(mProperties.size());
+         if (index < mSharedLayout->GetNumProperties() && mSharedLayout->GetPropertyName(index) == newProp->GetName())
+         {
+            AppendProperty(*newProp);
+            return;
+         }
+
+         // it doesn't fit the layout, so this container needs its own index.
+         DetachSharedLayout();
+      }
+
       PropertyMapType::iterator itor =
          mPropertyMap.find(newProp->GetName());
       if(itor != mPropertyMap.end())
@@ -60,27 +76,56 @@ namespace dtDAL
       }
       else
       {
-         mPropertyMap.insert(std::make_pair(dtUtil::RefString(newProp->GetName()),newProp));
-         mProperties.push_back(newProp);
+         mPropertyMap.insert(std::make_pair(dtUtil::RefString(newProp->GetName()), unsigned(mProperties.size())));
+         AppendProperty(*newProp);
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::AppendProperty(ActorProperty& newProp)
+   {
+      newProp.mOwner = this;
+      newProp.mOwnerIndex = unsigned(mProperties.size());
+      newProp.mDirty = false;
+      mProperties.push_back(&newProp);
+      OnPropertyListChanged();
+   }
+
    ///////////////////////////////////////////////////////////////////////////////////////
    void PropertyContainer::RemoveProperty(const std::string& nameToRemove)
    {
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(nameToRemove);
-      if (itor != mPropertyMap.end())
+      int index = FindPropertyIndex(nameToRemove);
+      if (index >= 0)
       {
-         mPropertyMap.erase(itor);
-         for (size_t i = 0; i < mProperties.size(); ++i)
+         DetachSharedLayout();
+
+         if (mProperties[index]->mOwner == this)
+         {
+            mProperties[index]->mOwner = NULL;
+            mProperties[index]->mDirty = false;
+         }
+         mProperties.erase(mProperties.begin() + index);
+
+         // the properties after the removed one have moved down.
+         mPropertyMap.clear();
+         for (size_t j = 0; j < mProperties.size(); ++j)
+         {
+            if (mProperties[j]->mOwner == this)
+            {
+               mProperties[j]->mOwnerIndex = unsigned(j);
+            }
+            mPropertyMap.insert(std::make_pair(mProperties[j]->GetName(), unsigned(j)));
+         }
+
+         mDirtyIndices.clear();
+         for (size_t j = 0; j < mProperties.size(); ++j)
          {
-            if (mProperties[i]->GetName() == nameToRemove)
+            if (mProperties[j]->mOwner == this && mProperties[j]->mDirty)
             {
-               mProperties.erase(mProperties.begin() + i);
-               break;
+               mDirtyIndices.push_back(unsigned(j));
             }
          }
+         OnPropertyListChanged();
       }
       else
       {
@@ -91,27 +136,77 @@ namespace dtDAL
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////
-   ActorProperty* PropertyContainer::GetProperty(const std::string& name)
+   int PropertyContainer::FindPropertyIndex(const std::string& name) const
    {
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(name);
+      if (mSharedLayout.valid())
+      {
+         // the layout may have more properties than this container.
+         int index = mSharedLayout->FindPropertyIndex(name);
+         return index < int(mProperties.size()) ? index : -1;
+      }
 
-      if(itor == mPropertyMap.end())
-         return NULL;
-      else
-         return itor->second.get();
+      PropertyMapType::const_iterator itor = mPropertyMap.find(name);
+      return itor == mPropertyMap.end() ? -1 : int(itor->second);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   ActorProperty* PropertyContainer::GetProperty(const std::string& name)
+   {
+      int index = FindPropertyIndex(name);
+      return index < 0 ? NULL : mProperties[index].get();
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////
    const ActorProperty* PropertyContainer::GetProperty(const std::string& name) const
    {
-      PropertyMapType::const_iterator itor =
-         mPropertyMap.find(name);
+      int index = FindPropertyIndex(name);
+      return index < 0 ? NULL : mProperties[index].get();
+   }
 
-      if(itor == mPropertyMap.end())
-         return NULL;
-      else
-         return itor->second.get();
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::SetSharedLayout(const PropertyLayout* layout)
+   {
+      if (layout == mSharedLayout.get())
+      {
+         return;
+      }
+
+      if (layout != NULL)
+      {
+         // the layout can only be used if the properties already added match its start.
+         bool matches = mProperties.size() <= layout->GetNumProperties();
+         for (unsigned i = 0; matches && i < mProperties.size(); ++i)
+         {
+            matches = layout->GetPropertyName(i) == mProperties[i]->GetName();
+         }
+
+         if (matches)
+         {
+            mSharedLayout = layout;
+            mPropertyMap.clear();
+            OnPropertyListChanged();
+            return;
+         }
+      }
+
+      DetachSharedLayout();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::DetachSharedLayout()
+   {
+      if (!mSharedLayout.valid())
+      {
+         return;
+      }
+
+      mSharedLayout = NULL;
+      mPropertyMap.clear();
+      for (unsigned i = 0; i < mProperties.size(); ++i)
+      {
+         mPropertyMap.insert(std::make_pair(mProperties[i]->GetName(), i));
+      }
+      OnPropertyListChanged();
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -146,13 +241,101 @@ namespace dtDAL
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::MarkPropertyDirty(const dtUtil::RefString& name)
+   {
+      ActorProperty* prop = GetProperty(name);
+      if (prop != NULL && prop->mOwner == this)
+      {
+         MarkPropertyDirty(prop->mOwnerIndex);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::MarkPropertyDirty(unsigned index)
+   {
+      if (index >= mProperties.size())
+      {
+         return;
+      }
+
+      ActorProperty& prop = *mProperties[index];
+      if (prop.mOwner != this || prop.mDirty)
+      {
+         return;
+      }
+
+      prop.mDirty = true;
+      mDirtyIndices.push_back(index);
+      if (mDirtyIndices.size() == 1)
+      {
+         OnPropertiesDirty();
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   bool PropertyContainer::IsPropertyDirty(const dtUtil::RefString& name) const
+   {
+      const ActorProperty* prop = GetProperty(name);
+      return prop != NULL && prop->mOwner == this && prop->mDirty;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::GetDirtyPropertyNames(std::vector<dtUtil::RefString>& toFill) const
+   {
+      toFill.clear();
+      toFill.reserve(mDirtyIndices.size());
+      for (size_t i = 0; i < mDirtyIndices.size(); ++i)
+      {
+         toFill.push_back(mProperties[mDirtyIndices[i]]->GetName());
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::ClearPropertyDirty(const dtUtil::RefString& name)
+   {
+      ActorProperty* prop = GetProperty(name);
+      if (prop == NULL || prop->mOwner != this || !prop->mDirty)
+      {
+         return;
+      }
+
+      prop->mDirty = false;
+      std::vector<unsigned>::iterator found = std::find(mDirtyIndices.begin(), mDirtyIndices.end(), prop->mOwnerIndex);
+      if (found != mDirtyIndices.end())
+      {
+         mDirtyIndices.erase(found);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::ClearDirtyProperties()
+   {
+      for (size_t i = 0; i < mDirtyIndices.size(); ++i)
+      {
+         mProperties[mDirtyIndices[i]]->mDirty = false;
+      }
+      mDirtyIndices.clear();
+   }
+
    ///////////////////////////////////////////////////////////////////////////////////////
    void PropertyContainer::CopyPropertiesFrom(const PropertyContainer& copyFrom)
    {
+      // containers that share a layout have their properties in the same positions.
+      bool sameLayout = mSharedLayout.valid() && mSharedLayout == copyFrom.mSharedLayout;
+
       //Now copy all of the properties from this proxy to the clone.
       for (size_t i = 0; i < mProperties.size(); ++i)
       {
-         const ActorProperty* prop = copyFrom.GetProperty(mProperties[i]->GetName());
+         const ActorProperty* prop = NULL;
+         if (sameLayout)
+         {
+            prop = i < copyFrom.mProperties.size() ? copyFrom.mProperties[i].get() : NULL;
+         }
+         else
+         {
+            prop = copyFrom.GetProperty(mProperties[i]->GetName());
+         }
          if (prop != NULL && !prop->IsReadOnly())
          {
             mProperties[i]->CopyFrom(*prop);
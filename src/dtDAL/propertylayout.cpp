@@ -0,0 +1,70 @@
+/* -*-c++-*-
+ * Delta3D
+ * Copyright 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtdalprefix-src.h>
+#include <dtDAL/propertylayout.h>
+#include <dtDAL/propertycontainer.h>
+
+namespace dtDAL
+{
+   ///////////////////////////////////////////////////////////////////////////////////////
+   const unsigned PropertyLayout::INVALID_HANDLE;
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   PropertyLayout::PropertyLayout(const PropertyContainer& container)
+   {
+      unsigned numProperties = container.GetNumProperties();
+      mNames.reserve(numProperties);
+      mHandles.resize(numProperties, INVALID_HANDLE);
+      for (unsigned i = 0; i < numProperties; ++i)
+      {
+         const dtUtil::RefString& name = container.GetPropertyByIndex(i)->GetName();
+         mNames.push_back(name);
+         mIndices.insert(std::make_pair(name, i));
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   PropertyLayout::~PropertyLayout()
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   int PropertyLayout::FindPropertyIndex(const std::string& name) const
+   {
+      IndexMap::const_iterator found = mIndices.find(name);
+      return found == mIndices.end() ? -1 : int(found->second);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyLayout::SetPropertyHandle(unsigned index, unsigned handle)
+   {
+      mHandles[index] = handle;
+      if (handle >= mIndexOfHandle.size())
+      {
+         mIndexOfHandle.resize(handle + 1, -1);
+      }
+      mIndexOfHandle[handle] = int(index);
+   }
+}
@@ -88,6 +88,7 @@ void ESPduProcessor::ApplyFullUpdateToProxy(const DIS::EntityStatePdu& pdu, dtGa
 
    details::FullApplicator apply;
    apply( pdu , *msg, mConfig );
+   msg->ResolveUpdateParameterHandles( proxy.GetActorType() );
 
    proxy.ApplyActorUpdate( *msg );
 }
@@ -32,6 +32,8 @@ using namespace dtGame;
 ////////////////////////////////////////////////////////////////////////////////
 dtGame::ActorComponent::ActorComponent(const ACType& type) : 
   mOwner(NULL)
+, mSystem(NULL)
+, mSystemIndex(0)
 , mType(type) 
 {
 
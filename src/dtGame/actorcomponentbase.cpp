@@ -19,6 +19,7 @@
  */
 
 #include <dtGame/actorcomponentbase.h>
+#include <dtGame/actorcomponentsystem.h>
 #include <dtGame/gameactor.h>
 #include <dtUtil/exception.h>
 #include <cassert>
@@ -62,6 +63,7 @@ void ActorComponentBase::AddComponent(ActorComponent* component)
       // initialize component
       component->OnAddedToActor(*self);
       OnActorComponentAdded(component);
+      AddToComponentSystem(*component);
    }
 }
 
@@ -91,6 +93,10 @@ void ActorComponentBase::RemoveComponent(const ActorComponent::ACType& type)
    ActorComponentMap::iterator iter = mComponents.find(type);
    if (iter != mComponents.end())
    {
+      if (iter->second->mSystem != NULL)
+      {
+         iter->second->mSystem->RemoveActorComponent(*iter->second);
+      }
       iter->second->OnRemovedFromActor(*static_cast<GameActor*>(this));
       OnActorComponentRemoved(iter->second.get());
       mComponents.erase(iter);
@@ -126,6 +132,21 @@ void ActorComponentBase::InitComponents()
    {
       (*iter).second->OnAddedToActor(*static_cast<GameActor*>(this));
       OnActorComponentAdded((*iter).second.get());
+      AddToComponentSystem(*(*iter).second);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ActorComponentBase::AddToComponentSystem(ActorComponent& component)
+{
+   GameManager* gm = static_cast<GameActor*>(this)->GetGameActorProxy().GetGameManager();
+   if (gm != NULL)
+   {
+      ActorComponentSystem* system = ActorComponentSystem::FindSystem(*gm, component.GetType());
+      if (system != NULL)
+      {
+         system->AddActorComponent(component);
+      }
    }
 }
 
@@ -0,0 +1,251 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtgameprefix-src.h>
+#include <dtGame/actorcomponentsystem.h>
+#include <dtGame/actorcomponentbase.h>
+#include <dtGame/gameactor.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/basemessages.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/tracer.h>
+
+#include <algorithm>
+
+namespace dtGame
+{
+   ///////////////////////////////////////////////////////////////////////////////
+   class ActorComponentSystem::ChunkTask : public dtUtil::WorkerPool::Task
+   {
+   public:
+      ChunkTask(ActorComponentSystem& system, const TickMessage& tickMessage, unsigned chunkSize)
+         : mSystem(system)
+         , mTickMessage(tickMessage)
+         , mChunkSize(chunkSize)
+      {
+      }
+
+      virtual void Run(unsigned index)
+      {
+         const ComponentList& components = mSystem.mComponents;
+         unsigned begin = index * mChunkSize;
+         unsigned count = std::min(mChunkSize, unsigned(components.size()) - begin);
+         mSystem.UpdateComponents(mTickMessage, &components[begin], count);
+      }
+
+   private:
+      ActorComponentSystem& mSystem;
+      const TickMessage& mTickMessage;
+      unsigned mChunkSize;
+   };
+
+   ///////////////////////////////////////////////////////////////////////////////
+   std::string ActorComponentSystem::GetSystemName(const ActorComponent::ACType& type)
+   {
+      return "ActorComponentSystem " + type.Get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorComponentSystem* ActorComponentSystem::FindSystem(GameManager& gm, const ActorComponent::ACType& type)
+   {
+      ActorComponentSystem* system = NULL;
+      gm.GetComponentByName(GetSystemName(type), system);
+      return system;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorComponentSystem::ActorComponentSystem(const ActorComponent::ACType& type)
+      : GMComponent(GetSystemName(type))
+      , mComponentType(type)
+      , mChunkSize(DEFAULT_CHUNK_SIZE)
+      , mUpdating(false)
+   {
+      AddMessageTypeInterest(MessageType::TICK_LOCAL);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorComponentSystem::~ActorComponentSystem()
+   {
+      OnRemovedFromGM();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::ProcessMessage(const Message& message)
+   {
+      if (message.GetMessageType() == MessageType::TICK_LOCAL)
+      {
+         Update(static_cast<const TickMessage&>(message));
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::Update(const TickMessage& tickMessage)
+   {
+      if (mComponents.empty() || mUpdating)
+      {
+         return;
+      }
+
+      DT_TRACE_SCOPE(GetTraceName());
+      mUpdating = true;
+
+      unsigned chunkSize = mChunkSize > 0 ? mChunkSize : unsigned(mComponents.size());
+      unsigned numChunks = (unsigned(mComponents.size()) + chunkSize - 1) / chunkSize;
+      ChunkTask task(*this, tickMessage, chunkSize);
+      if (mWorkerPool.valid())
+      {
+         mWorkerPool->Run(task, numChunks);
+      }
+      else
+      {
+         for (unsigned i = 0; i < numChunks; ++i)
+         {
+            task.Run(i);
+         }
+      }
+
+      mUpdating = false;
+
+      for (unsigned i = 0; i < mPendingRemovals.size(); ++i)
+      {
+         RemoveActorComponent(*mPendingRemovals[i]);
+      }
+      mPendingRemovals.clear();
+
+      for (unsigned i = 0; i < mPendingAdds.size(); ++i)
+      {
+         ActorComponent& component = *mPendingAdds[i];
+         component.mSystemIndex = unsigned(mComponents.size());
+         mComponents.push_back(&component);
+      }
+      mPendingAdds.clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::AddActorComponent(ActorComponent& component)
+   {
+      if (component.mSystem == this)
+      {
+         // it may have been removed and added back during an update.
+         ComponentList::iterator found = std::find(mPendingRemovals.begin(), mPendingRemovals.end(), &component);
+         if (found != mPendingRemovals.end())
+         {
+            mPendingRemovals.erase(found);
+         }
+         return;
+      }
+
+      if (component.mSystem != NULL)
+      {
+         component.mSystem->RemoveActorComponent(component);
+      }
+
+      component.mSystem = this;
+      if (mUpdating)
+      {
+         // the list can't grow while the chunks are being updated.
+         component.mSystemIndex = INVALID_INDEX;
+         mPendingAdds.push_back(&component);
+         return;
+      }
+
+      component.mSystemIndex = unsigned(mComponents.size());
+      mComponents.push_back(&component);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::RemoveActorComponent(ActorComponent& component)
+   {
+      if (component.mSystem != this)
+      {
+         return;
+      }
+
+      if (component.mSystemIndex == INVALID_INDEX)
+      {
+         ComponentList::iterator found = std::find(mPendingAdds.begin(), mPendingAdds.end(), &component);
+         if (found != mPendingAdds.end())
+         {
+            mPendingAdds.erase(found);
+         }
+         component.mSystem = NULL;
+         return;
+      }
+
+      if (mUpdating)
+      {
+         if (std::find(mPendingRemovals.begin(), mPendingRemovals.end(), &component) == mPendingRemovals.end())
+         {
+            mPendingRemovals.push_back(&component);
+         }
+         return;
+      }
+
+      RemoveAt(component.mSystemIndex);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::RemoveAt(unsigned index)
+   {
+      // swap the last one into the hole so the list stays contiguous.
+      dtCore::RefPtr<ActorComponent> removed = mComponents[index];
+      if (index + 1 < mComponents.size())
+      {
+         mComponents[index] = mComponents.back();
+         mComponents[index]->mSystemIndex = index;
+      }
+      mComponents.pop_back();
+
+      removed->mSystem = NULL;
+      removed->mSystemIndex = INVALID_INDEX;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::OnAddedToGM()
+   {
+      std::vector<GameActorProxy*> proxies;
+      GetGameManager()->GetAllGameActors(proxies);
+      for (unsigned i = 0; i < proxies.size(); ++i)
+      {
+         ActorComponentBase* base = dynamic_cast<ActorComponentBase*>(proxies[i]->GetActor());
+         if (base != NULL && base->HasComponent(mComponentType))
+         {
+            AddActorComponent(*base->GetComponent(mComponentType));
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorComponentSystem::OnRemovedFromGM()
+   {
+      while (!mComponents.empty())
+      {
+         RemoveAt(unsigned(mComponents.size() - 1));
+      }
+      mPendingRemovals.clear();
+
+      for (unsigned i = 0; i < mPendingAdds.size(); ++i)
+      {
+         mPendingAdds[i]->mSystem = NULL;
+      }
+      mPendingAdds.clear();
+   }
+}
@@ -0,0 +1,496 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtgameprefix-src.h>
+#include <dtGame/actorspatialindex.h>
+
+#include <dtDAL/actorproxy.h>
+#include <dtDAL/actortype.h>
+
+#include <dtCore/transformable.h>
+#include <dtCore/transform.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dtGame
+{
+   const float ActorSpatialIndex::DEFAULT_CELL_SIZE(100.0f);
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorSpatialIndex::ActorSpatialIndex(float cellSize)
+      : mCellSize(DEFAULT_CELL_SIZE)
+      , mInvCellSize(1.0f / DEFAULT_CELL_SIZE)
+      , mDirty(false)
+      , mBoundsDirty(false)
+   {
+      SetCellSize(cellSize);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorSpatialIndex::~ActorSpatialIndex()
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::SetCellSize(float cellSize)
+   {
+      if (cellSize <= 0.0f)
+      {
+         return;
+      }
+
+      mCellSize = cellSize;
+      mInvCellSize = 1.0f / cellSize;
+
+      mCells.clear();
+      for (unsigned i = 0; i < mEntries.size(); ++i)
+      {
+         Entry& entry = mEntries[i];
+         entry.mCell = ToCell(entry.mPosition);
+         AddToCell(entry.mCell, i);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   float ActorSpatialIndex::GetCellSize() const
+   {
+      return mCellSize;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool ActorSpatialIndex::Insert(dtDAL::ActorProxy& proxy)
+   {
+      dtCore::Transformable* transformable = dynamic_cast<dtCore::Transformable*>(proxy.GetActor());
+      if (transformable == NULL)
+      {
+         return false;
+      }
+
+      if (mProxyIndices.find(&proxy) != mProxyIndices.end())
+      {
+         return true;
+      }
+
+      Entry entry;
+      entry.mProxy = &proxy;
+      entry.mTransformable = transformable;
+      entry.mTransformVersion = transformable->GetAbsoluteTransformVersion();
+      ReadPosition(entry);
+      entry.mCell = ToCell(entry.mPosition);
+
+      unsigned index = unsigned(mEntries.size());
+      mEntries.push_back(entry);
+      mProxyIndices.insert(std::make_pair(&proxy, index));
+      AddToCell(entry.mCell, index);
+      mBounds.expandBy(entry.mPosition);
+      return true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::Remove(const dtDAL::ActorProxy& proxy)
+   {
+      ProxyIndexMap::iterator found = mProxyIndices.find(&proxy);
+      if (found == mProxyIndices.end())
+      {
+         return;
+      }
+
+      unsigned index = found->second;
+      mProxyIndices.erase(found);
+      RemoveFromCell(mEntries[index].mCell, index);
+
+      // Fill the hole with the last entry so the entries stay contiguous.
+      unsigned lastIndex = unsigned(mEntries.size() - 1);
+      if (index != lastIndex)
+      {
+         Entry& moved = mEntries[lastIndex];
+         ReplaceInCell(moved.mCell, lastIndex, index);
+         mProxyIndices[moved.mProxy] = index;
+         mEntries[index] = moved;
+      }
+      mEntries.pop_back();
+      mBoundsDirty = true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::Clear()
+   {
+      mEntries.clear();
+      mCells.clear();
+      mProxyIndices.clear();
+      mBounds.init();
+      mDirty = false;
+      mBoundsDirty = false;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   size_t ActorSpatialIndex::GetNumActors() const
+   {
+      return mEntries.size();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::Invalidate()
+   {
+      mDirty = true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::Update()
+   {
+      mDirty = false;
+      for (unsigned i = 0; i < mEntries.size(); ++i)
+      {
+         Entry& entry = mEntries[i];
+         unsigned version = entry.mTransformable->GetAbsoluteTransformVersion();
+         if (version == entry.mTransformVersion)
+         {
+            continue;
+         }
+
+         entry.mTransformVersion = version;
+         osg::Vec3 oldPosition = entry.mPosition;
+         ReadPosition(entry);
+         if (entry.mPosition == oldPosition)
+         {
+            continue;
+         }
+         mBoundsDirty = true;
+
+         CellCoord newCell = ToCell(entry.mPosition);
+         if (newCell != entry.mCell)
+         {
+            RemoveFromCell(entry.mCell, i);
+            entry.mCell = newCell;
+            AddToCell(newCell, i);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   static int ToCellCoordinate(float value, float invCellSize)
+   {
+      // clamp so that huge query extents can't overflow the int conversion.
+      const float maxCoord = float(1 << 30);
+      float scaled = std::floor(value * invCellSize);
+      return int(std::max(-maxCoord, std::min(maxCoord, scaled)));
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   ActorSpatialIndex::CellCoord ActorSpatialIndex::ToCell(const osg::Vec3& pos) const
+   {
+      CellCoord result;
+      result.x = ToCellCoordinate(pos.x(), mInvCellSize);
+      result.y = ToCellCoordinate(pos.y(), mInvCellSize);
+      result.z = ToCellCoordinate(pos.z(), mInvCellSize);
+      return result;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::ReadPosition(Entry& entry) const
+   {
+      dtCore::Transform xform;
+      entry.mTransformable->GetTransform(xform, dtCore::Transformable::ABS_CS);
+      xform.GetTranslation(entry.mPosition);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::UpdateBounds()
+   {
+      if (!mBoundsDirty)
+      {
+         return;
+      }
+
+      mBoundsDirty = false;
+      mBounds.init();
+      for (unsigned i = 0; i < mEntries.size(); ++i)
+      {
+         mBounds.expandBy(mEntries[i].mPosition);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::AddToCell(const CellCoord& cell, unsigned entryIndex)
+   {
+      mCells[cell].push_back(entryIndex);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::RemoveFromCell(const CellCoord& cell, unsigned entryIndex)
+   {
+      CellMap::iterator found = mCells.find(cell);
+      if (found == mCells.end())
+      {
+         return;
+      }
+
+      IndexList& indices = found->second;
+      IndexList::iterator i = std::find(indices.begin(), indices.end(), entryIndex);
+      if (i != indices.end())
+      {
+         *i = indices.back();
+         indices.pop_back();
+      }
+
+      if (indices.empty())
+      {
+         mCells.erase(found);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::ReplaceInCell(const CellCoord& cell, unsigned oldIndex, unsigned newIndex)
+   {
+      CellMap::iterator found = mCells.find(cell);
+      if (found != mCells.end())
+      {
+         std::replace(found->second.begin(), found->second.end(), oldIndex, newIndex);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   template <typename EntryFunc>
+   void ActorSpatialIndex::VisitCells(const CellCoord& minCell, const CellCoord& maxCell, EntryFunc& func)
+   {
+      double numCellsInRange = double(maxCell.x - minCell.x + 1) *
+               double(maxCell.y - minCell.y + 1) * double(maxCell.z - minCell.z + 1);
+
+      if (numCellsInRange > double(mCells.size()))
+      {
+         // The query covers more cells than are occupied, so walk the occupied ones instead.
+         for (CellMap::iterator i = mCells.begin(); i != mCells.end(); ++i)
+         {
+            const CellCoord& c = i->first;
+            if (c.x < minCell.x || c.x > maxCell.x ||
+                c.y < minCell.y || c.y > maxCell.y ||
+                c.z < minCell.z || c.z > maxCell.z)
+            {
+               continue;
+            }
+
+            const IndexList& indices = i->second;
+            for (unsigned j = 0; j < indices.size(); ++j)
+            {
+               func(mEntries[indices[j]]);
+            }
+         }
+         return;
+      }
+
+      CellCoord c;
+      for (c.x = minCell.x; c.x <= maxCell.x; ++c.x)
+      {
+         for (c.y = minCell.y; c.y <= maxCell.y; ++c.y)
+         {
+            for (c.z = minCell.z; c.z <= maxCell.z; ++c.z)
+            {
+               CellMap::iterator found = mCells.find(c);
+               if (found == mCells.end())
+               {
+                  continue;
+               }
+
+               const IndexList& indices = found->second;
+               for (unsigned j = 0; j < indices.size(); ++j)
+               {
+                  func(mEntries[indices[j]]);
+               }
+            }
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      bool TypeMatches(const dtDAL::ActorProxy& proxy, const dtDAL::ActorType* type)
+      {
+         return type == NULL || proxy.GetActorType().InstanceOf(*type);
+      }
+
+      typedef std::pair<float, dtDAL::ActorProxy*> DistanceProxyPair;
+
+      struct DistanceLess
+      {
+         bool operator()(const DistanceProxyPair& lhs, const DistanceProxyPair& rhs) const
+         {
+            return lhs.first < rhs.first;
+         }
+      };
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   template <typename EntryType>
+   class SphereCollector
+   {
+   public:
+      SphereCollector(const osg::Vec3& center, float radius, const dtDAL::ActorType* type,
+               std::vector<DistanceProxyPair>& result)
+         : mCenter(center)
+         , mRadius2(radius * radius)
+         , mType(type)
+         , mResult(result)
+      {
+      }
+
+      void operator()(const EntryType& entry)
+      {
+         float dist2 = (entry.mPosition - mCenter).length2();
+         if (dist2 <= mRadius2 && TypeMatches(*entry.mProxy, mType))
+         {
+            mResult.push_back(std::make_pair(dist2, entry.mProxy));
+         }
+      }
+
+   private:
+      osg::Vec3 mCenter;
+      float mRadius2;
+      const dtDAL::ActorType* mType;
+      std::vector<DistanceProxyPair>& mResult;
+   };
+
+   ///////////////////////////////////////////////////////////////////////////////
+   template <typename EntryType>
+   class BoxCollector
+   {
+   public:
+      BoxCollector(const osg::BoundingBox& box, const dtDAL::ActorType* type,
+               std::vector<dtDAL::ActorProxy*>& result)
+         : mBox(box)
+         , mType(type)
+         , mResult(result)
+      {
+      }
+
+      void operator()(const EntryType& entry)
+      {
+         if (mBox.contains(entry.mPosition) && TypeMatches(*entry.mProxy, mType))
+         {
+            mResult.push_back(entry.mProxy);
+         }
+      }
+
+   private:
+      const osg::BoundingBox& mBox;
+      const dtDAL::ActorType* mType;
+      std::vector<dtDAL::ActorProxy*>& mResult;
+   };
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::FindWithinRadius(const osg::Vec3& center, float radius,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type)
+   {
+      toFill.clear();
+      if (mDirty)
+      {
+         Update();
+      }
+
+      if (radius < 0.0f || mEntries.empty())
+      {
+         return;
+      }
+
+      std::vector<DistanceProxyPair> found;
+      osg::Vec3 extent(radius, radius, radius);
+      SphereCollector<Entry> collector(center, radius, type, found);
+      VisitCells(ToCell(center - extent), ToCell(center + extent), collector);
+
+      toFill.reserve(found.size());
+      for (unsigned i = 0; i < found.size(); ++i)
+      {
+         toFill.push_back(found[i].second);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::FindWithinBox(const osg::BoundingBox& box,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type)
+   {
+      toFill.clear();
+      if (mDirty)
+      {
+         Update();
+      }
+
+      if (!box.valid() || mEntries.empty())
+      {
+         return;
+      }
+
+      BoxCollector<Entry> collector(box, type, toFill);
+      VisitCells(ToCell(box._min), ToCell(box._max), collector);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void ActorSpatialIndex::FindNearest(const osg::Vec3& center, unsigned count, float maxRadius,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type)
+   {
+      toFill.clear();
+      if (mDirty)
+      {
+         Update();
+      }
+
+      if (count == 0 || maxRadius < 0.0f || mEntries.empty())
+      {
+         return;
+      }
+
+      // No actor is farther away than the farthest corner of the bounds, so searching past that is pointless.
+      UpdateBounds();
+      float farthest2 = 0.0f;
+      for (unsigned i = 0; i < 8; ++i)
+      {
+         farthest2 = std::max(farthest2, (mBounds.corner(i) - center).length2());
+      }
+      float limit = std::min(maxRadius, std::sqrt(farthest2));
+
+      // Grow the search sphere until it holds enough actors.  Any actor closer than the
+      // k-th one found must also be inside the sphere, so the result is exact.
+      std::vector<DistanceProxyPair> found;
+      float radius = std::min(mCellSize, limit);
+      while (true)
+      {
+         found.clear();
+         osg::Vec3 extent(radius, radius, radius);
+         SphereCollector<Entry> collector(center, radius, type, found);
+         VisitCells(ToCell(center - extent), ToCell(center + extent), collector);
+
+         if (found.size() >= count || radius >= limit)
+         {
+            break;
+         }
+         radius = std::min(radius * 2.0f, limit);
+      }
+
+      unsigned numResults = std::min(count, unsigned(found.size()));
+      std::partial_sort(found.begin(), found.begin() + numResults, found.end(), DistanceLess());
+
+      toFill.reserve(numResults);
+      for (unsigned i = 0; i < numResults; ++i)
+      {
+         toFill.push_back(found[i].second);
+      }
+   }
+}
@@ -36,11 +36,18 @@ namespace dtGame
 
    /////////////////////////////////////////////////////////////////
    ActorUpdateMessage::ActorUpdateMessage() : Message() 
-   {
-      AddParameter(new StringMessageParameter(NAME_PARAMETER));
-      AddParameter(new StringMessageParameter(ACTOR_TYPE_NAME_PARAMETER));
-      AddParameter(new StringMessageParameter(ACTOR_TYPE_CATEGORY_PARAMETER));
-      AddParameter(new StringMessageParameter(PROTOTYPE_NAME_PARAMETER));
+      , mParameterHandleType(NULL)
+      , mParameterHandleRevision(0)
+      , mParameterHandlesComplete(false)
+   {
+      mName = new StringMessageParameter(NAME_PARAMETER);
+      mActorTypeName = new StringMessageParameter(ACTOR_TYPE_NAME_PARAMETER);
+      mActorTypeCategory = new StringMessageParameter(ACTOR_TYPE_CATEGORY_PARAMETER);
+      mPrototypeName = new StringMessageParameter(PROTOTYPE_NAME_PARAMETER);
+      AddParameter(mName);
+      AddParameter(mActorTypeName);
+      AddParameter(mActorTypeCategory);
+      AddParameter(mPrototypeName);
       mUpdateParameters = new GroupMessageParameter(UPDATE_GROUP_PARAMETER);
       AddParameter(mUpdateParameters);
    }
@@ -54,37 +61,37 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    const std::string& ActorUpdateMessage::GetName() const
    {
-      return static_cast<const StringMessageParameter*>(GetParameter(NAME_PARAMETER))->GetValue();
+      return mName->GetValue();
    }
 
    /////////////////////////////////////////////////////////////////
    void ActorUpdateMessage::SetName(const std::string& newName)
    {
-      static_cast<StringMessageParameter*>(GetParameter(NAME_PARAMETER))->SetValue(newName);
+      mName->SetValue(newName);
    }
 
    /////////////////////////////////////////////////////////////////
    const std::string& ActorUpdateMessage::GetActorTypeName() const
    {
-      return static_cast<const StringMessageParameter*>(GetParameter(ACTOR_TYPE_NAME_PARAMETER))->GetValue();
+      return mActorTypeName->GetValue();
    }
    
    /////////////////////////////////////////////////////////////////
    void ActorUpdateMessage::SetActorTypeName(const std::string& newTypeName)
    {
-      static_cast<StringMessageParameter*>(GetParameter(ACTOR_TYPE_NAME_PARAMETER))->SetValue(newTypeName);
+      mActorTypeName->SetValue(newTypeName);
    }
 
    /////////////////////////////////////////////////////////////////
    const std::string& ActorUpdateMessage::GetActorTypeCategory() const
    {
-      return static_cast<const StringMessageParameter*>(GetParameter(ACTOR_TYPE_CATEGORY_PARAMETER))->GetValue();
+      return mActorTypeCategory->GetValue();
    }
 
    /////////////////////////////////////////////////////////////////
    void ActorUpdateMessage::SetActorTypeCategory(const std::string& newTypeCategory)
    {
-      static_cast<StringMessageParameter*>(GetParameter(ACTOR_TYPE_CATEGORY_PARAMETER))->SetValue(newTypeCategory);
+      mActorTypeCategory->SetValue(newTypeCategory);
    }
 
    /////////////////////////////////////////////////////////////////
@@ -118,6 +125,90 @@ namespace dtGame
       mUpdateParameters->GetParameters(toFill);
    }
 
+   /////////////////////////////////////////////////////////////////
+   void ActorUpdateMessage::SetUpdateParameterHandle(const dtDAL::ActorType& actorType, unsigned handle,
+            const MessageParameter& param)
+   {
+      if (mParameterHandleType != &actorType || !mParameterHandlesComplete)
+      {
+         mParameterHandles.clear();
+         mParameterHandleType = &actorType;
+         mParameterHandlesComplete = true;
+      }
+      mParameterHandles.push_back(std::make_pair(handle, &param));
+      mParameterHandleRevision = mUpdateParameters->GetRevision();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool ActorUpdateMessage::ResolveUpdateParameterHandles(const dtDAL::ActorType& actorType)
+   {
+      FindUpdateParameterHandles(actorType);
+      return mParameterHandlesComplete;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   const ActorUpdateMessage::ParameterHandleList& ActorUpdateMessage::FindUpdateParameterHandles(
+            const dtDAL::ActorType& actorType) const
+   {
+      if (IsParameterHandleListCurrent(actorType))
+      {
+         return mParameterHandles;
+      }
+
+      std::vector<const MessageParameter*> params;
+      GetUpdateParameters(params);
+
+      mParameterHandles.clear();
+      mParameterHandles.reserve(params.size());
+      mParameterHandleType = &actorType;
+      mParameterHandleRevision = mUpdateParameters->GetRevision();
+      mParameterHandlesComplete = true;
+
+      dtDAL::ActorType::PropertyHandleLookup lookup(actorType);
+      for (unsigned i = 0; i < params.size(); ++i)
+      {
+         unsigned handle = lookup.Find(params[i]->GetName());
+         mParameterHandlesComplete = mParameterHandlesComplete && handle != dtDAL::ActorType::INVALID_PROPERTY_HANDLE;
+         mParameterHandles.push_back(std::make_pair(handle, params[i]));
+      }
+      return mParameterHandles;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   const ActorUpdateMessage::ParameterHandleList* ActorUpdateMessage::GetUpdateParameterHandles(
+            const dtDAL::ActorType& actorType) const
+   {
+      if (!mParameterHandlesComplete || !IsParameterHandleListCurrent(actorType))
+      {
+         return NULL;
+      }
+      return &mParameterHandles;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool ActorUpdateMessage::IsParameterHandleListCurrent(const dtDAL::ActorType& actorType) const
+   {
+      // adding or removing a parameter after the last handle was set changes the revision, and
+      // removing one before leaves the list longer than the group, so a stale list is never used.
+      return mParameterHandleType == &actorType
+               && mParameterHandleRevision == mUpdateParameters->GetRevision()
+               && mParameterHandles.size() == mUpdateParameters->GetParameterCount();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void ActorUpdateMessage::CopyDataTo(Message& msg) const
+   {
+      Message::CopyDataTo(msg);
+
+      ActorUpdateMessage* updateMsg = dynamic_cast<ActorUpdateMessage*>(&msg);
+      if (updateMsg != NULL)
+      {
+         updateMsg->mParameterHandles.clear();
+         updateMsg->mParameterHandleType = NULL;
+         updateMsg->mParameterHandlesComplete = false;
+      }
+   }
+
    /////////////////////////////////////////////////////////////////
    const dtDAL::ActorType* ActorUpdateMessage::GetActorType() const
    {
@@ -134,13 +225,13 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    const std::string& ActorUpdateMessage::GetPrototypeName() const
    {
-      return static_cast<const StringMessageParameter*>(GetParameter(PROTOTYPE_NAME_PARAMETER))->GetValue();
+      return mPrototypeName->GetValue();
    }
 
    /////////////////////////////////////////////////////////////////
    void ActorUpdateMessage::SetPrototypeName(const std::string& newPrototypeName)
    {
-      static_cast<StringMessageParameter*>(GetParameter(PROTOTYPE_NAME_PARAMETER))->SetValue(newPrototypeName);
+      mPrototypeName->SetValue(newPrototypeName);
    }
 
 }
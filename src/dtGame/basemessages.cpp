@@ -100,29 +100,25 @@ namespace dtGame
 
    const std::string& TimerElapsedMessage::GetTimerName() const
    {
-      const StringMessageParameter *mp = static_cast<const StringMessageParameter*> (GetParameter("TimerName"));
-      return mp->GetValue();
+      return mTimerName->GetValue();
    }
 
    //////////////////////////////////////////////////////////////////////////////
    float TimerElapsedMessage::GetLateTime() const
    {
-      const FloatMessageParameter *mp = static_cast<const FloatMessageParameter*> (GetParameter("LateTime"));
-      return mp->GetValue();
+      return mLateTime->GetValue();
    }
 
    //////////////////////////////////////////////////////////////////////////////
    void TimerElapsedMessage::SetTimerName(const std::string &name)
    {
-      StringMessageParameter *mp = static_cast<StringMessageParameter*> (GetParameter("TimerName"));
-      mp->SetValue(name);
+      mTimerName->SetValue(name);
    }
 
    //////////////////////////////////////////////////////////////////////////////
    void TimerElapsedMessage::SetLateTime(float newTime)
    {
-      FloatMessageParameter *mp = static_cast<FloatMessageParameter*> (GetParameter("LateTime"));
-      mp->SetValue(newTime);
+      mLateTime->SetValue(newTime);
    }
 
    //////////////////////////////////////////////////////////////////////////////
@@ -170,6 +166,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////////////
 
    const dtUtil::RefString MapMessage::PARAM_MAP_NAMES("MapNames");
+   const dtUtil::RefString MapMessage::PARAM_LOAD_PROGRESS("LoadProgress");
 
    class GetStringParameterFunc
    {
@@ -213,6 +210,8 @@ namespace dtGame
    {
       mMapNames = new GroupMessageParameter(PARAM_MAP_NAMES); 
       AddParameter(mMapNames.get());
+      mLoadProgress = new FloatMessageParameter(PARAM_LOAD_PROGRESS, 0.0f);
+      AddParameter(mLoadProgress.get());
    }
 
    //////////////////////////////////////////////////////////////////////////////
@@ -231,6 +230,18 @@ namespace dtGame
       std::for_each(nameVec.begin(), nameVec.end(), parameterFunc);
    }
 
+   //////////////////////////////////////////////////////////////////////////////
+   float MapMessage::GetLoadProgress() const
+   {
+      return mLoadProgress->GetValue();
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   void MapMessage::SetLoadProgress(float progress)
+   {
+      mLoadProgress->SetValue(progress);
+   }
+
    //////////////////////////////////////////////////////////////////////////////
    //////////////////////////////////////////////////////////////////////////////
 
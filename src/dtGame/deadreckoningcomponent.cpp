@@ -41,14 +41,58 @@ namespace dtGame
 {
    //////////////////////////////////////////////////////////////////////
    const std::string DeadReckoningComponent::DEFAULT_NAME("Dead Reckoning Component");
+   const unsigned DeadReckoningComponent::BATCH_CHUNK_SIZE;
+   const unsigned DeadReckoningComponent::DRBatch::INVALID_INDEX;
+
+   //////////////////////////////////////////////////////////////////////
+   class DeadReckoningComponent::BatchTask : public dtUtil::WorkerPool::Task
+   {
+   public:
+      BatchTask(DeadReckoningComponent& component, const dtGame::TickMessage& tickMessage)
+         : mComponent(component)
+         , mTickMessage(tickMessage)
+      {
+      }
+
+      virtual void Run(unsigned index)
+      {
+         DRBatch& batch = mComponent.mBatch;
+         unsigned begin = index * BATCH_CHUNK_SIZE;
+         unsigned end = std::min(begin + BATCH_CHUNK_SIZE, batch.GetSize());
+         mComponent.PrepareEntries(begin, end, mTickMessage);
+         batch.DeadReckon(begin, end);
+         batch.ApplyToHelpers(begin, end);
+         mComponent.DoDREntries(begin, end);
+      }
+
+   private:
+      DeadReckoningComponent& mComponent;
+      const dtGame::TickMessage& mTickMessage;
+   };
 
    //////////////////////////////////////////////////////////////////////
    DeadReckoningComponent::DeadReckoningComponent(const std::string& name)
       : dtGame::GMComponent(name)
       , mGroundClamper(new DefaultGroundClamper)
       , mArticSmoothTime(0.5f)
+      , mUseBatchDR(false)
+      , mOffScreenInterval(1)
+      , mOffScreenHalfAngle(60.0f)
+      , mOffScreenCos(0.5f)
+      , mUseUpdateIntervals(false)
+      , mPublishOnDRError(false)
+      , mMaxTranslationError(0.5f)
+      , mMaxRotationError(3.0f)
+      , mMaxRotationErrorCos(std::cos(osg::DegreesToRadians(1.5f)))
+      , mPublishHeartbeat(5.0f)
    {
       mLogger = &dtUtil::Log::GetInstance("deadreckoningcomponent.cpp");
+
+      mDRPropertyNames.push_back(DeadReckoningHelper::PROPERTY_LAST_KNOWN_TRANSLATION);
+      mDRPropertyNames.push_back(DeadReckoningHelper::PROPERTY_LAST_KNOWN_ROTATION);
+      mDRPropertyNames.push_back(DeadReckoningHelper::PROPERTY_VELOCITY_VECTOR);
+      mDRPropertyNames.push_back(DeadReckoningHelper::PROPERTY_ACCELERATION_VECTOR);
+      mDRPropertyNames.push_back(DeadReckoningHelper::PROPERTY_ANGULAR_VELOCITY_VECTOR);
    }
 
    //////////////////////////////////////////////////////////////////////
@@ -83,6 +127,7 @@ namespace dtGame
       }
       else if (message.GetMessageType()  == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN)
       {
+         mBatch.Clear();
          mRegisteredActors.clear();
          mGroundClamper->SetEyePointActor(NULL);
          mGroundClamper->SetTerrainActor(NULL);
@@ -131,6 +176,86 @@ namespace dtGame
       mGroundClamper = &clamper;
    }
 
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetWorkerPool(dtUtil::WorkerPool* pool)
+   {
+      mWorkerPool = pool;
+
+      DefaultGroundClamper* defaultClamper = dynamic_cast<DefaultGroundClamper*>(mGroundClamper.get());
+      if (defaultClamper != NULL)
+      {
+         defaultClamper->SetWorkerPool(pool);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetUseRayQueryTree(bool useTree)
+   {
+      DefaultGroundClamper* defaultClamper = dynamic_cast<DefaultGroundClamper*>(mGroundClamper.get());
+      if (defaultClamper != NULL)
+      {
+         defaultClamper->SetUseRayQueryTree(useTree);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   bool DeadReckoningComponent::GetUseRayQueryTree() const
+   {
+      const DefaultGroundClamper* defaultClamper = dynamic_cast<const DefaultGroundClamper*>(mGroundClamper.get());
+      return defaultClamper != NULL && defaultClamper->GetUseRayQueryTree();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::AddDistanceBand(float minDistance, unsigned updateInterval)
+   {
+      std::pair<float, unsigned> band(minDistance * minDistance, std::max(updateInterval, 1U));
+
+      DistanceBandList::iterator i = std::lower_bound(mDistanceBands.begin(), mDistanceBands.end(),
+               std::make_pair(band.first, 0U));
+      if (i != mDistanceBands.end() && i->first == band.first)
+      {
+         i->second = band.second;
+      }
+      else
+      {
+         mDistanceBands.insert(i, band);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::ClearDistanceBands()
+   {
+      mDistanceBands.clear();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   unsigned DeadReckoningComponent::GetUpdateIntervalForDistance(float distance) const
+   {
+      float distance2 = distance * distance;
+      unsigned interval = 1;
+      for (DistanceBandList::const_iterator i = mDistanceBands.begin();
+         i != mDistanceBands.end() && i->first <= distance2; ++i)
+      {
+         interval = i->second;
+      }
+      return interval;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetOffScreenUpdateInterval(unsigned updateInterval, float halfAngleDegrees)
+   {
+      mOffScreenInterval = std::max(updateInterval, 1U);
+      mOffScreenHalfAngle = halfAngleDegrees;
+      mOffScreenCos = std::cos(osg::DegreesToRadians(halfAngleDegrees));
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetMaxRotationError(float maxErrorDegrees)
+   {
+      mMaxRotationError = maxErrorDegrees;
+      mMaxRotationErrorCos = std::cos(osg::DegreesToRadians(maxErrorDegrees * 0.5f));
+   }
+
    //////////////////////////////////////////////////////////////////////
    BaseGroundClamper& DeadReckoningComponent::GetGroundClamper()
    {
@@ -155,6 +280,9 @@ namespace dtGame
             updateMode = &DeadReckoningHelper::UpdateMode::CALCULATE_AND_MOVE_ACTOR;
       }
 
+      // Spreads the full updates of actors using distance bands across ticks.
+      helper.mTicksUntilDR = unsigned(mRegisteredActors.size());
+
       if (!mRegisteredActors.insert(std::make_pair(toRegister.GetId(), &helper)).second)
       {
          throw dtUtil::Exception(ExceptionEnum::DEAD_RECKONING_EXCEPTION,
@@ -195,15 +323,18 @@ namespace dtGame
          helper.SetTranslationBeforeLastUpdate( helper.GetLastKnownTranslation() );
          helper.SetRotationBeforeLastUpdate( helper.GetLastKnownRotationByQuaternion() );
       }
+
+      mBatch.Add(helper, toRegister.GetGameActor());
    }
 
    //////////////////////////////////////////////////////////////////////
    void DeadReckoningComponent::UnregisterActor(dtGame::GameActorProxy& toRegister)
    {
-      std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningHelper> >::iterator itor;
+      HelperMap::iterator itor;
       itor = mRegisteredActors.find(toRegister.GetId());
       if (itor != mRegisteredActors.end())
       {
+         mBatch.Remove(*itor->second);
          mRegisteredActors.erase(itor);
       }
    }
@@ -211,8 +342,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////
    const DeadReckoningHelper* DeadReckoningComponent::GetHelperForProxy(dtGame::GameActorProxy &proxy) const
    {
-      std::map<dtCore::UniqueId,
-         dtCore::RefPtr<DeadReckoningHelper> >::const_iterator itor = mRegisteredActors.find(proxy.GetId());
+      HelperMap::const_iterator itor = mRegisteredActors.find(proxy.GetId());
 
       return itor == mRegisteredActors.end() ? NULL : itor->second.get();
    }
@@ -220,7 +350,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////
    bool DeadReckoningComponent::IsRegisteredActor(dtGame::GameActorProxy& gameActorProxy)
    {
-      std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningHelper> >::iterator itor;
+      HelperMap::iterator itor;
       itor = mRegisteredActors.find(gameActorProxy.GetId());
       return itor != mRegisteredActors.end();
    }
@@ -229,8 +359,21 @@ namespace dtGame
    void DeadReckoningComponent::TickRemote(const dtGame::TickMessage& tickMessage)
    {
       mGroundClamper->UpdateEyePoint();
+      mBatch.BeginTick();
 
-      for (std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningHelper> >::iterator i = mRegisteredActors.begin();
+      dtCore::Transformable* eyePointActor = mGroundClamper->GetEyePointActor();
+      mUseUpdateIntervals = eyePointActor != NULL && (!mDistanceBands.empty() || mOffScreenInterval > 1);
+      if (mUseUpdateIntervals && mOffScreenInterval > 1)
+      {
+         dtCore::Transform eyeXform;
+         eyePointActor->GetTransform(eyeXform, dtCore::Transformable::ABS_CS);
+         eyeXform.GetRow(1, mEyeForward);
+         mEyeForward.normalize();
+      }
+
+      // Finding the actors and logging stay on this thread.  Everything else about each
+      // actor until it is moved is done by PrepareEntries, in parallel if there is a pool.
+      for (HelperMap::iterator i = mRegisteredActors.begin();
          i != mRegisteredActors.end(); ++i)
       {
 
@@ -241,7 +384,6 @@ namespace dtGame
          }
 
          dtGame::GameActor& gameActor = gameActorProxy->GetGameActor();
-         DeadReckoningHelper& helper = *i->second;
 
          if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
@@ -251,14 +393,90 @@ namespace dtGame
                gameActorProxy->GetActorType().GetFullName().c_str());
          }
 
-         dtCore::Transform xform;
-         //Init the transform with the last deadreckoned position, not
-         //the current actual position, because the current actual can be clamped
-         xform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
-         xform.SetRotation(helper.GetCurrentDeadReckonedRotation());
+         mBatch.SetPending(*i->second, gameActor);
+      }
 
-         // Get the current time delta.
-         float simTimeDelta = tickMessage.GetDeltaSimTime();
+      // Dead reckon everything, in parallel if there is enough of it to be worth it.
+      // The kernel runs over every entry, which is cheaper than packing the batched ones,
+      // but only the batched entries are applied.  DoDR logs, so it stays on this thread
+      // when debug logging is on.
+      const unsigned batchSize = mBatch.GetSize();
+      mBatch.PrepareOutput();
+      BatchTask task(*this, tickMessage);
+      unsigned numChunks = (batchSize + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+      if (mWorkerPool.valid() && numChunks > 1 && !mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+      {
+         mWorkerPool->Run(task, numChunks);
+      }
+      else
+      {
+         for (unsigned i = 0; i < numChunks; ++i)
+         {
+            task.Run(i);
+         }
+      }
+
+      // Moving, clamping and articulating the actors stay on this thread, in order.
+      for (unsigned i = 0; i < batchSize; ++i)
+      {
+         const unsigned char step = mBatch.mStep[i];
+         if (step == DRBatch::STEP_NONE)
+         {
+            continue;
+         }
+
+         DeadReckoningHelper& helper = *mBatch.mHelpers[i];
+         GameActor& gameActor = *mBatch.mActors[i];
+
+         if (step == DRBatch::STEP_MOVE_BETWEEN_UPDATES)
+         {
+            MoveBetweenUpdates(helper, gameActor, tickMessage.GetDeltaSimTime());
+            continue;
+         }
+
+         bool transformChanged = mBatch.mChanged[i] != 0;
+         BaseGroundClamper::GroundClampingType& groundClampingType = *mBatch.mClampTypes[i];
+         dtCore::Transform& xform = mBatch.mTransforms[i];
+
+         if (step == DRBatch::STEP_BATCH
+             && !transformChanged
+             && helper.GetEffectiveUpdateMode(gameActor.IsRemote())
+                  == DeadReckoningHelper::UpdateMode::CALCULATE_AND_MOVE_ACTOR
+             && groundClampingType == BaseGroundClamper::GroundClampingType::NONE
+             && helper.GetDeadReckoningDOFs().empty())
+         {
+            // Nothing to clamp and nothing moved, so skip writing the same transform back
+            // unless something else has moved the actor.
+            dtCore::Transform current;
+            gameActor.GetTransform(current, dtCore::Transformable::REL_CS);
+            if (current.EpsilonEquals(xform))
+            {
+               continue;
+            }
+         }
+
+         FinishDR(helper, gameActor, xform, groundClampingType, transformChanged, tickMessage);
+      }
+
+      // Make sure all remaining queued objects for batch clamping are clamped.
+      mGroundClamper->FinishUp();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::PrepareEntries(unsigned begin, unsigned end, const dtGame::TickMessage& tickMessage)
+   {
+      // Get the current time delta.
+      float simTimeDelta = tickMessage.GetDeltaSimTime();
+
+      for (unsigned index = begin; index < end; ++index)
+      {
+         if (mBatch.mStep[index] != DRBatch::STEP_PENDING)
+         {
+            continue;
+         }
+
+         DeadReckoningHelper& helper = *mBatch.mHelpers[index];
+         GameActor& gameActor = *mBatch.mActors[index];
 
          if (helper.IsUpdated())
          {
@@ -288,45 +506,473 @@ namespace dtGame
          if (rotElapsedTime < 0.0) rotElapsedTime = 0.0f;
          helper.SetRotationElapsedTimeSinceUpdate(rotElapsedTime);
 
+         // Only actors being moved are skipped, since the other ones are not seen.
+         if (mUseUpdateIntervals && helper.GetEffectiveUpdateMode(gameActor.IsRemote())
+               == DeadReckoningHelper::UpdateMode::CALCULATE_AND_MOVE_ACTOR)
+         {
+            unsigned interval = GetUpdateInterval(helper);
+            if (interval > 1)
+            {
+               helper.mTicksUntilDR %= interval;
+               if (helper.mTicksUntilDR > 0 && !helper.IsUpdated())
+               {
+                  --helper.mTicksUntilDR;
+                  mBatch.mStep[index] = DRBatch::STEP_MOVE_BETWEEN_UPDATES;
+                  continue;
+               }
+               helper.mTicksUntilDR = interval - 1;
+            }
+         }
+
+         // The translation of the batched entities is computed all at once by the kernel.
+         if (IsBatchable(helper))
+         {
+            mBatch.Activate(index);
+            mBatch.mClampTypes[index] = &helper.GetGroundClampingType();
+            continue;
+         }
+
+         // DoDR may change the state the batch has a copy of.
+         mBatch.MarkStale(index);
+         mBatch.mStep[index] = DRBatch::STEP_DO_DR;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DoDREntries(unsigned begin, unsigned end)
+   {
+      for (unsigned index = begin; index < end; ++index)
+      {
+         if (mBatch.mStep[index] != DRBatch::STEP_DO_DR)
+         {
+            continue;
+         }
+
+         DeadReckoningHelper& helper = *mBatch.mHelpers[index];
+         dtCore::Transform& xform = mBatch.mTransforms[index];
+         //Init the transform with the last deadreckoned position, not
+         //the current actual position, because the current actual can be clamped
+         xform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
+         xform.SetRotation(helper.GetCurrentDeadReckonedRotation());
 
          // Actual dead reckoning code moved into the helper..
          BaseGroundClamper::GroundClampingType* groundClampingType = &BaseGroundClamper::GroundClampingType::NONE;
-         bool transformChanged = helper.DoDR(gameActor, xform, mLogger, groundClampingType);
+         bool transformChanged = helper.DoDR(*mBatch.mActors[index], xform, mLogger, groundClampingType);
+         mBatch.mChanged[index] = transformChanged ? 1 : 0;
+         mBatch.mClampTypes[index] = groundClampingType;
+      }
+   }
 
+   //////////////////////////////////////////////////////////////////////
+   unsigned DeadReckoningComponent::GetUpdateInterval(const DeadReckoningHelper& helper) const
+   {
+      osg::Vec3 toActor = helper.GetCurrentDeadReckonedTranslation() - mGroundClamper->GetLastEyePoint();
+      float distance = toActor.length();
+      unsigned interval = GetUpdateIntervalForDistance(distance);
 
-         // Only ground clamp and move remote objects.
-         if(helper.GetEffectiveUpdateMode(gameActor.IsRemote())
-               == DeadReckoningHelper::UpdateMode::CALCULATE_AND_MOVE_ACTOR)
+      if (mOffScreenInterval > interval && toActor * mEyeForward < mOffScreenCos * distance)
+      {
+         interval = mOffScreenInterval;
+      }
+      return interval;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::MoveBetweenUpdates(DeadReckoningHelper& helper, GameActor& gameActor, float simTimeDelta)
+   {
+      if (helper.GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::NONE
+         || helper.GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::STATIC
+         || helper.GetLastKnownVelocity().length2() < 1e-4f)
+      {
+         return;
+      }
+
+      dtCore::Transform xform;
+      gameActor.GetTransform(xform, dtCore::Transformable::REL_CS);
+      osg::Vec3 pos;
+      xform.GetTranslation(pos);
+      xform.SetTranslation(pos + helper.GetLastKnownVelocity() * simTimeDelta);
+      gameActor.SetTransform(xform, dtCore::Transformable::REL_CS);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::PublishIfOverError(DeadReckoningHelper& helper, GameActor& gameActor,
+            const dtGame::TickMessage& tickMessage)
+   {
+      dtCore::Transform actualXform;
+      gameActor.GetTransform(actualXform, dtCore::Transformable::REL_CS);
+
+      // Compare against the extrapolation without smoothing, since that is where the remote copies end up.
+      dtCore::Transform xform;
+      helper.GetExtrapolatedTransform(xform);
+
+      osg::Vec3 actualPos, drPos;
+      actualXform.GetTranslation(actualPos);
+      xform.GetTranslation(drPos);
+
+      bool publish = (actualPos - drPos).length2() > mMaxTranslationError * mMaxTranslationError;
+
+      if (!publish)
+      {
+         osg::Matrix actualRot, drRot;
+         actualXform.GetRotation(actualRot);
+         xform.GetRotation(drRot);
+         // q and -q are the same rotation, hence the abs.
+         publish = std::abs(actualRot.getRotate().asVec4() * drRot.getRotate().asVec4()) < mMaxRotationErrorCos;
+      }
+
+      if (!publish && mPublishHeartbeat > 0.0f)
+      {
+         double sinceLastPublish = tickMessage.GetSimulationTime()
+            - std::max(helper.GetLastTranslationUpdatedTime(), helper.GetLastRotationUpdatedTime());
+         publish = sinceLastPublish >= mPublishHeartbeat;
+      }
+
+      if (!publish)
+      {
+         return;
+      }
+
+      // The update times are set on the next tick, the same way they are for a remote actor.
+      osg::Vec3 actualHPR;
+      actualXform.GetRotation(actualHPR);
+      helper.SetLastKnownTranslation(actualPos);
+      helper.SetLastKnownRotation(actualHPR);
+
+      gameActor.GetGameActorProxy().NotifyPartialActorUpdate(mDRPropertyNames);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   bool DeadReckoningComponent::IsBatchable(const DeadReckoningHelper& helper) const
+   {
+      // Updated helpers need their smoothing times recalculated, and the debug
+      // logging is only done by the per entity path.
+      return mUseBatchDR && !helper.IsUpdated()
+         && (helper.GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_ONLY
+            || helper.GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION)
+         && !mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::FinishDR(DeadReckoningHelper& helper, GameActor& gameActor,
+            dtCore::Transform& xform, BaseGroundClamper::GroundClampingType& groundClampingType,
+            bool transformChanged, const dtGame::TickMessage& tickMessage)
+   {
+      // Only ground clamp and move remote objects.
+      if(helper.GetEffectiveUpdateMode(gameActor.IsRemote())
+            == DeadReckoningHelper::UpdateMode::CALCULATE_AND_MOVE_ACTOR)
+      {
+         // Get the object's velocity for the current frame.
+         osg::Vec3 velocity( helper.GetLastKnownVelocity() + helper.GetLastKnownAcceleration() * tickMessage.GetDeltaSimTime() );
+
+         // Call the ground clamper for the current object.
+         // The ground clamper should be smart enough to know
+         // what to do with the supplied values.
+         mGroundClamper->ClampToGround(groundClampingType, tickMessage.GetSimulationTime(),
+                  xform, gameActor.GetGameActorProxy(),
+                  helper.GetGroundClampingData(), transformChanged, velocity);
+
+         if(mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
-            // Get the object's velocity for the current frame.
-            osg::Vec3 velocity( helper.GetLastKnownVelocity() + helper.GetLastKnownAcceleration() * simTimeDelta );
+            std::ostringstream ss;
+            ss << "Actor " << gameActor.GetUniqueId() << " - " << gameActor.GetName() << " has attitude "
+               << "\"" << helper.GetCurrentDeadReckonedRotation() << "\" and position \"" << helper.GetCurrentDeadReckonedTranslation() << "\" at time "
+               << helper.GetLastRotationUpdatedTime() +  helper.GetRotationElapsedTimeSinceUpdate() << "";
+            mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
+                  ss.str().c_str());
+         }
+      }
+      else if (mPublishOnDRError && !gameActor.IsRemote() && gameActor.GetGameActorProxy().IsPublished())
+      {
+         PublishIfOverError(helper, gameActor, tickMessage);
+      }
 
-            // Call the ground clamper for the current object.
-            // The ground clamper should be smart enough to know
-            // what to do with the supplied values.
-            mGroundClamper->ClampToGround(*groundClampingType, tickMessage.GetSimulationTime(),
-                     xform, gameActor.GetGameActorProxy(),
-                     helper.GetGroundClampingData(), transformChanged, velocity);
+      DoArticulation(helper, gameActor, tickMessage);
 
-            if(mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-            {
-               std::ostringstream ss;
-               ss << "Actor " << gameActor.GetUniqueId() << " - " << gameActor.GetName() << " has attitude "
-                  << "\"" << helper.GetCurrentDeadReckonedRotation() << "\" and position \"" << helper.GetCurrentDeadReckonedTranslation() << "\" at time "
-                  << helper.GetLastRotationUpdatedTime() +  helper.GetRotationElapsedTimeSinceUpdate() << "";
-               mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                     ss.str().c_str());
-            }
+      // Clear the updated flag.
+      helper.ClearUpdated();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::Clear()
+   {
+      for (size_t i = 0; i < mHelpers.size(); ++i)
+      {
+         mHelpers[i]->mBatchIndex = INVALID_INDEX;
+      }
+
+      mHelpers.clear();
+      mActors.clear();
+      mLastTranslation.Clear();
+      mTransBeforeLastUpdate.Clear();
+      mCurrentTranslation.Clear();
+      mVelocity.Clear();
+      mVelocityBeforeLastUpdate.Clear();
+      mAcceleration.Clear();
+      mAngularVelocity.Clear();
+      mElapsedTime.clear();
+      mEndSmoothingTime.clear();
+      mRotationResolved.clear();
+      mStep.clear();
+      mStale.clear();
+      mResult.Clear();
+      mChanged.clear();
+      mTransforms.clear();
+      mClampTypes.clear();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::Add(DeadReckoningHelper& helper, GameActor& gameActor)
+   {
+      if (helper.mBatchIndex != INVALID_INDEX)
+      {
+         Remove(helper);
+      }
+
+      helper.mBatchIndex = GetSize();
+      mHelpers.push_back(&helper);
+      mActors.push_back(&gameActor);
+
+      const osg::Vec3 zero;
+      mLastTranslation.PushBack(zero);
+      mTransBeforeLastUpdate.PushBack(zero);
+      mCurrentTranslation.PushBack(zero);
+      mVelocity.PushBack(zero);
+      mVelocityBeforeLastUpdate.PushBack(zero);
+      mAcceleration.PushBack(zero);
+      mAngularVelocity.PushBack(zero);
+      mElapsedTime.push_back(0.0f);
+      mEndSmoothingTime.push_back(0.0f);
+      mRotationResolved.push_back(0);
+      mStep.push_back(STEP_BATCH);
+      mStale.push_back(0);
+
+      CopyState(helper.mBatchIndex, helper);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::Remove(DeadReckoningHelper& helper)
+   {
+      const unsigned i = helper.mBatchIndex;
+      if (i >= GetSize() || mHelpers[i] != &helper)
+      {
+         return;
+      }
+
+      const unsigned last = GetSize() - 1;
+      mHelpers[last]->mBatchIndex = i;
+      helper.mBatchIndex = INVALID_INDEX;
+
+      mHelpers[i] = mHelpers[last];
+      mHelpers.pop_back();
+      mActors[i] = mActors[last];
+      mActors.pop_back();
+      mLastTranslation.RemoveBySwap(i);
+      mTransBeforeLastUpdate.RemoveBySwap(i);
+      mCurrentTranslation.RemoveBySwap(i);
+      mVelocity.RemoveBySwap(i);
+      mVelocityBeforeLastUpdate.RemoveBySwap(i);
+      mAcceleration.RemoveBySwap(i);
+      mAngularVelocity.RemoveBySwap(i);
+      mElapsedTime[i] = mElapsedTime[last];
+      mElapsedTime.pop_back();
+      mEndSmoothingTime[i] = mEndSmoothingTime[last];
+      mEndSmoothingTime.pop_back();
+      mRotationResolved[i] = mRotationResolved[last];
+      mRotationResolved.pop_back();
+      mStep[i] = mStep[last];
+      mStep.pop_back();
+      mStale[i] = mStale[last];
+      mStale.pop_back();
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::BeginTick()
+   {
+      mStep.assign(mStep.size(), STEP_NONE);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::SetPending(DeadReckoningHelper& helper, GameActor& gameActor)
+   {
+      if (helper.mBatchIndex >= GetSize() || mHelpers[helper.mBatchIndex] != &helper)
+      {
+         Add(helper, gameActor);
+      }
+
+      mActors[helper.mBatchIndex] = &gameActor;
+      mStep[helper.mBatchIndex] = STEP_PENDING;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::Activate(unsigned i)
+   {
+      DeadReckoningHelper& helper = *mHelpers[i];
+      if (mStale[i] != 0)
+      {
+         CopyState(i, helper);
+         mStale[i] = 0;
+      }
+      else
+      {
+         mCurrentTranslation.Set(i, helper.GetCurrentDeadReckonedTranslation());
+         mElapsedTime[i] = helper.GetTranslationElapsedTimeSinceUpdate();
+         mRotationResolved[i] = helper.IsRotationResolved() ? 1 : 0;
+      }
+
+      mStep[i] = STEP_BATCH;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::MarkStale(unsigned i)
+   {
+      mStale[i] = 1;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::CopyState(unsigned i, DeadReckoningHelper& helper)
+   {
+      mLastTranslation.Set(i, helper.GetLastKnownTranslation());
+      mTransBeforeLastUpdate.Set(i, helper.GetTranslationBeforeLastUpdate());
+      mCurrentTranslation.Set(i, helper.GetCurrentDeadReckonedTranslation());
+      mVelocity.Set(i, helper.GetLastKnownVelocity());
+      mVelocityBeforeLastUpdate.Set(i, helper.GetVelocityBeforeLastUpdate());
+
+      // Zeroing these for velocity only lets the kernel treat both algorithms the same way.
+      if (helper.GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION)
+      {
+         mAcceleration.Set(i, helper.GetLastKnownAcceleration());
+         mAngularVelocity.Set(i, helper.GetLastKnownAngularVelocity());
+      }
+      else
+      {
+         mAcceleration.Set(i, osg::Vec3());
+         mAngularVelocity.Set(i, osg::Vec3());
+      }
+
+      mElapsedTime[i] = helper.GetTranslationElapsedTimeSinceUpdate();
+      mEndSmoothingTime[i] = helper.GetTranslationEndSmoothingTime();
+      mRotationResolved[i] = helper.IsRotationResolved() ? 1 : 0;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   // Extrapolates one axis for all the batched entities.  This is the same math as
+   // DeadReckoningHelper::DeadReckonThePosition, written without branches other than
+   // selects so the compiler can vectorize it.
+   static void DeadReckonAxis(unsigned size, const float* last, const float* before,
+            const float* velocity, const float* velocityBefore, const float* acceleration,
+            const float* elapsed, const float* endSmoothing, float* result)
+   {
+      for (unsigned i = 0; i < size; ++i)
+      {
+         const float t = elapsed[i];
+         const float endTime = endSmoothing[i];
+         const float accelerationEffect = (acceleration[i] * 0.5f) * (t * t);
+
+         // Blend the velocity over a fraction of the translation smoothing time.
+         const float velBlendTime = endTime / 3.0f;
+         const bool blendVelocity = velBlendTime > 0.0f && t < velBlendTime;
+         const float velFactor = blendVelocity ? t / velBlendTime : 1.0f;
+         const float blendedVelocity = blendVelocity ?
+                  velocityBefore[i] * (1.0f - velFactor) + velocity[i] * velFactor : velocity[i];
+
+         const float drPos = last[i] + (velocity[i] * t + accelerationEffect);
+         const float blendedPos = before[i] + (blendedVelocity * t + accelerationEffect);
+
+         const bool smooth = endTime > 0.0f && t < endTime;
+         const float smoothingFactor = smooth ? t / endTime : 1.0f;
+         result[i] = smooth ? blendedPos + (drPos - blendedPos) * smoothingFactor : drPos;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::PrepareOutput()
+   {
+      const unsigned size = GetSize();
+      mResult.mX.resize(size);
+      mResult.mY.resize(size);
+      mResult.mZ.resize(size);
+      mChanged.resize(size);
+      mTransforms.resize(size);
+      mClampTypes.resize(size, &BaseGroundClamper::GroundClampingType::NONE);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::DeadReckon(unsigned begin, unsigned end)
+   {
+      if (begin >= end)
+      {
+         return;
+      }
+
+      const unsigned size = end - begin;
+
+      DeadReckonAxis(size, &mLastTranslation.mX[begin], &mTransBeforeLastUpdate.mX[begin],
+               &mVelocity.mX[begin], &mVelocityBeforeLastUpdate.mX[begin], &mAcceleration.mX[begin],
+               &mElapsedTime[begin], &mEndSmoothingTime[begin], &mResult.mX[begin]);
+      DeadReckonAxis(size, &mLastTranslation.mY[begin], &mTransBeforeLastUpdate.mY[begin],
+               &mVelocity.mY[begin], &mVelocityBeforeLastUpdate.mY[begin], &mAcceleration.mY[begin],
+               &mElapsedTime[begin], &mEndSmoothingTime[begin], &mResult.mY[begin]);
+      DeadReckonAxis(size, &mLastTranslation.mZ[begin], &mTransBeforeLastUpdate.mZ[begin],
+               &mVelocity.mZ[begin], &mVelocityBeforeLastUpdate.mZ[begin], &mAcceleration.mZ[begin],
+               &mElapsedTime[begin], &mEndSmoothingTime[begin], &mResult.mZ[begin]);
+
+      // Same tests DeadReckoningHelper::DRVelocityAcceleration uses to decide if any work is needed.
+      const float* lastX = &mLastTranslation.mX[begin];
+      const float* lastY = &mLastTranslation.mY[begin];
+      const float* lastZ = &mLastTranslation.mZ[begin];
+      const float* curX = &mCurrentTranslation.mX[begin];
+      const float* curY = &mCurrentTranslation.mY[begin];
+      const float* curZ = &mCurrentTranslation.mZ[begin];
+      const float* velX = &mVelocity.mX[begin];
+      const float* velY = &mVelocity.mY[begin];
+      const float* velZ = &mVelocity.mZ[begin];
+      const float* accX = &mAcceleration.mX[begin];
+      const float* accY = &mAcceleration.mY[begin];
+      const float* accZ = &mAcceleration.mZ[begin];
+      const float* angX = &mAngularVelocity.mX[begin];
+      const float* angY = &mAngularVelocity.mY[begin];
+      const float* angZ = &mAngularVelocity.mZ[begin];
+      const unsigned char* rotationResolved = &mRotationResolved[begin];
+      unsigned char* changed = &mChanged[begin];
+
+      for (unsigned i = 0; i < size; ++i)
+      {
+         const bool moved = lastX[i] != curX[i] || lastY[i] != curY[i] || lastZ[i] != curZ[i];
+         const float vel2 = velX[i] * velX[i] + velY[i] * velY[i] + velZ[i] * velZ[i];
+         const float acc2 = accX[i] * accX[i] + accY[i] * accY[i] + accZ[i] * accZ[i];
+         const float ang2 = angX[i] * angX[i] + angY[i] * angY[i] + angZ[i] * angZ[i];
+         changed[i] = (moved || rotationResolved[i] == 0 || vel2 > 1e-2f || acc2 > 1e-2f || ang2 > 1e-5f) ? 1 : 0;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DRBatch::ApplyToHelpers(unsigned begin, unsigned end)
+   {
+      for (unsigned i = begin; i < end; ++i)
+      {
+         if (mStep[i] != STEP_BATCH)
+         {
+            continue;
          }
 
-         DoArticulation(helper, gameActor, tickMessage);
+         DeadReckoningHelper& helper = *mHelpers[i];
+         dtCore::Transform& xform = mTransforms[i];
+         xform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
+         xform.SetRotation(helper.GetCurrentDeadReckonedRotation());
 
-         // Clear the updated flag.
-         helper.ClearUpdated();
+         if (mChanged[i] != 0)
+         {
+            helper.ApplyBatchDeadReckoning(xform, mResult.Get(i));
+         }
       }
+   }
 
-      // Make sure all remaining queued objects for batch clamping are clamped.
-      mGroundClamper->FinishUp();
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DeadReckonBatch(DRBatch& batch)
+   {
+      batch.PrepareOutput();
+      batch.DeadReckon(0, batch.GetSize());
    }
 
    void DeadReckoningComponent::DoArticulation(dtGame::DeadReckoningHelper& helper,
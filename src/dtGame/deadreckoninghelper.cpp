@@ -42,6 +42,14 @@ namespace dtGame
    const float DeadReckoningHelper::DEFAULT_MAX_SMOOTHING_TIME_ROT = 2.0f;
    const float DeadReckoningHelper::DEFAULT_MAX_SMOOTHING_TIME_POS = 8.0f;
 
+   const dtUtil::RefString DeadReckoningHelper::PROPERTY_LAST_KNOWN_TRANSLATION("Last Known Translation");
+   const dtUtil::RefString DeadReckoningHelper::PROPERTY_LAST_KNOWN_ROTATION("Last Known Rotation");
+   // Note - the member vars were changed to LastKnownXYZ, but the properties were left the same
+   // so as to not break MANY maps in production.
+   const dtUtil::RefString DeadReckoningHelper::PROPERTY_VELOCITY_VECTOR("Velocity Vector");
+   const dtUtil::RefString DeadReckoningHelper::PROPERTY_ACCELERATION_VECTOR("Acceleration Vector");
+   const dtUtil::RefString DeadReckoningHelper::PROPERTY_ANGULAR_VELOCITY_VECTOR("Angular Velocity Vector");
+
    const std::string DeadReckoningHelper::DeadReckoningDOF::REPRESENATION_POSITION("Position");
    const std::string DeadReckoningHelper::DeadReckoningDOF::REPRESENATION_POSITIONRATE("PositionRate");
    const std::string DeadReckoningHelper::DeadReckoningDOF::REPRESENATION_EXTENSION("Extension");
@@ -80,6 +88,8 @@ namespace dtGame
       mRotationEndSmoothingTime(0.0f),
       mMinDRAlgorithm(&DeadReckoningAlgorithm::NONE),
       mUpdateMode(&DeadReckoningHelper::UpdateMode::AUTO),
+      mTicksUntilDR(0),
+      mBatchIndex(DeadReckoningComponent::DRBatch::INVALID_INDEX),
       mTranslationInitiated(false),
       mRotationInitiated(false),
       mUpdated(false),
@@ -212,7 +222,7 @@ namespace dtGame
    }
 
    //////////////////////////////////////////////////////////////////////
-   void DeadReckoningHelper::ComputeRotationChangeWithAngularVelocity(double deltaTime, osg::Matrix& result)
+   void DeadReckoningHelper::ComputeRotationChangeWithAngularVelocity(double deltaTime, osg::Matrix& result) const
    {
       //mComputedAngularRotationMatrix
       if (mAngularVelocityVector.length2() < 1e-6)
@@ -426,33 +436,33 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////////////////////
    void DeadReckoningHelper::GetActorProperties(std::vector<dtCore::RefPtr<dtDAL::ActorProperty> >& pFillVector)
    {
-      pFillVector.push_back(new dtDAL::Vec3ActorProperty("Last Known Translation", "Last Known Translation",
+      pFillVector.push_back(new dtDAL::Vec3ActorProperty(PROPERTY_LAST_KNOWN_TRANSLATION, "Last Known Translation",
          dtDAL::Vec3ActorProperty::SetFuncType(this, &DeadReckoningHelper::SetLastKnownTranslation),
          dtDAL::Vec3ActorProperty::GetFuncType(this, &DeadReckoningHelper::GetLastKnownTranslation),
          "Sets the last know position of this Entity", "Dead Reckoning"));
 
-      pFillVector.push_back(new dtDAL::Vec3ActorProperty("Last Known Rotation", "Last Known Rotation",
+      pFillVector.push_back(new dtDAL::Vec3ActorProperty(PROPERTY_LAST_KNOWN_ROTATION, "Last Known Rotation",
          dtDAL::Vec3ActorProperty::SetFuncType(this, &DeadReckoningHelper::SetLastKnownRotation),
          dtDAL::Vec3ActorProperty::GetFuncType(this, &DeadReckoningHelper::GetLastKnownRotation),
          "Sets the last known rotation of this Entity","Dead Reckoning"));
 
       // Note - the member vars were changed to LastKnownXYZ, but the properties were left the same
       // so as to not break MANY maps in production.
-      pFillVector.push_back(new dtDAL::Vec3ActorProperty("Velocity Vector", "Velocity Vector",
+      pFillVector.push_back(new dtDAL::Vec3ActorProperty(PROPERTY_VELOCITY_VECTOR, "Velocity Vector",
          dtDAL::Vec3ActorProperty::SetFuncType(this, &DeadReckoningHelper::SetLastKnownVelocity),
          dtDAL::Vec3ActorProperty::GetFuncType(this, &DeadReckoningHelper::GetLastKnownVelocity),
          "Sets the last known velocity vector of this Entity", "Dead Reckoning"));
 
       // Note - the member vars were changed to LastKnownXYZ, but the properties were left the same
       // so as to not break MANY maps in production.
-      pFillVector.push_back(new dtDAL::Vec3ActorProperty("Acceleration Vector", "Acceleration Vector",
+      pFillVector.push_back(new dtDAL::Vec3ActorProperty(PROPERTY_ACCELERATION_VECTOR, "Acceleration Vector",
          dtDAL::Vec3ActorProperty::SetFuncType(this, &DeadReckoningHelper::SetLastKnownAcceleration),
          dtDAL::Vec3ActorProperty::GetFuncType(this, &DeadReckoningHelper::GetLastKnownAcceleration),
          "Sets the last known acceleration vector of this Entity", "Dead Reckoning"));
 
       // Note - the member vars were changed to LastKnownXYZ, but the properties were left the same
       // so as to not break MANY maps in production.
-      pFillVector.push_back(new dtDAL::Vec3ActorProperty("Angular Velocity Vector", "Angular Velocity Vector",
+      pFillVector.push_back(new dtDAL::Vec3ActorProperty(PROPERTY_ANGULAR_VELOCITY_VECTOR, "Angular Velocity Vector",
          dtDAL::Vec3ActorProperty::SetFuncType(this, &DeadReckoningHelper::SetLastKnownAngularVelocity),
          dtDAL::Vec3ActorProperty::GetFuncType(this, &DeadReckoningHelper::GetLastKnownAngularVelocity),
          "Sets the last known angular velocity vector of this Entity", "Dead Reckoning"));
@@ -488,12 +498,7 @@ namespace dtGame
          dtUtil::Log* pLogger, BaseGroundClamper::GroundClampingType*& gcType)
    {
       bool returnValue = false; // indicates we changed the transform
-      if (IsFlying())
-         gcType = &BaseGroundClamper::GroundClampingType::NONE;
-      else if (GetGroundClampingData().GetAdjustRotationToGround())
-         gcType = &BaseGroundClamper::GroundClampingType::RANGED;
-      else
-         gcType = &BaseGroundClamper::GroundClampingType::INTERMITTENT_SAVE_OFFSET;
+      gcType = &GetGroundClampingType();
 
       if (GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::NONE)
       {
@@ -521,6 +526,53 @@ namespace dtGame
       return returnValue;
    }
 
+   /////////////////////////////////////////////////////////////////////////////////
+   void DeadReckoningHelper::GetExtrapolatedTransform(dtCore::Transform& xform) const
+   {
+      osg::Vec3 pos = mLastTranslation;
+      osg::Quat rot = mLastQuatRotation;
+
+      if (GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_ONLY
+         || GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION)
+      {
+         float t = mTranslationElapsedTimeSinceUpdate;
+         pos += mLastVelocity * t;
+
+         if (GetDeadReckoningAlgorithm() == DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION)
+         {
+            pos += (mAccelerationVector * 0.5f) * (t * t);
+
+            osg::Matrix angularRotation;
+            ComputeRotationChangeWithAngularVelocity(mRotationElapsedTimeSinceUpdate, angularRotation);
+            rot = angularRotation.getRotate() * mLastQuatRotation;
+         }
+      }
+
+      xform.SetTranslation(pos);
+      xform.SetRotation(rot);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   BaseGroundClamper::GroundClampingType& DeadReckoningHelper::GetGroundClampingType() const
+   {
+      if (IsFlying())
+         return BaseGroundClamper::GroundClampingType::NONE;
+      else if (GetGroundClampingData().GetAdjustRotationToGround())
+         return BaseGroundClamper::GroundClampingType::RANGED;
+
+      return BaseGroundClamper::GroundClampingType::INTERMITTENT_SAVE_OFFSET;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   void DeadReckoningHelper::ApplyBatchDeadReckoning(dtCore::Transform& xform, const osg::Vec3& pos)
+   {
+      // RESOLVE ROTATION
+      DeadReckonTheRotation(xform);
+
+      xform.SetTranslation(pos);
+      mCurrentDeadReckonedTranslation = pos;
+   }
+
    //////////////////////////////////////////////////////////////////////
    void DeadReckoningHelper::DRStatic(GameActor& gameActor, dtCore::Transform& xform, dtUtil::Log* pLogger)
    {
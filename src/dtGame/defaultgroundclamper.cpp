@@ -30,6 +30,7 @@
 #include <dtUtil/boundingshapeutils.h>
 #include <osg/io_utils>
 #include <osg/Matrix>
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -37,6 +38,32 @@
 
 namespace dtGame
 {
+   /////////////////////////////////////////////////////////////////////////////
+   // CLAMP QUERY TASK
+   /////////////////////////////////////////////////////////////////////////////
+   class DefaultGroundClamper::ClampQueryTask : public dtUtil::WorkerPool::Task
+   {
+   public:
+      ClampQueryTask(DefaultGroundClamper& clamper)
+         : mClamper(clamper)
+      {
+      }
+
+      virtual void Run(unsigned index)
+      {
+         unsigned batchSize = unsigned(mClamper.mGroundClampBatch.size());
+         unsigned begin = index * CLAMP_BATCH_SIZE;
+         mClamper.RunClampQuery(*mClamper.mParallelIsectors[index], begin,
+                  std::min(begin + CLAMP_BATCH_SIZE, batchSize));
+      }
+
+   private:
+      DefaultGroundClamper& mClamper;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   const unsigned DefaultGroundClamper::CLAMP_BATCH_SIZE;
+
    /////////////////////////////////////////////////////////////////////////////
    // DEFAULT GROUND CLAMPER
    /////////////////////////////////////////////////////////////////////////////
@@ -44,6 +71,7 @@ namespace dtGame
       : dtGame::BaseGroundClamper()
       , mTripleIsector(new dtCore::BatchIsector)
       , mIsector(new dtCore::BatchIsector)
+      , mRayQueryTreeRefit(false)
    {
       mGroundClampBatch.reserve(32);
    }
@@ -70,6 +98,47 @@ namespace dtGame
    {
       return *mIsector;
    }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::SetUseRayQueryTree(bool useTree)
+   {
+      mRayQueryTree = useTree ? new dtCore::RayQueryTree : NULL;
+      mRayQueryTreeRefit = false;
+
+      mIsector->SetRayQueryTree(mRayQueryTree.get());
+      mTripleIsector->SetRayQueryTree(mRayQueryTree.get());
+      for (unsigned i = 0; i < mParallelIsectors.size(); ++i)
+      {
+         mParallelIsectors[i]->SetRayQueryTree(mRayQueryTree.get());
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::UpdateRayQueryTree()
+   {
+      dtCore::Transformable* terrain = GetTerrainActor();
+      if (!mRayQueryTree.valid() || terrain == NULL || terrain->GetOSGNode() == NULL)
+      {
+         return;
+      }
+
+      // The isectors ignore a tree built from some other node, so until it is rebuilt they traverse the terrain.
+      if (mRayQueryTree->GetRoot() != terrain->GetOSGNode())
+      {
+         mRayQueryTree->Build(*terrain->GetOSGNode());
+      }
+      else if (!mRayQueryTreeRefit)
+      {
+         mRayQueryTree->Update();
+      }
+      mRayQueryTreeRefit = true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool DefaultGroundClamper::GetUseHighestLevelOfDetail() const
+   {
+      return mRayQueryTree.valid() || GetEyePointActor() == NULL;
+   }
    
    /////////////////////////////////////////////////////////////////////////////
    void DefaultGroundClamper::CalculateAndSetBoundingBox(osg::Vec3& modelDimensions,
@@ -191,6 +260,32 @@ namespace dtGame
       dtUtil::Log& logger = GetLogger();
       bool debugEnabled = logger.IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
 
+      if (mHeightCache.valid())
+      {
+         osg::Vec3 hits[3], normal;
+         bool cached = true;
+         for (unsigned i = 0; i < 3; ++i)
+         {
+            const osg::Vec3& point = inOutPoints[i];
+            if (osg::isNaN(point.x()) || osg::isNaN(point.y()) || osg::isNaN(point.z()))
+            {
+               // Leave the NaN handling to the query below.
+               cached = false;
+               break;
+            }
+            // Keep looking up after a miss so all the missing heights are queued.
+            cached = mHeightCache->GetHeight(point, hits[i], normal) && cached;
+         }
+
+         if (cached)
+         {
+            std::copy(hits, hits + 3, inOutPoints);
+            return;
+         }
+      }
+
+      UpdateRayQueryTree();
+
       mTripleIsector->Reset();
       mTripleIsector->SetQueryRoot(GetTerrainActor());
 
@@ -221,7 +316,7 @@ namespace dtGame
             osg::Vec3(singlePoint[0], singlePoint[1], singlePoint[2] - 100.0f));
       }
 
-      if (mTripleIsector->Update(GetLastEyePoint(), GetEyePointActor() == NULL))
+      if (mTripleIsector->Update(GetLastEyePoint(), GetUseHighestLevelOfDetail()))
       {
          for (unsigned i = 0; i < 3; ++i)
          {
@@ -349,11 +444,7 @@ namespace dtGame
       if( (runtimeData.GetLastClampedTime() + GetIntermittentGroundClampingTimeDelta() )<= currentTime)
       {
          runtimeData.SetLastClampedTime(currentTime);
-         mGroundClampBatch.push_back(std::make_pair(xform, std::make_pair(&proxy, &data)));
-         if(mGroundClampBatch.size() == 32)
-         {
-            RunClampBatch();
-         }
+         QueueClamp(xform, proxy, data);
       }
       else
       {
@@ -379,31 +470,92 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////////////////
    void DefaultGroundClamper::RunClampBatch()
    {
+      UpdateRayQueryTree();
+      FillHeightCache();
+
       if (mGroundClampBatch.empty())
       {
          return;
       }
 
-      dtUtil::Log& logger = GetLogger();
-      bool debugEnabled = logger.IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
-
-      if(mGroundClampBatch.size() > 32)
+      unsigned batchSize = unsigned(mGroundClampBatch.size());
+      if (!mWorkerPool.valid() || batchSize <= CLAMP_BATCH_SIZE)
+      {
+         for (unsigned begin = 0; begin < batchSize; begin += CLAMP_BATCH_SIZE)
+         {
+            unsigned end = std::min(begin + CLAMP_BATCH_SIZE, batchSize);
+            if (!RunClampQuery(*mIsector, begin, end) && GetLogger().IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+            {
+               GetLogger().LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, "Found no hits with batch query.");
+            }
+            ApplyClampQuery(*mIsector, begin, end);
+         }
+      }
+      else
       {
-         logger.LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__, 
-            "Attempted to batch %u entities, when 32 is the max.", mGroundClampBatch.size());        
+         unsigned numQueries = (batchSize + CLAMP_BATCH_SIZE - 1) / CLAMP_BATCH_SIZE;
+         while (mParallelIsectors.size() < numQueries)
+         {
+            mParallelIsectors.push_back(new dtCore::BatchIsector);
+            mParallelIsectors.back()->SetRayQueryTree(mRayQueryTree.get());
+         }
+
+         // The intersect visitor computes any dirty node bounds as it goes, which would race
+         // between the workers, so compute them all here first.  The queries then only read the terrain.
+         dtCore::Transformable* terrain = GetTerrainActor();
+         if (terrain != NULL && terrain->GetOSGNode() != NULL)
+         {
+            terrain->GetOSGNode()->getBound();
+         }
+
+         // Only the queries run in parallel.  Moving the actors, and the virtual methods
+         // subclasses may override, stay on this thread.
+         ClampQueryTask task(*this);
+         mWorkerPool->Run(task, numQueries);
+
+         for (unsigned i = 0; i < numQueries; ++i)
+         {
+            unsigned begin = i * CLAMP_BATCH_SIZE;
+            ApplyClampQuery(*mParallelIsectors[i], begin, std::min(begin + CLAMP_BATCH_SIZE, batchSize));
+         }
       }
 
-      mIsector->Reset();
-      mIsector->SetQueryRoot(GetTerrainActor());
+      mGroundClampBatch.clear();
+   }
 
-      for (size_t i = 0; i < mGroundClampBatch.size(); ++i)
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::QueueClamp(const dtCore::Transform& xform,
+            dtDAL::TransformableActorProxy& proxy, GroundClampingData& data)
+   {
+      if (mHeightCache.valid())
       {
-         dtCore::BatchIsector::SingleISector& single = mIsector->EnableAndGetISector(i);
-
-         if(debugEnabled)
+         osg::Vec3 point, hp, normal;
+         xform.GetTranslation(point);
+         if (mHeightCache->GetHeight(point, hp, normal))
          {
-            logger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, "Using one point ground clamping.");
+            dtCore::Transform clampedXform(xform);
+            ApplyClampHit(clampedXform, data, GetOrCreateRuntimeData(data), hp, normal);
+            static_cast<dtCore::Transformable*>(proxy.GetActor())->SetTransform(clampedXform, dtCore::Transformable::REL_CS);
+            return;
          }
+      }
+
+      mGroundClampBatch.push_back(std::make_pair(xform, std::make_pair(&proxy, &data)));
+      if (!mWorkerPool.valid() && mGroundClampBatch.size() == CLAMP_BATCH_SIZE)
+      {
+         RunClampBatch();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool DefaultGroundClamper::RunClampQuery(dtCore::BatchIsector& isector, unsigned begin, unsigned end)
+   {
+      isector.Reset();
+      isector.SetQueryRoot(GetTerrainActor());
+
+      for (unsigned i = begin; i < end; ++i)
+      {
+         dtCore::BatchIsector::SingleISector& single = isector.EnableAndGetISector(i - begin);
 
          dtCore::Transform& xform = mGroundClampBatch[i].first;
          osg::Vec3 singlePoint;
@@ -413,38 +565,30 @@ namespace dtGame
                osg::Vec3(singlePoint[0], singlePoint[1], singlePoint[2] - 100.0f));
       }
 
-      bool ignoreEyePoint = GetEyePointActor() == NULL;
-      if (!mIsector->Update(GetLastEyePoint(), ignoreEyePoint))
-      {
-         if(debugEnabled)
-         {
-            std::ostringstream ss;
-            ss << "Found no hits with batch query.";
-            logger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, ss.str().c_str());
-         }
-      }
+      return isector.Update(GetLastEyePoint(), GetUseHighestLevelOfDetail());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::ApplyClampQuery(dtCore::BatchIsector& isector, unsigned begin, unsigned end)
+   {
+      dtUtil::Log& logger = GetLogger();
+      bool debugEnabled = logger.IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
 
       // Set the positions even if there are no hits.
       osg::Vec3 normal;
       osg::Vec3 hp;
 
-      BatchVector::iterator i, iend;
-      i = mGroundClampBatch.begin();
-      iend = mGroundClampBatch.end();
-
-      unsigned index = 0;
-      for(; i != iend; ++i, ++index)
+      for (unsigned index = begin; index < end; ++index)
       {
-         dtCore::Transform& xform = i->first;
-         osg::Matrix rotation;
-         xform.GetRotation(rotation);
+         BatchVector::value_type& entry = mGroundClampBatch[index];
+         dtCore::Transform& xform = entry.first;
          osg::Vec3 singlePoint;
          xform.GetTranslation(singlePoint);
 
-         dtCore::BatchIsector::SingleISector& single = mIsector->EnableAndGetISector(index);
+         dtCore::BatchIsector::SingleISector& single = isector.EnableAndGetISector(index - begin);
 
-         dtDAL::TransformableActorProxy* proxy = i->second.first;
-         GroundClampingData* gcData = i->second.second;
+         dtDAL::TransformableActorProxy* proxy = entry.second.first;
+         GroundClampingData* gcData = entry.second.second;
 
          // Get the proxy's actor since it has the transform data.
          dtCore::Transformable* actor = NULL;
@@ -465,46 +609,103 @@ namespace dtGame
                logger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, ss.str().c_str());
             }
 
-            runtimeData.SetLastClampedOffset(hp.z() - singlePoint.z());
-
-            if(gcData->GetAdjustRotationToGround())
+            ApplyClampHit(xform, *gcData, runtimeData, hp, normal);
+            actor->SetTransform(xform, dtCore::Transformable::REL_CS);
+         }
+         else
+         {
+            if(GetMissingHit(*proxy, *gcData, singlePoint.z(), hp, normal))
             {
-               normal.normalize();
-               OrientTransform(xform, rotation, hp, normal);
-               runtimeData.SetLastClampedRotation(rotation);
+               ApplyClampHit(xform, *gcData, runtimeData, hp, normal);
             }
             else
             {
-               xform.Set(hp, rotation);
+               runtimeData.SetLastClampedOffset(0);
             }
-
             actor->SetTransform(xform, dtCore::Transformable::REL_CS);
          }
-         else
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::ApplyClampHit(dtCore::Transform& xform, GroundClampingData& data,
+            RuntimeData& runtimeData, const osg::Vec3& hit, osg::Vec3 normal)
+   {
+      osg::Matrix rotation;
+      xform.GetRotation(rotation);
+      osg::Vec3 position;
+      xform.GetTranslation(position);
+
+      runtimeData.SetLastClampedOffset(hit.z() - position.z());
+
+      if(data.GetAdjustRotationToGround())
+      {
+         normal.normalize();
+         OrientTransform(xform, rotation, hit, normal);
+         runtimeData.SetLastClampedRotation(rotation);
+      }
+      else
+      {
+         xform.Set(hit, rotation);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::FillHeightCache()
+   {
+      if (!mHeightCache.valid() || mHeightCache->GetNumPendingSamples() == 0 || !HasValidSurface())
+      {
+         return;
+      }
+
+      mHeightCache->TakePendingSamples(mHeightSamples);
+
+      unsigned numSamples = unsigned(mHeightSamples.size());
+      for (unsigned begin = 0; begin < numSamples; begin += CLAMP_BATCH_SIZE)
+      {
+         unsigned end = std::min(begin + CLAMP_BATCH_SIZE, numSamples);
+
+         mIsector->Reset();
+         mIsector->SetQueryRoot(GetTerrainActor());
+         for (unsigned i = begin; i < end; ++i)
          {
-            if(GetMissingHit(*proxy, *gcData, singlePoint.z(), hp, normal))
+            const osg::Vec3& point = mHeightSamples[i].mPoint;
+            mIsector->EnableAndGetISector(i - begin).SetSectorAsLineSegment(
+                     osg::Vec3(point[0], point[1], point[2] + 100.0f),
+                     osg::Vec3(point[0], point[1], point[2] - 100.0f));
+         }
+
+         bool anyHits = mIsector->Update(GetLastEyePoint(), GetUseHighestLevelOfDetail());
+
+         // Keep the hit closest to the height the sample was requested at, like GetClosestHit.
+         // Samples that hit nothing are recorded too, so they aren't requested again.
+         osg::Vec3 hit;
+         for (unsigned i = begin; i < end; ++i)
+         {
+            dtCore::BatchIsector::SingleISector& single = mIsector->EnableAndGetISector(i - begin);
+            const osg::Vec3& point = mHeightSamples[i].mPoint;
+            int numHits = anyHits ? single.GetNumberOfHits() : 0;
+            if (numHits == 0)
             {
-               runtimeData.SetLastClampedOffset(hp.z() - singlePoint.z());
+               mHeightCache->SetSampleMissed(mHeightSamples[i].mX, mHeightSamples[i].mY);
+               continue;
+            }
 
-               if(gcData->GetAdjustRotationToGround())
-               {
-                  normal.normalize();
-                  OrientTransform(xform, rotation, hp, normal);
-                  runtimeData.SetLastClampedRotation(rotation);
-               }
-               else
+            float diff = FLT_MAX;
+            for (int h = 0; h < numHits; ++h)
+            {
+               single.GetHitPoint(hit, h);
+               float newDiff = std::abs(hit.z() - point.z());
+               if (newDiff < diff)
                {
-                  xform.Set(hp, rotation);
+                  diff = newDiff;
+                  mHeightCache->SetSampleHeight(mHeightSamples[i].mX, mHeightSamples[i].mY, hit.z());
                }
             }
-            else
-            {
-               runtimeData.SetLastClampedOffset(0);
-            }
-            actor->SetTransform(xform, dtCore::Transformable::REL_CS);
          }
       }
-      mGroundClampBatch.clear();
+
+      mHeightSamples.clear();
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -569,11 +770,7 @@ namespace dtGame
                   && distanceToEyeSqr > GetHighResGroundClampingRange2()))
          {
             // this should be moved.
-            mGroundClampBatch.push_back(std::make_pair(xform, std::make_pair(&proxy, &data)));
-            if (mGroundClampBatch.size() == 32)
-            {
-               RunClampBatch();
-            }
+            QueueClamp(xform, proxy, data);
          }
          else
          {
@@ -617,6 +814,7 @@ namespace dtGame
    {
       // Ground clamping has been completed
       RunClampBatch();
+      mRayQueryTreeRefit = false;
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -91,7 +91,9 @@ namespace dtGame
       , mOwnership(&GameActorProxy::Ownership::SERVER_LOCAL)
       , mLocalActorUpdatePolicy(&GameActorProxy::LocalActorUpdatePolicy::ACCEPT_ALL)
       , mLogger(dtUtil::Log::GetInstance("gameactor.cpp"))
+      , mInvokableRevision(0)
       , mIsInGM(false)
+      , mPublishDirtyPropertiesOnTick(false)
    {
       SetClassName("dtGame::GameActor");
    }
@@ -229,6 +231,7 @@ namespace dtGame
 
       PopulateActorUpdate(*message);
       GetGameManager()->SendMessage(*updateMsg);
+      ClearDirtyProperties();
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -246,6 +249,11 @@ namespace dtGame
 
       PopulateActorUpdate(*message, propNames, true);
       GetGameManager()->SendMessage(*updateMsg);
+
+      for (unsigned i = 0; i < propNames.size(); ++i)
+      {
+         ClearPropertyDirty(propNames[i]);
+      }
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -270,6 +278,46 @@ namespace dtGame
       NotifyPartialActorUpdate(propNames);
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::NotifyDirtyActorUpdate()
+   {
+      if (GetGameManager() == NULL || IsRemote() || !HasDirtyProperties())
+      {
+         return;
+      }
+
+      std::vector<dtUtil::RefString> propNames;
+      GetDirtyPropertyNames(propNames);
+      NotifyPartialActorUpdate(propNames);
+      // in case a subclass overrides the partial update to send something else.
+      ClearDirtyProperties();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::SetPublishDirtyPropertiesOnTick(bool publish)
+   {
+      mPublishDirtyPropertiesOnTick = publish;
+      if (publish && HasDirtyProperties())
+      {
+         OnPropertiesDirty();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool GameActorProxy::GetPublishDirtyPropertiesOnTick() const
+   {
+      return mPublishDirtyPropertiesOnTick;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::OnPropertiesDirty()
+   {
+      if (mPublishDirtyPropertiesOnTick && mIsInGM && GetGameManager() != NULL && !IsRemote())
+      {
+         GetGameManager()->QueueDirtyActorUpdate(*this);
+      }
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    void GameActorProxy::GetPartialUpdateProperties(std::vector<dtUtil::RefString>& propNamesToFill)
    {
@@ -315,6 +363,8 @@ namespace dtGame
       update.SetSendingActorId(GetId());
       update.SetAboutActorId(GetId());
 
+      const dtDAL::ActorType& actorType = GetActorType();
+
       if (limitProperties)
       {
          for (unsigned i = 0; i < propNames.size(); ++i)
@@ -326,6 +376,7 @@ namespace dtGame
                {
                   MessageParameter* mp = update.AddUpdateParameter(property->GetName(), property->GetDataType());
                   mp->SetFromProperty(*property);
+                  update.SetUpdateParameterHandle(actorType, GetPropertyHandle(*property), *mp);
                   //if (mp != NULL)
                   //   mp->FromString(property->GetStringValue());
                }
@@ -339,11 +390,10 @@ namespace dtGame
       }
       else
       {
-         std::vector<dtDAL::ActorProperty* > toFill;
-         GetPropertyList(toFill);
-         for (unsigned i = 0; i < toFill.size(); ++i)
+         unsigned numProperties = GetNumProperties();
+         for (unsigned i = 0; i < numProperties; ++i)
          {
-            dtDAL::ActorProperty& property = *toFill[i];
+            dtDAL::ActorProperty& property = *GetPropertyByIndex(i);
 
             // don't send read-only properties
             if (property.IsReadOnly())
@@ -355,7 +405,10 @@ namespace dtGame
             {
                MessageParameter* mp = update.AddUpdateParameter(property.GetName(), property.GetDataType());
                if (mp != NULL)
+               {
                   mp->SetFromProperty(property);
+                  update.SetUpdateParameterHandle(actorType, GetPropertyHandle(property), *mp);
+               }
                //   mp->FromString(property.GetStringValue());
             }
             catch (const dtUtil::Exception&)
@@ -407,12 +460,15 @@ namespace dtGame
             SetName(nameInMessage);
       }
 
-      std::vector<const MessageParameter*> params;
-      msg.GetUpdateParameters(params);
+      // use the property handles if the sender or the component that read the update resolved them.
+      // Otherwise the names are all resolved here at once, and the message keeps them for the next actor.
+      const ActorUpdateMessage::ParameterHandleList& handles = msg.FindUpdateParameterHandles(GetActorType());
+      unsigned numParams = unsigned(handles.size());
 
-      for (unsigned int i = 0; i < params.size(); ++i)
+      for (unsigned int i = 0; i < numParams; ++i)
       {
-         const dtUtil::RefString& paramName = params[i]->GetName();
+         const MessageParameter* param = handles[i].second;
+         const dtUtil::RefString& paramName = param->GetName();
 
          if (filterProps && !ShouldAcceptPropertyInLocalUpdate(paramName))
          {
@@ -428,9 +484,16 @@ namespace dtGame
             continue;
          }
 
-         const dtDAL::DataType& paramType = params[i]->GetDataType();
+         const dtDAL::DataType& paramType = param->GetDataType();
 
-         dtDAL::ActorProperty* property = GetProperty(paramName);
+         // a property added to just this actor has no handle.
+         unsigned handle = handles[i].first;
+         dtDAL::ActorProperty* property =
+            handle != dtDAL::ActorType::INVALID_PROPERTY_HANDLE ? GetPropertyByHandle(handle) : NULL;
+         if (property == NULL)
+         {
+            property = GetProperty(paramName);
+         }
 
          if (property == NULL)
          {
@@ -449,7 +512,7 @@ namespace dtGame
                mLogger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
                         "Not setting property \"%s\" on actor type \"%s\" to value \"%s\" because the property is read only.",
                         paramName.c_str(), GetActorType().GetFullName().c_str(),
-                        params[i]->ToString().c_str()
+                        param->ToString().c_str()
                );
             }
             continue;
@@ -460,7 +523,7 @@ namespace dtGame
             mLogger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
                      "Setting property \"%s\" on actor type \"%s\" to value \"%s\"",
                      paramName.c_str(), GetActorType().GetFullName().c_str(),
-                     params[i]->ToString().c_str()
+                     param->ToString().c_str()
             );
          }
 
@@ -475,7 +538,7 @@ namespace dtGame
          // If the property is of type ACTOR AND it is an ActorActor property not an ActorID property, it's a special case.
          if (aap != NULL)
          {
-            const ActorMessageParameter* amp = static_cast<const ActorMessageParameter*>(params[i]);
+            const ActorMessageParameter* amp = static_cast<const ActorMessageParameter*>(param);
             if ( GetGameManager() != NULL )
             {
                dtGame::GameActorProxy* valueProxy = GetGameManager()->FindGameActorById(amp->GetValue());
@@ -494,7 +557,7 @@ namespace dtGame
          {
             try
             {
-               params[i]->ApplyValueToProperty(*property);
+               param->ApplyValueToProperty(*property);
             }
             catch (const dtUtil::Exception& ex)
             {
@@ -504,6 +567,11 @@ namespace dtGame
 
       }
 
+      // remote actors are never published from here, so their changes aren't worth tracking.
+      if (!isLocal)
+      {
+         ClearDirtyProperties();
+      }
    }
 
    /////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -556,6 +624,7 @@ namespace dtGame
       else
       {
          mInvokables.insert(std::make_pair(newInvokable.GetName(), dtCore::RefPtr<Invokable>(&newInvokable)));
+         ++mInvokableRevision;
       }
    }
 
@@ -567,6 +636,7 @@ namespace dtGame
       if (itor != mInvokables.end())
       {
          mInvokables.erase(itor);
+         ++mInvokableRevision;
       }
    }
 
@@ -656,6 +726,23 @@ namespace dtGame
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::RegisterForTicks(const MessageType& type, const std::string& invokableName,
+            unsigned interval, unsigned phase)
+   {
+      if (IsInGM())
+      {
+         GetGameManager()->RegisterForTicks(type, *this, invokableName, interval, phase);
+      }
+      else
+      {
+         std::ostringstream oss;
+         oss << "Could not register the messagetype: " << type.GetName() << " with the invokable: " <<
+         invokableName << " because the actor is not in the Game Manager yet.";
+         mLogger.LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__, oss.str());
+      }
+   }
+
    ///////////////////////////////////////////////////////////////////////////////////////////////////////
    void GameActorProxy::RegisterForMessagesAboutOtherActor(const MessageType& type,
             const dtCore::UniqueId& targetActorId, const std::string& invokableName)
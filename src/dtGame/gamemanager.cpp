@@ -34,6 +34,8 @@
 #include <dtGame/invokable.h>
 #include <dtGame/mapchangestatedata.h>
 #include <dtGame/gmstatistics.h>
+#include <dtGame/actorspatialindex.h>
+#include <dtGame/timerwheel.h>
 
 #include <dtDAL/actortype.h>
 #include <dtDAL/project.h>
@@ -45,7 +47,9 @@
 #include <dtCore/scene.h>
 
 #include <dtUtil/stringutils.h>
+#include <dtUtil/lockfreequeue.h>
 #include <dtUtil/log.h>
+#include <dtUtil/tracer.h>
 
 namespace dtGame
 {
@@ -77,15 +81,124 @@ namespace dtGame
    class GMImpl
    {
    public:
-      GMImpl() 
+      typedef std::vector<dtCore::RefPtr<GMComponent> > ComponentList;
+      typedef dtUtil::HashMap<const MessageType*, ComponentList> ComponentDispatchMap;
+
+      GMImpl()
+         : mComponentDispatchDirty(false)
+         , mComponentDispatchDepth(0)
+         , mInvokableDispatchDepth(0)
+         , mInvokableListenersDirty(false)
       {  
       }
       ~GMImpl() 
       { 
       }
 
+      /**
+       * Finds the components to call ProcessMessage on for a message type, in priority order.
+       * The lists are built on first use and thrown away whenever the components or their interests change.
+       * If that happens while a message is being dispatched, the list is built into the scratch
+       * vector instead so that the list being iterated stays intact.
+       */
+      const ComponentList& GetComponentsForMessageType(const MessageType& type,
+               const ComponentList& allComponents, ComponentList& scratch)
+      {
+         if (mComponentDispatchDirty)
+         {
+            if (mComponentDispatchDepth > 0)
+            {
+               BuildComponentList(type, allComponents, scratch);
+               return scratch;
+            }
+
+            mComponentDispatch.clear();
+            mComponentDispatchDirty = false;
+         }
+
+         ComponentDispatchMap::iterator found = mComponentDispatch.find(&type);
+         if (found == mComponentDispatch.end())
+         {
+            found = mComponentDispatch.insert(std::make_pair(&type, ComponentList())).first;
+            BuildComponentList(type, allComponents, found->second);
+         }
+         return found->second;
+      }
+
+      void BuildComponentList(const MessageType& type, const ComponentList& allComponents, ComponentList& toFill)
+      {
+         toFill.clear();
+         // all components are in priority order, so the wildcard and the interested components stay merged in order.
+         for (ComponentList::const_iterator i = allComponents.begin(); i != allComponents.end(); ++i)
+         {
+            if ((*i)->IsInterestedInMessageType(type))
+            {
+               toFill.push_back(*i);
+            }
+         }
+      }
+
       /// stats for the work of the GM - in a class so its less obtrusive to the gm
       GMStatistics mGMStatistics;
+
+      /// backs the proximity queries.
+      ActorSpatialIndex mSpatialIndex;
+
+      /// the pending timers, by which clock they use.
+      TimerWheel mRealTimeTimers;
+      TimerWheel mSimulationTimers;
+      /// reused for processing the timers so it doesn't allocate.
+      std::vector<TimerWheel::ExpiredTimer> mExpiredTimers;
+
+      /// messages sent from other threads, drained in PreFrame.
+      dtUtil::LockFreeQueue<dtCore::RefPtr<const Message> > mThreadSafeNetworkMessages;
+      dtUtil::LockFreeQueue<dtCore::RefPtr<const Message> > mThreadSafeMessages;
+      /// reused for draining so the drain doesn't allocate.
+      std::vector<dtCore::RefPtr<const Message> > mDrainBuffer;
+
+      /// the actors that set a property this tick and publish dirty properties on tick.
+      std::vector<dtCore::RefPtr<GameActorProxy> > mDirtyActors;
+      /// swapped with mDirtyActors while sending so actors dirtied by the updates wait for the next tick.
+      std::vector<dtCore::RefPtr<GameActorProxy> > mDirtyActorsSending;
+
+      /// the phase RegisterForTicks gives the next listener with each interval.
+      std::map<unsigned, unsigned> mNextTickPhase;
+      /// reused to send the summed tick times to listeners with a tick interval.
+      dtCore::RefPtr<TickMessage> mIntervalTickMessage;
+
+      /// the deleted actors of a type kept for reuse.
+      struct ActorPool
+      {
+         ActorPool() : mMaxSize(0) {}
+
+         unsigned mMaxSize;
+         /// a new actor of the type, never added, that pooled actors are reset to.
+         dtCore::RefPtr<GameActorProxy> mDefaults;
+         std::vector<dtCore::RefPtr<GameActorProxy> > mActors;
+      };
+      typedef std::map<dtCore::RefPtr<const dtDAL::ActorType>, ActorPool> ActorPoolMap;
+      ActorPoolMap mActorPools;
+
+      /// the components to send each message type to.
+      ComponentDispatchMap mComponentDispatch;
+      bool mComponentDispatchDirty;
+      /// how many component dispatches are on the stack.
+      unsigned mComponentDispatchDepth;
+
+      /// how many invokable listener lists are being invoked.
+      unsigned mInvokableDispatchDepth;
+      /// listeners were unregistered during an invoke and still need to be removed.
+      bool mInvokableListenersDirty;
+   };
+
+   /// Tracks a dispatch depth so the lists being dispatched to aren't changed from under a dispatch.
+   class DispatchDepthScope
+   {
+   public:
+      DispatchDepthScope(unsigned& depth) : mDepth(depth) { ++mDepth; }
+      ~DispatchDepthScope() { --mDepth; }
+   private:
+      unsigned& mDepth;
    };
 
 
@@ -142,6 +255,8 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::UnloadActorRegistry(const std::string& libName)
    {
+      // pooled actors may be from the library.
+      ClearActorPools();
       mLibMgr->UnloadActorRegistry(libName);
    }
 
@@ -345,6 +460,43 @@ namespace dtGame
       mSendMessageQueue.push(dtCore::RefPtr<const Message>(&message));
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SendNetworkMessageThreadSafe(const Message& message)
+   {
+      mGMImpl->mThreadSafeNetworkMessages.Push(dtCore::RefPtr<const Message>(&message));
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SendMessageThreadSafe(const Message& message)
+   {
+      mGMImpl->mThreadSafeMessages.Push(dtCore::RefPtr<const Message>(&message));
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::DrainThreadSafeMessageQueues()
+   {
+      DT_TRACE_SCOPE("GameManager::DrainThreadSafeMessageQueues");
+      std::vector<dtCore::RefPtr<const Message> >& buffer = mGMImpl->mDrainBuffer;
+
+      if (mGMImpl->mThreadSafeNetworkMessages.PopAll(buffer) > 0)
+      {
+         for (unsigned i = 0; i < buffer.size(); ++i)
+         {
+            mSendNetworkMessageQueue.push(buffer[i]);
+         }
+         buffer.clear();
+      }
+
+      if (mGMImpl->mThreadSafeMessages.PopAll(buffer) > 0)
+      {
+         for (unsigned i = 0; i < buffer.size(); ++i)
+         {
+            mSendMessageQueue.push(buffer[i]);
+         }
+         buffer.clear();
+      }
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    float GameManager::GetTimeScale() const
    {
@@ -456,10 +608,16 @@ namespace dtGame
          frameTickStart = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
       }
 
+      // actors may have moved since the last frame.
+      mGMImpl->mSpatialIndex.Invalidate();
+
+      DrainThreadSafeMessageQueues();
+
       DoSendNetworkMessages();
 
       if (mMapChangeStateData.valid())
       {
+         DT_TRACE_SCOPE("MapChangeStateData::ContinueMapChange");
          mMapChangeStateData->ContinueMapChange();
          if (mMapChangeStateData->GetCurrentState() == MapChangeStateData::MapChangeState::IDLE)
          {
@@ -480,11 +638,16 @@ namespace dtGame
       SendMessage(*tick);
       SendMessage(*tickRemote);
 
-      ProcessTimers(mRealTimeTimers, GetRealClockTime());
-      ProcessTimers(mSimulationTimers, dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0));
+      ProcessTimers(mGMImpl->mRealTimeTimers, GetRealClockTime());
+      ProcessTimers(mGMImpl->mSimulationTimers, dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0));
 
       DoSendMessages();
 
+      if (SendDirtyActorUpdates())
+      {
+         DoSendMessages();
+      }
+
       dtCore::RefPtr<TickMessage> tickEnd;
       GetMessageFactory().CreateMessage(MessageType::TICK_END_OF_FRAME, tickEnd);
       PopulateTickMessage(*tickEnd, deltaSimTime, deltaRealTime, simulationTime);
@@ -496,9 +659,47 @@ namespace dtGame
       mGMImpl->mGMStatistics.FragmentTimeDump(frameTickStart, *this);
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::QueueDirtyActorUpdate(GameActorProxy& gameActorProxy)
+   {
+      // the proxy only queues itself when its first property is marked dirty.  If its flags are cleared
+      // and dirtied again in the same tick it is queued twice, but the second entry finds nothing dirty.
+      mGMImpl->mDirtyActors.push_back(&gameActorProxy);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool GameManager::SendDirtyActorUpdates()
+   {
+      if (mGMImpl->mDirtyActors.empty())
+      {
+         return false;
+      }
+
+      DT_TRACE_SCOPE("GameManager::SendDirtyActorUpdates");
+      std::vector<dtCore::RefPtr<GameActorProxy> >& sending = mGMImpl->mDirtyActorsSending;
+      sending.swap(mGMImpl->mDirtyActors);
+
+      bool sent = false;
+      for (unsigned i = 0; i < sending.size(); ++i)
+      {
+         GameActorProxy& proxy = *sending[i];
+         // it may have been deleted, gone remote, or sent a full update since it was queued.
+         if (!proxy.IsInGM() || proxy.GetGameManager() != this || proxy.IsRemote() || !proxy.HasDirtyProperties())
+         {
+            continue;
+         }
+
+         proxy.NotifyDirtyActorUpdate();
+         sent = true;
+      }
+      sending.clear();
+      return sent;
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::RemoveDeletedActors()
    {
+      DT_TRACE_SCOPE("GameManager::RemoveDeletedActors");
       // DELETE ACTORS
       // IT IS CRUCIAL TO NOT SAVE OFF THE SIZE OR CHANGE THIS TO AN ITERATOR
       // BECAUSE ACTORS CAN DELETE OTHER ACTORS IN THE ON REMOVED FROM WORLD
@@ -510,7 +711,7 @@ namespace dtGame
          // It could listen for the ACTOR_DELETE_MESSAGE instead.
          gameActorProxy.InvokeRemovedFromWorld();
 
-         std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::iterator itor
+         GameActorMap::iterator itor
             = mGameActorProxyMap.find(gameActorProxy.GetId());
 
          dtCore::UniqueId id;
@@ -518,11 +719,13 @@ namespace dtGame
          {
             id = itor->first;
             UnregisterAllMessageListenersForActor(*itor->second);
+            mGMImpl->mSpatialIndex.Remove(gameActorProxy);
             mGameActorProxyMap.erase(itor);
             RemoveActorFromScene(gameActorProxy);
          }
 
          gameActorProxy.SetGameManager(NULL);
+         ReturnActorToPool(gameActorProxy);
       }
 
       mDeleteList.clear();
@@ -531,6 +734,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::DoSendNetworkMessages()
    {
+      DT_TRACE_SCOPE("GameManager::DoSendNetworkMessages");
       // statistics stuff.
       bool logComponents = mGMImpl->mGMStatistics.ShouldWeLogComponents();
       dtCore::Timer_t frameTickStartCurrent(0);
@@ -601,20 +805,30 @@ namespace dtGame
       dtCore::Timer_t frameTickStartCurrent(0);
       bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
 
-      // Components get messages first
-      std::vector< dtCore::RefPtr<GMComponent> >::iterator i, iend;
-      i = mComponentList.begin();
-      iend = mComponentList.end();
+      // Components get messages first, but only the ones interested in this message type.
+      GMImpl::ComponentList scratch;
+      const GMImpl::ComponentList& components =
+         mGMImpl->GetComponentsForMessageType(message.GetMessageType(), mComponentList, scratch);
+      DispatchDepthScope dispatchScope(mGMImpl->mComponentDispatchDepth);
+
+      GMImpl::ComponentList::const_iterator i, iend;
+      i = components.begin();
+      iend = components.end();
       for (;i != iend; ++i)
       {
+         GMComponent& component = **i;
+         // skip components removed by an earlier component during this dispatch.
+         if (component.GetGameManager() != this)
+         {
+            continue;
+         }
+
          // Statistics information
          if (logComponents)
          {
             frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
          }
 
-         GMComponent& component = **i;
-
          try
          {
             if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
@@ -624,6 +838,7 @@ namespace dtGame
                         component.GetName() + "\"",
                         dtUtil::Log::LOG_DEBUG);
             }
+            DT_TRACE_SCOPE_CATEGORY(component.GetTraceName(), "component");
             component.ProcessMessage(message);
          }
          catch (const dtUtil::Exception& ex)
@@ -653,7 +868,7 @@ namespace dtGame
       InvokeGlobalInvokables(message);
 
       // ABOUT ACTOR - The actor itself and others registered against a particular actor
-      if (!message.GetAboutActorId().ToString().empty())
+      if (!message.GetAboutActorId().IsNull())
       {
          // if we have an about actor, first try to send it to the actor itself
          GameActorProxy* aboutActor = FindGameActorById(message.GetAboutActorId());
@@ -669,6 +884,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::DoSendMessages()
    {
+      DT_TRACE_SCOPE("GameManager::DoSendMessages");
       // PROCESS MESSAGES - Send all Process messages to components and interested actors
       while (!mSendMessageQueue.empty())
       {
@@ -693,96 +909,10 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::InvokeGlobalInvokables(const Message& message)
    {
-      // statistics stuff.
-      bool logActors = mGMImpl->mGMStatistics.ShouldWeLogActors();
-      dtCore::Timer_t frameTickStartCurrent(0);
-      bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
-
-      // GLOBAL INVOKABLES - Process it on globally registered invokables
-      const MessageType& msgType = message.GetMessageType();
-      std::multimap<const MessageType*, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator itor
-         = mGlobalMessageListeners.find(&msgType);
-
-      while (itor != mGlobalMessageListeners.end() && itor->first == &msgType)
+      GlobalMessageListenerMap::iterator found = mGlobalMessageListeners.find(&message.GetMessageType());
+      if (found != mGlobalMessageListeners.end())
       {
-         std::pair<dtCore::RefPtr<GameActorProxy>, std::string >& listener = itor->second;
-         ++itor;
-
-         // hold onto the actor in a refptr so that the stats code
-         // won't crash if the actor unregisters for the message.
-         dtCore::RefPtr<GameActorProxy> listenerActorProxy = listener.first;
-
-         Invokable* invokable = NULL;
-
-         if (listenerActorProxy->IsInGM())
-         {
-            invokable = listenerActorProxy->GetInvokable(listener.second);
-         }
-
-
-         if (invokable != NULL)
-         {
-            // Statistics information
-            if (logActors)
-            {
-               frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
-            }
-
-            try
-            {
-               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-               {
-                  mLogger->LogMessage(__FUNCTION__, __LINE__,
-                           "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
-                           listenerActorProxy->GetName() + "\" of Type \"" + listenerActorProxy->GetActorType().GetFullName()
-                           + "\"",
-                           dtUtil::Log::LOG_DEBUG);
-               }
-               invokable->Invoke(message);
-            }
-            catch (const dtUtil::Exception& ex)
-            {
-               ex.LogException(dtUtil::Log::LOG_ERROR, *mLogger);
-            }
-
-            // Statistics information
-            if (logActors)
-            {
-               double frameTickDelta
-               = mGMImpl->mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent,
-                                                        mGMImpl->mGMStatistics.mStatsTickClock.Tick());
-
-               mGMImpl->mGMStatistics.UpdateDebugStats(listenerActorProxy->GetId(),
-                     listenerActorProxy->GetName(), frameTickDelta,
-                     false, isATickLocalMessage);
-            }
-         }
-         else
-         {
-            if (listenerActorProxy->IsInGM())
-            {
-               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
-               {
-                  mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
-                                      "Invokable named %s is registered as a listener, but "
-                                      "Proxy %s does not have an invokable by that name.",
-                                      listener.second.c_str(),
-                                      listener.first->GetActorType().GetName().c_str());
-               }
-            }
-            else
-            {
-               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-               {
-                  mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                                      "Invokable named %s is registered as a listener, "
-                                      "but Proxy %s is no longer in the GM and is probably "
-                                      "being deleted.",
-                                      listener.second.c_str(),
-                                      listenerActorProxy->GetActorType().GetName().c_str());
-               }
-            }
-         }
+         InvokeListeners(message, found->second, true);
       }
    }
 
@@ -819,6 +949,7 @@ namespace dtGame
                          + "\"",
                          dtUtil::Log::LOG_DEBUG);
             }
+            DT_TRACE_SCOPE_CATEGORY((*i)->GetTraceName(), "invokable");
             (*i)->Invoke(message);
          }
          catch (const dtUtil::Exception& ex)
@@ -841,86 +972,300 @@ namespace dtGame
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::InvokeOtherActorInvokables(const Message& message)
+   {
+      // send it to all actors listening to that actor for that message type.
+      ActorMessageListenerMap::iterator foundType = mActorMessageListeners.find(&message.GetMessageType());
+      if (foundType == mActorMessageListeners.end())
+      {
+         return;
+      }
+
+      AboutActorListenerMap::iterator found = foundType->second.find(message.GetAboutActorId());
+      if (found != foundType->second.end())
+      {
+         InvokeListeners(message, found->second, false);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::InvokeListeners(const Message& message, InvokableListenerList& listeners, bool isGlobal)
    {
       // statistics stuff.
       bool logActors = mGMImpl->mGMStatistics.ShouldWeLogActors();
       dtCore::Timer_t frameTickStartCurrent(0);
+      bool isATickLocalMessage = isGlobal && (message.GetMessageType() == MessageType::TICK_LOCAL);
 
-      // next, sent it to all actors listening to that actor for that message type.
-      // TODO - This should be refactored like we did for the Global
-      // Invokables a few lines up. It should work with the map directly instead of filling lists repeatedly
-      std::vector<std::pair<GameActorProxy*, std::string > > toFill;
-      GetRegistrantsForMessagesAboutActor(message.GetMessageType(), message.GetAboutActorId(), toFill);
-
-      std::vector<std::pair<GameActorProxy*, std::string > >::iterator i, iend;
-      i = toFill.begin();
-      iend = toFill.end();
-      for (;i != iend; ++i)
       {
-         std::pair<GameActorProxy*, std::string >& listener = *i;
-         GameActorProxy& currentProxy = *listener.first;
-         Invokable* invokable = NULL;
-
-         /// Don't want to invoke
-         if (currentProxy.IsInGM())
-         {
-            invokable = currentProxy.GetInvokable(listener.second);
-         }
+         DispatchDepthScope dispatchScope(mGMImpl->mInvokableDispatchDepth);
 
-         if (invokable != NULL)
+         // Listeners added by an invokable don't get this message.  Removed listeners are only cleared until
+         // the dispatch is done, so the indices stay valid.  The list may reallocate, so don't hold references
+         // to the listeners across an invoke.
+         const unsigned numListeners = unsigned(listeners.size());
+         for (unsigned i = 0; i < numListeners; ++i)
          {
-            // Statistics information
-            if (logActors)
+            if (!listeners[i].mProxy.valid())
             {
-               frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
+               continue;
             }
 
-            try
+            const Message* messageToSend = &message;
+            if (listeners[i].mTickInterval > 1)
             {
-               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+               messageToSend = GetIntervalTickMessage(message, listeners[i]);
+               if (messageToSend == NULL)
                {
-                   mLogger->LogMessage(__FUNCTION__, __LINE__,
-                            "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
-                            currentProxy.GetName() + "\" of Type \"" + currentProxy.GetActorType().GetFullName()
-                            + "\"",
-                            dtUtil::Log::LOG_DEBUG);
+                  continue;
                }
-               invokable->Invoke(message);
             }
-            catch (const dtUtil::Exception& ex)
+
+            // hold onto the actor in a refptr so that the stats code
+            // won't crash if the actor unregisters for the message.
+            dtCore::RefPtr<GameActorProxy> listenerActorProxy = listeners[i].mProxy;
+
+            Invokable* invokable = NULL;
+
+            if (listenerActorProxy->IsInGM())
             {
-               ex.LogException(dtUtil::Log::LOG_ERROR, *mLogger);
+               invokable = GetListenerInvokable(listeners[i]);
             }
 
-            if (logActors)
+            if (invokable != NULL)
             {
-               double frameTickDelta =
-                  mGMImpl->mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent,
-                                                         mGMImpl->mGMStatistics.mStatsTickClock.Tick());
-               mGMImpl->mGMStatistics.UpdateDebugStats(currentProxy.GetId(), currentProxy.GetName(),
-                                              frameTickDelta, false, false);
+               // Statistics information
+               if (logActors)
+               {
+                  frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
+               }
+
+               try
+               {
+                  if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+                  {
+                     mLogger->LogMessage(__FUNCTION__, __LINE__,
+                              "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
+                              listenerActorProxy->GetName() + "\" of Type \"" + listenerActorProxy->GetActorType().GetFullName()
+                              + "\"",
+                              dtUtil::Log::LOG_DEBUG);
+                  }
+                  DT_TRACE_SCOPE_CATEGORY(invokable->GetTraceName(), "invokable");
+                  invokable->Invoke(*messageToSend);
+               }
+               catch (const dtUtil::Exception& ex)
+               {
+                  ex.LogException(dtUtil::Log::LOG_ERROR, *mLogger);
+               }
+
+               // Statistics information
+               if (logActors)
+               {
+                  double frameTickDelta
+                  = mGMImpl->mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent,
+                                                           mGMImpl->mGMStatistics.mStatsTickClock.Tick());
+
+                  mGMImpl->mGMStatistics.UpdateDebugStats(listenerActorProxy->GetId(),
+                        listenerActorProxy->GetName(), frameTickDelta,
+                        false, isATickLocalMessage);
+               }
             }
+            else if (listenerActorProxy->IsInGM())
+            {
+               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
+               {
+                  mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
+                                      "Invokable named %s is registered as a listener, but "
+                                      "Proxy %s does not have an invokable by that name.",
+                                      listeners[i].mInvokableName.c_str(),
+                                      listenerActorProxy->GetActorType().GetName().c_str());
+               }
+            }
+            else
+            {
+               if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+               {
+                  mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
+                                      "Invokable named %s is registered as a listener, "
+                                      "but Proxy %s is no longer in the GM and is probably "
+                                      "being deleted.",
+                                      listeners[i].mInvokableName.c_str(),
+                                      listenerActorProxy->GetActorType().GetName().c_str());
+               }
+            }
+         }
+      }
+
+      if (mGMImpl->mInvokableDispatchDepth == 0 && mGMImpl->mInvokableListenersDirty)
+      {
+         CompactInvokableListeners();
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   Invokable* GameManager::GetListenerInvokable(InvokableListener& listener)
+   {
+      GameActorProxy& proxy = *listener.mProxy;
+      if (listener.mInvokableRevision != proxy.mInvokableRevision)
+      {
+         listener.mInvokable = proxy.GetInvokable(listener.mInvokableName);
+         listener.mInvokableRevision = proxy.mInvokableRevision;
+      }
+      return listener.mInvokable;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::AddInvokableListener(InvokableListenerList& listeners,
+            GameActorProxy& proxy, const std::string& invokableName)
+   {
+      InvokableListener listener;
+      listener.mProxy = &proxy;
+      listener.mInvokableName = invokableName;
+      listener.mInvokable = proxy.GetInvokable(invokableName);
+      listener.mInvokableRevision = proxy.mInvokableRevision;
+      listener.mTickInterval = 1;
+      listener.mTicksToSkip = 0;
+      listener.mSkippedSimTime = 0.0f;
+      listener.mSkippedRealTime = 0.0f;
+      listeners.push_back(listener);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   const Message* GameManager::GetIntervalTickMessage(const Message& tick, InvokableListener& listener)
+   {
+      const TickMessage& tickMessage = static_cast<const TickMessage&>(tick);
+      listener.mSkippedSimTime += tickMessage.GetDeltaSimTime();
+      listener.mSkippedRealTime += tickMessage.GetDeltaRealTime();
+
+      if (listener.mTicksToSkip > 0)
+      {
+         --listener.mTicksToSkip;
+         return NULL;
+      }
+
+      // an invokable may have kept the last one, so only reuse it if nothing else holds it.
+      dtCore::RefPtr<TickMessage>& intervalTick = mGMImpl->mIntervalTickMessage;
+      if (!intervalTick.valid() || intervalTick->referenceCount() > 1
+               || intervalTick->GetMessageType() != tick.GetMessageType())
+      {
+         dtCore::RefPtr<Message> newMessage = mFactory.CreateMessage(tick.GetMessageType());
+         intervalTick = static_cast<TickMessage*>(newMessage.get());
+      }
+
+      tick.CopyDataTo(*intervalTick);
+      intervalTick->SetDeltaSimTime(listener.mSkippedSimTime);
+      intervalTick->SetDeltaRealTime(listener.mSkippedRealTime);
+
+      listener.mTicksToSkip = listener.mTickInterval - 1;
+      listener.mSkippedSimTime = 0.0f;
+      listener.mSkippedRealTime = 0.0f;
+      return intervalTick.get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::RemoveInvokableListener(InvokableListenerList& listeners, unsigned index)
+   {
+      if (mGMImpl->mInvokableDispatchDepth > 0)
+      {
+         listeners[index].mProxy = NULL;
+         listeners[index].mInvokable = NULL;
+         mGMImpl->mInvokableListenersDirty = true;
+      }
+      else
+      {
+         listeners.erase(listeners.begin() + index);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   template <typename ListenerMap>
+   static void EraseEmptyListenerLists(ListenerMap& listenerMap)
+   {
+      typename ListenerMap::iterator i = listenerMap.begin();
+      while (i != listenerMap.end())
+      {
+         typename ListenerMap::iterator current = i;
+         ++i;
+         if (current->second.empty())
+         {
+            listenerMap.erase(current);
          }
-         else if (currentProxy.IsInGM())
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::CompactInvokableListeners()
+   {
+      mGMImpl->mInvokableListenersDirty = false;
+
+      for (GlobalMessageListenerMap::iterator i = mGlobalMessageListeners.begin(); i != mGlobalMessageListeners.end(); ++i)
+      {
+         InvokableListenerList& listeners = i->second;
+         for (unsigned j = unsigned(listeners.size()); j > 0; --j)
          {
-            if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
+            if (!listeners[j - 1].mProxy.valid())
             {
-               mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
-                                   "Invokable named %s is registered as a listener, but Proxy %s does not have an invokable by that name.",
-                                   listener.second.c_str(), currentProxy.GetActorType().GetName().c_str());
+               listeners.erase(listeners.begin() + (j - 1));
             }
          }
-         else
+      }
+      EraseEmptyListenerLists(mGlobalMessageListeners);
+
+      ActorMessageListenerMap::iterator i = mActorMessageListeners.begin();
+      while (i != mActorMessageListeners.end())
+      {
+         ActorMessageListenerMap::iterator current = i;
+         ++i;
+
+         AboutActorListenerMap& aboutActorListeners = current->second;
+         for (AboutActorListenerMap::iterator k = aboutActorListeners.begin(); k != aboutActorListeners.end(); ++k)
          {
-            if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+            InvokableListenerList& listeners = k->second;
+            for (unsigned j = unsigned(listeners.size()); j > 0; --j)
             {
-               mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                                   "Invokable named %s is registered as a listener, but Proxy %s is no longer in the GM and is probably being deleted.",
-                                   listener.second.c_str(), currentProxy.GetActorType().GetName().c_str());
+               if (!listeners[j - 1].mProxy.valid())
+               {
+                  listeners.erase(listeners.begin() + (j - 1));
+               }
             }
          }
+         EraseEmptyListenerLists(aboutActorListeners);
+
+         if (aboutActorListeners.empty())
+         {
+            mActorMessageListeners.erase(current);
+         }
       }
+   }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::ClearInvokableListeners()
+   {
+      if (mGMImpl->mInvokableDispatchDepth == 0)
+      {
+         mGlobalMessageListeners.clear();
+         mActorMessageListeners.clear();
+         mGMImpl->mInvokableListenersDirty = false;
+         return;
+      }
+
+      // the lists are being invoked, so just clear the listeners and remove them when the invoke is done.
+      for (GlobalMessageListenerMap::iterator i = mGlobalMessageListeners.begin(); i != mGlobalMessageListeners.end(); ++i)
+      {
+         for (unsigned j = 0; j < i->second.size(); ++j)
+         {
+            RemoveInvokableListener(i->second, j);
+         }
+      }
+
+      for (ActorMessageListenerMap::iterator i = mActorMessageListeners.begin(); i != mActorMessageListeners.end(); ++i)
+      {
+         for (AboutActorListenerMap::iterator k = i->second.begin(); k != i->second.end(); ++k)
+         {
+            for (unsigned j = 0; j < k->second.size(); ++j)
+            {
+               RemoveInvokableListener(k->second, j);
+            }
+         }
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -964,6 +1309,8 @@ namespace dtGame
          mComponentList.push_back(dtCore::RefPtr<GMComponent>(&component));
       }
 
+      InvalidateComponentDispatch();
+
       // notify the component that it was added to the GM
       component.OnAddedToGM();
    }
@@ -978,11 +1325,18 @@ namespace dtGame
             component.OnRemovedFromGM();
             component.SetGameManager(NULL);
             mComponentList.erase(i);
+            InvalidateComponentDispatch();
             return;
          }
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::InvalidateComponentDispatch()
+   {
+      mGMImpl->mComponentDispatchDirty = true;
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::GetAllComponents(std::vector<GMComponent*>& toFill)
    {
@@ -1060,6 +1414,12 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    dtCore::RefPtr<dtDAL::ActorProxy> GameManager::CreateActor(const dtDAL::ActorType& actorType)
    {
+      dtCore::RefPtr<GameActorProxy> pooled = TakePooledActor(actorType);
+      if (pooled.valid())
+      {
+         return pooled.get();
+      }
+
       try
       {
          dtCore::RefPtr<dtDAL::ActorProxy> ap = dtDAL::LibraryManager::GetInstance().CreateActorProxy(actorType).get();
@@ -1077,13 +1437,164 @@ namespace dtGame
             }
          }
 
-         return ap;
+         return ap;
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         mLogger->LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__, "Error creating actor: %s", ex.What().c_str());
+         throw ex;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SetActorPoolSize(const dtDAL::ActorType& actorType, unsigned maxPooled)
+   {
+      if (maxPooled == 0)
+      {
+         mGMImpl->mActorPools.erase(&actorType);
+         return;
+      }
+
+      GMImpl::ActorPool& pool = mGMImpl->mActorPools[&actorType];
+      pool.mMaxSize = maxPooled;
+      if (pool.mActors.size() > maxPooled)
+      {
+         pool.mActors.resize(maxPooled);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned GameManager::GetActorPoolSize(const dtDAL::ActorType& actorType) const
+   {
+      GMImpl::ActorPoolMap::const_iterator found = mGMImpl->mActorPools.find(&actorType);
+      return found == mGMImpl->mActorPools.end() ? 0 : found->second.mMaxSize;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned GameManager::GetNumPooledActors(const dtDAL::ActorType& actorType) const
+   {
+      GMImpl::ActorPoolMap::const_iterator found = mGMImpl->mActorPools.find(&actorType);
+      return found == mGMImpl->mActorPools.end() ? 0 : unsigned(found->second.mActors.size());
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::ClearActorPools()
+   {
+      GMImpl::ActorPoolMap::iterator i, iend;
+      i = mGMImpl->mActorPools.begin();
+      iend = mGMImpl->mActorPools.end();
+      for (; i != iend; ++i)
+      {
+         i->second.mActors.clear();
+         i->second.mDefaults = NULL;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned GameManager::GetNumActorPoolHits() const
+   {
+      return mGMImpl->mGMStatistics.mStatsNumPoolHits;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned GameManager::GetNumActorPoolMisses() const
+   {
+      return mGMImpl->mGMStatistics.mStatsNumPoolMisses;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<GameActorProxy> GameManager::TakePooledActor(const dtDAL::ActorType& actorType)
+   {
+      if (mGMImpl->mActorPools.empty())
+      {
+         return NULL;
+      }
+
+      GMImpl::ActorPoolMap::iterator found = mGMImpl->mActorPools.find(&actorType);
+      if (found == mGMImpl->mActorPools.end())
+      {
+         return NULL;
+      }
+
+      GMImpl::ActorPool& pool = found->second;
+      if (pool.mActors.empty())
+      {
+         ++mGMImpl->mGMStatistics.mStatsNumPoolMisses;
+         return NULL;
+      }
+
+      dtCore::RefPtr<GameActorProxy> gameActorProxy = pool.mActors.back();
+      pool.mActors.pop_back();
+      ++mGMImpl->mGMStatistics.mStatsNumPoolHits;
+
+      // it must not be mistaken for the actor it was before.
+      gameActorProxy->SetId(dtCore::UniqueId());
+      gameActorProxy->SetGameManager(this);
+      return gameActorProxy;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool GameManager::ReturnActorToPool(GameActorProxy& gameActorProxy)
+   {
+      if (mGMImpl->mActorPools.empty())
+      {
+         return false;
+      }
+
+      GMImpl::ActorPoolMap::iterator found = mGMImpl->mActorPools.find(&gameActorProxy.GetActorType());
+      if (found == mGMImpl->mActorPools.end())
+      {
+         return false;
+      }
+
+      GMImpl::ActorPool& pool = found->second;
+      // the delete list holds the only reference unless something else is still using the actor.
+      if (gameActorProxy.referenceCount() > 1 || pool.mActors.size() >= pool.mMaxSize)
+      {
+         ++mGMImpl->mGMStatistics.mStatsNumPoolDiscards;
+         return false;
+      }
+
+      if (!pool.mDefaults.valid())
+      {
+         try
+         {
+            dtCore::RefPtr<dtDAL::ActorProxy> defaults = mLibMgr->CreateActorProxy(gameActorProxy.GetActorType()).get();
+            pool.mDefaults = dynamic_cast<GameActorProxy*>(defaults.get());
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            ex.LogException(dtUtil::Log::LOG_ERROR, *mLogger);
+         }
+
+         if (!pool.mDefaults.valid())
+         {
+            ++mGMImpl->mGMStatistics.mStatsNumPoolDiscards;
+            return false;
+         }
       }
-      catch (const dtUtil::Exception& ex)
+
+      GameActorProxy& defaults = *pool.mDefaults;
+
+      // InvokeRemovedFromWorld has already removed the components that the actor was made with,
+      // and copying the properties can't put them back, so an actor that should have any is let go.
+      if (defaults.GetGameActor().GetNumComponents() > 0)
       {
-         mLogger->LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__, "Error creating actor: %s", ex.What().c_str());
-         throw ex;
+         ++mGMImpl->mGMStatistics.mStatsNumPoolDiscards;
+         return false;
       }
+
+      gameActorProxy.SetName(defaults.GetName());
+      gameActorProxy.CopyPropertiesFrom(defaults);
+      gameActorProxy.ClearDirtyProperties();
+      gameActorProxy.SetRemote(false);
+      gameActorProxy.SetPublished(false);
+      gameActorProxy.SetPublishDirtyPropertiesOnTick(defaults.GetPublishDirtyPropertiesOnTick());
+      gameActorProxy.GetGameActor().SetPrototypeName(defaults.GetGameActor().GetPrototypeName());
+
+      pool.mActors.push_back(&gameActorProxy);
+      ++mGMImpl->mGMStatistics.mStatsNumActorsPooled;
+      return true;
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1102,7 +1613,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::AddActor(dtDAL::ActorProxy& actorProxy)
    {
-      if (actorProxy.GetId().ToString().empty())
+      if (actorProxy.GetId().IsNull())
       {
          throw dtUtil::Exception(ExceptionEnum::INVALID_ACTOR_STATE,
             "Actors may not be added the GM with an empty unique id", __FILE__, __LINE__);
@@ -1132,23 +1643,14 @@ namespace dtGame
          mActorProxyMap.insert(std::make_pair(actorProxy.GetId(), &actorProxy));
          mScene->AddDrawable(actorProxy.GetActor());
       }
+
+      mGMImpl->mSpatialIndex.Insert(actorProxy);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::AddActor(GameActorProxy& gameActorProxy, bool isRemote, bool publish)
    {
-      if (gameActorProxy.GetId().ToString().empty())
-      {
-         throw dtUtil::Exception(ExceptionEnum::INVALID_ACTOR_STATE,
-            "Actors may not be added the GM with an empty unique id", __FILE__, __LINE__);
-      }
-
-      // Fail early here so that it doesn't fail is PublishActor and need to wait a tick to
-      // clean up the actor.
-      if (publish && isRemote)
-      {
-         throw dtUtil::Exception(ExceptionEnum::ACTOR_IS_REMOTE, "A remote game actor may not be published", __FILE__, __LINE__);
-      }
+      CheckActorCanBeAdded(gameActorProxy, isRemote, publish);
 
       gameActorProxy.SetGameManager(this);
       gameActorProxy.SetRemote(isRemote);
@@ -1174,6 +1676,86 @@ namespace dtGame
          mScene->AddDrawable(gameActorProxy.GetActor());
       }
 
+      mGMImpl->mSpatialIndex.Insert(gameActorProxy);
+
+      ActorEnteredGM(gameActorProxy, publish);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::AddActors(const std::vector<dtCore::RefPtr<GameActorProxy> >& actors, bool isRemote, bool publish)
+   {
+      for (size_t i = 0; i < actors.size(); ++i)
+      {
+         CheckActorCanBeAdded(*actors[i], isRemote, publish);
+      }
+
+      // Insert them all into the GM and the scene before any of them enters the world.
+      std::vector<dtCore::DeltaDrawable*> drawables;
+      drawables.reserve(actors.size());
+      IEnvGameActor* ea = mEnvironment.valid() ? static_cast<IEnvGameActor*>(mEnvironment->GetActor()) : NULL;
+      for (size_t i = 0; i < actors.size(); ++i)
+      {
+         GameActorProxy& gameActorProxy = *actors[i];
+         gameActorProxy.SetGameManager(this);
+         gameActorProxy.SetRemote(isRemote);
+         mGameActorProxyMap.insert(std::make_pair(gameActorProxy.GetId(), &gameActorProxy));
+         mGMImpl->mSpatialIndex.Insert(gameActorProxy);
+
+         if (ea != NULL)
+         {
+            ea->AddActor(*gameActorProxy.GetActor());
+         }
+         else
+         {
+            drawables.push_back(gameActorProxy.GetActor());
+         }
+      }
+      mScene->AddDrawables(drawables);
+
+      size_t entered = 0;
+      try
+      {
+         for (; entered < actors.size(); ++entered)
+         {
+            ActorEnteredGM(*actors[entered], publish);
+         }
+      }
+      catch (const dtUtil::Exception&)
+      {
+         // The one that failed deleted itself.  The rest never entered the world, so just take them out again.
+         for (size_t i = entered + 1; i < actors.size(); ++i)
+         {
+            GameActorProxy& gameActorProxy = *actors[i];
+            RemoveActorFromScene(gameActorProxy);
+            mGMImpl->mSpatialIndex.Remove(gameActorProxy);
+            mGameActorProxyMap.erase(gameActorProxy.GetId());
+         }
+         throw;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::CheckActorCanBeAdded(const GameActorProxy& gameActorProxy, bool isRemote, bool publish) const
+   {
+      if (gameActorProxy.GetId().IsNull())
+      {
+         throw dtUtil::Exception(ExceptionEnum::INVALID_ACTOR_STATE,
+            "Actors may not be added the GM with an empty unique id", __FILE__, __LINE__);
+      }
+
+      // Fail early here so that it doesn't fail is PublishActor and need to wait a tick to
+      // clean up the actor.
+      if (publish && isRemote)
+      {
+         throw dtUtil::Exception(ExceptionEnum::ACTOR_IS_REMOTE, "A remote game actor may not be published", __FILE__, __LINE__);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::ActorEnteredGM(GameActorProxy& gameActorProxy, bool publish)
+   {
+      bool isRemote = gameActorProxy.IsRemote();
+
       // Remote actors are normally created in response to a create message, so sending another is silly.
       // Also, this doen't currently send messages when loading a map, so check here for that state.
       if (!isRemote && mMapChangeStateData->GetCurrentState() == MapChangeStateData::MapChangeState::IDLE)
@@ -1183,6 +1765,8 @@ namespace dtGame
          SendMessage(*msg);
       }
 
+      // the create message has all the values, so nothing set before now needs to be sent again.
+      gameActorProxy.ClearDirtyProperties();
       gameActorProxy.SetIsInGM(true);
 
       try
@@ -1216,23 +1800,73 @@ namespace dtGame
       dtDAL::ActorProxy* ourObject = FindPrototypeByID(uniqueID);
       if (ourObject != NULL)
       {
-         dtCore::RefPtr<dtDAL::ActorProxy> temp = ourObject->Clone().get();
-         dtGame::GameActorProxy* gap = dynamic_cast<dtGame::GameActorProxy*>(temp.get());
-         if (gap != NULL)
+         return CloneActorFromPrototype(*ourObject);
+      }
+      return NULL;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<dtDAL::ActorProxy> GameManager::CloneActorFromPrototype(dtDAL::ActorProxy& prototype)
+   {
+      dtCore::RefPtr<dtDAL::ActorProxy> temp;
+
+      // A pooled actor already has the default values, so it only needs the prototype's copied in.
+      dtCore::RefPtr<GameActorProxy> pooled = TakePooledActor(prototype.GetActorType());
+      if (pooled.valid())
+      {
+         pooled->SetName(prototype.GetName());
+         pooled->CopyPropertiesFrom(prototype);
+         temp = pooled.get();
+      }
+      else
+      {
+         temp = prototype.Clone().get();
+      }
+
+      dtGame::GameActorProxy* gap = dynamic_cast<dtGame::GameActorProxy*>(temp.get());
+      if (gap != NULL)
+      {
+         gap->SetGameManager(this);
+
+         // Actors created from prototype hold onto the prototype name - for use
+         // across networks, via replay, and so forth.
+         dtGame::GameActor* gameActor = dynamic_cast<dtGame::GameActor*>(gap->GetActor());
+         if (gameActor != NULL)
          {
-            gap->SetGameManager(this);
+            gameActor->SetPrototypeName(prototype.GetName());
+         }
+      }
+      return temp;
+   }
 
-            // Actors created from prototype hold onto the prototype name - for use
-            // across networks, via replay, and so forth.
-            dtGame::GameActor* gameActor = dynamic_cast<dtGame::GameActor*>(gap->GetActor());
-            if (gameActor != NULL)
-            {
-               gameActor->SetPrototypeName(ourObject->GetName());
-            }
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::CreateActorsFromPrototype(const dtCore::UniqueId& uniqueID, unsigned count,
+            std::vector<dtCore::RefPtr<GameActorProxy> >& toFill, bool isRemote, bool publish)
+   {
+      toFill.clear();
+
+      dtDAL::ActorProxy* prototype = FindPrototypeByID(uniqueID);
+      if (prototype == NULL)
+      {
+         throw dtUtil::Exception(ExceptionEnum::INVALID_PARAMETER,
+                  "No prototype exists with the id \"" + uniqueID.ToString() + "\".", __FILE__, __LINE__);
+      }
+
+      toFill.reserve(count);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         dtCore::RefPtr<dtDAL::ActorProxy> proxy = CloneActorFromPrototype(*prototype);
+         GameActorProxy* gap = dynamic_cast<GameActorProxy*>(proxy.get());
+         if (gap == NULL)
+         {
+            toFill.clear();
+            throw dtUtil::Exception(ExceptionEnum::INVALID_PARAMETER,
+                     "The prototype \"" + prototype->GetName() + "\" could not be cloned as a game actor.", __FILE__, __LINE__);
          }
-         return temp;
+         toFill.push_back(gap);
       }
-      return NULL;
+
+      AddActors(toFill, isRemote, publish);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1299,7 +1933,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::PublishActor(GameActorProxy& gameActorProxy)
    {
-      std::map<dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::iterator itor = mGameActorProxyMap.find(gameActorProxy.GetId());
+      GameActorMap::iterator itor = mGameActorProxyMap.find(gameActorProxy.GetId());
 
       if (itor == mGameActorProxyMap.end())
       {
@@ -1347,18 +1981,19 @@ namespace dtGame
          }
       }
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::iterator itor = mGameActorProxyMap.find(actorProxy.GetId());
+      GameActorMap::iterator itor = mGameActorProxyMap.find(actorProxy.GetId());
 
       dtCore::UniqueId id;
       if (itor == mGameActorProxyMap.end())
       {
          // it's not in the game manager as a game actor proxy, maybe it's in there
          // as a regular actor proxy.
-         std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> >::iterator itor = mActorProxyMap.find(actorProxy.GetId());
+         ActorMap::iterator itor = mActorProxyMap.find(actorProxy.GetId());
 
          if (itor != mActorProxyMap.end())
          {
             RemoveActorFromScene(actorProxy);
+            mGMImpl->mSpatialIndex.Remove(actorProxy);
             mActorProxyMap.erase(itor);
          }
       }
@@ -1451,15 +2086,16 @@ namespace dtGame
          }
 
          mActorProxyMap.clear();
-         mGlobalMessageListeners.clear();
-         mActorMessageListeners.clear();
+         ClearInvokableListeners();
          mGameActorProxyMap.clear();
-         mRealTimeTimers.clear();
-         mSimulationTimers.clear();
+         mGMImpl->mSpatialIndex.Clear();
+         mGMImpl->mRealTimeTimers.Clear();
+         mGMImpl->mSimulationTimers.Clear();
 
          // all the actors are deleted now, so the problems with clearing the list
          // of deleted actors is not a problem.
          mDeleteList.clear();
+         ClearActorPools();
       }
       else
       {
@@ -1468,7 +2104,7 @@ namespace dtGame
             DeleteActor(*mActorProxyMap.begin()->second);
          }
 
-         for (std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::iterator i = mGameActorProxyMap.begin();
+         for (GameActorMap::iterator i = mGameActorProxyMap.begin();
             i != mGameActorProxyMap.end(); ++i)
          {
             DeleteActor(*i->second);
@@ -1487,7 +2123,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::DeletePrototype(const dtCore::UniqueId& uniqueId)
    {
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::iterator itor = mPrototypeActors.find(uniqueId);
+      GameActorMap::iterator itor = mPrototypeActors.find(uniqueId);
       if (itor != mPrototypeActors.end())
       {
          mPrototypeActors.erase(itor);
@@ -1501,13 +2137,13 @@ namespace dtGame
 
       // spin through the actors and add all used actor types to the set, so that we don't
       // get duplicates.
-      for (std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor = mGameActorProxyMap.begin();
+      for (GameActorMap::const_iterator itor = mGameActorProxyMap.begin();
          itor != mGameActorProxyMap.end(); ++itor)
       {
          toFill.insert(&itor->second->GetActorType());
       }
 
-      for (std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> >::const_iterator itor = mActorProxyMap.begin();
+      for (ActorMap::const_iterator itor = mActorProxyMap.begin();
          itor != mActorProxyMap.end(); ++itor)
       {
          toFill.insert(&itor->second->GetActorType());
@@ -1520,7 +2156,7 @@ namespace dtGame
       toFill.clear();
       toFill.reserve(mGameActorProxyMap.size());
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor;
+      GameActorMap::const_iterator itor;
       for (itor = mGameActorProxyMap.begin(); itor != mGameActorProxyMap.end(); ++itor)
       {
          toFill.push_back(itor->second.get());
@@ -1533,7 +2169,7 @@ namespace dtGame
       toFill.clear();
       toFill.reserve(mActorProxyMap.size());
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> >::const_iterator itor;
+      ActorMap::const_iterator itor;
       for (itor = mActorProxyMap.begin(); itor != mActorProxyMap.end(); ++itor)
       {
          toFill.push_back(itor->second.get());
@@ -1546,13 +2182,13 @@ namespace dtGame
       toFill.clear();
       toFill.reserve(mGameActorProxyMap.size() + mActorProxyMap.size() + mPrototypeActors.size());
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor;
+      GameActorMap::const_iterator itor;
       for (itor = mGameActorProxyMap.begin(); itor != mGameActorProxyMap.end(); ++itor)
       {
          toFill.push_back(itor->second.get());
       }
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> >::const_iterator iter;
+      ActorMap::const_iterator iter;
       for (iter = mActorProxyMap.begin(); iter != mActorProxyMap.end(); ++iter)
       {
          toFill.push_back(iter->second.get());
@@ -1576,7 +2212,7 @@ namespace dtGame
       toFill.clear();
       toFill.reserve(mPrototypeActors.size());
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor;
+      GameActorMap::const_iterator itor;
       for (itor = mPrototypeActors.begin(); itor != mPrototypeActors.end(); ++itor)
       {
          toFill.push_back(itor->second.get());
@@ -1701,7 +2337,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    dtDAL::ActorProxy* GameManager::FindPrototypeByID(const dtCore::UniqueId& uniqueID)
    {
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor = mPrototypeActors.find(uniqueID);
+      GameActorMap::const_iterator itor = mPrototypeActors.find(uniqueID);
       if (itor != mPrototypeActors.end())
       {
          return itor->second.get();
@@ -1713,13 +2349,46 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::FindActorsWithinRadius(const float radius, std::vector<dtDAL::ActorProxy*>& toFill) const
    {
-      toFill.clear();
+      FindActorsWithinRadius(osg::Vec3(0.0f, 0.0f, 0.0f), radius, toFill);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindActorsWithinRadius(const osg::Vec3& position, float radius,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type) const
+   {
+      mGMImpl->mSpatialIndex.FindWithinRadius(position, radius, toFill, type);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindActorsWithinBox(const osg::BoundingBox& box,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type) const
+   {
+      mGMImpl->mSpatialIndex.FindWithinBox(box, toFill, type);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindNearestActors(const osg::Vec3& position, unsigned count,
+            std::vector<dtDAL::ActorProxy*>& toFill, const dtDAL::ActorType* type, float maxRadius) const
+   {
+      mGMImpl->mSpatialIndex.FindNearest(position, count, maxRadius, toFill, type);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SetSpatialIndexCellSize(float cellSize)
+   {
+      mGMImpl->mSpatialIndex.SetCellSize(cellSize);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   float GameManager::GetSpatialIndexCellSize() const
+   {
+      return mGMImpl->mSpatialIndex.GetCellSize();
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    GameActorProxy* GameManager::FindGameActorById(const dtCore::UniqueId& id) const
    {
-      std::map< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> >::const_iterator itor = mGameActorProxyMap.find(id);
+      GameActorMap::const_iterator itor = mGameActorProxyMap.find(id);
       return itor == mGameActorProxyMap.end() ? NULL : itor->second.get();
    }
 
@@ -1733,7 +2402,7 @@ namespace dtGame
          return actorProxy;
       }
 
-      std::map< dtCore::UniqueId, dtCore::RefPtr<dtDAL::ActorProxy> >::const_iterator itor = mActorProxyMap.find(id);
+      ActorMap::const_iterator itor = mActorProxyMap.find(id);
       return itor == mActorProxyMap.end() ? NULL : itor->second.get();
    }
 
@@ -1799,62 +2468,93 @@ namespace dtGame
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::SetTimer(const std::string& name, const GameActorProxy* aboutActor,
+   void GameManager::SetLoadMapsInBackground(bool background)
+   {
+      mMapChangeStateData->SetLoadInBackground(background);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool GameManager::GetLoadMapsInBackground() const
+   {
+      return mMapChangeStateData->GetLoadInBackground();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SetMapLoadFrameBudget(float milliseconds)
+   {
+      mMapChangeStateData->SetFrameBudget(milliseconds);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   float GameManager::GetMapLoadFrameBudget() const
+   {
+      return mMapChangeStateData->GetFrameBudget();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   GameManager::TimerHandle GameManager::SetTimer(const std::string& name, const GameActorProxy* aboutActor,
       float time, bool repeat, bool realTime)
    {
-      TimerInfo t;
-      t.name = name;
+      dtCore::UniqueId aboutActorId("");
+      if (aboutActor != NULL)
+      {
+         aboutActorId = aboutActor->GetId();
+      }
 
-      if (aboutActor == NULL)
+      dtCore::Timer_t interval = dtCore::Timer_t(time * 1e6);
+      dtCore::Timer_t expireTime;
+      if (realTime)
       {
-         t.aboutActor = dtCore::UniqueId("");
+         expireTime = GetRealClockTime() + interval;
       }
       else
       {
-         t.aboutActor = aboutActor->GetId();
+         expireTime = dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0) + interval;
       }
 
-      t.interval = dtCore::Timer_t(time * 1e6);
-      if (realTime)
+      TimerWheel& timers = realTime ? mGMImpl->mRealTimeTimers : mGMImpl->mSimulationTimers;
+      // the low bit says which wheel the timer is in.  Wheel handles never use the top bit.
+      return (timers.Add(name, aboutActorId, expireTime, repeat, interval) << 1) | (realTime ? 1 : 0);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::ClearTimer(const std::string& name, const GameActorProxy* proxy)
+   {
+      if (proxy == NULL)
       {
-         t.time = GetRealClockTime() + t.interval;
+         mGMImpl->mRealTimeTimers.Remove(name, NULL);
+         mGMImpl->mSimulationTimers.Remove(name, NULL);
       }
       else
       {
-         t.time = dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0) + t.interval;
+         const dtCore::UniqueId& id = proxy->GetId();
+         mGMImpl->mRealTimeTimers.Remove(name, &id);
+         mGMImpl->mSimulationTimers.Remove(name, &id);
       }
-
-      t.repeat = repeat;
-      realTime ? mRealTimeTimers.insert(t) : mSimulationTimers.insert(t);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::ClearTimerSingleSet(std::set<TimerInfo>& timerSet,
-         const std::string& name, const GameActorProxy* proxy)
+   bool GameManager::ClearTimer(TimerHandle handle)
    {
-      std::set<TimerInfo>::iterator i = timerSet.begin();
-      while (i != timerSet.end())
+      if (handle == INVALID_TIMER_HANDLE)
       {
-         std::set<TimerInfo>::iterator toDelete;
-         const TimerInfo& timer = *i;
-         if (timer.name == name &&  (proxy == NULL || timer.aboutActor == proxy->GetId()))
-         {
-            toDelete = i;
-            ++i;
-            timerSet.erase(toDelete);
-         }
-         else
-         {
-            ++i;
-         }
+         return false;
       }
+
+      TimerWheel& timers = (handle & 1) != 0 ? mGMImpl->mRealTimeTimers : mGMImpl->mSimulationTimers;
+      return timers.Remove(handle >> 1);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::ClearTimer(const std::string& name, const GameActorProxy* proxy)
+   bool GameManager::IsTimerSet(TimerHandle handle) const
    {
-      ClearTimerSingleSet(mRealTimeTimers, name, proxy);
-      ClearTimerSingleSet(mSimulationTimers, name, proxy);
+      if (handle == INVALID_TIMER_HANDLE)
+      {
+         return false;
+      }
+
+      const TimerWheel& timers = (handle & 1) != 0 ? mGMImpl->mRealTimeTimers : mGMImpl->mSimulationTimers;
+      return timers.IsPending(handle >> 1);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1862,16 +2562,22 @@ namespace dtGame
          std::vector< std::pair<GameActorProxy*, std::string> >& toFill) const
    {
       toFill.clear();
-      toFill.reserve(mGlobalMessageListeners.size());
 
-      std::multimap<const MessageType*, std::pair< dtCore::RefPtr<GameActorProxy>, std::string> >::const_iterator  itor
-         = mGlobalMessageListeners.find(&type);
+      GlobalMessageListenerMap::const_iterator found = mGlobalMessageListeners.find(&type);
+      if (found == mGlobalMessageListeners.end())
+      {
+         return;
+      }
 
-      while (itor != mGlobalMessageListeners.end() && itor->first == &type)
+      const InvokableListenerList& listeners = found->second;
+      toFill.reserve(listeners.size());
+      for (InvokableListenerList::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
       {
-         // add the game actor proxy and invokable name to a new pair in the vector.
-         toFill.push_back(std::make_pair(itor->second.first.get(), itor->second.second));
-         ++itor;
+         if (i->mProxy.valid())
+         {
+            // add the game actor proxy and invokable name to a new pair in the vector.
+            toFill.push_back(std::make_pair(i->mProxy.get(), i->mInvokableName));
+         }
       }
    }
 
@@ -1881,21 +2587,26 @@ namespace dtGame
          std::string> >& toFill) const
    {
       toFill.clear();
-      toFill.reserve(mActorMessageListeners.size());
 
-      std::map< const MessageType*, std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> > >::const_iterator itor
-         = mActorMessageListeners.find(&type);
+      ActorMessageListenerMap::const_iterator foundType = mActorMessageListeners.find(&type);
+      if (foundType == mActorMessageListeners.end())
+      {
+         return;
+      }
 
-      if (itor != mActorMessageListeners.end())
+      AboutActorListenerMap::const_iterator found = foundType->second.find(targetActorId);
+      if (found == foundType->second.end())
       {
+         return;
+      }
 
-         //second on itor is the internal map.
-         std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::const_iterator itorInner
-            = itor->second.find(targetActorId);
-         while (itorInner != itor->second.end() && itorInner->first == targetActorId)
+      const InvokableListenerList& listeners = found->second;
+      toFill.reserve(listeners.size());
+      for (InvokableListenerList::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
+      {
+         if (i->mProxy.valid())
          {
-            toFill.push_back(std::make_pair(itorInner->second.first.get(), itorInner->second.second));
-            ++itorInner;
+            toFill.push_back(std::make_pair(i->mProxy.get(), i->mInvokableName));
          }
       }
    }
@@ -1921,31 +2632,59 @@ namespace dtGame
    {
       ValidateMessageType(type, proxy, invokableName);
 
-      mGlobalMessageListeners.insert(
-            std::make_pair(&type,
-                  std::make_pair(dtCore::RefPtr<GameActorProxy>(&proxy), invokableName)));
+      AddInvokableListener(mGlobalMessageListeners[&type], proxy, invokableName);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::RegisterForTicks(const MessageType& type, GameActorProxy& proxy,
+         const std::string& invokableName, unsigned interval, unsigned phase)
+   {
+      if (type != MessageType::TICK_LOCAL && type != MessageType::TICK_REMOTE)
+      {
+         throw dtUtil::Exception(ExceptionEnum::INVALID_PARAMETER, "Only MessageType::TICK_LOCAL and MessageType::TICK_REMOTE"
+                  " may be registered for with a tick interval, not \"" + type.GetName() + "\".", __FILE__, __LINE__);
+      }
+
+      InvokableListenerList& listeners = mGlobalMessageListeners[&type];
+      AddInvokableListener(listeners, proxy, invokableName);
+
+      if (interval > 1)
+      {
+         if (phase == GameActorProxy::AUTO_TICK_PHASE)
+         {
+            phase = mGMImpl->mNextTickPhase[interval]++;
+         }
 
+         InvokableListener& listener = listeners.back();
+         listener.mTickInterval = interval;
+         listener.mTicksToSkip = phase % interval;
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::UnregisterForMessages(const MessageType& type, GameActorProxy& proxy,
          const std::string& invokableName)
    {
-      std::multimap< const MessageType*, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator itor
-         = mGlobalMessageListeners.find(&type);
+      GlobalMessageListenerMap::iterator found = mGlobalMessageListeners.find(&type);
+      if (found == mGlobalMessageListeners.end())
+      {
+         return;
+      }
 
-      while (itor != mGlobalMessageListeners.end() && itor->first == &type)
+      InvokableListenerList& listeners = found->second;
+      for (unsigned i = 0; i < listeners.size(); ++i)
       {
-         if (itor->second.first.get() == &proxy && itor->second.second == invokableName)
-         {
-            mGlobalMessageListeners.erase(itor);
-            return;
-         }
-         else
+         if (listeners[i].mProxy.get() == &proxy && listeners[i].mInvokableName == invokableName)
          {
-            ++itor;
+            RemoveInvokableListener(listeners, i);
+            break;
          }
       }
+
+      if (listeners.empty())
+      {
+         mGlobalMessageListeners.erase(found);
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1955,89 +2694,91 @@ namespace dtGame
    {
       ValidateMessageType(type, proxy, invokableName);
 
-      ActorMessageListenerMap::iterator itor = mActorMessageListeners.find(&type);
+      AddInvokableListener(mActorMessageListeners[&type][targetActorId], proxy, invokableName);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::UnregisterForMessagesAboutActor(const MessageType& type,
+         const dtCore::UniqueId& targetActorId, GameActorProxy& proxy,
+         const std::string& invokableName)
+   {
+      ActorMessageListenerMap::iterator foundType = mActorMessageListeners.find(&type);
+      if (foundType == mActorMessageListeners.end())
+      {
+         return;
+      }
 
-      ProxyInvokableMap* mapForType = NULL;
+      AboutActorListenerMap& aboutActorListeners = foundType->second;
+      AboutActorListenerMap::iterator found = aboutActorListeners.find(targetActorId);
+      if (found == aboutActorListeners.end())
+      {
+         return;
+      }
 
-      if (itor == mActorMessageListeners.end())
+      InvokableListenerList& listeners = found->second;
+      for (unsigned i = unsigned(listeners.size()); i > 0; --i)
       {
-         itor = mActorMessageListeners.insert(std::make_pair(&type, ProxyInvokableMap())).first;
-         if (itor != mActorMessageListeners.end())
-         {
-            mapForType = &itor->second;
-         }
-         else
+         if (listeners[i - 1].mProxy.get() == &proxy && listeners[i - 1].mInvokableName == invokableName)
          {
-            // this is one of those "it should never happen" things.
-            throw dtUtil::Exception(ExceptionEnum::GENERAL_GAMEMANAGER_EXCEPTION,
-               "Internal Error: Unable to find item just inserted in the map.", __FILE__, __LINE__);
+            RemoveInvokableListener(listeners, i - 1);
          }
       }
-      else
+
+      if (listeners.empty())
       {
-         mapForType = &itor->second;
+         aboutActorListeners.erase(found);
+         if (aboutActorListeners.empty())
+         {
+            mActorMessageListeners.erase(foundType);
+         }
       }
-
-      mapForType->insert(std::make_pair(targetActorId, std::make_pair(dtCore::RefPtr<GameActorProxy>(&proxy), invokableName)));
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::UnregisterForMessagesAboutActor(const MessageType& type,
-         const dtCore::UniqueId& targetActorId, GameActorProxy& proxy,
-         const std::string& invokableName)
+   void GameManager::UnregisterAllMessageListenersForActor(GameActorProxy& proxy)
    {
-      std::map< const MessageType*, std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> > >::iterator itor
-         = mActorMessageListeners.find(&type);
-
-      if (itor != mActorMessageListeners.end())
+      for (GlobalMessageListenerMap::iterator i = mGlobalMessageListeners.begin(); i != mGlobalMessageListeners.end(); ++i)
       {
-         //second on itor is the internal map.
-         std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator itorInner
-            = itor->second.find(targetActorId);
-         while (itorInner != itor->second.end() && itorInner->first == targetActorId)
+         InvokableListenerList& listeners = i->second;
+         for (unsigned j = unsigned(listeners.size()); j > 0; --j)
          {
-            //second is a pair.
-            //second.first is the game actor proxy to receive the message second.second is the name of the invokable
-            if (itorInner->second.first.get() == &proxy && itorInner->second.second == invokableName)
-            {
-               std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator toDelete =
-                  itorInner;
-               ++itorInner;
-               itor->second.erase(toDelete);
-            }
-            else
+            if (listeners[j - 1].mProxy.get() == &proxy)
             {
-               ++itorInner;
+               RemoveInvokableListener(listeners, j - 1);
             }
          }
       }
-   }
 
-   ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::UnregisterAllMessageListenersForActor(GameActorProxy& proxy)
-   {
-      for (std::multimap< const MessageType*, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator i
-         = mGlobalMessageListeners.begin(); i != mGlobalMessageListeners.end();)
+      const dtCore::UniqueId& id = proxy.GetId();
+      for (ActorMessageListenerMap::iterator i = mActorMessageListeners.begin(); i != mActorMessageListeners.end(); ++i)
       {
-         std::multimap< const MessageType*, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator toDelete = i;
-         ++i;
-         if (toDelete->second.first.get() == &proxy)
+         for (AboutActorListenerMap::iterator k = i->second.begin(); k != i->second.end(); ++k)
          {
-            mGlobalMessageListeners.erase(toDelete);
+            bool aboutProxy = k->first == id;
+            InvokableListenerList& listeners = k->second;
+            for (unsigned j = unsigned(listeners.size()); j > 0; --j)
+            {
+               if (aboutProxy || listeners[j - 1].mProxy.get() == &proxy)
+               {
+                  RemoveInvokableListener(listeners, j - 1);
+               }
+            }
          }
       }
 
-      for (std::map< const MessageType*, std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> > >::iterator i
-         = mActorMessageListeners.begin(); i != mActorMessageListeners.end(); ++i)
+      if (mGMImpl->mInvokableDispatchDepth == 0)
       {
-         for (std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator j
-            = i->second.begin(); j != i->second.end();)
+         EraseEmptyListenerLists(mGlobalMessageListeners);
+
+         ActorMessageListenerMap::iterator i = mActorMessageListeners.begin();
+         while (i != mActorMessageListeners.end())
          {
-            std::multimap< dtCore::UniqueId, std::pair<dtCore::RefPtr<GameActorProxy>, std::string> >::iterator toDelete = j;
-            ++j;
-            if (toDelete->first == proxy.GetId() || toDelete->second.first.get() == &proxy)
+            ActorMessageListenerMap::iterator current = i;
+            ++i;
+            EraseEmptyListenerLists(current->second);
+            if (current->second.empty())
             {
-               i->second.erase(toDelete);
+               mActorMessageListeners.erase(current);
             }
          }
       }
@@ -2081,43 +2822,26 @@ namespace dtGame
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::ProcessTimers(std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime)
+   void GameManager::ProcessTimers(TimerWheel& timers, dtCore::Timer_t clockTime)
    {
-      std::set<TimerInfo>::iterator itor;
-      std::set<TimerInfo> repeatingTimers;
-      for (itor=listToProcess.begin(); itor!=listToProcess.end();)
-      {
-         if (itor->time <= clockTime)
-         {
-            dtCore::RefPtr<TimerElapsedMessage> timerMsg =
-               static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
+      DT_TRACE_SCOPE("GameManager::ProcessTimers");
+      std::vector<TimerWheel::ExpiredTimer>& expired = mGMImpl->mExpiredTimers;
+      timers.Advance(clockTime, expired);
 
-            timerMsg->SetTimerName(itor->name);
-            float lateTime = float((clockTime - itor->time));
-            // convert from microseconds to seconds
-            lateTime /= 1e6;
-            timerMsg->SetLateTime(lateTime);
-            timerMsg->SetAboutActorId(itor->aboutActor);
-            SendMessage(*timerMsg.get());
-            if (itor->repeat)
-            {
-               TimerInfo tInfo = *itor;
-               tInfo.time += tInfo.interval;
-               repeatingTimers.insert(tInfo);
-            }
+      for (unsigned i = 0; i < expired.size(); ++i)
+      {
+         const TimerWheel::ExpiredTimer& timer = expired[i];
+         dtCore::RefPtr<TimerElapsedMessage> timerMsg =
+            static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
 
-            std::set<TimerInfo>::iterator toDelete = itor;
-            ++itor;
-            listToProcess.erase(toDelete);
-         }
-         else
-         {
-            break;
-         }
+         timerMsg->SetTimerName(timer.mName);
+         float lateTime = float((clockTime - timer.mTime));
+         // convert from microseconds to seconds
+         lateTime /= 1e6;
+         timerMsg->SetLateTime(lateTime);
+         timerMsg->SetAboutActorId(timer.mAboutActor);
+         SendMessage(*timerMsg.get());
       }
-
-      // Repeating timers have to be readded so they are processed again later
-      listToProcess.insert(repeatingTimers.begin(), repeatingTimers.end());
    }
 
    ///////////////////////////////////////////////////////////////////////////////
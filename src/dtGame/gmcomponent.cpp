@@ -21,12 +21,15 @@
 #include <prefix/dtgameprefix-src.h>
 #include <dtGame/gmcomponent.h>
 #include <dtGame/message.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/tracer.h>
 
 namespace dtGame
 {
    //////////////////////////////////////////////
    GMComponent::GMComponent(const std::string& name) : dtCore::Base(name), mParent(NULL),
-      mPriority(&GameManager::ComponentPriority::NORMAL)
+      mPriority(&GameManager::ComponentPriority::NORMAL),
+      mTraceName(dtUtil::Tracer::InternName(name))
    {
    }
 
@@ -51,6 +54,62 @@ namespace dtGame
       return *mPriority;
    }
 
+   //////////////////////////////////////////////
+   void GMComponent::AddMessageTypeInterest(const MessageType& type)
+   {
+      if (mMessageTypeInterests.insert(&type).second)
+      {
+         MessageTypeInterestsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::RemoveMessageTypeInterest(const MessageType& type)
+   {
+      if (mMessageTypeInterests.erase(&type) > 0)
+      {
+         MessageTypeInterestsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::ClearMessageTypeInterests()
+   {
+      if (!mMessageTypeInterests.empty())
+      {
+         mMessageTypeInterests.clear();
+         MessageTypeInterestsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   bool GMComponent::IsInterestedInMessageType(const MessageType& type) const
+   {
+      return mMessageTypeInterests.empty() || mMessageTypeInterests.find(&type) != mMessageTypeInterests.end();
+   }
+
+   //////////////////////////////////////////////
+   bool GMComponent::IsInterestedInAllMessageTypes() const
+   {
+      return mMessageTypeInterests.empty();
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::GetMessageTypeInterests(std::vector<const MessageType*>& toFill) const
+   {
+      toFill.clear();
+      toFill.insert(toFill.end(), mMessageTypeInterests.begin(), mMessageTypeInterests.end());
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::MessageTypeInterestsChanged()
+   {
+      if (mParent != NULL)
+      {
+         mParent->InvalidateComponentDispatch();
+      }
+   }
+
    //////////////////////////////////////////////
    void GMComponent::OnAddedToGM() {}
 
@@ -61,6 +120,8 @@ namespace dtGame
    void GMComponent::SetGameManager(GameManager* gameManager)
    {
       mParent = gameManager;
+      // Interned here rather than per message, so dispatching never takes the string table lock.
+      mTraceName = dtUtil::Tracer::InternName(GetName());
    }
 
    //////////////////////////////////////////////
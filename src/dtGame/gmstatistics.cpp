@@ -41,6 +41,10 @@ namespace dtGame
       , mStatsCumGMProcessTime(0)
       , mStatsCurFrameActorTotal(0.0f)
       , mStatsCurFrameCompTotal(0.0f)
+      , mStatsNumPoolHits(0)
+      , mStatsNumPoolMisses(0)
+      , mStatsNumActorsPooled(0)
+      , mStatsNumPoolDiscards(0)
       , mStatisticsInterval(0)
       , mPrintFileToConsole(false)
       , mDoStatsOnTheComponents(false)
@@ -91,7 +95,7 @@ namespace dtGame
                                       const std::string& nameOfObject, float elapsedTime, bool isComponent, bool ticklocal)
    {
 
-      std::map<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation> >::iterator itor =
+      DebugInfoMap::iterator itor =
          mDebugLoggerInformation.find(uniqueIDToFind);
       if (itor != mDebugLoggerInformation.end())
       {
@@ -187,6 +191,12 @@ namespace dtGame
          " Ntwrk], #Actors[" << ourGm.mActorProxyMap.size() << "/" << ourGm.mGameActorProxyMap.size() <<
          " Game/" << ourGm.mActorProxyMap.size() << "]" << std::endl;
 
+      if (mStatsNumPoolHits > 0 || mStatsNumPoolMisses > 0 || mStatsNumActorsPooled > 0 || mStatsNumPoolDiscards > 0)
+      {
+         ss << "Actor Pools: Hits[" << mStatsNumPoolHits << "], Misses[" << mStatsNumPoolMisses <<
+            "], Pooled[" << mStatsNumActorsPooled << "], Discarded[" << mStatsNumPoolDiscards << "]" << std::endl;
+      }
+
       // reset values for next fragment
       mStatsNumFrames         = 0;
       mStatsNumProcMessages   = 0;
@@ -194,7 +204,7 @@ namespace dtGame
       mStatsNumSendNetworkMessages = 0;
 
       // Build up all the information in the stream
-      std::map<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation> >::iterator iter = mDebugLoggerInformation.begin();
+      DebugInfoMap::iterator iter = mDebugLoggerInformation.begin();
       if (mDoStatsOnTheComponents)
       {
          ss << "*************** STARTING LOGGING OF TIME IN COMPONENTS *****************" << std::endl;
@@ -298,7 +308,7 @@ namespace dtGame
       for (unsigned int i = 0; i < debugDeleteList.size(); ++i)
       {
          LogDebugInformation &debugInfo = *debugDeleteList[i];
-         std::map<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation> >::iterator deleteIter =
+         DebugInfoMap::iterator deleteIter =
             mDebugLoggerInformation.find(debugInfo.mUniqueID);
          if (deleteIter != mDebugLoggerInformation.end())
          {
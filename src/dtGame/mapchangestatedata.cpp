@@ -21,9 +21,11 @@
 #include <prefix/dtgameprefix-src.h>
 #include <dtUtil/log.h>
 #include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
 
 #include <dtDAL/project.h>
 #include <dtDAL/map.h>
+#include <dtDAL/mapxml.h>
 #include <dtDAL/actortype.h>
 
 #include <dtGame/exceptionenum.h>
@@ -33,8 +35,91 @@
 #include <dtGame/basemessages.h>
 
 #include <dtCore/system.h>
+#include <dtCore/timer.h>
+
+#include <OpenThreads/Thread>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
 namespace dtGame
 {
+   /**
+    * Reads the XML of the new maps, in order, on its own thread.  It only touches the
+    * dtDAL::MapXMLEvents it is given.  The main thread builds the maps, and so creates the actors,
+    * from the events.
+    */
+   class MapParseThread : public OpenThreads::Thread
+   {
+   public:
+      /// @param maps the maps to read.  NULL entries are skipped for the maps that are already open.
+      MapParseThread(const std::vector<dtCore::RefPtr<dtDAL::MapXMLEvents> >& maps)
+         : mMaps(maps)
+         , mNumDone(0)
+         , mCancelled(false)
+      {
+      }
+
+      virtual void run()
+      {
+         for (unsigned i = 0; i < mMaps.size() && !IsCancelled(); ++i)
+         {
+            if (mMaps[i].valid())
+            {
+               mMaps[i]->Read();
+            }
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            ++mNumDone;
+         }
+      }
+
+      /**
+       * Takes the events read from a map.
+       * @param events set to the events, or NULL if the map was skipped.
+       * @return false if the map has not been read yet.
+       * @throws dtUtil::Exception if reading the map failed.
+       */
+      bool TakeResult(unsigned index, dtCore::RefPtr<dtDAL::MapXMLEvents>& events)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         if (index >= mNumDone)
+         {
+            return false;
+         }
+
+         if (mMaps[index].valid() && !mMaps[index]->GetError().empty())
+         {
+            throw dtUtil::Exception(ExceptionEnum::GENERAL_GAMEMANAGER_EXCEPTION,
+                     "Unable to parse map file \"" + mMaps[index]->GetPath() + "\": " + mMaps[index]->GetError(), __FILE__, __LINE__);
+         }
+         events.swap(mMaps[index]);
+         return true;
+      }
+
+      /// Stops reading after the current map.
+      void Cancel()
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mCancelled = true;
+      }
+
+   private:
+      bool IsCancelled()
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         return mCancelled;
+      }
+
+      std::vector<dtCore::RefPtr<dtDAL::MapXMLEvents> > mMaps;
+
+      OpenThreads::Mutex mMutex;
+      unsigned mNumDone;
+      bool mCancelled;
+   };
+
+   /// How many of the events read from a map are sent to the parser between checks of the frame budget.
+   static const unsigned EVENTS_PER_BUDGET_CHECK = 32;
+
    IMPLEMENT_ENUM(MapChangeStateData::MapChangeState);
 
 
@@ -50,8 +135,15 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    MapChangeStateData::MapChangeStateData(GameManager& gm):
       osg::Referenced(), mGameManager(&gm), mCurrentState(&MapChangeStateData::MapChangeState::IDLE),
-      mAddBillboards(false)
+      mAddBillboards(false), mLoadInBackground(false), mFrameBudget(0.0f), mParseThread(NULL),
+      mNextMap(0), mNextActor(0)
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   MapChangeStateData::~MapChangeStateData()
    {
+      EndLoad();
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -107,6 +199,9 @@ namespace dtGame
    {
       if (!mOldMapNames.empty())
       {
+         // the pooled actors may be from libraries that are unloaded with the maps.
+         mGameManager->ClearActorPools();
+
          MapChangeStateData::NameVector::const_iterator i = mOldMapNames.begin();
          MapChangeStateData::NameVector::const_iterator end = mOldMapNames.end();
 
@@ -152,11 +247,7 @@ namespace dtGame
             }
             catch (const dtUtil::Exception&)
             {
-               // if we can't load a map, we go back to idle and send and
-               // empty string map change ended message
-               mCurrentState = &MapChangeState::IDLE;
-               SendMapMessage(MessageType::INFO_MAP_CHANGED, MapChangeStateData::NameVector());
-               mNewMapNames.clear();
+               FailLoad();
                success = false;
                break;
             }
@@ -175,9 +266,144 @@ namespace dtGame
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void MapChangeStateData::LoadSingleMapIntoGM(const std::string& mapName)
+   bool MapChangeStateData::StartParsingNewMaps()
+   {
+      if (mNewMapNames.empty())
+      {
+         return false;
+      }
+
+      dtDAL::Project& project = dtDAL::Project::GetInstance();
+      std::vector<dtCore::RefPtr<dtDAL::MapXMLEvents> > maps;
+      maps.reserve(mNewMapNames.size());
+      try
+      {
+         MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+         MapChangeStateData::NameVector::const_iterator end = mNewMapNames.end();
+         for (; i != end; ++i)
+         {
+            if (project.IsMapOpen(*i))
+            {
+               maps.push_back(dtCore::RefPtr<dtDAL::MapXMLEvents>());
+            }
+            else
+            {
+               maps.push_back(new dtDAL::MapXMLEvents(project.GetMapFilePath(*i)));
+            }
+         }
+      }
+      catch (const dtUtil::Exception&)
+      {
+         FailLoad();
+         return false;
+      }
+
+      mParseThread = new MapParseThread(maps);
+      mParseThread->start();
+
+      SendMapMessage(MessageType::INFO_MAP_LOAD_BEGIN, mNewMapNames);
+      return true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::FailLoad()
+   {
+      // if we can't load a map, we go back to idle and send and
+      // empty string map change ended message
+      EndLoad();
+      mCurrentState = &MapChangeState::IDLE;
+      SendMapMessage(MessageType::INFO_MAP_CHANGED, MapChangeStateData::NameVector());
+      mNewMapNames.clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::EndLoad()
+   {
+      if (mParseThread != NULL)
+      {
+         mParseThread->Cancel();
+         mParseThread->join();
+         delete mParseThread;
+         mParseThread = NULL;
+      }
+
+      mMapParser = NULL;
+      mActorsToAdd.clear();
+      mNextActor = 0;
+      mNextMap = 0;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool MapChangeStateData::IsFrameBudgetUsed(const dtCore::Timer& timer, dtCore::Timer_t startTime) const
+   {
+      return mFrameBudget > 0.0f && timer.DeltaMil(startTime, timer.Tick()) >= mFrameBudget;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   dtDAL::Map* MapChangeStateData::GetNextNewMap(const dtCore::Timer& timer, dtCore::Timer_t startTime)
+   {
+      const std::string& mapName = mNewMapNames[mNextMap];
+      dtDAL::Project& project = dtDAL::Project::GetInstance();
+
+      if (mParseThread == NULL)
+      {
+         return &project.GetMap(mapName);
+      }
+
+      if (!mMapParser.valid())
+      {
+         dtCore::RefPtr<dtDAL::MapXMLEvents> events;
+         if (!mParseThread->TakeResult(mNextMap, events))
+         {
+            return NULL;
+         }
+
+         // it was already open.
+         if (!events.valid())
+         {
+            return &project.GetMap(mapName);
+         }
+
+         mMapParser = new dtDAL::MapParser;
+         mMapParser->BeginParse(*events);
+      }
+
+      // Building the map creates its actors, so it gets the same frame budget as adding them.
+      // It's done in the project directory, as the project does when it loads a map.
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      fileUtils.PushDirectory(project.GetContext());
+
+      dtCore::RefPtr<dtDAL::Map> parsedMap;
+      try
+      {
+         do
+         {
+            parsedMap = mMapParser->ContinueParse(EVENTS_PER_BUDGET_CHECK);
+         }
+         while (!parsedMap.valid() && !IsFrameBudgetUsed(timer, startTime));
+      }
+      catch (const dtUtil::Exception&)
+      {
+         fileUtils.PopDirectory();
+         mMapParser = NULL;
+         throw;
+      }
+
+      fileUtils.PopDirectory();
+
+      if (!parsedMap.valid())
+      {
+         return NULL;
+      }
+
+      dtDAL::Map& map = project.OpenParsedMap(mapName, *parsedMap, *mMapParser);
+      mMapParser = NULL;
+      return &map;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::BeginLoadingMapIntoGM(dtDAL::Map& map)
    {
-      dtDAL::Map& map = dtDAL::Project::GetInstance().GetMap(mapName);
       // add all the events in the map to the game manager.
       std::vector<dtDAL::GameEvent* > events;
       map.GetEventManager().GetAllEvents(events);
@@ -205,58 +431,145 @@ namespace dtGame
       std::vector<dtCore::RefPtr<dtDAL::ActorProxy> > proxies;
       map.GetAllProxies(proxies);
 
+      mActorsToAdd.clear();
+      mActorsToAdd.reserve(proxies.size());
+      mNextActor = 0;
       for (unsigned int i = 0; i < proxies.size(); ++i)
       {
-         dtDAL::ActorProxy& aProxy = *proxies[i];
          // Ensure that we don't try and add the environment actor
-         if (map.GetEnvironmentActor() == &aProxy)
+         if (map.GetEnvironmentActor() != proxies[i].get())
          {
-            continue;
+            mActorsToAdd.push_back(proxies[i]);
          }
+      }
+   }
 
-         if (aProxy.IsGameActorProxy())
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::AddActorToGM(dtDAL::ActorProxy& aProxy)
+   {
+      if (aProxy.IsGameActorProxy())
+      {
+         GameActorProxy* gameProxy = dynamic_cast<GameActorProxy*>(&aProxy);
+         if (gameProxy != NULL)
          {
-            GameActorProxy* gameProxy = dynamic_cast<GameActorProxy*>(&aProxy);
-            if (gameProxy != NULL)
+            gameProxy->SetGameManager(mGameManager.get());
+            if (gameProxy->GetInitialOwnership() == GameActorProxy::Ownership::PROTOTYPE)
             {
-               gameProxy->SetGameManager(mGameManager.get());
-               if (gameProxy->GetInitialOwnership() == GameActorProxy::Ownership::PROTOTYPE)
+               mGameManager->AddActorAsAPrototype(*gameProxy);
+            }
+            else
+            {
+               bool shouldPublish = gameProxy->GetInitialOwnership() == GameActorProxy::Ownership::SERVER_PUBLISHED;
+               // neither sends create messages nor adds to the scene when
+               // this object is not in IDLE state :-)
+               try
                {
-                  mGameManager->AddActorAsAPrototype(*gameProxy);
+                  mGameManager->AddActor(*gameProxy, false, shouldPublish);
                }
-               else
+               catch (const dtUtil::Exception& ex)
                {
-                  bool shouldPublish = gameProxy->GetInitialOwnership() == GameActorProxy::Ownership::SERVER_PUBLISHED;
-                  // neither sends create messages nor adds to the scene when
-                  // this object is not in IDLE state :-)
-                  try
-                  {
-                     mGameManager->AddActor(*gameProxy, false, shouldPublish);
-                  }
-                  catch (const dtUtil::Exception& ex)
-                  {
-                     dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
-                           "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
-                           gameProxy->GetName().c_str(), gameProxy->GetActorType().GetFullName().c_str());
-                     ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
-                  }
+                  dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+                        "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
+                        gameProxy->GetName().c_str(), gameProxy->GetActorType().GetFullName().c_str());
+                  ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
                }
             }
-            else
+         }
+         else
+         {
+            dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+               "Actor has the type of a GameActor, but casting it to a GameActorProxy failed.  "
+               "Actor \"%s\" of type \"%s\" will not be added to the scene.",
+               aProxy.GetName().c_str(), aProxy.GetActorType().GetFullName().c_str());
+         }
+      }
+      else
+      {
+         mGameManager->AddActor(aProxy);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool MapChangeStateData::ContinueLoadingMaps()
+   {
+      dtCore::Timer timer;
+      const dtCore::Timer_t startTime = timer.Tick();
+      bool addedActor = false;
+
+      while (true)
+      {
+         if (mNextActor >= mActorsToAdd.size())
+         {
+            mActorsToAdd.clear();
+            mNextActor = 0;
+
+            if (mNextMap >= mNewMapNames.size())
             {
-               dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
-                  "Actor has the type of a GameActor, but casting it to a GameActorProxy failed.  "
-                  "Actor \"%s\" of type \"%s\" will not be added to the scene.",
-                  gameProxy->GetName().c_str(), gameProxy->GetActorType().GetFullName().c_str());
+               return true;
             }
+
+            dtDAL::Map* map = NULL;
+            try
+            {
+               map = GetNextNewMap(timer, startTime);
+            }
+            catch (const dtUtil::Exception& ex)
+            {
+               ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
+               FailLoad();
+               return true;
+            }
+
+            // still reading or building it.
+            if (map == NULL)
+            {
+               return false;
+            }
+
+            ++mNextMap;
+            BeginLoadingMapIntoGM(*map);
          }
          else
          {
-            mGameManager->AddActor(aProxy);
+            if (addedActor && IsFrameBudgetUsed(timer, startTime))
+            {
+               return false;
+            }
+
+            // release the proxy as it's added so the map holds the only other reference.
+            dtCore::RefPtr<dtDAL::ActorProxy> proxy;
+            proxy.swap(mActorsToAdd[mNextActor]);
+            ++mNextActor;
+
+            AddActorToGM(*proxy);
+            addedActor = true;
          }
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   float MapChangeStateData::GetLoadProgress() const
+   {
+      if (mCurrentState != &MapChangeState::LOAD || mNewMapNames.empty())
+      {
+         return 0.0f;
+      }
+
+      // mNextMap is already past the map whose actors are being added.  When loading in the
+      // background, building each map from its file is the first half of its share.
+      const float addingShare = mParseThread != NULL ? 0.5f : 1.0f;
+      float mapsDone = float(mNextMap);
+      if (mMapParser.valid())
+      {
+         mapsDone += (1.0f - addingShare) * mMapParser->GetParseProgress();
+      }
+      else if (!mActorsToAdd.empty())
+      {
+         mapsDone -= addingShare * (1.0f - float(mNextActor) / float(mActorsToAdd.size()));
+      }
+      return mapsDone / float(mNewMapNames.size());
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void MapChangeStateData::ContinueMapChange()
    {
@@ -277,7 +590,9 @@ namespace dtGame
       {
          CloseOldMaps();
 
-         if (OpenNewMaps())
+         EndLoad();
+         bool opened = mLoadInBackground ? StartParsingNewMaps() : OpenNewMaps();
+         if (opened)
          {
             mCurrentState = &MapChangeState::LOAD;
          }
@@ -288,29 +603,36 @@ namespace dtGame
       }
       else if (mCurrentState == &MapChangeState::LOAD)
       {
-         MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
-         MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
+         if (!ContinueLoadingMaps())
+         {
+            SendMapMessage(MessageType::INFO_MAP_LOAD_PROGRESS, mNewMapNames, GetLoadProgress());
+            return;
+         }
 
-         for (; i != iend; ++i)
+         // loading failed.
+         if (mCurrentState != &MapChangeState::LOAD)
          {
-            LoadSingleMapIntoGM(*i);
+            return;
          }
 
+         EndLoad();
+
          // set the app to unpause so time stepping is correct
          mGameManager->SetPaused(false);
 
-         SendMapMessage(MessageType::INFO_MAP_LOADED, mNewMapNames);
-         SendMapMessage(MessageType::INFO_MAP_CHANGED, mNewMapNames);
+         SendMapMessage(MessageType::INFO_MAP_LOADED, mNewMapNames, 1.0f);
+         SendMapMessage(MessageType::INFO_MAP_CHANGED, mNewMapNames, 1.0f);
          mCurrentState = &MapChangeState::IDLE;
       }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void MapChangeStateData::SendMapMessage(const MessageType& type, const MapChangeStateData::NameVector& names)
+   void MapChangeStateData::SendMapMessage(const MessageType& type, const MapChangeStateData::NameVector& names, float progress)
    {
       dtCore::RefPtr<MapMessage> mapMessage;
       mGameManager->GetMessageFactory().CreateMessage(type, mapMessage);
       mapMessage->SetMapNames(names);
+      mapMessage->SetLoadProgress(progress);
 
       mGameManager->SendMessage(*mapMessage);
    }
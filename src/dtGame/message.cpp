@@ -27,10 +27,24 @@
 #include <dtGame/machineinfo.h>
 #include <dtGame/messagetype.h>
 
+#include <algorithm>
+
 using dtUtil::DataStream;
    
 namespace dtGame 
 {
+   const unsigned Message::INVALID_PARAMETER_INDEX = UINT_MAX;
+
+   ///////////////////////////////////////////////////////////////////////////////
+   /// Orders parameters by name so the flat parameter list streams in the same order the old map did.
+   struct MessageParameterNameLess
+   {
+      bool operator()(const dtCore::RefPtr<MessageParameter>& param, const std::string& name) const
+      {
+         return param->GetName().Get() < name;
+      }
+   };
+
    Message::Message()
       : mMessageType(&MessageType::UNKNOWN)
       , mDestination(NULL)
@@ -82,19 +96,13 @@ namespace dtGame
          return false;
       }
       
-      std::map< std::string, dtCore::RefPtr<MessageParameter> >::const_iterator i, j;
-      i = mParameterList.begin();
-      j = toCompare.mParameterList.begin();
-      
       // must compare the value of each parameter.
-      while (i != mParameterList.end() && j != toCompare.mParameterList.end())
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
-         if (*i->second != *j->second)
+         if (*mParameterList[i] != *toCompare.mParameterList[i])
          {
             return false;
          }
-         ++i;
-         ++j;
       }
          
       return (mCausingMessage == toCompare.mCausingMessage
@@ -105,11 +113,9 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void Message::ToString(std::string& toFill) const
    {
-      for (std::map<std::string,dtCore::RefPtr<MessageParameter> >::const_iterator i = mParameterList.begin(); 
-         i != mParameterList.end();
-         ++i)
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
-         toFill.append(i->second->ToString());
+         toFill.append(mParameterList[i]->ToString());
          toFill.append(1, '\n');
       }
    }
@@ -120,13 +126,11 @@ namespace dtGame
       bool okay = true;
 
       std::istringstream iss(source);
-      for (std::map<std::string,dtCore::RefPtr<MessageParameter> >::iterator i = mParameterList.begin(); 
-         i != mParameterList.end();
-         ++i)
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
          std::string line;
          std::getline(iss, line);
-         okay = okay && i->second->FromString(line);
+         okay = okay && mParameterList[i]->FromString(line);
       }
 
       return okay;
@@ -135,11 +139,9 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void Message::ToDataStream(DataStream& stream) const
    {
-      for (std::map< std::string, dtCore::RefPtr<MessageParameter> >::const_iterator i = mParameterList.begin(); 
-         i != mParameterList.end();
-         ++i)
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
-         i->second->ToDataStream(stream);
+         mParameterList[i]->ToDataStream(stream);
       }
    }
 
@@ -148,11 +150,9 @@ namespace dtGame
    {
       bool okay = true;
 
-      for (std::map< std::string, dtCore::RefPtr<MessageParameter> >::iterator i = mParameterList.begin(); 
-         i != mParameterList.end();
-         ++i)
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
-         okay = okay && i->second->FromDataStream(stream);
+         okay = okay && mParameterList[i]->FromDataStream(stream);
       }
 
       return okay;
@@ -167,50 +167,67 @@ namespace dtGame
          "NULL parameters are not legal.", __FILE__, __LINE__);
       }
       
-      std::map<std::string,dtCore::RefPtr<MessageParameter> >::iterator itor =
-         mParameterList.find(param->GetName());         
-      if (itor != mParameterList.end())
+      const std::string& name = param->GetName();
+      std::vector<dtCore::RefPtr<MessageParameter> >::iterator itor =
+         std::lower_bound(mParameterList.begin(), mParameterList.end(), name, MessageParameterNameLess());
+      if (itor != mParameterList.end() && (*itor)->GetName() == name)
       {
-         LOG_ERROR("Could not add new parameter: " + param->GetName() + ". A "
+         LOG_ERROR("Could not add new parameter: " + name + ". A "
             "parameter with that name already exists.");
       }
       else
       {
-         mParameterList.insert(std::make_pair(param->GetName(), param));
+         mParameterList.insert(itor, param);
+         // The layout no longer matches the other messages of the type.
+         mParameterSchema = NULL;
       }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   MessageParameter* Message::GetParameter(const std::string& name)
+   bool Message::SetParameterSchema(const MessageParameterSchema* schema)
    {
-      std::map< std::string, dtCore::RefPtr<MessageParameter> >::iterator itor =
-         mParameterList.find(name);
-         
-      if (itor != mParameterList.end())
+      if (schema != NULL && !schema->Matches(*this))
       {
-         return itor->second.get();
-      }
-      else
-      {
-         return NULL;
+         mParameterSchema = NULL;
+         return false;
       }
+
+      mParameterSchema = schema;
+      return true;
    }
-   
-   const MessageParameter* Message::GetParameter(const std::string& name) const
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned Message::GetParameterIndex(const std::string& name) const
    {
-      std::map<std::string,dtCore::RefPtr<MessageParameter> >::const_iterator itor =
-         mParameterList.find(name);
-         
-      if (itor != mParameterList.end())
+      if (mParameterSchema.valid())
       {
-         return itor->second.get();
+         return mParameterSchema->GetIndex(name);
       }
-      else
+
+      std::vector<dtCore::RefPtr<MessageParameter> >::const_iterator itor =
+         std::lower_bound(mParameterList.begin(), mParameterList.end(), name, MessageParameterNameLess());
+      if (itor != mParameterList.end() && (*itor)->GetName() == name)
       {
-         return NULL;
+         return unsigned(itor - mParameterList.begin());
       }
+      return INVALID_PARAMETER_INDEX;
    }
-         
+
+   ///////////////////////////////////////////////////////////////////////////////
+   MessageParameter* Message::GetParameter(const std::string& name)
+   {
+      unsigned index = GetParameterIndex(name);
+      return index == INVALID_PARAMETER_INDEX ? NULL : mParameterList[index].get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   const MessageParameter* Message::GetParameter(const std::string& name) const
+   {
+      unsigned index = GetParameterIndex(name);
+      return index == INVALID_PARAMETER_INDEX ? NULL : mParameterList[index].get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
    void Message::CopyDataTo(Message& msg) const
    {
       //copy header stuff
@@ -221,14 +238,33 @@ namespace dtGame
       msg.mSource         = mSource;
       
       //copy parameters
-      for (std::map<std::string, dtCore::RefPtr<MessageParameter> >::const_iterator i = mParameterList.begin();     
-            i != mParameterList.end();
-            ++i)
+      if (mParameterSchema.valid() && mParameterSchema == msg.mParameterSchema)
+      {
+         // same layout, so no names need to be looked at.
+         for (unsigned i = 0; i < mParameterList.size(); ++i)
+         {
+            msg.mParameterList[i]->CopyFrom(*mParameterList[i]);
+         }
+         return;
+      }
+
+      for (unsigned i = 0; i < mParameterList.size(); ++i)
       {
-         std::map<std::string,dtCore::RefPtr<MessageParameter> >::iterator copyTo = msg.mParameterList.find(i->first);
-         if (copyTo != msg.mParameterList.end())
+         const MessageParameter& copyFrom = *mParameterList[i];
+         // messages of the same class have the same layout, so check the same slot before searching.
+         MessageParameter* copyTo = NULL;
+         if (i < msg.mParameterList.size() && msg.mParameterList[i]->GetName() == copyFrom.GetName())
+         {
+            copyTo = msg.mParameterList[i].get();
+         }
+         else
+         {
+            copyTo = msg.GetParameter(copyFrom.GetName());
+         }
+
+         if (copyTo != NULL)
          {
-            copyTo->second->CopyFrom(*i->second);
+            copyTo->CopyFrom(copyFrom);
          }
       }
    }
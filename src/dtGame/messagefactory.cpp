@@ -26,6 +26,7 @@
 #include <dtGame/loggermessages.h>
 #include <dtGame/actorupdatemessage.h>
 #include <dtCore/refptr.h>
+#include <OpenThreads/ScopedLock>
 #include <sstream>
 
 #include <typeinfo>
@@ -36,6 +37,74 @@ namespace dtGame
    MessageFactory::MessageFactoryException MessageFactory::MessageFactoryException::TYPE_ALREADY_REGISTERED("Type already registered");
    MessageFactory::MessageFactoryException MessageFactory::MessageFactoryException::TYPE_NOT_REGISTERED("Type not registered");
 
+   const unsigned MessageFactory::DEFAULT_MESSAGE_POOL_SIZE = 32;
+
+   /////////////////////////////////////////////////////////////////
+   /**
+    * The recycled messages of one type.  A message is free when the pool holds the only reference to it.
+    * All the methods must be called with the factory pool mutex locked.
+    */
+   class MessageFactory::MessagePool : public osg::Referenced
+   {
+   public:
+      MessagePool(Message& pristine, unsigned maxPooled)
+         : mPristine(&pristine)
+         , mMaxPooled(maxPooled)
+         , mNextToCheck(0)
+         , mHits(0)
+         , mMisses(0)
+      {
+      }
+
+      /// @return a free message or NULL if they are all in use.
+      Message* Acquire()
+      {
+         // start where the last search stopped since the oldest messages are the most likely to be free.
+         const unsigned size = unsigned(mMessages.size());
+         for (unsigned i = 0; i < size; ++i)
+         {
+            unsigned index = (mNextToCheck + i) % size;
+            if (mMessages[index]->referenceCount() == 1)
+            {
+               mNextToCheck = (index + 1) % size;
+               ++mHits;
+               return mMessages[index].get();
+            }
+         }
+         ++mMisses;
+         return NULL;
+      }
+
+      /// Holds on to a newly allocated message if the pool is not full.
+      void Add(Message& msg)
+      {
+         if (mMessages.size() < mMaxPooled)
+         {
+            mMessages.push_back(&msg);
+         }
+      }
+
+      void SetMaxPooled(unsigned maxPooled)
+      {
+         mMaxPooled = maxPooled;
+         if (mMessages.size() > mMaxPooled)
+         {
+            mMessages.resize(mMaxPooled);
+            mNextToCheck = 0;
+         }
+      }
+
+      dtCore::RefPtr<Message> mPristine;
+      std::vector<dtCore::RefPtr<Message> > mMessages;
+      unsigned mMaxPooled;
+      unsigned mNextToCheck;
+      unsigned long mHits;
+      unsigned long mMisses;
+
+   protected:
+      virtual ~MessagePool() {}
+   };
+
    /////////////////////////////////////////////////////////////////
    MessageFactory::MessageFactory(const std::string& name,
                                   const MachineInfo& machine,
@@ -58,6 +127,7 @@ namespace dtGame
       RegisterMessageType<MapMessage>(MessageType::INFO_MAP_UNLOAD_BEGIN);
       RegisterMessageType<MapMessage>(MessageType::INFO_MAP_CHANGE_BEGIN);
       RegisterMessageType<MapMessage>(MessageType::INFO_MAP_CHANGED);
+      RegisterMessageType<MapMessage>(MessageType::INFO_MAP_LOAD_PROGRESS);
 
       RegisterMessageType<Message>(MessageType::INFO_PAUSED);
       RegisterMessageType<Message>(MessageType::INFO_RESUMED);
@@ -119,6 +189,16 @@ namespace dtGame
       RegisterMessageType<SystemMessage>(MessageType::SYSTEM_POST_EVENT_TRAVERSAL);
       RegisterMessageType<SystemMessage>(MessageType::SYSTEM_FRAME_SYNCH);
       RegisterMessageType<SystemMessage>(MessageType::SYSTEM_POST_FRAME);
+
+      // These are created every frame or for every network update.
+      SetMessagePoolSize(MessageType::TICK_LOCAL, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::TICK_REMOTE, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::TICK_END_OF_FRAME, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::INFO_TIMER_ELAPSED, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::INFO_ACTOR_UPDATED, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::SYSTEM_POST_EVENT_TRAVERSAL, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::SYSTEM_FRAME_SYNCH, DEFAULT_MESSAGE_POOL_SIZE);
+      SetMessagePoolSize(MessageType::SYSTEM_POST_FRAME, DEFAULT_MESSAGE_POOL_SIZE);
    }
 
    /////////////////////////////////////////////////////////////////
@@ -142,13 +222,43 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    dtCore::RefPtr<Message> MessageFactory::CreateMessage(const MessageType& msgType) const
    {
-      dtCore::RefPtr<Message> msg = mMessageFactory->CreateObject(&msgType);
+      dtCore::RefPtr<Message> msg;
+      dtCore::RefPtr<MessagePool> pool;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+         MessagePoolMap::const_iterator found = mMessagePools.find(&msgType);
+         if (found != mMessagePools.end())
+         {
+            pool = found->second;
+            msg = pool->Acquire();
+         }
+      }
 
-      if (msg == NULL)
+      if (msg.valid())
+      {
+         // The pool is no longer the only reference, so no other thread can take it.  Make it look new.
+         pool->mPristine->CopyDataTo(*msg);
+         msg->SetCausingMessage(NULL);
+      }
+      else
       {
-         LOGN_ERROR("messagefactory.cpp", "Object factory returned NULL, the message could not be created");
-         throw dtUtil::Exception(MessageFactory::MessageFactoryException::TYPE_NOT_REGISTERED,
-            std::string("Could not create type ") + msgType.GetName(), __FILE__, __LINE__);
+         msg = mMessageFactory->CreateObject(&msgType);
+
+         if (msg == NULL)
+         {
+            LOGN_ERROR("messagefactory.cpp", "Object factory returned NULL, the message could not be created");
+            throw dtUtil::Exception(MessageFactory::MessageFactoryException::TYPE_NOT_REGISTERED,
+               std::string("Could not create type ") + msgType.GetName(), __FILE__, __LINE__);
+         }
+
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+         if (pool.valid())
+         {
+            pool->Add(*msg);
+         }
+
+         // Pooled messages keep their schema, so this only happens when a message is allocated.
+         AttachParameterSchema(msgType, *msg);
       }
       msg->SetMessageType(msgType);
       msg->SetSource(*mMachine);
@@ -208,6 +318,92 @@ namespace dtGame
       return NULL;
    }
 
+   /////////////////////////////////////////////////////////////////
+   void MessageFactory::SetMessagePoolSize(const MessageType& type, unsigned maxPooled)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      MessagePoolMap::iterator found = mMessagePools.find(&type);
+      if (maxPooled == 0)
+      {
+         if (found != mMessagePools.end())
+         {
+            mMessagePools.erase(found);
+         }
+      }
+      else if (found != mMessagePools.end())
+      {
+         found->second->SetMaxPooled(maxPooled);
+      }
+      else
+      {
+         dtCore::RefPtr<Message> pristine = mMessageFactory->CreateObject(&type);
+         if (!pristine.valid())
+         {
+            throw dtUtil::Exception(MessageFactory::MessageFactoryException::TYPE_NOT_REGISTERED,
+               std::string("Could not create a message pool for unregistered type ") + type.GetName(), __FILE__, __LINE__);
+         }
+         pristine->SetMessageType(type);
+         pristine->SetSource(*mMachine);
+         AttachParameterSchema(type, *pristine);
+         mMessagePools.insert(std::make_pair(&type, new MessagePool(*pristine, maxPooled)));
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned MessageFactory::GetMessagePoolSize(const MessageType& type) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      MessagePoolMap::const_iterator found = mMessagePools.find(&type);
+      return found == mMessagePools.end() ? 0 : found->second->mMaxPooled;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned long MessageFactory::GetMessagePoolHits(const MessageType& type) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      MessagePoolMap::const_iterator found = mMessagePools.find(&type);
+      return found == mMessagePools.end() ? 0 : found->second->mHits;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned long MessageFactory::GetMessagePoolMisses(const MessageType& type) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      MessagePoolMap::const_iterator found = mMessagePools.find(&type);
+      return found == mMessagePools.end() ? 0 : found->second->mMisses;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void MessageFactory::ResetMessagePoolCounters()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      for (MessagePoolMap::iterator i = mMessagePools.begin(); i != mMessagePools.end(); ++i)
+      {
+         i->second->mHits = 0;
+         i->second->mMisses = 0;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void MessageFactory::AttachParameterSchema(const MessageType& type, Message& msg) const
+   {
+      SchemaMap::iterator schema = mParameterSchemas.find(&type);
+      if (schema == mParameterSchemas.end())
+      {
+         schema = mParameterSchemas.insert(std::make_pair(&type,
+            dtCore::RefPtr<const MessageParameterSchema>(new MessageParameterSchema(msg)))).first;
+      }
+      msg.SetParameterSchema(schema->second.get());
+   }
+
+   /////////////////////////////////////////////////////////////////
+   const MessageParameterSchema* MessageFactory::GetParameterSchema(const MessageType& type) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+      SchemaMap::const_iterator found = mParameterSchemas.find(&type);
+      return found == mParameterSchemas.end() ? NULL : found->second.get();
+   }
+
    /////////////////////////////////////////////////////////////////
    void MessageFactory::ThrowIdException(const MessageType& type) const
    {
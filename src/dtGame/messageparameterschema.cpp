@@ -0,0 +1,94 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005, BMH Associates, Inc.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtgameprefix-src.h>
+#include <dtGame/messageparameterschema.h>
+#include <dtGame/message.h>
+
+namespace dtGame
+{
+   /////////////////////////////////////////////////////////////////////////////
+   size_t MessageParameterSchema::StringHash::operator()(const std::string& key) const
+   {
+      // FNV-1a
+      size_t hash = 2166136261U;
+      for (std::string::const_iterator i = key.begin(); i != key.end(); ++i)
+      {
+         hash = (hash ^ (unsigned char)(*i)) * 16777619U;
+      }
+      return hash;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MessageParameterSchema::MessageParameterSchema(const Message& layout)
+   {
+      const unsigned numParameters = layout.GetNumParameters();
+      mNames.reserve(numParameters);
+      mDataTypes.reserve(numParameters);
+
+      for (unsigned i = 0; i < numParameters; ++i)
+      {
+         const MessageParameter& param = *layout.GetParameterByIndex(i);
+         mNames.push_back(param.GetName());
+         mDataTypes.push_back(&param.GetDataType());
+         mInternedIndices.insert(std::make_pair(&param.GetName().Get(), i));
+         mIndices.insert(std::make_pair(param.GetName().Get(), i));
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MessageParameterSchema::~MessageParameterSchema()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned MessageParameterSchema::GetIndex(const std::string& name) const
+   {
+      dtUtil::HashMap<const std::string*, unsigned>::const_iterator interned = mInternedIndices.find(&name);
+      if (interned != mInternedIndices.end())
+      {
+         return interned->second;
+      }
+
+      dtUtil::HashMap<std::string, unsigned, StringHash>::const_iterator found = mIndices.find(name);
+      return found == mIndices.end() ? Message::INVALID_PARAMETER_INDEX : found->second;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MessageParameterSchema::Matches(const Message& msg) const
+   {
+      if (msg.GetNumParameters() != mNames.size())
+      {
+         return false;
+      }
+
+      for (unsigned i = 0; i < mNames.size(); ++i)
+      {
+         const MessageParameter& param = *msg.GetParameterByIndex(i);
+         // The names are interned, so comparing the addresses is enough.
+         if (&param.GetName().Get() != &mNames[i].Get() || &param.GetDataType() != mDataTypes[i])
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+}
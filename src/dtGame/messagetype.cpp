@@ -49,6 +49,7 @@ namespace dtGame
    const MessageType MessageType::INFO_MAP_UNLOAD_BEGIN("Map Unload Began", "Info", "Sent when unloading a map has begun.", 24);
    const MessageType MessageType::INFO_MAP_CHANGE_BEGIN("Map Change Began", "Info", "Sent when the program has begun to unload a map and load a new one.  Unload and load messages will be sent", 25);
    const MessageType MessageType::INFO_MAP_CHANGED("Map Changed", "Info", "Sent when the program has completed unloading and loading a new map.", 26);
+   const MessageType MessageType::INFO_MAP_LOAD_PROGRESS("Map Load Progress", "Info", "Sent each frame while the actors of new maps are being added over several frames.", 27);
 
    const MessageType MessageType::INFO_PLAYER_ENTERED_WORLD("Player entered world", "Info", "Sent when the player of a game enters the world.", 30);
 
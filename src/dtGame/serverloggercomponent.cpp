@@ -1024,7 +1024,7 @@ namespace dtGame
    void ServerLoggerComponent::HandleAddPlaybackActorMessage(const Message& message)
    {
       // Make sure no ignored actors get added when they join the playback simulation.
-      if (!message.GetAboutActorId().ToString().empty() &&
+      if (!message.GetAboutActorId().IsNull() &&
          !IsActorIdInList(message.GetAboutActorId(), mPlaybackList))
       {
          mPlaybackList.insert(message.GetAboutActorId());
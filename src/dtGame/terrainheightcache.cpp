@@ -0,0 +1,241 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2007, Alion Science and Technology, BMH Operation.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtgameprefix-src.h>
+#include <dtGame/terrainheightcache.h>
+#include <osg/Math>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dtGame
+{
+   /// Marks a corner that has not been sampled yet.
+   static const float UNKNOWN_HEIGHT = std::numeric_limits<float>::quiet_NaN();
+   /// Marks a corner whose query did not hit the terrain.
+   static const float NO_HIT_HEIGHT = std::numeric_limits<float>::infinity();
+
+   /////////////////////////////////////////////////////////////////////////////
+   static int FloorDivide(int value, int divisor)
+   {
+      return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TerrainHeightCache::TerrainHeightCache(float cellSize, unsigned tileCells, unsigned maxTiles)
+      : mCellSize(std::max(cellSize, 0.001f))
+      , mTileCells(std::max(tileCells, 1U))
+      , mMaxTiles(std::max(maxTiles, 1U))
+      , mMaxPendingSamples(64)
+      , mLookupCount(0)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TerrainHeightCache::~TerrainHeightCache()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::SetMaxTiles(unsigned maxTiles)
+   {
+      mMaxTiles = std::max(maxTiles, 1U);
+      while (mTiles.size() > mMaxTiles)
+      {
+         DropOldestTile();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TerrainHeightCache::GridKey TerrainHeightCache::GetTileKey(int x, int y, unsigned& outIndex) const
+   {
+      int tileCells = int(mTileCells);
+      GridKey key(FloorDivide(x, tileCells), FloorDivide(y, tileCells));
+      outIndex = unsigned(y - key.second * tileCells) * mTileCells + unsigned(x - key.first * tileCells);
+      return key;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TerrainHeightCache::Tile& TerrainHeightCache::GetTile(const GridKey& key)
+   {
+      TileMap::iterator i = mTiles.find(key);
+      if (i == mTiles.end())
+      {
+         if (mTiles.size() >= mMaxTiles)
+         {
+            DropOldestTile();
+         }
+
+         i = mTiles.insert(std::make_pair(key, Tile())).first;
+         i->second.mHeights.resize(mTileCells * mTileCells, UNKNOWN_HEIGHT);
+      }
+      i->second.mLastUsed = mLookupCount;
+      return i->second;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::DropOldestTile()
+   {
+      TileMap::iterator oldest = mTiles.begin();
+      for (TileMap::iterator i = mTiles.begin(); i != mTiles.end(); ++i)
+      {
+         if (i->second.mLastUsed < oldest->second.mLastUsed)
+         {
+            oldest = i;
+         }
+      }
+
+      if (oldest != mTiles.end())
+      {
+         mTiles.erase(oldest);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   float TerrainHeightCache::GetSample(int x, int y, const osg::Vec3& point)
+   {
+      unsigned index = 0;
+      TileMap::iterator i = mTiles.find(GetTileKey(x, y, index));
+      if (i != mTiles.end())
+      {
+         i->second.mLastUsed = mLookupCount;
+         float height = i->second.mHeights[index];
+         if (!osg::isNaN(height))
+         {
+            return height;
+         }
+      }
+
+      GridKey corner(x, y);
+      if (mPendingSamples.size() < mMaxPendingSamples && mPendingSet.insert(corner).second)
+      {
+         SampleRequest request;
+         request.mX = x;
+         request.mY = y;
+         request.mPoint.set(float(x) * mCellSize, float(y) * mCellSize, point.z());
+         mPendingSamples.push_back(request);
+      }
+
+      return UNKNOWN_HEIGHT;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool TerrainHeightCache::GetHeight(const osg::Vec3& point, osg::Vec3& outHit, osg::Vec3& outNormal)
+   {
+      if (IsInDynamicArea(point.x(), point.y()))
+      {
+         return false;
+      }
+
+      ++mLookupCount;
+
+      float gridX = point.x() / mCellSize;
+      float gridY = point.y() / mCellSize;
+      int x = int(std::floor(gridX));
+      int y = int(std::floor(gridY));
+      float fx = gridX - float(x);
+      float fy = gridY - float(y);
+
+      // Look up all four, even after a miss, so all of the missing corners get queued at once.
+      float h00 = GetSample(x, y, point);
+      float h10 = GetSample(x + 1, y, point);
+      float h01 = GetSample(x, y + 1, point);
+      float h11 = GetSample(x + 1, y + 1, point);
+
+      if (osg::isNaN(h00) || osg::isNaN(h10) || osg::isNaN(h01) || osg::isNaN(h11))
+      {
+         return false;
+      }
+
+      // A corner with no terrain can't be interpolated, so the caller has to query.
+      if (h00 == NO_HIT_HEIGHT || h10 == NO_HIT_HEIGHT || h01 == NO_HIT_HEIGHT || h11 == NO_HIT_HEIGHT)
+      {
+         return false;
+      }
+
+      float height = (h00 * (1.0f - fx) + h10 * fx) * (1.0f - fy) + (h01 * (1.0f - fx) + h11 * fx) * fy;
+      outHit.set(point.x(), point.y(), height);
+
+      // The normal is from the slope of the bilinear surface at the point.
+      float slopeX = ((h10 - h00) * (1.0f - fy) + (h11 - h01) * fy) / mCellSize;
+      float slopeY = ((h01 - h00) * (1.0f - fx) + (h11 - h10) * fx) / mCellSize;
+      outNormal.set(-slopeX, -slopeY, 1.0f);
+      outNormal.normalize();
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::SetSampleHeight(int x, int y, float height)
+   {
+      unsigned index = 0;
+      Tile& tile = GetTile(GetTileKey(x, y, index));
+      tile.mHeights[index] = height;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::SetSampleMissed(int x, int y)
+   {
+      SetSampleHeight(x, y, NO_HIT_HEIGHT);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::TakePendingSamples(std::vector<SampleRequest>& outSamples)
+   {
+      outSamples.swap(mPendingSamples);
+      mPendingSamples.clear();
+      mPendingSet.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::AddDynamicArea(const osg::Vec2& minXY, const osg::Vec2& maxXY)
+   {
+      mDynamicAreas.push_back(std::make_pair(minXY, maxXY));
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::ClearDynamicAreas()
+   {
+      mDynamicAreas.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool TerrainHeightCache::IsInDynamicArea(float x, float y) const
+   {
+      for (unsigned i = 0; i < mDynamicAreas.size(); ++i)
+      {
+         const osg::Vec2& minXY = mDynamicAreas[i].first;
+         const osg::Vec2& maxXY = mDynamicAreas[i].second;
+         if (x >= minXY.x() && x <= maxXY.x() && y >= minXY.y() && y <= maxXY.y())
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TerrainHeightCache::Clear()
+   {
+      mTiles.clear();
+      mPendingSamples.clear();
+      mPendingSet.clear();
+   }
+}
@@ -0,0 +1,431 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtgameprefix-src.h>
+#include <dtGame/timerwheel.h>
+
+#include <algorithm>
+
+namespace dtGame
+{
+   /// Stepping the wheel one tick at a time is only worth it for jumps shorter than this.
+   static const dtCore::Timer_t MAX_STEPPED_TICKS = 1 << 16;
+
+   ///////////////////////////////////////////////////////////////////////////////
+   struct TimerWheel::ExpireTimeLess
+   {
+      ExpireTimeLess(const std::vector<Node>& nodes) : mNodes(nodes) {}
+
+      bool operator()(unsigned lhs, unsigned rhs) const
+      {
+         if (mNodes[lhs].mTime != mNodes[rhs].mTime)
+         {
+            return mNodes[lhs].mTime < mNodes[rhs].mTime;
+         }
+         return lhs < rhs;
+      }
+
+      const std::vector<Node>& mNodes;
+   };
+
+   ///////////////////////////////////////////////////////////////////////////////
+   const unsigned TimerWheel::NIL;
+
+   ///////////////////////////////////////////////////////////////////////////////
+   TimerWheel::TimerWheel()
+      : mFreeList(NIL)
+      , mNumTimers(0)
+      , mCurrentTick(0)
+   {
+      std::fill(mSlots, mSlots + NUM_LEVELS * NUM_SLOTS, NIL);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   TimerWheel::~TimerWheel()
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   TimerWheel::Handle TimerWheel::Add(const std::string& name, const dtCore::UniqueId& aboutActor,
+            dtCore::Timer_t expireTime, bool repeat, dtCore::Timer_t interval)
+   {
+      unsigned index = AllocateNode();
+      Node& node = mNodes[index];
+      node.mName = name;
+      node.mAboutActor = aboutActor;
+      node.mTime = expireTime;
+      node.mInterval = interval;
+      node.mRepeat = repeat;
+
+      AddToNameList(index);
+      Schedule(index);
+      ++mNumTimers;
+      return MakeHandle(index);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::Remove(Handle handle)
+   {
+      unsigned index = FindNode(handle);
+      if (index == NIL)
+      {
+         return false;
+      }
+
+      Unlink(index);
+      FreeNode(index);
+      return true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::Remove(const std::string& name, const dtCore::UniqueId* aboutActor)
+   {
+      NameMap::iterator found = mNames.find(name);
+      if (found == mNames.end())
+      {
+         return 0;
+      }
+
+      // removing changes the name list, so copy the matches first.
+      IndexList toRemove;
+      const IndexList& sameName = found->second;
+      for (IndexList::const_iterator i = sameName.begin(); i != sameName.end(); ++i)
+      {
+         if (aboutActor == NULL || mNodes[*i].mAboutActor == *aboutActor)
+         {
+            toRemove.push_back(*i);
+         }
+      }
+
+      for (IndexList::const_iterator i = toRemove.begin(); i != toRemove.end(); ++i)
+      {
+         Unlink(*i);
+         FreeNode(*i);
+      }
+      return unsigned(toRemove.size());
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::IsPending(Handle handle) const
+   {
+      return FindNode(handle) != NIL;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Clear()
+   {
+      for (unsigned i = 0; i < mNodes.size(); ++i)
+      {
+         if (mNodes[i].mInUse)
+         {
+            mNodes[i].mSlot = NIL;
+            FreeNode(i);
+         }
+      }
+      std::fill(mSlots, mSlots + NUM_LEVELS * NUM_SLOTS, NIL);
+      mNames.clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::GetNumTimers() const
+   {
+      return mNumTimers;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Advance(dtCore::Timer_t clockTime, std::vector<ExpiredTimer>& expired)
+   {
+      expired.clear();
+
+      dtCore::Timer_t clockTick = clockTime / TICK_LENGTH;
+      if (mNumTimers == 0)
+      {
+         mCurrentTick = clockTick;
+         return;
+      }
+
+      // Big jumps, like the first call or a change to the simulation time, just rebucket everything.
+      if (clockTick > mCurrentTick + MAX_STEPPED_TICKS || clockTick + NUM_SLOTS < mCurrentTick)
+      {
+         Rebuild(clockTick);
+      }
+
+      mCollected.clear();
+      while (mCurrentTick < clockTick)
+      {
+         // every timer in the slot of a past tick has expired.
+         CollectExpired(unsigned(mCurrentTick & SLOT_MASK), clockTime, true);
+         ++mCurrentTick;
+
+         for (unsigned level = 1; level < NUM_LEVELS; ++level)
+         {
+            if (((mCurrentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0)
+            {
+               break;
+            }
+            Cascade(level);
+         }
+      }
+      CollectExpired(unsigned(mCurrentTick & SLOT_MASK), clockTime, false);
+
+      if (mCollected.empty())
+      {
+         return;
+      }
+
+      std::sort(mCollected.begin(), mCollected.end(), ExpireTimeLess(mNodes));
+
+      expired.resize(mCollected.size());
+      for (unsigned i = 0; i < mCollected.size(); ++i)
+      {
+         unsigned index = mCollected[i];
+         Node& node = mNodes[index];
+         ExpiredTimer& timer = expired[i];
+         timer.mHandle = MakeHandle(index);
+         timer.mName = node.mName;
+         timer.mAboutActor = node.mAboutActor;
+         timer.mTime = node.mTime;
+
+         // Repeating timers are put back only after collecting, so they can't expire twice in one call.
+         if (node.mRepeat)
+         {
+            node.mTime += node.mInterval;
+            Schedule(index);
+         }
+         else
+         {
+            FreeNode(index);
+         }
+      }
+      mCollected.clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::FindNode(Handle handle) const
+   {
+      unsigned index = unsigned(handle & 0xFFFFFFFFULL);
+      unsigned generation = unsigned(handle >> 32);
+      if (index >= mNodes.size())
+      {
+         return NIL;
+      }
+
+      const Node& node = mNodes[index];
+      if (!node.mInUse || node.mGeneration != generation)
+      {
+         return NIL;
+      }
+      return index;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   TimerWheel::Handle TimerWheel::MakeHandle(unsigned index) const
+   {
+      // generations start at 1, so a handle is never INVALID_HANDLE.
+      return (Handle(mNodes[index].mGeneration) << 32) | Handle(index);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::AllocateNode()
+   {
+      unsigned index;
+      if (mFreeList != NIL)
+      {
+         index = mFreeList;
+         mFreeList = mNodes[index].mNext;
+      }
+      else
+      {
+         index = unsigned(mNodes.size());
+         mNodes.push_back(Node());
+         mNodes[index].mGeneration = 1;
+      }
+
+      Node& node = mNodes[index];
+      node.mInUse = true;
+      node.mSlot = NIL;
+      node.mPrev = NIL;
+      node.mNext = NIL;
+      return index;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::FreeNode(unsigned index)
+   {
+      RemoveFromNameList(index);
+
+      Node& node = mNodes[index];
+      node.mInUse = false;
+      node.mName.clear();
+      // keeps the top bit of the handles clear.
+      if (++node.mGeneration > 0x7FFFFFFFU)
+      {
+         node.mGeneration = 1;
+      }
+      node.mNext = mFreeList;
+      mFreeList = index;
+      --mNumTimers;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Schedule(unsigned index)
+   {
+      dtCore::Timer_t tick = mNodes[index].mTime / TICK_LENGTH;
+      // timers that are already due go in the current slot, which is checked every call to Advance.
+      if (tick < mCurrentTick)
+      {
+         tick = mCurrentTick;
+      }
+
+      dtCore::Timer_t delta = tick - mCurrentTick;
+      unsigned level = 0;
+      while (level < NUM_LEVELS - 1 && delta >= (dtCore::Timer_t(1) << (SLOT_BITS * (level + 1))))
+      {
+         ++level;
+      }
+
+      // timers beyond the range of the wheel wait in the last slot they can reach and are rescheduled when it cascades.
+      dtCore::Timer_t maxDelta = (dtCore::Timer_t(1) << (SLOT_BITS * NUM_LEVELS)) - 1;
+      if (delta > maxDelta)
+      {
+         tick = mCurrentTick + maxDelta;
+      }
+
+      unsigned slot = level * NUM_SLOTS + unsigned((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+      Link(index, slot);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Link(unsigned index, unsigned slot)
+   {
+      Node& node = mNodes[index];
+      node.mSlot = slot;
+      node.mPrev = NIL;
+      node.mNext = mSlots[slot];
+      if (node.mNext != NIL)
+      {
+         mNodes[node.mNext].mPrev = index;
+      }
+      mSlots[slot] = index;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Unlink(unsigned index)
+   {
+      Node& node = mNodes[index];
+      if (node.mSlot == NIL)
+      {
+         return;
+      }
+
+      if (node.mPrev != NIL)
+      {
+         mNodes[node.mPrev].mNext = node.mNext;
+      }
+      else
+      {
+         mSlots[node.mSlot] = node.mNext;
+      }
+
+      if (node.mNext != NIL)
+      {
+         mNodes[node.mNext].mPrev = node.mPrev;
+      }
+
+      node.mSlot = NIL;
+      node.mPrev = NIL;
+      node.mNext = NIL;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::AddToNameList(unsigned index)
+   {
+      IndexList& sameName = mNames[mNodes[index].mName];
+      mNodes[index].mNamePosition = unsigned(sameName.size());
+      sameName.push_back(index);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::RemoveFromNameList(unsigned index)
+   {
+      NameMap::iterator found = mNames.find(mNodes[index].mName);
+      if (found == mNames.end())
+      {
+         return;
+      }
+
+      IndexList& sameName = found->second;
+      unsigned position = mNodes[index].mNamePosition;
+      unsigned last = sameName.back();
+      sameName[position] = last;
+      mNodes[last].mNamePosition = position;
+      sameName.pop_back();
+
+      if (sameName.empty())
+      {
+         mNames.erase(found);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Cascade(unsigned level)
+   {
+      unsigned slot = level * NUM_SLOTS + unsigned((mCurrentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+      unsigned index = mSlots[slot];
+      mSlots[slot] = NIL;
+      while (index != NIL)
+      {
+         unsigned next = mNodes[index].mNext;
+         Schedule(index);
+         index = next;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Rebuild(dtCore::Timer_t tick)
+   {
+      std::fill(mSlots, mSlots + NUM_LEVELS * NUM_SLOTS, NIL);
+      mCurrentTick = tick;
+      for (unsigned i = 0; i < mNodes.size(); ++i)
+      {
+         if (mNodes[i].mInUse)
+         {
+            Schedule(i);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::CollectExpired(unsigned slot, dtCore::Timer_t clockTime, bool all)
+   {
+      unsigned index = mSlots[slot];
+      while (index != NIL)
+      {
+         unsigned next = mNodes[index].mNext;
+         if (all || mNodes[index].mTime <= clockTime)
+         {
+            Unlink(index);
+            mCollected.push_back(index);
+         }
+         index = next;
+      }
+   }
+}
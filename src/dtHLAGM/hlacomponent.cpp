@@ -1505,6 +1505,7 @@ namespace dtHLAGM
 
          auMsg.SetActorTypeName(bestObjectToActor->GetActorType().GetName());
          auMsg.SetActorTypeCategory(bestObjectToActor->GetActorType().GetCategory());
+         auMsg.ResolveUpdateParameterHandles(bestObjectToActor->GetActorType());
 
          auMsg.SetAboutActorId(*currentActorId);
          auMsg.SetSource(*mMachineInfo);
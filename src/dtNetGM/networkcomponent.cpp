@@ -181,14 +181,10 @@ IMPLEMENT_ENUM(MessageActionCode);
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::ProcessTickLocal(const dtGame::TickMessage& msg)
    {
+      // the messages that were waiting go first, then everything received since the last tick.
       MessageBufferType swapBuffer;
-
-      {
-         // safely push all the received messages onto the GameManager message queue
-         //printf("Buffer [%x].\n", &mBufferMutex);
-         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mBufferMutex);
-         swapBuffer.swap(mMessageBuffer);
-      }
+      swapBuffer.swap(mWaitingMessages);
+      mReceivedMessages.PopAll(swapBuffer);
 
       std::string rejectMessageString;
       MessageBufferType::iterator i, iend;
@@ -207,8 +203,7 @@ IMPLEMENT_ENUM(MessageActionCode);
          else if (code == MessageActionCode::WAIT)
          {
             //put it back in the queue
-            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mBufferMutex);
-            mMessageBuffer.push_back(&msg);
+            mWaitingMessages.push_back(&msg);
          }
          else if (code == MessageActionCode::DROP)
          {
@@ -447,9 +442,7 @@ IMPLEMENT_ENUM(MessageActionCode);
       {
          // Store the message on the local buffer
          // Message queue will be forwarded to the GM on the next frame tick
-         //printf("Buffer [%x].\n", &mBufferMutex);
-         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mBufferMutex);
-         mMessageBuffer.push_back(&message);
+         mReceivedMessages.Push(&message);
       }
 
    }
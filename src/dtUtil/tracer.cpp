@@ -0,0 +1,384 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtutilprefix-src.h>
+#include <dtUtil/tracer.h>
+#include <dtUtil/refstring.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#if defined(_MSC_VER)
+#  define DT_TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#  define DT_TRACE_THREAD_LOCAL __thread
+#endif
+
+namespace dtUtil
+{
+   bool Tracer::mEnabled = false;
+
+   namespace
+   {
+      struct TraceEvent
+      {
+         const char* mName;
+         const char* mCategory;
+         Tracer::Nanoseconds mStartTime;
+         Tracer::Nanoseconds mDuration;
+         unsigned mFrame;
+      };
+
+      /// The events recorded by one thread.  Only that thread adds events, but a trace being written reads them.
+      struct ThreadBuffer
+      {
+         /// Held while recording, and while events are copied out or cleared.
+         OpenThreads::Mutex mMutex;
+         std::vector<TraceEvent> mEvents;
+         /// where the next event goes.
+         unsigned mNext;
+         /// true once the buffer has filled and the oldest events are being overwritten.
+         bool mWrapped;
+         unsigned mThreadIndex;
+
+         /// Call with mMutex locked.
+         void Reset(unsigned numEvents)
+         {
+            mEvents.resize(numEvents);
+            mNext = 0;
+            mWrapped = false;
+         }
+      };
+
+      /// The state shared by all threads.  The buffer list is only changed while holding the mutex.
+      struct TraceState
+      {
+         TraceState()
+            : mStartTick(osg::Timer::instance()->tick())
+            , mNanosecondsPerTick(osg::Timer::instance()->getSecondsPerTick() * 1e9)
+            , mEventsPerThread(Tracer::DEFAULT_EVENTS_PER_THREAD)
+            , mFrameNumber(0)
+            , mCapturing(false)
+            , mCaptureFirstFrame(0)
+            , mCaptureLastFrame(0)
+            , mEnabledBeforeCapture(false)
+         {
+         }
+
+         ~TraceState()
+         {
+            for (unsigned i = 0; i < mBuffers.size(); ++i)
+            {
+               delete mBuffers[i];
+            }
+         }
+
+         osg::Timer_t mStartTick;
+         double mNanosecondsPerTick;
+
+         OpenThreads::Mutex mMutex;
+         std::vector<ThreadBuffer*> mBuffers;
+         unsigned mEventsPerThread;
+
+         unsigned mFrameNumber;
+
+         bool mCapturing;
+         unsigned mCaptureFirstFrame;
+         unsigned mCaptureLastFrame;
+         std::string mCaptureFile;
+         bool mEnabledBeforeCapture;
+      };
+
+      TraceState& GetState()
+      {
+         static TraceState state;
+         return state;
+      }
+
+      DT_TRACE_THREAD_LOCAL ThreadBuffer* gThreadBuffer = NULL;
+
+      ThreadBuffer& GetThreadBuffer()
+      {
+         if (gThreadBuffer == NULL)
+         {
+            TraceState& state = GetState();
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(state.mMutex);
+            ThreadBuffer* buffer = new ThreadBuffer;
+            buffer->mThreadIndex = unsigned(state.mBuffers.size());
+            buffer->Reset(state.mEventsPerThread);
+            state.mBuffers.push_back(buffer);
+            gThreadBuffer = buffer;
+         }
+         return *gThreadBuffer;
+      }
+
+      void WriteJsonString(std::ostream& stream, const char* str)
+      {
+         stream << '"';
+         for (const char* c = str; *c != '\0'; ++c)
+         {
+            switch (*c)
+            {
+            case '"':  stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+               if ((unsigned char)(*c) < 0x20)
+               {
+                  stream << ' ';
+               }
+               else
+               {
+                  stream << *c;
+               }
+               break;
+            }
+         }
+         stream << '"';
+      }
+
+      /// Chrome traces are in microseconds, so this writes the nanoseconds as a fraction.
+      void WriteMicroseconds(std::ostream& stream, Tracer::Nanoseconds time)
+      {
+         char oldFill = stream.fill('0');
+         stream << (time / 1000) << '.' << std::setw(3) << unsigned(time % 1000);
+         stream.fill(oldFill);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::SetEnabled(bool enabled)
+   {
+      // make sure the clock is started from the main thread.
+      GetState();
+      mEnabled = enabled;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   Tracer::Nanoseconds Tracer::GetTime()
+   {
+      TraceState& state = GetState();
+      osg::Timer_t ticks = osg::Timer::instance()->tick() - state.mStartTick;
+      return Nanoseconds(double(ticks) * state.mNanosecondsPerTick);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::AddEvent(const char* name, const char* category, Nanoseconds startTime, Nanoseconds endTime)
+   {
+      ThreadBuffer& buffer = GetThreadBuffer();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(buffer.mMutex);
+      if (buffer.mEvents.empty())
+      {
+         return;
+      }
+
+      TraceEvent& event = buffer.mEvents[buffer.mNext];
+      event.mName = name;
+      event.mCategory = category;
+      event.mStartTime = startTime;
+      event.mDuration = endTime > startTime ? endTime - startTime : 0;
+      event.mFrame = GetState().mFrameNumber;
+
+      if (++buffer.mNext == buffer.mEvents.size())
+      {
+         buffer.mNext = 0;
+         buffer.mWrapped = true;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   const char* Tracer::InternName(const std::string& name)
+   {
+      // interned strings are never freed.
+      return dtUtil::RefString(name).c_str();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::BeginFrame()
+   {
+      TraceState& state = GetState();
+      ++state.mFrameNumber;
+
+      if (state.mCapturing && state.mFrameNumber > state.mCaptureLastFrame)
+      {
+         state.mCapturing = false;
+         mEnabled = state.mEnabledBeforeCapture;
+         if (!WriteChromeTrace(state.mCaptureFile, state.mCaptureFirstFrame, state.mCaptureLastFrame))
+         {
+            LOG_ERROR("Unable to write the trace capture to \"" + state.mCaptureFile + "\".");
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned Tracer::GetFrameNumber()
+   {
+      return GetState().mFrameNumber;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::CaptureFrames(unsigned numFrames, const std::string& fileName)
+   {
+      if (numFrames == 0)
+      {
+         return;
+      }
+
+      TraceState& state = GetState();
+      if (!state.mCapturing)
+      {
+         state.mEnabledBeforeCapture = mEnabled;
+      }
+      state.mCapturing = true;
+      state.mCaptureFirstFrame = state.mFrameNumber + 1;
+      state.mCaptureLastFrame = state.mFrameNumber + numFrames;
+      state.mCaptureFile = fileName;
+      mEnabled = true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool Tracer::IsCapturing()
+   {
+      return GetState().mCapturing;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::WriteChromeTrace(std::ostream& stream, unsigned firstFrame, unsigned lastFrame)
+   {
+      // Copy the events out first, holding each buffer only as long as it takes to copy it, so
+      // threads that are still recording aren't blocked while the stream is written.
+      std::vector<std::vector<TraceEvent> > threadEvents;
+      {
+         TraceState& state = GetState();
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(state.mMutex);
+         threadEvents.resize(state.mBuffers.size());
+         for (unsigned i = 0; i < state.mBuffers.size(); ++i)
+         {
+            ThreadBuffer& buffer = *state.mBuffers[i];
+            OpenThreads::ScopedLock<OpenThreads::Mutex> bufferLock(buffer.mMutex);
+
+            // oldest first.
+            unsigned numEvents = buffer.mWrapped ? unsigned(buffer.mEvents.size()) : buffer.mNext;
+            unsigned start = buffer.mWrapped ? buffer.mNext : 0;
+            for (unsigned j = 0; j < numEvents; ++j)
+            {
+               const TraceEvent& event = buffer.mEvents[(start + j) % buffer.mEvents.size()];
+               if (event.mFrame >= firstFrame && event.mFrame <= lastFrame)
+               {
+                  threadEvents[buffer.mThreadIndex].push_back(event);
+               }
+            }
+         }
+      }
+
+      stream << "{\"traceEvents\":[";
+      bool first = true;
+      for (unsigned i = 0; i < threadEvents.size(); ++i)
+      {
+         stream << (first ? "\n" : ",\n");
+         first = false;
+         stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+                << ",\"args\":{\"name\":\"Thread " << i << "\"}}";
+
+         for (unsigned j = 0; j < threadEvents[i].size(); ++j)
+         {
+            const TraceEvent& event = threadEvents[i][j];
+
+            stream << ",\n{\"name\":";
+            WriteJsonString(stream, event.mName);
+            stream << ",\"cat\":";
+            WriteJsonString(stream, event.mCategory);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            WriteMicroseconds(stream, event.mStartTime);
+            stream << ",\"dur\":";
+            WriteMicroseconds(stream, event.mDuration);
+            stream << ",\"pid\":1,\"tid\":" << i
+                   << ",\"args\":{\"frame\":" << event.mFrame << "}}";
+         }
+      }
+      stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool Tracer::WriteChromeTrace(const std::string& fileName, unsigned firstFrame, unsigned lastFrame)
+   {
+      std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+      if (!file.is_open())
+      {
+         return false;
+      }
+
+      WriteChromeTrace(file, firstFrame, lastFrame);
+      return !file.fail();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::Clear()
+   {
+      TraceState& state = GetState();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(state.mMutex);
+      for (unsigned i = 0; i < state.mBuffers.size(); ++i)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> bufferLock(state.mBuffers[i]->mMutex);
+         state.mBuffers[i]->Reset(state.mEventsPerThread);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void Tracer::SetEventsPerThread(unsigned numEvents)
+   {
+      TraceState& state = GetState();
+      if (numEvents == state.mEventsPerThread)
+      {
+         return;
+      }
+
+      state.mEventsPerThread = numEvents;
+      Clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned Tracer::GetEventsPerThread()
+   {
+      return GetState().mEventsPerThread;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   TraceScope::TraceScope(const std::string& name, const char* category)
+      : mName(NULL)
+      , mCategory(category)
+      , mStartTime(0)
+   {
+      if (Tracer::IsEnabled())
+      {
+         mName = Tracer::InternName(name);
+         mStartTime = Tracer::GetTime();
+      }
+   }
+}
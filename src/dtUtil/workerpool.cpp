@@ -0,0 +1,164 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2010, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * David Guthrie
+ */
+
+#include <prefix/dtutilprefix-src.h>
+#include <dtUtil/workerpool.h>
+
+#include <OpenThreads/Thread>
+#include <OpenThreads/ScopedLock>
+
+namespace dtUtil
+{
+   ///////////////////////////////////////////////////////////////////////////////
+   class WorkerPool::WorkerThread : public OpenThreads::Thread
+   {
+   public:
+      WorkerThread(WorkerPool& pool)
+         : mPool(pool)
+      {
+      }
+
+      virtual void run()
+      {
+         mPool.WorkerLoop();
+      }
+
+   private:
+      WorkerPool& mPool;
+   };
+
+   ///////////////////////////////////////////////////////////////////////////////
+   WorkerPool::WorkerPool(unsigned numThreads)
+      : mTask(NULL)
+      , mCount(0)
+      , mNext(0)
+      , mRunning(0)
+      , mJobNumber(0)
+      , mQuit(false)
+   {
+      if (numThreads == 0)
+      {
+         int processors = OpenThreads::GetNumberOfProcessors();
+         numThreads = processors > 1 ? unsigned(processors - 1) : 0;
+      }
+
+      for (unsigned i = 0; i < numThreads; ++i)
+      {
+         WorkerThread* thread = new WorkerThread(*this);
+         mThreads.push_back(thread);
+         thread->start();
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   WorkerPool::~WorkerPool()
+   {
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mQuit = true;
+         mJobReady.broadcast();
+      }
+
+      for (unsigned i = 0; i < mThreads.size(); ++i)
+      {
+         mThreads[i]->join();
+         delete mThreads[i];
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void WorkerPool::Run(Task& task, unsigned count)
+   {
+      if (count == 0)
+      {
+         return;
+      }
+
+      // not worth waking anyone.
+      if (mThreads.empty() || count == 1)
+      {
+         for (unsigned i = 0; i < count; ++i)
+         {
+            task.Run(i);
+         }
+         return;
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mTask = &task;
+      mCount = count;
+      mNext = 0;
+      ++mJobNumber;
+      mJobReady.broadcast();
+
+      RunPieces();
+
+      while (mNext < mCount || mRunning > 0)
+      {
+         mJobDone.wait(&mMutex);
+      }
+      mTask = NULL;
+      mCount = 0;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void WorkerPool::RunPieces()
+   {
+      while (mTask != NULL && mNext < mCount)
+      {
+         Task& task = *mTask;
+         unsigned index = mNext++;
+         ++mRunning;
+
+         mMutex.unlock();
+         task.Run(index);
+         mMutex.lock();
+
+         --mRunning;
+         if (mNext >= mCount && mRunning == 0)
+         {
+            mJobDone.broadcast();
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void WorkerPool::WorkerLoop()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      unsigned lastJob = mJobNumber;
+      while (!mQuit)
+      {
+         while (lastJob == mJobNumber && !mQuit)
+         {
+            mJobReady.wait(&mMutex);
+         }
+
+         if (mQuit)
+         {
+            break;
+         }
+
+         lastJob = mJobNumber;
+         RunPieces();
+      }
+   }
+}
@@ -33,6 +33,9 @@
 #include <dtCore/deltawin.h>
 #include <dtCore/infiniteterrain.h>
 #include <dtCore/batchisector.h>
+#include <dtCore/rayquerytree.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
 #include <dtCore/scene.h>
 #include <dtCore/system.h>
 #include <dtCore/exceptionenum.h>
@@ -41,6 +44,8 @@
 #include <dtUtil/exception.h>
 
 #include <osg/io_utils>
+#include <osg/Geode>
+#include <osg/Geometry>
 
 extern dtABC::Application& GetGlobalApplication();
 
@@ -49,6 +54,7 @@ class BatchISectorTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST_SUITE(BatchISectorTests);
 
       CPPUNIT_TEST(TestIntersection);
+      CPPUNIT_TEST(TestRayQueryTree);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -165,6 +171,87 @@ class BatchISectorTests : public CPPUNIT_NS::TestFixture
       }
 
 
+      void TestRayQueryTree()
+      {
+         // A 20 x 20 square on the x-y plane, under a transformable that can move it.
+         dtCore::RefPtr<dtCore::Transformable> quad = new dtCore::Transformable("Quad");
+         osg::Geometry* geometry = new osg::Geometry;
+         osg::Vec3Array* vertices = new osg::Vec3Array;
+         vertices->push_back(osg::Vec3(-10.0f, -10.0f, 0.0f));
+         vertices->push_back(osg::Vec3(10.0f, -10.0f, 0.0f));
+         vertices->push_back(osg::Vec3(10.0f, 10.0f, 0.0f));
+         vertices->push_back(osg::Vec3(-10.0f, 10.0f, 0.0f));
+         geometry->setVertexArray(vertices);
+         geometry->addPrimitiveSet(new osg::DrawArrays(GL_QUADS, 0, 4));
+         osg::Geode* geode = new osg::Geode;
+         geode->addDrawable(geometry);
+         quad->GetMatrixNode()->addChild(geode);
+
+         dtCore::RefPtr<dtCore::RayQueryTree> tree = new dtCore::RayQueryTree;
+         tree->Build(*quad->GetOSGNode());
+         CPPUNIT_ASSERT(tree->GetRoot() == quad->GetOSGNode());
+         CPPUNIT_ASSERT_EQUAL(1U, tree->GetNumDrawables());
+         CPPUNIT_ASSERT_EQUAL(2U, tree->GetNumTriangles());
+         CPPUNIT_ASSERT(!tree->Update());
+
+         mBatchIsector->SetQueryRoot(quad.get());
+         mBatchIsector->SetRayQueryTree(tree.get());
+         CPPUNIT_ASSERT(mBatchIsector->GetRayQueryTree() == tree.get());
+
+         dtCore::BatchIsector::SingleISector& iSector = mBatchIsector->EnableAndGetISector(0);
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         iSector.SetToCheckForClosestDrawable(true);
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3()));
+         CPPUNIT_ASSERT_EQUAL(1U, iSector.GetNumberOfHits());
+         CheckIsectorValues(0.0f, osg::Vec3(0.0f, 0.0f, 1.0f));
+         CPPUNIT_ASSERT(iSector.GetClosestDrawable() == quad.get());
+
+         // Moving the quad refits the tree without rebuilding it.
+         quad->SetTransform(dtCore::Transform(0.0f, 0.0f, 5.0f));
+         CPPUNIT_ASSERT(tree->Update());
+         CPPUNIT_ASSERT_EQUAL(2U, tree->GetNumTriangles());
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, tree->GetBound().zMax(), 1e-4f);
+
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3()));
+         CheckIsectorValues(5.0f, osg::Vec3(0.0f, 0.0f, 1.0f));
+
+         // The scene graph traversal finds the same point.
+         mBatchIsector->SetRayQueryTree(NULL);
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3()));
+         CheckIsectorValues(5.0f, osg::Vec3(0.0f, 0.0f, 1.0f));
+
+         mBatchIsector->SetRayQueryTree(tree.get());
+         iSector.SetSectorAsLineSegment(osg::Vec3(50.0f, 50.0f, 100.0f), osg::Vec3(50.0f, 50.0f, -100.0f));
+         CPPUNIT_ASSERT(!mBatchIsector->Update(osg::Vec3()));
+         CPPUNIT_ASSERT_EQUAL(0U, iSector.GetNumberOfHits());
+
+         // Move the quad without refitting the tree, so it is clear which one answered.
+         quad->SetTransform(dtCore::Transform(0.0f, 0.0f, 7.0f));
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3()));
+         CheckIsectorValues(5.0f, osg::Vec3(0.0f, 0.0f, 1.0f));
+
+         // The tree only has the highest level of detail, so other queries traverse the graph.
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3(), false));
+         CheckIsectorValues(7.0f, osg::Vec3(0.0f, 0.0f, 1.0f));
+
+         // A tree built from some other node is ignored.
+         dtCore::RefPtr<dtCore::Transformable> other = new dtCore::Transformable("Other");
+         mBatchIsector->SetQueryRoot(other.get());
+         iSector.SetSectorAsLineSegment(osg::Vec3(1.0f, 2.0f, 100.0f), osg::Vec3(1.0f, 2.0f, -100.0f));
+         CPPUNIT_ASSERT(!mBatchIsector->Update(osg::Vec3()));
+         CPPUNIT_ASSERT_EQUAL(0U, iSector.GetNumberOfHits());
+
+         tree->Clear();
+         CPPUNIT_ASSERT(tree->GetRoot() == NULL);
+
+         mBatchIsector->SetRayQueryTree(NULL);
+         mBatchIsector->ClearQueryRoot();
+      }
+
    private:
       dtCore::RefPtr<dtCore::BatchIsector>   mBatchIsector;
       dtCore::RefPtr<dtCore::Scene>          mScene;
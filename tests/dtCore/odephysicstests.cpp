@@ -24,7 +24,11 @@
 #include <dtCore/refptr.h>
 #include <dtCore/observerptr.h>
 #include <dtCore/odecontroller.h>
+#include <dtCore/odespacewrap.h>
+#include <dtCore/odeworldwrap.h>
 #include <dtCore/scene.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
 #include <dtUtil/mathdefines.h>
 #include <ode/objects.h>
 
@@ -37,6 +41,7 @@ class ODEPhysicsTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestSettingMassBeforeBodyAssignment);
       CPPUNIT_TEST(TestSettingThePosition);
       CPPUNIT_TEST(TestODEControllerDestructor);
+      CPPUNIT_TEST(TestStaticSpace);
    CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -51,6 +56,10 @@ public:
    void TestSettingThePosition();
    void TestSettingTheCoG();	
    void TestODEControllerDestructor();
+   void TestStaticSpace();
+
+private:
+   static void CountPairs(void* data, dGeomID o1, dGeomID o2);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ODEPhysicsTests);
@@ -226,3 +235,72 @@ void ODEPhysicsTests::TestODEControllerDestructor()
 
    CPPUNIT_ASSERT_EQUAL_MESSAGE("1 reference should exist for ode because of the global unit test application.", 1U, dtCore::ODEController::GetODERefCount());
 }
+
+//////////////////////////////////////////////////////////////////////////
+void ODEPhysicsTests::CountPairs(void* data, dGeomID o1, dGeomID o2)
+{
+   ++*static_cast<unsigned*>(data);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ODEPhysicsTests::TestStaticSpace()
+{
+   using namespace dtCore;
+
+   RefPtr<ODEWorldWrap> worldWrap = new ODEWorldWrap();
+   RefPtr<ODESpaceWrap> spaceWrap = new ODESpaceWrap(worldWrap.get());
+
+   unsigned numPairs = 0;
+   spaceWrap->SetUserCollisionCallback(CountPairs, &numPairs);
+
+   // Three boxes that all overlap each other.
+   RefPtr<Transformable> boxes[3];
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      boxes[i] = new Transformable();
+      boxes[i]->SetCollisionBox(1.f, 1.f, 1.f);
+      Transform xform;
+      xform.SetTranslation(0.25f * float(i), 0.f, 0.f);
+      boxes[i]->SetTransform(xform);
+      spaceWrap->RegisterCollidable(boxes[i].get());
+   }
+
+   spaceWrap->Collide();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Every pair of boxes should be tested.", 3U, numPairs);
+
+   spaceWrap->SetCollidableStatic(*boxes[0], true);
+   spaceWrap->SetCollidableStatic(*boxes[1], true);
+   CPPUNIT_ASSERT(spaceWrap->IsCollidableStatic(*boxes[0]));
+   CPPUNIT_ASSERT(!spaceWrap->IsCollidableStatic(*boxes[2]));
+
+   numPairs = 0;
+   spaceWrap->Collide();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The static boxes should not be tested against each other.", 2U, numPairs);
+
+   spaceWrap->SetStaticSpaceSettings(spaceWrap->ComputeTunedSettings(ODESpaceWrap::SPACE_QUADTREE, true));
+   spaceWrap->SetSpaceSettings(spaceWrap->ComputeTunedSettings(ODESpaceWrap::SPACE_SWEEP_AND_PRUNE, false));
+   CPPUNIT_ASSERT_EQUAL(ODESpaceWrap::SPACE_QUADTREE, spaceWrap->GetStaticSpaceSettings().mType);
+   CPPUNIT_ASSERT_EQUAL(ODESpaceWrap::SPACE_SWEEP_AND_PRUNE, spaceWrap->GetSpaceSettings().mType);
+   CPPUNIT_ASSERT_MESSAGE("Replacing the spaces should keep the geoms in them.",
+                          spaceWrap->IsCollidableStatic(*boxes[1]) && !spaceWrap->IsCollidableStatic(*boxes[2]));
+
+   numPairs = 0;
+   spaceWrap->Collide();
+   CPPUNIT_ASSERT_EQUAL(2U, numPairs);
+
+   ODESpaceWrap::SelfTestResults results;
+   spaceWrap->RunSelfTest(results, 2);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Each space should be timed with each type.", 8U, unsigned(results.size()));
+   for (unsigned i = 0; i < results.size(); ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Every type of space should find the same pairs.",
+                                   results[i].mStaticSpace ? 2U : 0U, results[i].mNumPairs);
+   }
+   CPPUNIT_ASSERT_MESSAGE("The self test should put the geoms back.",
+                          spaceWrap->IsCollidableStatic(*boxes[0]) && !spaceWrap->IsCollidableStatic(*boxes[2]));
+
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      spaceWrap->UnRegisterCollidable(boxes[i].get());
+   }
+}
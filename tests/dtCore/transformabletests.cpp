@@ -68,6 +68,7 @@ class TransformableTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestGetTransformNotInScene);
    CPPUNIT_TEST(TestGetTransformFromInactiveTransformable);
    CPPUNIT_TEST(TestGetTransformFromInactiveParent);
+   CPPUNIT_TEST(TestCachedAbsoluteTransform);
    CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -99,6 +100,7 @@ public:
    void TestGetTransformNotInScene();
    void TestGetTransformFromInactiveTransformable();
    void TestGetTransformFromInactiveParent();
+   void TestCachedAbsoluteTransform();
 
 private:
    bool CompareMatrix(const osg::Matrix& rhs, const osg::Matrix& lhs) const;
@@ -787,3 +789,72 @@ void TransformableTests::TestGetTransformFromInactiveParent()
       dtUtil::Equivalent(childStartXYZ+parentStartXYZ, endXform.GetTranslation(), TEST_EPSILON) );
 }
 
+void TransformableTests::TestCachedAbsoluteTransform()
+{
+   using namespace dtCore;
+   RefPtr<Transformable> grandparent = new Transformable("grandparent");
+   RefPtr<Transformable> parent = new Transformable("parent");
+   RefPtr<Transformable> child = new Transformable("child");
+   grandparent->AddChild(parent.get());
+   parent->AddChild(child.get());
+
+   Transform xform;
+   xform.SetTranslation(1.f, 2.f, 3.f);
+   grandparent->SetTransform(xform, Transformable::REL_CS);
+   parent->SetTransform(xform, Transformable::REL_CS);
+   child->SetTransform(xform, Transformable::REL_CS);
+
+   Transform result;
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(3.f, 6.f, 9.f), result.GetTranslation(), TEST_EPSILON));
+
+   // Asking again gives the same answer from the cache.
+   unsigned version = child->GetAbsoluteTransformVersion();
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(3.f, 6.f, 9.f), result.GetTranslation(), TEST_EPSILON));
+   CPPUNIT_ASSERT_EQUAL(version, child->GetAbsoluteTransformVersion());
+
+   // Moving a transformable above clears the cache of the ones under it.
+   xform.SetTranslation(10.f, 0.f, 0.f);
+   grandparent->SetTransform(xform, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(version != child->GetAbsoluteTransformVersion());
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(12.f, 4.f, 6.f), result.GetTranslation(), TEST_EPSILON));
+
+   // Setting the absolute transform of the child uses the cached parent matrix.
+   xform.SetTranslation(20.f, 20.f, 20.f);
+   child->SetTransform(xform, Transformable::ABS_CS);
+   child->GetTransform(result, Transformable::REL_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(9.f, 18.f, 17.f), result.GetTranslation(), TEST_EPSILON));
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(20.f, 20.f, 20.f), result.GetTranslation(), TEST_EPSILON));
+
+   // Changes made straight to the matrix nodes are still noticed.
+   version = child->GetAbsoluteTransformVersion();
+   child->GetMatrixNode()->setMatrix(osg::Matrix::translate(1.f, 1.f, 1.f));
+   CPPUNIT_ASSERT(version != child->GetAbsoluteTransformVersion());
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(12.f, 3.f, 4.f), result.GetTranslation(), TEST_EPSILON));
+   grandparent->GetMatrixNode()->setMatrix(osg::Matrix::translate(0.f, 0.f, 0.f));
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(2.f, 3.f, 4.f), result.GetTranslation(), TEST_EPSILON));
+
+   // Taking the parent out of the hierarchy leaves only its own transform above the child.
+   grandparent->RemoveChild(parent.get());
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(2.f, 3.f, 4.f), result.GetTranslation(), TEST_EPSILON));
+
+   // A plain osg transform above can't be tracked, so it is checked every time.
+   RefPtr<osg::MatrixTransform> osgTransform = new osg::MatrixTransform;
+   osgTransform->addChild(parent->GetOSGNode());
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(2.f, 3.f, 4.f), result.GetTranslation(), TEST_EPSILON));
+   version = child->GetAbsoluteTransformVersion();
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(version != child->GetAbsoluteTransformVersion());
+   osgTransform->setMatrix(osg::Matrix::translate(0.f, 0.f, 100.f));
+   child->GetTransform(result, Transformable::ABS_CS);
+   CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(2.f, 3.f, 104.f), result.GetTranslation(), TEST_EPSILON));
+   osgTransform->removeChild(parent->GetOSGNode());
+}
+
@@ -0,0 +1,150 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/dtgameprefix-src.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/hashmap.h>
+#include <sstream>
+#include <vector>
+
+namespace dtTest
+{
+   /// unit tests for dtCore::UniqueId
+   class UniqueIdTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE( UniqueIdTests );
+      CPPUNIT_TEST( TestGeneratedIdsAreBinary );
+      CPPUNIT_TEST( TestStringRoundTrip );
+      CPPUNIT_TEST( TestNonCanonicalStrings );
+      CPPUNIT_TEST( TestOrderingMatchesStrings );
+      CPPUNIT_TEST( TestHashMapLookup );
+      CPPUNIT_TEST_SUITE_END();
+
+      public:
+         void setUp()
+         {}
+         void tearDown()
+         {}
+
+         void TestGeneratedIdsAreBinary()
+         {
+            dtCore::UniqueId id1;
+            dtCore::UniqueId id2;
+            CPPUNIT_ASSERT(id1.IsBinary());
+            CPPUNIT_ASSERT(!id1.IsNull());
+            CPPUNIT_ASSERT(id1 != id2);
+            CPPUNIT_ASSERT_EQUAL(size_t(36), id1.ToString().size());
+
+            dtCore::UniqueId copy(id1);
+            CPPUNIT_ASSERT(copy == id1);
+            CPPUNIT_ASSERT_EQUAL(id1.GetHash(), copy.GetHash());
+         }
+
+         void TestStringRoundTrip()
+         {
+            const std::string idString("0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0");
+            dtCore::UniqueId id(idString);
+            CPPUNIT_ASSERT(id.IsBinary());
+            CPPUNIT_ASSERT_EQUAL(idString, id.ToString());
+
+            std::ostringstream ss;
+            ss << id;
+            CPPUNIT_ASSERT_EQUAL(idString, ss.str());
+
+            char buffer[dtCore::UniqueId::STRING_LENGTH + 1];
+            CPPUNIT_ASSERT(id.FormatString(buffer));
+            CPPUNIT_ASSERT_EQUAL(idString, std::string(buffer));
+            CPPUNIT_ASSERT(!dtCore::UniqueId("Some Actor").FormatString(buffer));
+
+            dtCore::UniqueId other;
+            other = idString;
+            CPPUNIT_ASSERT(other == id);
+            CPPUNIT_ASSERT_EQUAL(id.GetHash(), other.GetHash());
+         }
+
+         void TestNonCanonicalStrings()
+         {
+            dtCore::UniqueId empty("");
+            CPPUNIT_ASSERT(empty.IsNull());
+            CPPUNIT_ASSERT(!empty.IsBinary());
+            CPPUNIT_ASSERT(empty.ToString().empty());
+
+            // upper case must not compare equal to the lower case form since the strings differ.
+            dtCore::UniqueId upper("0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0");
+            dtCore::UniqueId lower("0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0");
+            CPPUNIT_ASSERT(!upper.IsBinary());
+            CPPUNIT_ASSERT(upper != lower);
+            CPPUNIT_ASSERT_EQUAL(std::string("0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0"), upper.ToString());
+
+            dtCore::UniqueId named("Some Actor");
+            CPPUNIT_ASSERT(!named.IsBinary());
+            CPPUNIT_ASSERT(named == dtCore::UniqueId("Some Actor"));
+         }
+
+         void TestOrderingMatchesStrings()
+         {
+            std::vector<dtCore::UniqueId> ids;
+            ids.push_back(dtCore::UniqueId(""));
+            ids.push_back(dtCore::UniqueId("Some Actor"));
+            ids.push_back(dtCore::UniqueId("0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0"));
+            ids.push_back(dtCore::UniqueId("0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0"));
+            for (unsigned i = 0; i < 10; ++i)
+            {
+               ids.push_back(dtCore::UniqueId());
+            }
+
+            for (unsigned i = 0; i < ids.size(); ++i)
+            {
+               for (unsigned j = 0; j < ids.size(); ++j)
+               {
+                  CPPUNIT_ASSERT_EQUAL(ids[i].ToString() < ids[j].ToString(), ids[i] < ids[j]);
+                  CPPUNIT_ASSERT_EQUAL(ids[i].ToString() == ids[j].ToString(), ids[i] == ids[j]);
+               }
+            }
+         }
+
+         void TestHashMapLookup()
+         {
+            typedef dtUtil::HashMap<dtCore::UniqueId, int, dtCore::UniqueIdHash> IdMap;
+            IdMap idMap;
+            std::vector<dtCore::UniqueId> ids;
+            for (int i = 0; i < 100; ++i)
+            {
+               ids.push_back(dtCore::UniqueId());
+               idMap.insert(std::make_pair(ids.back(), i));
+            }
+            idMap.insert(std::make_pair(dtCore::UniqueId("Some Actor"), 100));
+
+            CPPUNIT_ASSERT_EQUAL(size_t(101), idMap.size());
+            for (int i = 0; i < 100; ++i)
+            {
+               IdMap::const_iterator found = idMap.find(dtCore::UniqueId(ids[i].ToString()));
+               CPPUNIT_ASSERT(found != idMap.end());
+               CPPUNIT_ASSERT_EQUAL(i, found->second);
+            }
+            CPPUNIT_ASSERT(idMap.find(dtCore::UniqueId("Some Actor")) != idMap.end());
+            CPPUNIT_ASSERT(idMap.find(dtCore::UniqueId("Other Actor")) == idMap.end());
+         }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION( UniqueIdTests );
+}
@@ -82,6 +82,7 @@ class MapTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST( TestLoadMapIntoScene );
       CPPUNIT_TEST( TestMapSaveAndLoad );
       CPPUNIT_TEST( TestMapSaveAndLoadEvents );
+      CPPUNIT_TEST( TestMapReadEventsAndBuild );
       CPPUNIT_TEST( TestMapSaveAndLoadGroup );
       CPPUNIT_TEST( TestMapSaveAndLoadActorGroups );
       CPPUNIT_TEST( TestLibraryMethods );
@@ -101,6 +102,7 @@ class MapTests : public CPPUNIT_NS::TestFixture
       void TestMapEventsModified();
       void TestMapSaveAndLoad();
       void TestMapSaveAndLoadEvents();
+      void TestMapReadEventsAndBuild();
       void TestMapSaveAndLoadGroup();
       void TestMapSaveAndLoadActorGroups();
       void TestLoadMapIntoScene();
@@ -1284,6 +1286,76 @@ void MapTests::TestMapSaveAndLoadEvents()
    }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+void MapTests::TestMapReadEventsAndBuild()
+{
+   try
+   {
+      dtDAL::Project& project = dtDAL::Project::GetInstance();
+
+      const std::string mapName("Neato Map");
+      const std::string mapFileName("neatomap");
+
+      dtDAL::Map* map = &project.CreateMap(mapName, mapFileName);
+      map->SetDescription("Read on one thread, built on another.");
+
+      dtCore::RefPtr<dtDAL::GameEvent> ge = new dtDAL::GameEvent("name", "Test Description");
+      map->GetEventManager().AddEvent(*ge);
+
+      project.SaveMap(*map);
+      project.CloseMap(*map);
+      map = NULL;
+
+      dtCore::RefPtr<dtDAL::MapXMLEvents> badEvents = new dtDAL::MapXMLEvents("this file does not exist.xml");
+      CPPUNIT_ASSERT(!badEvents->Read());
+      CPPUNIT_ASSERT(!badEvents->GetError().empty());
+      CPPUNIT_ASSERT_EQUAL(0U, badEvents->GetNumEvents());
+
+      dtCore::RefPtr<dtDAL::MapXMLEvents> events = new dtDAL::MapXMLEvents(project.GetMapFilePath(mapName));
+      CPPUNIT_ASSERT_MESSAGE(events->GetError(), events->Read());
+      CPPUNIT_ASSERT(events->GetNumEvents() > 2U);
+
+      // one event at a time, as if each one used up the frame budget.
+      dtCore::RefPtr<dtDAL::MapParser> parser = new dtDAL::MapParser;
+      parser->BeginParse(*events);
+      CPPUNIT_ASSERT(parser->IsParsing());
+
+      dtCore::RefPtr<dtDAL::Map> parsedMap;
+      unsigned numCalls = 0;
+      float lastProgress = 0.0f;
+      while (!parsedMap.valid() && numCalls <= events->GetNumEvents())
+      {
+         parsedMap = parser->ContinueParse(1);
+         ++numCalls;
+         if (!parsedMap.valid())
+         {
+            CPPUNIT_ASSERT(parser->GetParseProgress() > lastProgress);
+            lastProgress = parser->GetParseProgress();
+         }
+      }
+
+      CPPUNIT_ASSERT(parsedMap.valid());
+      CPPUNIT_ASSERT(!parser->IsParsing());
+      CPPUNIT_ASSERT_EQUAL(events->GetNumEvents(), numCalls);
+
+      CPPUNIT_ASSERT(!project.IsMapOpen(mapName));
+      map = &project.OpenParsedMap(mapName, *parsedMap, *parser);
+      CPPUNIT_ASSERT(map == parsedMap.get());
+      CPPUNIT_ASSERT(project.IsMapOpen(mapName));
+      CPPUNIT_ASSERT(!map->IsModified());
+      CPPUNIT_ASSERT_EQUAL(mapName, map->GetName());
+      CPPUNIT_ASSERT_EQUAL(mapFileName + dtDAL::Map::MAP_FILE_EXTENSION, map->GetFileName());
+      CPPUNIT_ASSERT_EQUAL(std::string("Read on one thread, built on another."), map->GetDescription());
+      CPPUNIT_ASSERT(map->GetEventManager().FindEvent(ge->GetUniqueId()) != NULL);
+
+      project.DeleteMap(*map, true);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL((std::string("Error: ") + e.What()).c_str());
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 void MapTests::TestMapSaveAndLoadGroup()
 {
@@ -58,6 +58,8 @@
 
 #include <dtActors/engineactorregistry.h>
 
+#include "testcomponent.h"
+
 extern dtABC::Application& GetGlobalApplication();
 
 namespace dtGame
@@ -153,6 +155,11 @@ namespace dtGame
          CPPUNIT_TEST(TestDoDRVelocityAccelNoMotion);
          CPPUNIT_TEST(TestDoDRStatic);
          CPPUNIT_TEST(TestDoDRNoDR);
+         CPPUNIT_TEST(TestBatchMatchesDoDR);
+         CPPUNIT_TEST(TestBatchBehaviorRemote);
+         CPPUNIT_TEST(TestDistanceBands);
+         CPPUNIT_TEST(TestDistanceBandBehavior);
+         CPPUNIT_TEST(TestPublishOnDRError);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -645,6 +652,223 @@ namespace dtGame
             TestDoDRStatic(false);
          }
 
+         void TestBatchMatchesDoDR()
+         {
+            TestBatchMatchesDoDR(DeadReckoningAlgorithm::VELOCITY_ONLY);
+            TestBatchMatchesDoDR(DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION);
+
+            // A helper sitting at its last known position with no motion should not be flagged as changed.
+            dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
+            helper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_ONLY);
+            helper->ClearUpdated();
+
+            DeadReckoningComponent::DRBatch batch;
+            batch.Add(*helper, mTestGameActor->GetGameActor());
+            DeadReckoningComponent::DeadReckonBatch(batch);
+            CPPUNIT_ASSERT_EQUAL(1U, unsigned(batch.mChanged.size()));
+            CPPUNIT_ASSERT(batch.mChanged[0] == 0);
+
+            // Entries persist between ticks, and only stale ones get all their state copied again.
+            dtCore::RefPtr<DeadReckoningHelper> other = new DeadReckoningHelper;
+            other->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_ONLY);
+            other->ClearUpdated();
+            batch.Add(*other, mTestGameActor->GetGameActor());
+            CPPUNIT_ASSERT_EQUAL(2U, batch.GetSize());
+
+            batch.BeginTick();
+            CPPUNIT_ASSERT(batch.mStep[0] == DeadReckoningComponent::DRBatch::STEP_NONE);
+            CPPUNIT_ASSERT(batch.mStep[1] == DeadReckoningComponent::DRBatch::STEP_NONE);
+            batch.SetPending(*other, mTestGameActor->GetGameActor());
+            CPPUNIT_ASSERT(batch.mStep[1] == DeadReckoningComponent::DRBatch::STEP_PENDING);
+            other->SetLastKnownVelocity(osg::Vec3(1.0f, 0.0f, 0.0f));
+            batch.Activate(1);
+            CPPUNIT_ASSERT(batch.mStep[1] == DeadReckoningComponent::DRBatch::STEP_BATCH);
+            CPPUNIT_ASSERT_EQUAL(0.0f, batch.mVelocity.Get(1).x());
+            batch.MarkStale(1);
+            batch.Activate(1);
+            CPPUNIT_ASSERT_EQUAL(1.0f, batch.mVelocity.Get(1).x());
+
+            batch.Remove(*helper);
+            CPPUNIT_ASSERT_EQUAL(1U, batch.GetSize());
+            CPPUNIT_ASSERT(batch.mHelpers[0] == other.get());
+            CPPUNIT_ASSERT_EQUAL(1.0f, batch.mVelocity.Get(0).x());
+
+            batch.Clear();
+            CPPUNIT_ASSERT_EQUAL(0U, batch.GetSize());
+            DeadReckoningComponent::DeadReckonBatch(batch);
+            CPPUNIT_ASSERT(batch.mChanged.empty());
+         }
+
+         void TestBatchBehaviorRemote()
+         {
+            mDeadReckoningComponent->SetUseBatchDeadReckoning(true);
+            CPPUNIT_ASSERT(mDeadReckoningComponent->GetUseBatchDeadReckoning());
+
+            dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
+            mGM->AddActor(*mTestGameActor, true, false);
+            mDeadReckoningComponent->RegisterActor(*mTestGameActor, *helper);
+
+            helper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION);
+            helper->SetFlying(true);
+            helper->SetLastKnownVelocity(osg::Vec3(10.0f, 0.0f, 0.0f));
+
+            // The first tick goes through DoDR because the helper was updated.
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT(!helper->IsUpdated());
+            osg::Vec3 firstPos = helper->GetCurrentDeadReckonedTranslation();
+
+            // The second goes through the batch.
+            dtCore::System::GetInstance().Step();
+            osg::Vec3 secondPos = helper->GetCurrentDeadReckonedTranslation();
+
+            std::ostringstream ss;
+            ss << "The actor should have moved along x, but went from " << firstPos << " to " << secondPos;
+            CPPUNIT_ASSERT_MESSAGE(ss.str(), secondPos.x() > firstPos.x());
+
+            dtCore::Transform xform;
+            mTestGameActor->GetGameActor().GetTransform(xform);
+            osg::Vec3 actorPos;
+            xform.GetTranslation(actorPos);
+            ss.str("");
+            ss << "The actor should be at " << secondPos << " but it is at " << actorPos;
+            CPPUNIT_ASSERT_MESSAGE(ss.str(), dtUtil::Equivalent(actorPos, secondPos, 1e-3f));
+         }
+
+         void TestDistanceBands()
+         {
+            CPPUNIT_ASSERT_EQUAL(0U, mDeadReckoningComponent->GetNumDistanceBands());
+            CPPUNIT_ASSERT_EQUAL(1U, mDeadReckoningComponent->GetUpdateIntervalForDistance(1000.0f));
+
+            mDeadReckoningComponent->AddDistanceBand(200.0f, 8);
+            mDeadReckoningComponent->AddDistanceBand(50.0f, 4);
+            mDeadReckoningComponent->AddDistanceBand(50.0f, 3);
+            CPPUNIT_ASSERT_EQUAL(2U, mDeadReckoningComponent->GetNumDistanceBands());
+
+            CPPUNIT_ASSERT_EQUAL(1U, mDeadReckoningComponent->GetUpdateIntervalForDistance(10.0f));
+            CPPUNIT_ASSERT_EQUAL(3U, mDeadReckoningComponent->GetUpdateIntervalForDistance(60.0f));
+            CPPUNIT_ASSERT_EQUAL(8U, mDeadReckoningComponent->GetUpdateIntervalForDistance(300.0f));
+
+            mDeadReckoningComponent->ClearDistanceBands();
+            CPPUNIT_ASSERT_EQUAL(0U, mDeadReckoningComponent->GetNumDistanceBands());
+            CPPUNIT_ASSERT_EQUAL(1U, mDeadReckoningComponent->GetUpdateIntervalForDistance(300.0f));
+
+            CPPUNIT_ASSERT_EQUAL(1U, mDeadReckoningComponent->GetOffScreenUpdateInterval());
+            mDeadReckoningComponent->SetOffScreenUpdateInterval(5, 45.0f);
+            CPPUNIT_ASSERT_EQUAL(5U, mDeadReckoningComponent->GetOffScreenUpdateInterval());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(45.0f, mDeadReckoningComponent->GetOffScreenHalfAngle(), 1e-4f);
+         }
+
+         void TestDistanceBandBehavior()
+         {
+            dtCore::RefPtr<GameActorProxy> eyePoint;
+            mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, eyePoint);
+            mGM->AddActor(*eyePoint, false, false);
+            mDeadReckoningComponent->SetEyePointActor(&eyePoint->GetGameActor());
+            mDeadReckoningComponent->AddDistanceBand(50.0f, 4);
+
+            dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
+            mGM->AddActor(*mTestGameActor, true, false);
+            mDeadReckoningComponent->RegisterActor(*mTestGameActor, *helper);
+
+            helper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_ONLY);
+            helper->SetFlying(true);
+            helper->SetLastKnownTranslation(osg::Vec3(100.0f, 0.0f, 0.0f));
+            helper->SetLastKnownVelocity(osg::Vec3(10.0f, 0.0f, 0.0f));
+
+            // An update is always processed right away.
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT(!helper->IsUpdated());
+            osg::Vec3 drPos = helper->GetCurrentDeadReckonedTranslation();
+            CPPUNIT_ASSERT(drPos.x() >= 100.0f);
+
+            // The next three ticks only carry the actor along, so the helper is left alone.
+            for (unsigned i = 0; i < 3; ++i)
+            {
+               dtCore::System::GetInstance().Step();
+               CPPUNIT_ASSERT(drPos == helper->GetCurrentDeadReckonedTranslation());
+            }
+
+            dtCore::Transform xform;
+            mTestGameActor->GetGameActor().GetTransform(xform);
+            osg::Vec3 actorPos;
+            xform.GetTranslation(actorPos);
+            CPPUNIT_ASSERT(actorPos.x() >= drPos.x());
+
+            // A new update cuts the wait short.
+            dtCore::System::GetInstance().Step();
+            helper->SetLastKnownVelocity(osg::Vec3(20.0f, 0.0f, 0.0f));
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT(!helper->IsUpdated());
+
+            mDeadReckoningComponent->ClearDistanceBands();
+            mDeadReckoningComponent->SetEyePointActor(NULL);
+         }
+
+         bool WasActorUpdateSent(TestComponent& tc)
+         {
+            std::vector<dtCore::RefPtr<const dtGame::Message> >& msgs = tc.GetReceivedProcessMessages();
+            for (unsigned i = 0; i < msgs.size(); ++i)
+            {
+               if (msgs[i]->GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED
+                  && msgs[i]->GetAboutActorId() == mTestGameActor->GetId())
+               {
+                  return true;
+               }
+            }
+            return false;
+         }
+
+         void TestPublishOnDRError()
+         {
+            CPPUNIT_ASSERT(!mDeadReckoningComponent->GetPublishOnDeadReckoningError());
+            mDeadReckoningComponent->SetPublishOnDeadReckoningError(true);
+            mDeadReckoningComponent->SetMaxTranslationError(1.0f);
+            mDeadReckoningComponent->SetMaxRotationError(5.0f);
+            mDeadReckoningComponent->SetPublishHeartbeat(0.0f);
+            CPPUNIT_ASSERT(mDeadReckoningComponent->GetPublishOnDeadReckoningError());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f, mDeadReckoningComponent->GetMaxTranslationError(), 1e-5f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, mDeadReckoningComponent->GetMaxRotationError(), 1e-5f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, mDeadReckoningComponent->GetPublishHeartbeat(), 1e-5f);
+
+            dtCore::RefPtr<TestComponent> tc = new TestComponent;
+            mGM->AddComponent(*tc, GameManager::ComponentPriority::HIGHEST);
+
+            dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
+            mGM->AddActor(*mTestGameActor, false, true);
+            mDeadReckoningComponent->RegisterActor(*mTestGameActor, *helper);
+            helper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_ONLY);
+            helper->SetFlying(true);
+
+            dtCore::System::GetInstance().Step();
+            tc->reset();
+
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT_MESSAGE("The actor has not moved, so nothing should be published.", !WasActorUpdateSent(*tc));
+
+            dtCore::Transform xform;
+            xform.SetTranslation(osg::Vec3(0.5f, 0.0f, 0.0f));
+            mTestGameActor->GetGameActor().SetTransform(xform);
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT_MESSAGE("The error is under the threshold, so nothing should be published.", !WasActorUpdateSent(*tc));
+
+            xform.SetTranslation(osg::Vec3(2.0f, 0.0f, 0.0f));
+            mTestGameActor->GetGameActor().SetTransform(xform);
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT_MESSAGE("The error is over the threshold, so an update should be published.", WasActorUpdateSent(*tc));
+            CPPUNIT_ASSERT(dtUtil::Equivalent(helper->GetLastKnownTranslation(), osg::Vec3(2.0f, 0.0f, 0.0f), 1e-3f));
+
+            tc->reset();
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT_MESSAGE("The last known state matches again, so nothing should be published.", !WasActorUpdateSent(*tc));
+
+            xform.SetRotation(osg::Vec3(10.0f, 0.0f, 0.0f));
+            mTestGameActor->GetGameActor().SetTransform(xform);
+            dtCore::System::GetInstance().Step();
+            CPPUNIT_ASSERT_MESSAGE("The rotation error is over the threshold, so an update should be published.", WasActorUpdateSent(*tc));
+
+            mGM->RemoveComponent(*tc);
+         }
+
          void TestSimpleBehaviorLocal()
          {
             TestSimpleBehavior(false);
@@ -938,6 +1162,46 @@ namespace dtGame
             CPPUNIT_ASSERT(wasTransformed);
          }
 
+         void TestBatchMatchesDoDR(DeadReckoningAlgorithm& algorithm)
+         {
+            dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
+
+            InitDoDRTestHelper(*helper);
+            helper->SetDeadReckoningAlgorithm(algorithm);
+            helper->SetFlying(true);
+            helper->SetLastKnownVelocity(osg::Vec3(1.0f, -2.0f, 0.5f));
+            helper->SetLastKnownVelocity(osg::Vec3(3.0f, 1.0f, -0.5f));
+            helper->SetLastKnownAcceleration(osg::Vec3(0.2f, 0.4f, -1.0f));
+            helper->SetTranslationBeforeLastUpdate(osg::Vec3(0.5f, 2.0f, 3.0f));
+
+            dtCore::Transform xform;
+            xform.SetTranslation(helper->GetTranslationBeforeLastUpdate());
+            mDeadReckoningComponent->InternalCalcTotSmoothingSteps(*helper, xform);
+            helper->ClearUpdated();
+            helper->SetTranslationElapsedTimeSinceUpdate(0.1f);
+
+            DeadReckoningComponent::DRBatch batch;
+            batch.Add(*helper, mTestGameActor->GetGameActor());
+            DeadReckoningComponent::DeadReckonBatch(batch);
+            CPPUNIT_ASSERT_EQUAL(1U, batch.GetSize());
+
+            xform.SetTranslation(helper->GetCurrentDeadReckonedTranslation());
+            xform.SetRotation(helper->GetCurrentDeadReckonedRotation());
+            BaseGroundClamper::GroundClampingType* groundClampingType = &BaseGroundClamper::GroundClampingType::NONE;
+            bool wasTransformed = helper->DoDR(mTestGameActor->GetGameActor(), xform,
+                  &dtUtil::Log::GetInstance(), groundClampingType);
+
+            CPPUNIT_ASSERT_EQUAL(wasTransformed, batch.mChanged[0] != 0);
+            CPPUNIT_ASSERT(&helper->GetGroundClampingType() == groundClampingType);
+
+            osg::Vec3 trans;
+            xform.GetTranslation(trans);
+            std::ostringstream ss;
+            ss << "The batch position for " << algorithm.GetName() << " should be " << trans
+               << " but it is " << batch.mResult.Get(0);
+            CPPUNIT_ASSERT_MESSAGE(ss.str(), dtUtil::Equivalent(trans, batch.mResult.Get(0), 1e-4f));
+         }
+
          void TestDoDRStatic(bool flying)
          {
             dtCore::RefPtr<DeadReckoningHelper> helper = new DeadReckoningHelper;
@@ -38,6 +38,8 @@
 #include <dtCore/globals.h>
 
 #include <dtDAL/datatype.h>
+#include <dtDAL/enginepropertytypes.h>
+#include <dtDAL/transformableactorproxy.h>
 
 #include <dtGame/messageparameter.h>
 #include <dtGame/machineinfo.h>
@@ -70,6 +72,7 @@ namespace dtGame
          CPPUNIT_TEST(TestUpdateActor);
          CPPUNIT_TEST(TestDeleteActor);
          CPPUNIT_TEST(TestUpdateUnpublishedActor);
+         CPPUNIT_TEST(TestUpdateDirtyProperties);
          CPPUNIT_TEST(TestAdditionalTypesToPublishAddRemove);
          CPPUNIT_TEST(TestAdditionalTypesToPublishFunction);
 
@@ -83,6 +86,7 @@ namespace dtGame
       void TestUpdateActor();
       void TestDeleteActor();
       void TestUpdateUnpublishedActor();
+      void TestUpdateDirtyProperties();
       void TestAdditionalTypesToPublishAddRemove();
       void TestAdditionalTypesToPublishFunction();
 
@@ -279,4 +283,71 @@ namespace dtGame
 
       CPPUNIT_ASSERT_EQUAL(0U, unsigned(mTestComp->GetReceivedDispatchNetworkMessages().size()));
    }
+
+   //////////////////////////////////////////////////////////////////////////
+   void DefaultNetworkPublishingComponentTests::TestUpdateDirtyProperties()
+   {
+      mGameManager->PublishActor(*mGameActorProxy);
+      dtCore::System::GetInstance().Step();
+      dtCore::System::GetInstance().Step();
+
+      mTestComp->reset();
+
+      CPPUNIT_ASSERT_MESSAGE("Adding the actor should have cleared the dirty properties.", !mGameActorProxy->HasDirtyProperties());
+
+      dtDAL::Vec3ActorProperty* translation = NULL;
+      mGameActorProxy->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION, translation);
+      CPPUNIT_ASSERT(translation != NULL);
+      translation->SetValue(osg::Vec3(1.0f, 2.0f, 3.0f));
+      translation->SetValue(osg::Vec3(4.0f, 5.0f, 6.0f));
+
+      CPPUNIT_ASSERT(mGameActorProxy->IsPropertyDirty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION));
+      CPPUNIT_ASSERT(!mGameActorProxy->IsPropertyDirty(dtDAL::TransformableActorProxy::PROPERTY_ROTATION));
+      CPPUNIT_ASSERT_EQUAL(1U, mGameActorProxy->GetNumDirtyProperties());
+
+      dtCore::System::GetInstance().Step();
+      dtCore::System::GetInstance().Step();
+      CPPUNIT_ASSERT_MESSAGE("Nothing should be published on tick unless it is enabled.",
+               mTestComp->GetReceivedDispatchNetworkMessages().empty());
+
+      mGameActorProxy->NotifyDirtyActorUpdate();
+      CPPUNIT_ASSERT(!mGameActorProxy->HasDirtyProperties());
+      dtCore::System::GetInstance().Step();
+      dtCore::System::GetInstance().Step();
+
+      CPPUNIT_ASSERT_EQUAL(1U, unsigned(mTestComp->GetReceivedDispatchNetworkMessages().size()));
+      const ActorUpdateMessage* updateMessage = dynamic_cast<const ActorUpdateMessage*>(mTestComp->GetReceivedDispatchNetworkMessages()[0].get());
+      CPPUNIT_ASSERT(updateMessage != NULL);
+      std::vector<const MessageParameter*> params;
+      updateMessage->GetUpdateParameters(params);
+      CPPUNIT_ASSERT_EQUAL(1U, unsigned(params.size()));
+      CPPUNIT_ASSERT(updateMessage->GetUpdateParameter(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION) != NULL);
+
+      mTestComp->reset();
+      mGameActorProxy->NotifyDirtyActorUpdate();
+      dtCore::System::GetInstance().Step();
+      dtCore::System::GetInstance().Step();
+      CPPUNIT_ASSERT_MESSAGE("No update should be sent when nothing is dirty.",
+               mTestComp->GetReceivedDispatchNetworkMessages().empty());
+
+      mGameActorProxy->SetPublishDirtyPropertiesOnTick(true);
+      CPPUNIT_ASSERT(mGameActorProxy->GetPublishDirtyPropertiesOnTick());
+
+      dtDAL::Vec3ActorProperty* rotation = NULL;
+      mGameActorProxy->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_ROTATION, rotation);
+      CPPUNIT_ASSERT(rotation != NULL);
+      rotation->SetValue(osg::Vec3(10.0f, 0.0f, 0.0f));
+      dtCore::System::GetInstance().Step();
+      CPPUNIT_ASSERT_MESSAGE("The dirty properties should be cleared when they are published on tick.",
+               !mGameActorProxy->HasDirtyProperties());
+      dtCore::System::GetInstance().Step();
+
+      CPPUNIT_ASSERT_EQUAL(1U, unsigned(mTestComp->GetReceivedDispatchNetworkMessages().size()));
+      updateMessage = dynamic_cast<const ActorUpdateMessage*>(mTestComp->GetReceivedDispatchNetworkMessages()[0].get());
+      CPPUNIT_ASSERT(updateMessage != NULL);
+      params.clear();
+      updateMessage->GetUpdateParameters(params);
+      CPPUNIT_ASSERT_EQUAL(1U, unsigned(params.size()));
+      CPPUNIT_ASSERT(updateMessage->GetUpdateParameter(dtDAL::TransformableActorProxy::PROPERTY_ROTATION) != NULL);
+   }
 }
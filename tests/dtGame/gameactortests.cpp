@@ -42,6 +42,8 @@
 #include <dtDAL/actortype.h>
 #include <dtDAL/enginepropertytypes.h>
 #include <dtDAL/project.h>
+#include <dtDAL/functor.h>
+#include <dtDAL/transformableactorproxy.h>
 #include <dtUtil/datastream.h>
 #include <dtGame/messageparameter.h>
 #include <dtGame/machineinfo.h>
@@ -55,12 +57,16 @@
 #include <dtGame/gmcomponent.h>
 #include <dtGame/defaultmessageprocessor.h>
 #include <dtGame/invokable.h>
+#include <dtGame/actorcomponentsystem.h>
 #include <dtABC/application.h>
 #include <testGameActorLibrary/testgameactorlibrary.h>
 #include <testGameActorLibrary/testgameenvironmentactor.h>
 #include <testGameActorLibrary/testgamepropertyproxy.h>
 #include <testGameActorLibrary/testgameactor.h>
 #include <dtCore/observerptr.h>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+#include <map>
 
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -79,6 +85,7 @@ class GameActorTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestInvokableMessageRegistration);
       CPPUNIT_TEST(TestGlobalInvokableMessageRegistration);
       CPPUNIT_TEST(TestGlobalInvokableMessageRegistrationEndOfFrame);
+      CPPUNIT_TEST(TestInvokableRebinding);
       CPPUNIT_TEST(TestStaticGameActorTypes);
       CPPUNIT_TEST(TestEnvironmentTimeConversions);
       CPPUNIT_TEST(TestDefaultProcessMessageRegistration);
@@ -87,6 +94,9 @@ class GameActorTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestOnRemovedActor);
       CPPUNIT_TEST(TestAddActorComponent);
       CPPUNIT_TEST(TestActorComponentInitialized);
+      CPPUNIT_TEST(TestActorComponentSystem);
+      CPPUNIT_TEST(TestPropertyHandles);
+      CPPUNIT_TEST(TestSharedPropertyLayout);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -102,6 +112,7 @@ public:
    void TestDefaultProcessMessageRegistration();
    void TestGlobalInvokableMessageRegistration();
    void TestGlobalInvokableMessageRegistrationEndOfFrame();
+   void TestInvokableRebinding();
    void TestStaticGameActorTypes();
    void TestEnvironmentTimeConversions();
    void TestMessageProcessingPerformance();
@@ -109,6 +120,9 @@ public:
    void TestOnRemovedActor();
    void TestAddActorComponent();
    void TestActorComponentInitialized();
+   void TestActorComponentSystem();
+   void TestPropertyHandles();
+   void TestSharedPropertyLayout();
 
 private:
    static const std::string mTestGameActorLibrary;
@@ -120,6 +134,34 @@ private:
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(GameActorTests);
 
+/// Counts the messages it is invoked with, and can unregister itself while being invoked.
+class InvokeCounter
+{
+public:
+   static const std::string INVOKABLE_NAME;
+
+   InvokeCounter()
+      : mCount(0)
+      , mProxy(NULL)
+   {
+   }
+
+   void Invoke(const dtGame::Message& message)
+   {
+      ++mCount;
+      if (mProxy != NULL)
+      {
+         mProxy->UnregisterForMessages(message.GetMessageType(), INVOKABLE_NAME);
+      }
+   }
+
+   unsigned mCount;
+   /// if not NULL, the counter unregisters this proxy when invoked.
+   dtGame::GameActorProxy* mProxy;
+};
+
+const std::string InvokeCounter::INVOKABLE_NAME("Invoke Counter");
+
 const std::string GameActorTests::mTestGameActorLibrary = "testGameActorLibrary";
 const std::string GameActorTests::mTestActorLibrary     = "testActorLibrary";
 
@@ -853,6 +895,78 @@ void GameActorTests::TestSetEnvironmentActor()
    //}
 }
 
+////////////////////////////////////////////////////////////////////////
+void GameActorTests::TestInvokableRebinding()
+{
+   dtCore::RefPtr<const dtDAL::ActorType> actor1Type = mManager->FindActorType("ExampleActors", "Test1Actor");
+
+   dtCore::RefPtr<dtGame::GameActorProxy> listener;
+   mManager->CreateActor(*actor1Type, listener);
+   dtCore::RefPtr<dtGame::GameActorProxy> target;
+   mManager->CreateActor(*actor1Type, target);
+   mManager->AddActor(*listener, false, false);
+   mManager->AddActor(*target, false, false);
+
+   InvokeCounter counter;
+
+   // registering before the invokable exists is allowed.  It is looked up again once it is added.
+   mManager->RegisterForMessages(dtGame::MessageType::INFO_MAP_LOADED, *listener, InvokeCounter::INVOKABLE_NAME);
+   mManager->RegisterForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED,
+            target->GetId(), *listener, InvokeCounter::INVOKABLE_NAME);
+
+   dtCore::RefPtr<dtGame::Message> timerMsg =
+            mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+   timerMsg->SetAboutActorId(target->GetId());
+   dtCore::RefPtr<dtGame::Message> mapLoadedMsg =
+            mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_MAP_LOADED);
+
+   mManager->SendMessage(*mapLoadedMsg);
+   mManager->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(0U, counter.mCount);
+
+   listener->AddInvokable(*new dtGame::Invokable(InvokeCounter::INVOKABLE_NAME,
+            dtDAL::MakeFunctor(counter, &InvokeCounter::Invoke)));
+
+   mManager->SendMessage(*mapLoadedMsg);
+   mManager->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Both the global and the about actor listener should be invoked once the invokable exists",
+            2U, counter.mCount);
+
+   listener->RemoveInvokable(InvokeCounter::INVOKABLE_NAME);
+
+   mManager->SendMessage(*mapLoadedMsg);
+   mManager->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("A removed invokable must not be invoked", 2U, counter.mCount);
+
+   listener->AddInvokable(*new dtGame::Invokable(InvokeCounter::INVOKABLE_NAME,
+            dtDAL::MakeFunctor(counter, &InvokeCounter::Invoke)));
+   mManager->RegisterForMessages(dtGame::MessageType::INFO_MAP_LOADED, *target, dtGame::GameActorProxy::PROCESS_MSG_INVOKABLE);
+   counter.mProxy = listener.get();
+
+   // the counter unregisters itself from the map loaded message the first time.
+   mManager->SendMessage(*mapLoadedMsg);
+   mManager->SendMessage(*mapLoadedMsg);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(3U, counter.mCount);
+
+   std::vector< std::pair<dtGame::GameActorProxy*, std::string> > toFill;
+   mManager->GetRegistrantsForMessages(dtGame::MessageType::INFO_MAP_LOADED, toFill);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the other listener should be left once the invoke is done",
+            size_t(1), toFill.size());
+   CPPUNIT_ASSERT(toFill[0].first == target.get());
+
+   // deleting an actor removes the listeners about it.
+   mManager->DeleteActor(*target);
+   dtCore::System::GetInstance().Step();
+   mManager->GetRegistrantsForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, target->GetId(), toFill);
+   CPPUNIT_ASSERT(toFill.empty());
+
+   listener->RemoveInvokable(InvokeCounter::INVOKABLE_NAME);
+}
+
 void GameActorTests::TestStaticGameActorTypes()
 {
    const unsigned int size = 8;
@@ -1092,3 +1206,251 @@ void GameActorTests::TestActorComponentInitialized()
       CPPUNIT_FAIL(e.What());
    }
 }
+
+//////////////////////////////////////////////////////
+class TestComponent1System : public dtGame::ActorComponentSystem
+{
+public:
+   TestComponent1System()
+      : dtGame::ActorComponentSystem(TestActorComponent1::TYPE)
+   {
+   }
+
+   std::map<dtGame::ActorComponent*, int> mUpdates;
+   OpenThreads::Mutex mMutex;
+
+protected:
+   virtual void UpdateComponents(const dtGame::TickMessage& tickMessage,
+            const dtCore::RefPtr<dtGame::ActorComponent>* components, unsigned count)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         ++mUpdates[components[i].get()];
+      }
+   }
+};
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestActorComponentSystem()
+{
+   try
+   {
+      dtCore::RefPtr<const dtDAL::ActorType> actorType = mManager->FindActorType("ExampleActors", "Test1Actor");
+      std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > proxies;
+      std::vector<dtCore::RefPtr<TestActorComponent1> > components;
+      for (unsigned i = 0; i < 3; ++i)
+      {
+         dtCore::RefPtr<dtGame::GameActorProxy> gap;
+         mManager->CreateActor(*actorType, gap);
+         components.push_back(new TestActorComponent1());
+         gap->GetGameActor().AddComponent(components.back().get());
+         proxies.push_back(gap);
+      }
+
+      // the first actor is in the GM before the system, the others are added after it.
+      mManager->AddActor(*proxies[0], false, false);
+
+      dtCore::RefPtr<TestComponent1System> system = new TestComponent1System();
+      system->SetChunkSize(1);
+      system->SetWorkerPool(new dtUtil::WorkerPool(2));
+      mManager->AddComponent(*system, dtGame::GameManager::ComponentPriority::NORMAL);
+      CPPUNIT_ASSERT(dtGame::ActorComponentSystem::FindSystem(*mManager, TestActorComponent1::TYPE) == system.get());
+      CPPUNIT_ASSERT_EQUAL(1U, system->GetNumComponents());
+
+      mManager->AddActor(*proxies[1], false, false);
+      mManager->AddActor(*proxies[2], false, false);
+      CPPUNIT_ASSERT_EQUAL(3U, system->GetNumComponents());
+
+      dtCore::System::GetInstance().Step();
+      for (unsigned i = 0; i < components.size(); ++i)
+      {
+         CPPUNIT_ASSERT_EQUAL(1, system->mUpdates[components[i].get()]);
+      }
+
+      proxies[0]->GetGameActor().RemoveComponent(TestActorComponent1::TYPE);
+      CPPUNIT_ASSERT_EQUAL(2U, system->GetNumComponents());
+
+      mManager->DeleteActor(*proxies[1]);
+      dtCore::System::GetInstance().Step();
+      CPPUNIT_ASSERT_EQUAL(1U, system->GetNumComponents());
+      CPPUNIT_ASSERT(system->GetComponents()[0] == components[2].get());
+      CPPUNIT_ASSERT_EQUAL(1, system->mUpdates[components[0].get()]);
+      CPPUNIT_ASSERT_EQUAL(2, system->mUpdates[components[2].get()]);
+
+      mManager->RemoveComponent(*system);
+      CPPUNIT_ASSERT_EQUAL(0U, system->GetNumComponents());
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.What());
+   }
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestPropertyHandles()
+{
+   try
+   {
+      dtCore::RefPtr<const dtDAL::ActorType> actorType = mManager->FindActorType("ExampleActors", "Test1Actor");
+      CPPUNIT_ASSERT(actorType != NULL);
+
+      dtCore::RefPtr<dtGame::GameActorProxy> sender;
+      dtCore::RefPtr<dtGame::GameActorProxy> receiver;
+      mManager->CreateActor(*actorType, sender);
+      mManager->CreateActor(*actorType, receiver);
+
+      std::vector<dtDAL::ActorProperty*> props;
+      sender->GetPropertyList(props);
+      CPPUNIT_ASSERT(!props.empty());
+      for (unsigned i = 0; i < props.size(); ++i)
+      {
+         unsigned handle = sender->GetPropertyHandle(*props[i]);
+         CPPUNIT_ASSERT(handle != dtDAL::ActorType::INVALID_PROPERTY_HANDLE);
+         CPPUNIT_ASSERT(sender->GetPropertyByHandle(handle) == props[i]);
+         CPPUNIT_ASSERT_EQUAL(props[i]->GetName(), actorType->GetPropertyHandleName(handle));
+         CPPUNIT_ASSERT_EQUAL(handle, actorType->FindPropertyHandle(props[i]->GetName()));
+
+         const dtDAL::ActorProperty* otherProp = receiver->GetPropertyByHandle(handle);
+         CPPUNIT_ASSERT_MESSAGE("Proxies of the same type should share the handles.", otherProp != NULL);
+         CPPUNIT_ASSERT_EQUAL(props[i]->GetName(), otherProp->GetName());
+      }
+
+      CPPUNIT_ASSERT(sender->GetPropertyByHandle(actorType->GetNumPropertyHandles()) == NULL);
+      CPPUNIT_ASSERT_EQUAL(dtDAL::ActorType::INVALID_PROPERTY_HANDLE, actorType->FindPropertyHandle("not a property"));
+      CPPUNIT_ASSERT_EQUAL(dtDAL::ActorType::INVALID_PROPERTY_HANDLE, sender->GetPropertyHandle(*receiver->GetProperty(props[0]->GetName())));
+
+      dtDAL::Vec3ActorProperty* translation = NULL;
+      sender->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION, translation);
+      CPPUNIT_ASSERT(translation != NULL);
+      osg::Vec3 newTranslation(3.0f, 4.0f, 5.0f);
+      translation->SetValue(newTranslation);
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+      mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+      sender->PopulateActorUpdate(*update);
+
+      const dtGame::ActorUpdateMessage::ParameterHandleList* handles = update->GetUpdateParameterHandles(*actorType);
+      CPPUNIT_ASSERT_MESSAGE("Populating the update should set the handles of all the parameters.", handles != NULL);
+      std::vector<const dtGame::MessageParameter*> params;
+      update->GetUpdateParameters(params);
+      CPPUNIT_ASSERT_EQUAL(params.size(), handles->size());
+
+      dtCore::RefPtr<const dtDAL::ActorType> otherType = mManager->FindActorType("ExampleActors", "Test2Actor");
+      CPPUNIT_ASSERT(otherType != NULL);
+      CPPUNIT_ASSERT(update->GetUpdateParameterHandles(*otherType) == NULL);
+
+      receiver->ApplyActorUpdate(*update);
+      dtDAL::Vec3ActorProperty* receivedTranslation = NULL;
+      receiver->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION, receivedTranslation);
+      CPPUNIT_ASSERT(receivedTranslation->GetValue() == newTranslation);
+
+      // a parameter without a handle makes the update fall back to the names.
+      update->AddUpdateParameter("Not A Property", dtDAL::DataType::INT);
+      CPPUNIT_ASSERT(update->GetUpdateParameterHandles(*actorType) == NULL);
+
+      newTranslation.set(6.0f, 7.0f, 8.0f);
+      static_cast<dtDAL::NamedVec3Parameter*>(update->GetUpdateParameter(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION))->SetValue(newTranslation);
+      receiver->ApplyActorUpdate(*update);
+      CPPUNIT_ASSERT(receivedTranslation->GetValue() == newTranslation);
+
+      // copying the message must not copy handles that point at the original's parameters.
+      dtCore::RefPtr<dtGame::Message> clone = mManager->GetMessageFactory().CloneMessage(*update);
+      CPPUNIT_ASSERT(static_cast<dtGame::ActorUpdateMessage&>(*clone).GetUpdateParameterHandles(*actorType) == NULL);
+
+      // an update read from the network only has the names, so the reading component resolves them.
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> remoteUpdate;
+      mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, remoteUpdate);
+      remoteUpdate->SetActorType(*actorType);
+      newTranslation.set(9.0f, 10.0f, 11.0f);
+      static_cast<dtDAL::NamedVec3Parameter*>(remoteUpdate->AddUpdateParameter(
+               dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION, dtDAL::DataType::VEC3))->SetValue(newTranslation);
+      CPPUNIT_ASSERT(remoteUpdate->GetUpdateParameterHandles(*actorType) == NULL);
+      CPPUNIT_ASSERT(remoteUpdate->ResolveUpdateParameterHandles(*actorType));
+      handles = remoteUpdate->GetUpdateParameterHandles(*actorType);
+      CPPUNIT_ASSERT(handles != NULL);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), handles->size());
+      CPPUNIT_ASSERT_EQUAL(sender->GetPropertyHandle(*translation), (*handles)[0].first);
+      receiver->ApplyActorUpdate(*remoteUpdate);
+      CPPUNIT_ASSERT(receivedTranslation->GetValue() == newTranslation);
+
+      // a name the type doesn't have is applied by name, but the other names keep their handles.
+      remoteUpdate->AddUpdateParameter("Not A Property", dtDAL::DataType::INT);
+      CPPUNIT_ASSERT(!remoteUpdate->ResolveUpdateParameterHandles(*actorType));
+      CPPUNIT_ASSERT(remoteUpdate->GetUpdateParameterHandles(*actorType) == NULL);
+      const dtGame::ActorUpdateMessage::ParameterHandleList& partialHandles =
+         remoteUpdate->FindUpdateParameterHandles(*actorType);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), partialHandles.size());
+      CPPUNIT_ASSERT_EQUAL(sender->GetPropertyHandle(*translation), partialHandles[0].first);
+      CPPUNIT_ASSERT_EQUAL(dtDAL::ActorType::INVALID_PROPERTY_HANDLE, partialHandles[1].first);
+      newTranslation.set(12.0f, 13.0f, 14.0f);
+      static_cast<dtDAL::NamedVec3Parameter*>(remoteUpdate->GetUpdateParameter(
+               dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION))->SetValue(newTranslation);
+      receiver->ApplyActorUpdate(*remoteUpdate);
+      CPPUNIT_ASSERT(receivedTranslation->GetValue() == newTranslation);
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.What());
+   }
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestSharedPropertyLayout()
+{
+   try
+   {
+      dtCore::RefPtr<const dtDAL::ActorType> actorType = mManager->FindActorType("ExampleActors", "Test1Actor");
+      CPPUNIT_ASSERT(actorType != NULL);
+
+      dtCore::RefPtr<dtGame::GameActorProxy> first;
+      dtCore::RefPtr<dtGame::GameActorProxy> second;
+      mManager->CreateActor(*actorType, first);
+      mManager->CreateActor(*actorType, second);
+
+      CPPUNIT_ASSERT_MESSAGE("Proxies of a type should share the layout of the type.", first->GetSharedLayout() != NULL);
+      CPPUNIT_ASSERT(first->GetSharedLayout() == second->GetSharedLayout());
+      CPPUNIT_ASSERT(first->GetSharedLayout() == actorType->GetPropertyLayout().get());
+      CPPUNIT_ASSERT_EQUAL(first->GetNumProperties(), first->GetSharedLayout()->GetNumProperties());
+
+      dtDAL::ActorProperty* translation = first->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION);
+      dtDAL::ActorProperty* secondTranslation = second->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION);
+      CPPUNIT_ASSERT(translation != NULL);
+      CPPUNIT_ASSERT(secondTranslation != NULL);
+      CPPUNIT_ASSERT_MESSAGE("Each proxy still has its own properties.", translation != secondTranslation);
+      CPPUNIT_ASSERT(first->GetProperty("not a property") == NULL);
+
+      // adding a property that isn't in the layout makes the proxy index its own properties.
+      dtCore::Transformable* trans = static_cast<dtCore::Transformable*>(second->GetActor());
+      second->AddProperty(new dtDAL::BooleanActorProperty("Runtime Property", "Runtime Property",
+               dtDAL::BooleanActorProperty::SetFuncType(trans, &dtCore::Transformable::SetNormalRescaling),
+               dtDAL::BooleanActorProperty::GetFuncType(trans, &dtCore::Transformable::GetNormalRescaling)));
+
+      CPPUNIT_ASSERT(second->GetSharedLayout() == NULL);
+      CPPUNIT_ASSERT(first->GetSharedLayout() != NULL);
+      CPPUNIT_ASSERT(second->GetProperty("Runtime Property") != NULL);
+      CPPUNIT_ASSERT(first->GetProperty("Runtime Property") == NULL);
+      CPPUNIT_ASSERT(second->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION) == secondTranslation);
+
+      unsigned handle = first->GetPropertyHandle(*translation);
+      CPPUNIT_ASSERT_EQUAL(handle, second->GetPropertyHandle(*secondTranslation));
+      CPPUNIT_ASSERT(second->GetPropertyByHandle(handle) == secondTranslation);
+
+      // copying between proxies works whether or not they share a layout.
+      osg::Vec3 newTranslation(1.0f, 2.0f, 3.0f);
+      static_cast<dtDAL::Vec3ActorProperty*>(translation)->SetValue(newTranslation);
+      second->CopyPropertiesFrom(*first);
+      CPPUNIT_ASSERT(static_cast<dtDAL::Vec3ActorProperty*>(secondTranslation)->GetValue() == newTranslation);
+
+      dtCore::RefPtr<dtGame::GameActorProxy> third;
+      mManager->CreateActor(*actorType, third);
+      third->CopyPropertiesFrom(*first);
+      dtDAL::Vec3ActorProperty* thirdTranslation = NULL;
+      third->GetProperty(dtDAL::TransformableActorProxy::PROPERTY_TRANSLATION, thirdTranslation);
+      CPPUNIT_ASSERT(thirdTranslation->GetValue() == newTranslation);
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.What());
+   }
+}
@@ -44,6 +44,8 @@
 #include <dtCore/scene.h>
 #include <dtCore/system.h>
 #include <dtCore/globals.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
 
 #include <dtDAL/datatype.h>
 #include <dtDAL/resourcedescriptor.h>
@@ -68,6 +70,7 @@
 #include <dtGame/environmentactor.h>
 
 #include <testGameActorLibrary/testplayer.h>
+#include <testGameActorLibrary/testgameactor.h>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <dtActors/gamemeshactor.h>
@@ -86,6 +89,7 @@ class GameManagerTests : public CPPUNIT_NS::TestFixture
         CPPUNIT_TEST(TestFindActorByType);
         CPPUNIT_TEST(TestFindActorByWrongType);
         CPPUNIT_TEST(TestFindActorByName);
+        CPPUNIT_TEST(TestFindActorsWithinRadius);
 
         CPPUNIT_TEST(TestDataStream);
 
@@ -101,12 +105,18 @@ class GameManagerTests : public CPPUNIT_NS::TestFixture
         CPPUNIT_TEST(TestComplexScene);
         CPPUNIT_TEST(TestAddRemoveComponents);
         CPPUNIT_TEST(TestComponentPriority);
+        CPPUNIT_TEST(TestComponentMessageTypeInterests);
+        CPPUNIT_TEST(TestSendMessageThreadSafe);
         CPPUNIT_TEST(TestFindActorById);
         CPPUNIT_TEST(TestFindGameActorById);
         CPPUNIT_TEST(TestPrototypeActors);
+        CPPUNIT_TEST(TestCreateActorsFromPrototype);
+        CPPUNIT_TEST(TestActorPooling);
+        CPPUNIT_TEST(TestTickIntervals);
         CPPUNIT_TEST(TestGMShutdown);
 
         CPPUNIT_TEST(TestTimers);
+        CPPUNIT_TEST(TestTimerHandles);
         CPPUNIT_TEST(TestIfOnAddedToGMIsCalled);
         CPPUNIT_TEST(TestIfGMSendsRestartedMessage);
         CPPUNIT_TEST(TestSetProjectContext);
@@ -121,6 +131,7 @@ public:
    void TestFindActorByType();
    void TestFindActorByWrongType();
    void TestFindActorByName();
+   void TestFindActorsWithinRadius();
 
    void TestDataStream();
 
@@ -136,12 +147,18 @@ public:
    void TestComplexScene();
    void TestAddRemoveComponents();
    void TestComponentPriority();
+   void TestComponentMessageTypeInterests();
+   void TestSendMessageThreadSafe();
    void TestFindActorById();
    void TestFindGameActorById();
    void TestPrototypeActors();
+   void TestCreateActorsFromPrototype();
+   void TestActorPooling();
+   void TestTickIntervals();
    void TestGMShutdown();
 
    void TestTimers();
+   void TestTimerHandles();
 
    void TestIfOnAddedToGMIsCalled();
    void TestIfGMSendsRestartedMessage();
@@ -342,6 +359,85 @@ void GameManagerTests::TestFindActorByName()
    }
 }
 
+/////////////////////////////////////////////////
+void GameManagerTests::TestFindActorsWithinRadius()
+{
+   mManager->SetSpatialIndexCellSize(5.0f);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, mManager->GetSpatialIndexCellSize(), 1e-6f);
+
+   // place actors every 10 meters along the x axis.
+   const unsigned numProxies = 10;
+   std::vector<dtCore::RefPtr<dtActors::GameMeshActorProxy> > meshProxies;
+   for (unsigned i = 0; i < numProxies; ++i)
+   {
+      dtCore::RefPtr<dtActors::GameMeshActorProxy> p;
+      mManager->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, p);
+      CPPUNIT_ASSERT(p != NULL);
+
+      dtCore::Transformable* actor = NULL;
+      p->GetActor(actor);
+      dtCore::Transform xform;
+      xform.SetTranslation(osg::Vec3(float(i) * 10.0f, 0.0f, 0.0f));
+      actor->SetTransform(xform);
+
+      mManager->AddActor(*p, false, false);
+      meshProxies.push_back(p);
+   }
+
+   dtCore::RefPtr<dtActors::TaskActorGameEventProxy> gameEventProxy;
+   mManager->CreateActor(*dtActors::EngineActorRegistry::GAME_EVENT_TASK_ACTOR_TYPE, gameEventProxy);
+   mManager->AddActor(*gameEventProxy, false, false);
+
+   std::vector<dtDAL::ActorProxy*> toFill;
+   mManager->FindActorsWithinRadius(osg::Vec3(20.0f, 0.0f, 0.0f), 10.5f, toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(3), toFill.size());
+
+   mManager->FindActorsWithinRadius(osg::Vec3(20.0f, 0.0f, 0.0f), 10.5f, toFill,
+            dtActors::EngineActorRegistry::GAME_EVENT_TASK_ACTOR_TYPE.get());
+   CPPUNIT_ASSERT_MESSAGE("The type filter should exclude all the mesh actors.", toFill.empty());
+
+   mManager->FindActorsWithinBox(osg::BoundingBox(-1.0f, -1.0f, -1.0f, 35.0f, 1.0f, 1.0f), toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(4), toFill.size());
+
+   mManager->FindNearestActors(osg::Vec3(71.0f, 0.0f, 0.0f), 2, toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), toFill.size());
+   CPPUNIT_ASSERT(toFill[0] == meshProxies[7].get());
+   CPPUNIT_ASSERT(toFill[1] == meshProxies[8].get());
+
+   // Moving an actor should be picked up on the next frame.
+   dtCore::Transformable* actor = NULL;
+   meshProxies[0]->GetActor(actor);
+   dtCore::Transform xform;
+   xform.SetTranslation(osg::Vec3(500.0f, 500.0f, 0.0f));
+   actor->SetTransform(xform);
+   dtCore::System::GetInstance().Step();
+
+   mManager->FindActorsWithinRadius(osg::Vec3(500.0f, 500.0f, 0.0f), 1.0f, toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), toFill.size());
+   CPPUNIT_ASSERT(toFill[0] == meshProxies[0].get());
+
+   // So should moving it straight through its matrix node.
+   actor->GetMatrixNode()->setMatrix(osg::Matrix::translate(-500.0f, 0.0f, 0.0f));
+   dtCore::System::GetInstance().Step();
+   mManager->FindActorsWithinRadius(osg::Vec3(500.0f, 500.0f, 0.0f), 1.0f, toFill);
+   CPPUNIT_ASSERT(toFill.empty());
+
+   // The nearest search must still reach actors after the one on the edge of the bounds moves away.
+   mManager->FindNearestActors(osg::Vec3(-500.0f, 0.0f, 0.0f), 1, toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), toFill.size());
+   CPPUNIT_ASSERT(toFill[0] == meshProxies[0].get());
+   actor->SetTransform(xform);
+   dtCore::System::GetInstance().Step();
+   mManager->FindNearestActors(osg::Vec3(-500.0f, 0.0f, 0.0f), 1, toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), toFill.size());
+   CPPUNIT_ASSERT(toFill[0] == meshProxies[1].get());
+
+   mManager->DeleteActor(*meshProxies[0]);
+   dtCore::System::GetInstance().Step();
+   mManager->FindActorsWithinRadius(osg::Vec3(500.0f, 500.0f, 0.0f), 1.0f, toFill);
+   CPPUNIT_ASSERT_MESSAGE("Deleted actors should be removed from the spatial index.", toFill.empty());
+}
+
 /////////////////////////////////////////////////
 void GameManagerTests::TestPrototypeActors()
 {
@@ -388,6 +484,183 @@ void GameManagerTests::TestPrototypeActors()
    CPPUNIT_ASSERT_MESSAGE("The prototyped method should have been able to create the prototype",
       testCreatePrototype.valid());
 }
+
+/////////////////////////////////////////////////
+void GameManagerTests::TestCreateActorsFromPrototype()
+{
+   dtCore::RefPtr<dtActors::GameMeshActorProxy> prototype;
+   mManager->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, prototype);
+   prototype->SetName("BulkPrototype");
+   dtDAL::ActorProperty* descProp = prototype->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY);
+   CPPUNIT_ASSERT(descProp != NULL);
+   descProp->FromString("first");
+   mManager->AddActorAsAPrototype(*prototype);
+
+   std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > actors;
+   mManager->CreateActorsFromPrototype(prototype->GetId(), 5, actors);
+   CPPUNIT_ASSERT_EQUAL(size_t(5), actors.size());
+   for (unsigned i = 0; i < actors.size(); ++i)
+   {
+      CPPUNIT_ASSERT(actors[i]->IsInGM());
+      CPPUNIT_ASSERT(actors[i]->GetId() != prototype->GetId());
+      CPPUNIT_ASSERT_EQUAL(prototype->GetName(), actors[i]->GetName());
+      CPPUNIT_ASSERT_EQUAL(std::string("first"),
+               actors[i]->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->ToString());
+      CPPUNIT_ASSERT(mManager->FindGameActorById(actors[i]->GetId()) == actors[i].get());
+   }
+
+   // Changing the prototype through its properties must be seen by the next clone.
+   descProp->FromString("second");
+   dtCore::RefPtr<dtDAL::ActorProxy> clone = mManager->CreateActorFromPrototype(prototype->GetId());
+   CPPUNIT_ASSERT(clone.valid());
+   CPPUNIT_ASSERT_EQUAL(std::string("second"),
+            clone->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->ToString());
+
+   try
+   {
+      mManager->CreateActorsFromPrototype(dtCore::UniqueId(), 2, actors);
+      CPPUNIT_FAIL("Creating actors from a prototype that doesn't exist should throw.");
+   }
+   catch (const dtUtil::Exception&)
+   {
+      // correct
+   }
+   CPPUNIT_ASSERT(actors.empty());
+}
+
+/////////////////////////////////////////////////
+void GameManagerTests::TestActorPooling()
+{
+   const dtDAL::ActorType& type = *dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE;
+   CPPUNIT_ASSERT_EQUAL(0U, mManager->GetActorPoolSize(type));
+   mManager->SetActorPoolSize(type, 1);
+   CPPUNIT_ASSERT_EQUAL(1U, mManager->GetActorPoolSize(type));
+
+   dtCore::RefPtr<dtActors::GameMeshActorProxy> proxy;
+   mManager->CreateActor(type, proxy);
+   CPPUNIT_ASSERT_EQUAL(1U, mManager->GetNumActorPoolMisses());
+   proxy->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->FromString("used");
+   mManager->AddActor(*proxy, false, false);
+
+   dtCore::RefPtr<dtActors::GameMeshActorProxy> held;
+   mManager->CreateActor(type, held);
+   mManager->AddActor(*held, false, false);
+
+   dtActors::GameMeshActorProxy* pooledPtr = proxy.get();
+   dtCore::UniqueId oldId = proxy->GetId();
+   mManager->DeleteActor(*proxy);
+   mManager->DeleteActor(*held);
+   proxy = NULL;
+   dtCore::System::GetInstance().Step();
+
+   // the held actor is still referenced, so it can't be pooled.
+   CPPUNIT_ASSERT_EQUAL(1U, mManager->GetNumPooledActors(type));
+   CPPUNIT_ASSERT(held->GetGameManager() == NULL);
+
+   mManager->CreateActor(type, proxy);
+   CPPUNIT_ASSERT_MESSAGE("The pooled actor should have been reused.", proxy.get() == pooledPtr);
+   CPPUNIT_ASSERT_EQUAL(1U, mManager->GetNumActorPoolHits());
+   CPPUNIT_ASSERT_EQUAL(0U, mManager->GetNumPooledActors(type));
+   CPPUNIT_ASSERT(proxy->GetId() != oldId);
+   CPPUNIT_ASSERT(proxy->GetGameManager() == mManager.get());
+   CPPUNIT_ASSERT(!proxy->IsInGM());
+   CPPUNIT_ASSERT_EQUAL(std::string(""), proxy->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->ToString());
+   mManager->AddActor(*proxy, false, false);
+   CPPUNIT_ASSERT(mManager->FindGameActorById(proxy->GetId()) == proxy.get());
+
+   // Actors made from a prototype come from the pool too, with the prototype's values.
+   dtCore::RefPtr<dtActors::GameMeshActorProxy> prototype;
+   mManager->CreateActor(type, prototype);
+   prototype->SetName("PooledPrototype");
+   prototype->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->FromString("prototyped");
+   mManager->AddActorAsAPrototype(*prototype);
+
+   pooledPtr = proxy.get();
+   mManager->DeleteActor(*proxy);
+   proxy = NULL;
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(1U, mManager->GetNumPooledActors(type));
+
+   dtCore::RefPtr<dtDAL::ActorProxy> clone = mManager->CreateActorFromPrototype(prototype->GetId());
+   CPPUNIT_ASSERT_MESSAGE("The pooled actor should have been used for the prototype.", clone.get() == pooledPtr);
+   CPPUNIT_ASSERT_EQUAL(2U, mManager->GetNumActorPoolHits());
+   CPPUNIT_ASSERT_EQUAL(prototype->GetName(), clone->GetName());
+   CPPUNIT_ASSERT_EQUAL(std::string("prototyped"), clone->GetProperty(dtDAL::ActorProxy::DESCRIPTION_PROPERTY)->ToString());
+   CPPUNIT_ASSERT_EQUAL(prototype->GetName(),
+            static_cast<dtGame::GameActorProxy&>(*clone).GetGameActor().GetPrototypeName());
+
+   mManager->SetActorPoolSize(type, 0);
+   CPPUNIT_ASSERT_EQUAL(0U, mManager->GetActorPoolSize(type));
+
+   // Removing an actor from the world removes its components, so an actor made with them isn't pooled.
+   dtCore::RefPtr<const dtDAL::ActorType> componentType = mManager->FindActorType("ExampleActors", "TestComponentActor");
+   CPPUNIT_ASSERT(componentType.valid());
+   mManager->SetActorPoolSize(*componentType, 1);
+
+   dtCore::RefPtr<dtGame::GameActorProxy> componentProxy;
+   mManager->CreateActor(*componentType, componentProxy);
+   CPPUNIT_ASSERT(componentProxy->GetGameActor().HasComponent(TestActorComponent1::TYPE));
+   mManager->AddActor(*componentProxy, false, false);
+   mManager->DeleteActor(*componentProxy);
+   componentProxy = NULL;
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(0U, mManager->GetNumPooledActors(*componentType));
+
+   unsigned hits = mManager->GetNumActorPoolHits();
+   mManager->CreateActor(*componentType, componentProxy);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("An actor that lost its components should not be reused.",
+            hits, mManager->GetNumActorPoolHits());
+   CPPUNIT_ASSERT(componentProxy->GetGameActor().HasComponent(TestActorComponent1::TYPE));
+
+   mManager->SetActorPoolSize(*componentType, 0);
+}
+
+/////////////////////////////////////////////////
+void GameManagerTests::TestTickIntervals()
+{
+   dtCore::RefPtr<const dtDAL::ActorType> type = mManager->FindActorType("ExampleActors", "Test1Actor");
+   CPPUNIT_ASSERT(type.valid());
+
+   std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > proxies;
+   std::vector<TestGameActor1*> actors;
+   for (unsigned i = 0; i < 4; ++i)
+   {
+      dtCore::RefPtr<dtGame::GameActorProxy> proxy;
+      mManager->CreateActor(*type, proxy);
+      mManager->AddActor(*proxy, false, false);
+      mManager->RegisterForTicks(dtGame::MessageType::TICK_LOCAL, *proxy,
+               dtGame::GameActorProxy::TICK_LOCAL_INVOKABLE, 2);
+      proxies.push_back(proxy);
+      actors.push_back(dynamic_cast<TestGameActor1*>(proxy->GetActor()));
+      CPPUNIT_ASSERT(actors.back() != NULL);
+   }
+
+   dtCore::System::GetInstance().Step();
+   int total = 0;
+   for (unsigned i = 0; i < actors.size(); ++i)
+   {
+      total += actors[i]->GetTickLocals();
+   }
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The actors with the same interval should be staggered across ticks.", 2, total);
+
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      dtCore::System::GetInstance().Step();
+   }
+   for (unsigned i = 0; i < actors.size(); ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL(2, actors[i]->GetTickLocals());
+   }
+
+   mManager->UnregisterForMessages(dtGame::MessageType::TICK_LOCAL, *proxies[0], dtGame::GameActorProxy::TICK_LOCAL_INVOKABLE);
+   dtCore::System::GetInstance().Step();
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(2, actors[0]->GetTickLocals());
+   CPPUNIT_ASSERT_EQUAL(3, actors[1]->GetTickLocals());
+
+   CPPUNIT_ASSERT_THROW(mManager->RegisterForTicks(dtGame::MessageType::INFO_GAME_EVENT, *proxies[0],
+            dtGame::GameActorProxy::TICK_LOCAL_INVOKABLE, 2), dtUtil::Exception);
+}
 /////////////////////////////////////////////////
 void GameManagerTests::TestApplicationMember()
 {
@@ -867,6 +1140,86 @@ void GameManagerTests::TestComponentPriority()
 
 }
 
+/////////////////////////////////////////////////
+void GameManagerTests::TestComponentMessageTypeInterests()
+{
+   dtCore::RefPtr<TestComponent> allComp = new TestComponent("all");
+   dtCore::RefPtr<TestComponent> tickComp = new TestComponent("tick");
+
+   CPPUNIT_ASSERT(tickComp->IsInterestedInAllMessageTypes());
+   tickComp->AddMessageTypeInterest(dtGame::MessageType::TICK_LOCAL);
+   CPPUNIT_ASSERT(!tickComp->IsInterestedInAllMessageTypes());
+   CPPUNIT_ASSERT(tickComp->IsInterestedInMessageType(dtGame::MessageType::TICK_LOCAL));
+   CPPUNIT_ASSERT(!tickComp->IsInterestedInMessageType(dtGame::MessageType::TICK_REMOTE));
+
+   std::vector<const dtGame::MessageType*> interests;
+   tickComp->GetMessageTypeInterests(interests);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), interests.size());
+   CPPUNIT_ASSERT(interests[0] == &dtGame::MessageType::TICK_LOCAL);
+
+   mManager->AddComponent(*allComp, dtGame::GameManager::ComponentPriority::NORMAL);
+   mManager->AddComponent(*tickComp, dtGame::GameManager::ComponentPriority::HIGHER);
+
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(allComp->FindProcessMessageOfType(dtGame::MessageType::TICK_LOCAL).valid());
+   CPPUNIT_ASSERT(allComp->FindProcessMessageOfType(dtGame::MessageType::TICK_REMOTE).valid());
+   CPPUNIT_ASSERT(tickComp->FindProcessMessageOfType(dtGame::MessageType::TICK_LOCAL).valid());
+   CPPUNIT_ASSERT_MESSAGE("The tick component should only get the message types it is interested in.",
+            !tickComp->FindProcessMessageOfType(dtGame::MessageType::TICK_REMOTE).valid());
+   for (unsigned i = 0; i < tickComp->GetReceivedProcessMessages().size(); ++i)
+   {
+      CPPUNIT_ASSERT(tickComp->GetReceivedProcessMessages()[i]->GetMessageType() == dtGame::MessageType::TICK_LOCAL);
+   }
+
+   // changing the interests while in the GM must take effect on the next message.
+   allComp->reset();
+   tickComp->reset();
+   tickComp->AddMessageTypeInterest(dtGame::MessageType::TICK_REMOTE);
+   allComp->AddMessageTypeInterest(dtGame::MessageType::TICK_END_OF_FRAME);
+
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(tickComp->FindProcessMessageOfType(dtGame::MessageType::TICK_REMOTE).valid());
+   CPPUNIT_ASSERT(!allComp->FindProcessMessageOfType(dtGame::MessageType::TICK_LOCAL).valid());
+   CPPUNIT_ASSERT(allComp->FindProcessMessageOfType(dtGame::MessageType::TICK_END_OF_FRAME).valid());
+
+   // removing the last interest goes back to getting everything.
+   allComp->reset();
+   allComp->RemoveMessageTypeInterest(dtGame::MessageType::TICK_END_OF_FRAME);
+   CPPUNIT_ASSERT(allComp->IsInterestedInAllMessageTypes());
+
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(allComp->FindProcessMessageOfType(dtGame::MessageType::TICK_LOCAL).valid());
+
+   mManager->RemoveComponent(*tickComp);
+   tickComp->reset();
+
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(tickComp->GetReceivedProcessMessages().empty());
+}
+
+/////////////////////////////////////////////////
+void GameManagerTests::TestSendMessageThreadSafe()
+{
+   dtCore::RefPtr<TestComponent> tc = new TestComponent();
+   mManager->AddComponent(*tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   dtCore::RefPtr<dtGame::Message> msg = mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_PAUSED);
+   dtCore::RefPtr<dtGame::Message> netMsg = mManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_RESUMED);
+   mManager->SendMessageThreadSafe(*msg);
+   mManager->SendNetworkMessageThreadSafe(*netMsg);
+
+   CPPUNIT_ASSERT(!tc->FindProcessMessageOfType(dtGame::MessageType::INFO_PAUSED).valid());
+
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(tc->FindProcessMessageOfType(dtGame::MessageType::INFO_PAUSED).get() == msg.get());
+   CPPUNIT_ASSERT(tc->FindDispatchNetworkMessageOfType(dtGame::MessageType::INFO_RESUMED).get() == netMsg.get());
+}
+
 /////////////////////////////////////////////////
 void GameManagerTests::TestCreateRemoteActor()
 {
@@ -1421,6 +1774,75 @@ void GameManagerTests::TestTimers()
    mManager->RemoveComponent(*tc);
 }
 
+/////////////////////////////////////////////////
+void GameManagerTests::TestTimerHandles()
+{
+   dtCore::RefPtr<TestComponent> tc = new TestComponent;
+   mManager->AddComponent(*tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   CPPUNIT_ASSERT(!mManager->IsTimerSet(dtGame::GameManager::INVALID_TIMER_HANDLE));
+   CPPUNIT_ASSERT(!mManager->ClearTimer(dtGame::GameManager::INVALID_TIMER_HANDLE));
+
+   // timers with the same name are still separate timers when cleared by handle.
+   dtGame::GameManager::TimerHandle first = mManager->SetTimer("Cooldown", NULL, 0.001f);
+   dtGame::GameManager::TimerHandle second = mManager->SetTimer("Cooldown", NULL, 0.001f);
+   dtGame::GameManager::TimerHandle repeating = mManager->SetTimer("Poll", NULL, 0.001f, true, true);
+   dtGame::GameManager::TimerHandle farAway = mManager->SetTimer("Poll", NULL, 1000.0f);
+   CPPUNIT_ASSERT(first != second);
+   CPPUNIT_ASSERT(mManager->IsTimerSet(first));
+   CPPUNIT_ASSERT(mManager->IsTimerSet(second));
+
+   CPPUNIT_ASSERT(mManager->ClearTimer(first));
+   CPPUNIT_ASSERT(!mManager->IsTimerSet(first));
+   CPPUNIT_ASSERT_MESSAGE("A timer can only be cleared once", !mManager->ClearTimer(first));
+
+   dtCore::AppSleep(5);
+   dtCore::System::GetInstance().Step();
+   dtCore::AppSleep(5);
+   dtCore::System::GetInstance().Step();
+
+   unsigned cooldownCount = 0, pollCount = 0;
+   std::vector<dtCore::RefPtr<const dtGame::Message> > msgs = tc->GetReceivedProcessMessages();
+   for (unsigned i = 0; i < msgs.size(); ++i)
+   {
+      if (msgs[i]->GetMessageType() == dtGame::MessageType::INFO_TIMER_ELAPSED)
+      {
+         const dtGame::TimerElapsedMessage* tem = static_cast<const dtGame::TimerElapsedMessage*>(msgs[i].get());
+         CPPUNIT_ASSERT(tem->GetLateTime() >= 0.0f);
+         if (tem->GetTimerName() == "Cooldown")
+         {
+            ++cooldownCount;
+         }
+         else if (tem->GetTimerName() == "Poll")
+         {
+            ++pollCount;
+         }
+      }
+   }
+
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the timer that was not cleared should fire", 1U, cooldownCount);
+   CPPUNIT_ASSERT_MESSAGE("The repeating timer should have fired", pollCount > 0);
+   CPPUNIT_ASSERT_MESSAGE("A timer that fired is no longer set", !mManager->IsTimerSet(second));
+   CPPUNIT_ASSERT_MESSAGE("A repeating timer stays set", mManager->IsTimerSet(repeating));
+   CPPUNIT_ASSERT(mManager->IsTimerSet(farAway));
+
+   // the name based clear removes every timer with the name.
+   mManager->ClearTimer("Poll", NULL);
+   CPPUNIT_ASSERT(!mManager->IsTimerSet(repeating));
+   CPPUNIT_ASSERT(!mManager->IsTimerSet(farAway));
+
+   tc->reset();
+   dtCore::AppSleep(5);
+   dtCore::System::GetInstance().Step();
+   msgs = tc->GetReceivedProcessMessages();
+   for (unsigned i = 0; i < msgs.size(); ++i)
+   {
+      CPPUNIT_ASSERT(msgs[i]->GetMessageType() != dtGame::MessageType::INFO_TIMER_ELAPSED);
+   }
+
+   mManager->RemoveComponent(*tc);
+}
+
 /////////////////////////////////////////////////
 void GameManagerTests::TestFindActorById()
 {
@@ -35,10 +35,12 @@
 #include <osg/Node>
 
 #include <dtUtil/mathdefines.h>
+#include <dtUtil/workerpool.h>
 
 #include <dtCore/transform.h>
 #include <dtCore/transformable.h>
 #include <dtCore/batchisector.h>
+#include <dtCore/rayquerytree.h>
 #include <dtCore/scene.h>
 #include <dtCore/infiniteterrain.h>
 #include <dtCore/system.h>
@@ -48,6 +50,7 @@
 #include <dtGame/messagefactory.h>
 #include <dtGame/exceptionenum.h>
 #include <dtGame/defaultgroundclamper.h>
+#include <dtGame/terrainheightcache.h>
 
 #include <dtDAL/actortype.h>
 
@@ -139,6 +142,11 @@ namespace dtGame
             return BaseClass::GetOrCreateRuntimeData(data);
          }
 
+         dtCore::BatchIsector& GetGroundClampIsector()
+         {
+            return BaseClass::GetGroundClampIsector();
+         }
+
       protected:
          virtual ~TestClamper()
          {
@@ -168,6 +176,10 @@ namespace dtGame
          CPPUNIT_TEST(TestFinalizeSurfacePoints);
          CPPUNIT_TEST(TestClampThreePoint);
          CPPUNIT_TEST(TestClampIntermittent);
+         CPPUNIT_TEST(TestClampBatchParallel);
+         CPPUNIT_TEST(TestHeightCache);
+         CPPUNIT_TEST(TestClampWithHeightCache);
+         CPPUNIT_TEST(TestClampWithRayQueryTree);
          CPPUNIT_TEST(TestClampTransformUnchanged);
 
       CPPUNIT_TEST_SUITE_END();
@@ -891,6 +903,210 @@ namespace dtGame
          }
 
          ///////////////////////////////////////////////////////////////////////
+         void TestClampBatchParallel()
+         {
+            dtCore::RefPtr<dtUtil::WorkerPool> pool = new dtUtil::WorkerPool(3);
+            mGroundClamper->SetWorkerPool(pool.get());
+            CPPUNIT_ASSERT(mGroundClamper->GetWorkerPool() == pool.get());
+
+            dtCore::RefPtr<dtActors::InfiniteTerrainActorProxy> terrainProxy;
+            dtCore::InfiniteTerrain* terrain = NULL;
+            CreateTestTerrain(terrainProxy, terrain);
+            mGroundClamper->SetTerrainActor(terrain);
+            mGroundClamper->SetIntermittentGroundClampingTimeDelta(0.5f);
+
+            // Enough to need several batch queries.
+            const unsigned numActors = DefaultGroundClamper::CLAMP_BATCH_SIZE * 3 + 5;
+            std::vector<dtCore::RefPtr<GameActorProxy> > proxies(numActors);
+            std::vector<GroundClampingData> clampData(numActors);
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, proxies[i]);
+               dtCore::Transformable* actor = NULL;
+               proxies[i]->GetActor(actor);
+
+               dtCore::Transform xform;
+               xform.SetTranslation(osg::Vec3(float(i) * 3.0f - 200.0f, float(i) * -2.0f + 50.0f, 0.0f));
+               actor->SetTransform(xform);
+
+               DefaultGroundClamper::RuntimeData& runtimeData = mGroundClamper->GetOrCreateRuntimeData(clampData[i]);
+               runtimeData.SetLastClampedTime(0.0f);
+               mGroundClamper->ClampToGroundIntermittent(1.0, xform, *proxies[i], clampData[i], runtimeData);
+            }
+
+            // Nothing is run until FinishUp when there is a pool.
+            CPPUNIT_ASSERT_EQUAL(numActors, mGroundClamper->GetClampBatchSize());
+            mGroundClamper->FinishUp();
+            CPPUNIT_ASSERT_EQUAL(0U, mGroundClamper->GetClampBatchSize());
+
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               dtCore::Transformable* actor = NULL;
+               proxies[i]->GetActor(actor);
+               dtCore::Transform xform;
+               actor->GetTransform(xform);
+               osg::Vec3 pos;
+               xform.GetTranslation(pos);
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(terrain->GetHeight(pos.x(), pos.y(), true), pos.z(), 0.1f);
+            }
+
+            mGroundClamper->SetWorkerPool(NULL);
+         }
+
+         ///////////////////////////////////////////////////////////////////////
+         void TestHeightCache()
+         {
+            dtCore::RefPtr<TerrainHeightCache> cache = new TerrainHeightCache(2.0f, 4, 2);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0f, cache->GetCellSize(), 1e-5f);
+            CPPUNIT_ASSERT_EQUAL(4U, cache->GetTileCells());
+            CPPUNIT_ASSERT_EQUAL(2U, cache->GetMaxTiles());
+
+            osg::Vec3 hit, normal;
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.0f, -1.0f, 5.0f), hit, normal));
+            CPPUNIT_ASSERT_EQUAL(4U, cache->GetNumPendingSamples());
+
+            // Asking again does not queue the same corners twice.
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.5f, -0.5f, 5.0f), hit, normal));
+            CPPUNIT_ASSERT_EQUAL(4U, cache->GetNumPendingSamples());
+
+            std::vector<TerrainHeightCache::SampleRequest> samples;
+            cache->TakePendingSamples(samples);
+            CPPUNIT_ASSERT_EQUAL(size_t(4), samples.size());
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumPendingSamples());
+
+            // A plane rising 1 unit per unit along x.
+            for (unsigned i = 0; i < samples.size(); ++i)
+            {
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, samples[i].mPoint.z(), 1e-5f);
+               cache->SetSampleHeight(samples[i].mX, samples[i].mY, samples[i].mPoint.x());
+            }
+
+            // The corners straddle the tiles at y -1 and y 0.
+            CPPUNIT_ASSERT_EQUAL(2U, cache->GetNumTiles());
+
+            CPPUNIT_ASSERT(cache->GetHeight(osg::Vec3(1.0f, -1.0f, 5.0f), hit, normal));
+            CPPUNIT_ASSERT(IsEqual(hit, osg::Vec3(1.0f, -1.0f, 1.0f), 1e-4f));
+            osg::Vec3 expectedNormal(-1.0f, 0.0f, 1.0f);
+            expectedNormal.normalize();
+            CPPUNIT_ASSERT(IsEqual(normal, expectedNormal, 1e-4f));
+
+            cache->AddDynamicArea(osg::Vec2(0.0f, -2.0f), osg::Vec2(2.0f, 0.0f));
+            CPPUNIT_ASSERT(cache->IsInDynamicArea(1.0f, -1.0f));
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.0f, -1.0f, 5.0f), hit, normal));
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumPendingSamples());
+            cache->ClearDynamicAreas();
+            CPPUNIT_ASSERT(cache->GetHeight(osg::Vec3(1.0f, -1.0f, 5.0f), hit, normal));
+
+            // Needing a third tile drops the least recently used one.
+            cache->SetSampleHeight(100, 100, 3.0f);
+            CPPUNIT_ASSERT_EQUAL(2U, cache->GetNumTiles());
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.0f, -1.0f, 5.0f), hit, normal));
+
+            // Corners with no terrain miss without being requested again.
+            cache->Clear();
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.0f, 1.0f, 5.0f), hit, normal));
+            cache->TakePendingSamples(samples);
+            CPPUNIT_ASSERT_EQUAL(size_t(4), samples.size());
+            for (unsigned i = 0; i < samples.size(); ++i)
+            {
+               cache->SetSampleMissed(samples[i].mX, samples[i].mY);
+            }
+            CPPUNIT_ASSERT(!cache->GetHeight(osg::Vec3(1.0f, 1.0f, 5.0f), hit, normal));
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumPendingSamples());
+
+            cache->Clear();
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumTiles());
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumPendingSamples());
+         }
+
+         ///////////////////////////////////////////////////////////////////////
+         void TestClampWithHeightCache()
+         {
+            dtCore::RefPtr<TerrainHeightCache> cache = new TerrainHeightCache(0.5f);
+            mGroundClamper->SetHeightCache(cache.get());
+            CPPUNIT_ASSERT(mGroundClamper->GetHeightCache() == cache.get());
+
+            dtCore::RefPtr<dtActors::InfiniteTerrainActorProxy> terrainProxy;
+            dtCore::InfiniteTerrain* terrain = NULL;
+            CreateTestTerrain(terrainProxy, terrain);
+            mGroundClamper->SetTerrainActor(terrain);
+            mGroundClamper->SetIntermittentGroundClampingTimeDelta(0.5f);
+
+            GroundClampingData data;
+            DefaultGroundClamper::RuntimeData& runtimeData = mGroundClamper->GetOrCreateRuntimeData(data);
+            dtCore::Transformable* actor = NULL;
+            mTestGameActor->GetActor(actor);
+
+            dtCore::Transform xform;
+            xform.SetTranslation(osg::Vec3(10.3f, -20.7f, 0.0f));
+
+            // The first clamp misses the cache, so it is queried, and the missing heights are queued.
+            mGroundClamper->ClampToGroundIntermittent(1.0, xform, *mTestGameActor, data, runtimeData);
+            CPPUNIT_ASSERT_EQUAL(1U, mGroundClamper->GetClampBatchSize());
+            CPPUNIT_ASSERT_EQUAL(4U, cache->GetNumPendingSamples());
+            mGroundClamper->FinishUp();
+            CPPUNIT_ASSERT_EQUAL(0U, cache->GetNumPendingSamples());
+
+            osg::Vec3 pos;
+            actor->GetTransform(xform);
+            xform.GetTranslation(pos);
+            float terrainHeight = terrain->GetHeight(pos.x(), pos.y(), true);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(terrainHeight, pos.z(), 0.1f);
+
+            // The second clamp is a lookup that needs no query.
+            xform.SetTranslation(osg::Vec3(pos.x(), pos.y(), 0.0f));
+            mGroundClamper->ClampToGroundIntermittent(2.0, xform, *mTestGameActor, data, runtimeData);
+            CPPUNIT_ASSERT_EQUAL(0U, mGroundClamper->GetClampBatchSize());
+
+            actor->GetTransform(xform);
+            xform.GetTranslation(pos);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(terrainHeight, pos.z(), 0.25f);
+
+            mGroundClamper->SetHeightCache(NULL);
+         }
+
+         ///////////////////////////////////////////////////////////////////////
+         void TestClampWithRayQueryTree()
+         {
+            CPPUNIT_ASSERT(!mGroundClamper->GetUseRayQueryTree());
+            mGroundClamper->SetUseRayQueryTree(true);
+            CPPUNIT_ASSERT(mGroundClamper->GetUseRayQueryTree());
+
+            dtCore::RefPtr<dtActors::InfiniteTerrainActorProxy> terrainProxy;
+            dtCore::InfiniteTerrain* terrain = NULL;
+            CreateTestTerrain(terrainProxy, terrain);
+            mGroundClamper->SetTerrainActor(terrain);
+
+            dtCore::RayQueryTree* tree = mGroundClamper->GetGroundClampIsector().GetRayQueryTree();
+            CPPUNIT_ASSERT(tree != NULL);
+            CPPUNIT_ASSERT(tree->GetRoot() == NULL);
+
+            GroundClampingData data;
+            DefaultGroundClamper::RuntimeData& runtimeData = mGroundClamper->GetOrCreateRuntimeData(data);
+            dtCore::Transformable* actor = NULL;
+            mTestGameActor->GetActor(actor);
+
+            dtCore::Transform xform;
+            xform.SetTranslation(osg::Vec3(10.3f, -20.7f, 0.0f));
+            mGroundClamper->ClampToGroundIntermittent(1.0, xform, *mTestGameActor, data, runtimeData);
+            CPPUNIT_ASSERT_EQUAL(1U, mGroundClamper->GetClampBatchSize());
+            mGroundClamper->FinishUp();
+
+            // The batch built the tree over the terrain and answered the query from it.
+            CPPUNIT_ASSERT(tree->GetRoot() == terrain->GetOSGNode());
+            CPPUNIT_ASSERT(tree->GetNumTriangles() > 0U);
+
+            osg::Vec3 pos;
+            actor->GetTransform(xform);
+            xform.GetTranslation(pos);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(terrain->GetHeight(pos.x(), pos.y(), true), pos.z(), 0.1f);
+
+            mGroundClamper->SetUseRayQueryTree(false);
+            CPPUNIT_ASSERT(!mGroundClamper->GetUseRayQueryTree());
+            CPPUNIT_ASSERT(mGroundClamper->GetGroundClampIsector().GetRayQueryTree() == NULL);
+         }
+
+         ///////////////////////////////////////////////////////////////////////
          void TestClampTransformUnchanged()
          {
             dtCore::RefPtr<DefaultGroundClamper::RuntimeData> runtimeData
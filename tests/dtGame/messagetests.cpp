@@ -81,6 +81,8 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestOperatorEquals);
       CPPUNIT_TEST(TestBaseMessages);
       CPPUNIT_TEST(TestMessageFactory);
+      CPPUNIT_TEST(TestMessagePooling);
+      CPPUNIT_TEST(TestMessageParameterIndex);
       CPPUNIT_TEST(TestMessageDelivery);
       CPPUNIT_TEST(TestActorPublish);
       CPPUNIT_TEST(TestPauseResume);
@@ -91,6 +93,7 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestChangeMap);
       CPPUNIT_TEST(TestChangeMapGameEvents);
       CPPUNIT_TEST(TestChangeMapErrorConditions);
+      CPPUNIT_TEST(TestChangeMapInBackground);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithPauseResumeCommands);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithRemoteActorCreates);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithLocalActorCreates);
@@ -111,6 +114,8 @@ public:
    void TestOperatorEquals();
    void TestBaseMessages();
    void TestMessageFactory();
+   void TestMessagePooling();
+   void TestMessageParameterIndex();
    void TestMessageDelivery();
    void TestActorPublish();
    void TestPauseResume();
@@ -121,6 +126,7 @@ public:
    void TestChangeMapGameEvents();
    void TestChangeMap();
    void TestChangeMapErrorConditions();
+   void TestChangeMapInBackground();
    void TestDefaultMessageProcessorWithPauseResumeCommands();
    void TestDefaultMessageProcessorWithRemoteActorCreates();
    void TestDefaultMessageProcessorWithLocalActorCreates();
@@ -596,6 +602,133 @@ void MessageTests::TestMessageFactory()
    }
 }
 
+//////////////////////////////////////////////////////////////////////////
+void MessageTests::TestMessagePooling()
+{
+   try
+   {
+      dtGame::MessageFactory& factory = mGameManager->GetMessageFactory();
+
+      CPPUNIT_ASSERT_EQUAL(dtGame::MessageFactory::DEFAULT_MESSAGE_POOL_SIZE,
+               factory.GetMessagePoolSize(dtGame::MessageType::TICK_LOCAL));
+      CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_PAUSED));
+
+      factory.SetMessagePoolSize(dtGame::MessageType::TICK_REMOTE, 2);
+      CPPUNIT_ASSERT_EQUAL(2U, factory.GetMessagePoolSize(dtGame::MessageType::TICK_REMOTE));
+      factory.ResetMessagePoolCounters();
+
+      dtCore::RefPtr<dtGame::TickMessage> tick1;
+      factory.CreateMessage(dtGame::MessageType::TICK_REMOTE, tick1);
+      dtCore::RefPtr<dtGame::TickMessage> tick2;
+      factory.CreateMessage(dtGame::MessageType::TICK_REMOTE, tick2);
+      CPPUNIT_ASSERT(tick1 != tick2);
+      CPPUNIT_ASSERT_EQUAL(0UL, factory.GetMessagePoolHits(dtGame::MessageType::TICK_REMOTE));
+      CPPUNIT_ASSERT_EQUAL(2UL, factory.GetMessagePoolMisses(dtGame::MessageType::TICK_REMOTE));
+
+      dtCore::RefPtr<dtGame::Message> causing = factory.CreateMessage(dtGame::MessageType::INFO_PAUSED);
+      tick1->SetDeltaSimTime(3.5f);
+      tick1->SetAboutActorId(dtCore::UniqueId());
+      tick1->SetDestination(&mGameManager->GetMachineInfo());
+      tick1->SetCausingMessage(causing.get());
+
+      dtGame::Message* oldTick1 = tick1.get();
+      tick1 = NULL;
+
+      // the released message should come back looking like a new one.
+      dtCore::RefPtr<dtGame::TickMessage> tick3;
+      factory.CreateMessage(dtGame::MessageType::TICK_REMOTE, tick3);
+      CPPUNIT_ASSERT(tick3.get() == oldTick1);
+      CPPUNIT_ASSERT_EQUAL(1UL, factory.GetMessagePoolHits(dtGame::MessageType::TICK_REMOTE));
+      CPPUNIT_ASSERT(tick3->GetMessageType() == dtGame::MessageType::TICK_REMOTE);
+      CPPUNIT_ASSERT_EQUAL(0.0f, tick3->GetDeltaSimTime());
+      CPPUNIT_ASSERT(tick3->GetAboutActorId().IsNull());
+      CPPUNIT_ASSERT(tick3->GetDestination() == NULL);
+      CPPUNIT_ASSERT(tick3->GetCausingMessage() == NULL);
+      CPPUNIT_ASSERT(tick3->GetSource() == mGameManager->GetMachineInfo());
+
+      // both pooled messages are in use and the pool is full, so this one is allocated and not kept.
+      dtCore::RefPtr<dtGame::TickMessage> tick4;
+      factory.CreateMessage(dtGame::MessageType::TICK_REMOTE, tick4);
+      CPPUNIT_ASSERT(tick4 != tick2 && tick4 != tick3);
+      CPPUNIT_ASSERT_EQUAL(3UL, factory.GetMessagePoolMisses(dtGame::MessageType::TICK_REMOTE));
+
+      dtGame::Message* oldTick4 = tick4.get();
+      tick4 = NULL;
+      tick2 = NULL;
+      factory.CreateMessage(dtGame::MessageType::TICK_REMOTE, tick4);
+      CPPUNIT_ASSERT(tick4.get() != oldTick4);
+      CPPUNIT_ASSERT_EQUAL(2UL, factory.GetMessagePoolHits(dtGame::MessageType::TICK_REMOTE));
+
+      factory.SetMessagePoolSize(dtGame::MessageType::TICK_REMOTE, 0);
+      CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::TICK_REMOTE));
+      CPPUNIT_ASSERT_EQUAL(0UL, factory.GetMessagePoolHits(dtGame::MessageType::TICK_REMOTE));
+
+      CPPUNIT_ASSERT_THROW(factory.SetMessagePoolSize(dtGame::MessageType::NETCLIENT_REQUEST_CONNECTION, 4),
+               dtUtil::Exception);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.ToString());
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MessageTests::TestMessageParameterIndex()
+{
+   try
+   {
+      dtGame::MessageFactory& factory = mGameManager->GetMessageFactory();
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update1, update2;
+      factory.CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update1);
+      factory.CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update2);
+
+      CPPUNIT_ASSERT_EQUAL(5U, update1->GetNumParameters());
+      CPPUNIT_ASSERT_EQUAL(dtGame::Message::INVALID_PARAMETER_INDEX, update1->GetParameterIndex("Not a parameter"));
+      CPPUNIT_ASSERT(update1->GetParameter("Not a parameter") == NULL);
+
+      // the parameters are ordered by name and every message of a class has the same layout.
+      for (unsigned i = 0; i < update1->GetNumParameters(); ++i)
+      {
+         const dtGame::MessageParameter* param = update1->GetParameterByIndex(i);
+         if (i > 0)
+         {
+            CPPUNIT_ASSERT(update1->GetParameterByIndex(i - 1)->GetName().Get() < param->GetName().Get());
+         }
+         CPPUNIT_ASSERT_EQUAL(i, update1->GetParameterIndex(param->GetName()));
+         CPPUNIT_ASSERT_EQUAL(i, update2->GetParameterIndex(std::string(param->GetName().Get())));
+         CPPUNIT_ASSERT(update1->GetParameter(param->GetName()) == param);
+      }
+
+      update1->SetName("Bob");
+      unsigned nameIndex = update1->GetParameterIndex(dtGame::ActorUpdateMessage::NAME_PARAMETER);
+      CPPUNIT_ASSERT(nameIndex != dtGame::Message::INVALID_PARAMETER_INDEX);
+      CPPUNIT_ASSERT_EQUAL(std::string("Bob"), update1->GetParameterByIndex(nameIndex)->ToString());
+
+      // every message of the type from the factory shares one compiled schema.
+      const dtGame::MessageParameterSchema* schema = factory.GetParameterSchema(dtGame::MessageType::INFO_ACTOR_UPDATED);
+      CPPUNIT_ASSERT(schema != NULL);
+      CPPUNIT_ASSERT(update1->GetParameterSchema() == schema);
+      CPPUNIT_ASSERT(update2->GetParameterSchema() == schema);
+      CPPUNIT_ASSERT_EQUAL(update1->GetNumParameters(), schema->GetNumParameters());
+      CPPUNIT_ASSERT_EQUAL(nameIndex, schema->GetIndex(dtGame::ActorUpdateMessage::NAME_PARAMETER));
+      CPPUNIT_ASSERT_EQUAL(nameIndex, schema->GetIndex(std::string(dtGame::ActorUpdateMessage::NAME_PARAMETER.Get())));
+      CPPUNIT_ASSERT_EQUAL(dtGame::Message::INVALID_PARAMETER_INDEX, schema->GetIndex("Not a parameter"));
+
+      CPPUNIT_ASSERT_EQUAL(std::string("Bob"), update1->GetParameterValue<std::string>(nameIndex));
+      update1->SetParameterValue<std::string>(nameIndex, "Alice");
+      CPPUNIT_ASSERT_EQUAL(std::string("Alice"), update1->GetName());
+      CPPUNIT_ASSERT_THROW(update1->GetParameterValue<float>(nameIndex), dtUtil::Exception);
+
+      update1->CopyDataTo(*update2);
+      CPPUNIT_ASSERT_EQUAL(std::string("Alice"), update2->GetName());
+      CPPUNIT_ASSERT(*update1 == *update2);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.ToString());
+   }
+}
+
 //////////////////////////////////////////////////////////////////////////
 void MessageTests::TestMessageDelivery()
 {
@@ -1415,6 +1548,96 @@ void MessageTests::TestChangeMapErrorConditions()
 
 }
 
+void MessageTests::TestChangeMapInBackground()
+{
+   try
+   {
+      dtDAL::Project& project = dtDAL::Project::GetInstance();
+      dtGame::GameManager::NameVector mapNamesExpected;
+      mapNamesExpected.push_back("Background Game Actors");
+      mapNamesExpected.push_back("Background Game Actors the second");
+
+      dtCore::RefPtr<dtDAL::Map> mapA = &project.CreateMap(mapNamesExpected[0], "bga");
+      dtCore::RefPtr<dtDAL::Map> mapB = &project.CreateMap(mapNamesExpected[1], "bgb");
+
+      createActors(*mapA);
+      createActors(*mapB);
+
+      mapA->GetEventManager().AddEvent(*new dtDAL::GameEvent("event1", "Event"));
+      mapB->GetEventManager().AddEvent(*new dtDAL::GameEvent("event2", "Event"));
+
+      mapA->AddLibrary(mTestGameActorLibrary, "1.0");
+      mapA->AddLibrary(mTestActorLibrary, "1.0");
+      mapB->AddLibrary(mTestGameActorLibrary, "1.0");
+      mapB->AddLibrary(mTestActorLibrary, "1.0");
+
+      // minus two for the Crash Actors, which throw an exception in OnEnteredWorld.
+      const size_t expectedNumActors = mapA->GetAllProxies().size() + mapB->GetAllProxies().size() - 2;
+
+      project.SaveMap(*mapA);
+      project.CloseMap(*mapA);
+
+      project.SaveMap(*mapB);
+      project.CloseMap(*mapB);
+
+      TestComponent& tc = *new TestComponent("name");
+      mGameManager->AddComponent(tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      CPPUNIT_ASSERT(!mGameManager->GetLoadMapsInBackground());
+      mGameManager->SetLoadMapsInBackground(true);
+      CPPUNIT_ASSERT(mGameManager->GetLoadMapsInBackground());
+
+      // a budget this small means one actor is added per frame.
+      CPPUNIT_ASSERT_EQUAL(0.0f, mGameManager->GetMapLoadFrameBudget());
+      mGameManager->SetMapLoadFrameBudget(0.0001f);
+      CPPUNIT_ASSERT_EQUAL(0.0001f, mGameManager->GetMapLoadFrameBudget());
+
+      mGameManager->ChangeMapSet(mapNamesExpected, false);
+
+      unsigned numFrames = 0;
+      while (!tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid() && numFrames < 10000)
+      {
+         dtCore::AppSleep(1);
+         dtCore::System::GetInstance().Step();
+         ++numFrames;
+      }
+
+      dtCore::RefPtr<const dtGame::Message> processMapChange = tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED);
+      CPPUNIT_ASSERT_MESSAGE("A INFO_MAP_CHANGED message should have been processed.", processMapChange.valid());
+      const dtGame::MapMessage* mapMsg = static_cast<const dtGame::MapMessage*>(processMapChange.get());
+      CheckMapNames(*mapMsg, mapNamesExpected);
+      CPPUNIT_ASSERT_EQUAL(1.0f, mapMsg->GetLoadProgress());
+
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The number of Actors in the GM should equal the Proxies in the loaded Maps.",
+                                    expectedNumActors, mGameManager->GetNumAllActors());
+      CPPUNIT_ASSERT_EQUAL(2U, dtDAL::GameEventManager::GetInstance().GetNumEvents());
+      CPPUNIT_ASSERT(!mGameManager->IsPaused());
+
+      // The progress should have been reported on each frame that added actors.
+      unsigned numProgressMessages = 0;
+      float lastProgress = 0.0f;
+      std::vector<dtCore::RefPtr<const dtGame::Message> >& messages = tc.GetReceivedProcessMessages();
+      for (unsigned i = 0; i < messages.size(); ++i)
+      {
+         if (messages[i]->GetMessageType() == dtGame::MessageType::INFO_MAP_LOAD_PROGRESS)
+         {
+            float progress = static_cast<const dtGame::MapMessage&>(*messages[i]).GetLoadProgress();
+            CPPUNIT_ASSERT(progress >= lastProgress);
+            CPPUNIT_ASSERT(progress < 1.0f);
+            lastProgress = progress;
+            ++numProgressMessages;
+         }
+      }
+      CPPUNIT_ASSERT_MESSAGE("Adding the actors should have been spread over several frames.",
+               numProgressMessages >= expectedNumActors - 1);
+      CPPUNIT_ASSERT(lastProgress > 0.0f);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.ToString());
+   }
+}
+
 void MessageTests::TestDefaultMessageProcessorWithPauseResumeCommands()
 {
    dtGame::DefaultMessageProcessor& defMsgProcessor = *new dtGame::DefaultMessageProcessor();
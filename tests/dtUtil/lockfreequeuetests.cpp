@@ -0,0 +1,149 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2010, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+* 
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+* David Guthrie
+*/
+#include <prefix/dtgameprefix-src.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/lockfreequeue.h>
+#include <OpenThreads/Thread>
+#include <vector>
+
+namespace dtUtil
+{
+   /// Pushes a range of numbers onto a queue from its own thread.
+   class QueueProducerThread : public OpenThreads::Thread
+   {
+   public:
+      QueueProducerThread(LockFreeQueue<int>& queue, int first, int count)
+         : mQueue(queue)
+         , mFirst(first)
+         , mCount(count)
+      {
+      }
+
+      virtual void run()
+      {
+         for (int i = mFirst; i < mFirst + mCount; ++i)
+         {
+            mQueue.Push(i);
+         }
+      }
+
+   private:
+      LockFreeQueue<int>& mQueue;
+      int mFirst, mCount;
+   };
+
+   /// unit tests for dtUtil::LockFreeQueue
+   class LockFreeQueueTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(LockFreeQueueTests);
+         CPPUNIT_TEST( TestPushPopOrder );
+         CPPUNIT_TEST( TestMultipleProducers );
+      CPPUNIT_TEST_SUITE_END();
+
+      public:
+         void setUp()
+         {
+         }
+
+         void tearDown()
+         {
+         }
+
+         void TestPushPopOrder()
+         {
+            LockFreeQueue<int> queue;
+            CPPUNIT_ASSERT(queue.IsEmpty());
+
+            std::vector<int> result;
+            CPPUNIT_ASSERT_EQUAL(0U, queue.PopAll(result));
+
+            for (int i = 0; i < 10; ++i)
+            {
+               queue.Push(i);
+            }
+            CPPUNIT_ASSERT(!queue.IsEmpty());
+
+            result.push_back(-1);
+            CPPUNIT_ASSERT_EQUAL(10U, queue.PopAll(result));
+            CPPUNIT_ASSERT(queue.IsEmpty());
+            CPPUNIT_ASSERT_EQUAL(size_t(11), result.size());
+            CPPUNIT_ASSERT_EQUAL(-1, result[0]);
+            for (int i = 0; i < 10; ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(i, result[i + 1]);
+            }
+         }
+
+         void TestMultipleProducers()
+         {
+            const int numThreads = 4;
+            const int numPerThread = 20000;
+
+            LockFreeQueue<int> queue;
+            std::vector<QueueProducerThread*> threads;
+            for (int i = 0; i < numThreads; ++i)
+            {
+               threads.push_back(new QueueProducerThread(queue, i * numPerThread, numPerThread));
+               threads.back()->start();
+            }
+
+            // consume while the producers are still running.
+            std::vector<int> result;
+            while (result.size() < size_t(numThreads * numPerThread))
+            {
+               if (queue.PopAll(result) == 0)
+               {
+                  OpenThreads::Thread::YieldCurrentThread();
+               }
+            }
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+               threads[i]->join();
+               delete threads[i];
+            }
+
+            CPPUNIT_ASSERT(queue.IsEmpty());
+
+            // each producer's items must come out in the order it pushed them.
+            std::vector<int> lastSeen(numThreads, -1);
+            for (unsigned i = 0; i < result.size(); ++i)
+            {
+               int thread = result[i] / numPerThread;
+               CPPUNIT_ASSERT(result[i] > lastSeen[thread]);
+               lastSeen[thread] = result[i];
+            }
+            for (int i = 0; i < numThreads; ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL((i + 1) * numPerThread - 1, lastSeen[i]);
+            }
+         }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(LockFreeQueueTests);
+}
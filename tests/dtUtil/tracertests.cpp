@@ -0,0 +1,188 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2010, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+* 
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+* David Guthrie
+*/
+#include <prefix/dtgameprefix-src.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/tracer.h>
+#include <dtUtil/fileutils.h>
+#include <sstream>
+#include <string>
+
+namespace dtUtil
+{
+   /// unit tests for dtUtil::Tracer
+   class TracerTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TracerTests);
+         CPPUNIT_TEST( TestDisabled );
+         CPPUNIT_TEST( TestScopes );
+         CPPUNIT_TEST( TestFrameWindow );
+         CPPUNIT_TEST( TestCaptureFrames );
+         CPPUNIT_TEST( TestRingBuffer );
+      CPPUNIT_TEST_SUITE_END();
+
+      public:
+         void setUp()
+         {
+            Tracer::SetEnabled(false);
+            Tracer::Clear();
+         }
+
+         void tearDown()
+         {
+            Tracer::SetEnabled(false);
+            Tracer::SetEventsPerThread(Tracer::DEFAULT_EVENTS_PER_THREAD);
+            Tracer::Clear();
+         }
+
+         void TestDisabled()
+         {
+            CPPUNIT_ASSERT(!Tracer::IsEnabled());
+            {
+               DT_TRACE_SCOPE("DisabledScope");
+            }
+            CPPUNIT_ASSERT_EQUAL(0U, CountEvents("DisabledScope"));
+         }
+
+         void TestScopes()
+         {
+            Tracer::SetEnabled(true);
+            {
+               DT_TRACE_SCOPE_CATEGORY("OuterScope", "test");
+               {
+                  std::string name("Inner");
+                  name += "Scope";
+                  DT_TRACE_SCOPE(name);
+               }
+            }
+            Tracer::SetEnabled(false);
+
+            std::ostringstream trace;
+            Tracer::WriteChromeTrace(trace);
+            const std::string result = trace.str();
+
+            CPPUNIT_ASSERT_EQUAL(1U, Count(result, "\"name\":\"OuterScope\",\"cat\":\"test\",\"ph\":\"X\""));
+            CPPUNIT_ASSERT_EQUAL(1U, Count(result, "\"name\":\"InnerScope\",\"cat\":\"delta3d\",\"ph\":\"X\""));
+            CPPUNIT_ASSERT(Count(result, "\"ph\":\"M\"") > 0);
+            CPPUNIT_ASSERT(Count(result, "\"displayTimeUnit\":\"ns\"") == 1);
+
+            // the inner scope ends first, so it is written first.
+            CPPUNIT_ASSERT(result.find("InnerScope") < result.find("OuterScope"));
+         }
+
+         void TestFrameWindow()
+         {
+            Tracer::SetEnabled(true);
+            Tracer::BeginFrame();
+            const unsigned firstFrame = Tracer::GetFrameNumber();
+            {
+               DT_TRACE_SCOPE("FrameOne");
+            }
+            Tracer::BeginFrame();
+            CPPUNIT_ASSERT_EQUAL(firstFrame + 1, Tracer::GetFrameNumber());
+            {
+               DT_TRACE_SCOPE("FrameTwo");
+            }
+            Tracer::SetEnabled(false);
+
+            std::ostringstream trace;
+            Tracer::WriteChromeTrace(trace, firstFrame + 1, firstFrame + 1);
+            CPPUNIT_ASSERT_EQUAL(0U, Count(trace.str(), "FrameOne"));
+            CPPUNIT_ASSERT_EQUAL(1U, Count(trace.str(), "FrameTwo"));
+
+            CPPUNIT_ASSERT_EQUAL(1U, CountEvents("FrameOne"));
+            CPPUNIT_ASSERT_EQUAL(1U, CountEvents("FrameTwo"));
+         }
+
+         void TestCaptureFrames()
+         {
+            const std::string fileName("tracerTestCapture.json");
+            dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+            if (fileUtils.FileExists(fileName))
+            {
+               fileUtils.FileDelete(fileName);
+            }
+
+            Tracer::CaptureFrames(2, fileName);
+            CPPUNIT_ASSERT(Tracer::IsCapturing());
+            CPPUNIT_ASSERT(Tracer::IsEnabled());
+
+            for (unsigned i = 0; i < 2; ++i)
+            {
+               Tracer::BeginFrame();
+               DT_TRACE_SCOPE("CapturedScope");
+            }
+            CPPUNIT_ASSERT(Tracer::IsCapturing());
+            CPPUNIT_ASSERT(!fileUtils.FileExists(fileName));
+
+            Tracer::BeginFrame();
+            CPPUNIT_ASSERT(!Tracer::IsCapturing());
+            CPPUNIT_ASSERT_MESSAGE("Tracing should go back to disabled after the capture.", !Tracer::IsEnabled());
+            CPPUNIT_ASSERT(fileUtils.FileExists(fileName));
+            fileUtils.FileDelete(fileName);
+         }
+
+         void TestRingBuffer()
+         {
+            Tracer::SetEventsPerThread(4);
+            CPPUNIT_ASSERT_EQUAL(4U, Tracer::GetEventsPerThread());
+
+            Tracer::SetEnabled(true);
+            {
+               DT_TRACE_SCOPE("OldScope");
+            }
+            for (unsigned i = 0; i < 4; ++i)
+            {
+               DT_TRACE_SCOPE("NewScope");
+            }
+            Tracer::SetEnabled(false);
+
+            CPPUNIT_ASSERT_EQUAL(0U, CountEvents("OldScope"));
+            CPPUNIT_ASSERT_EQUAL(4U, CountEvents("NewScope"));
+         }
+
+      private:
+         unsigned Count(const std::string& str, const std::string& toFind)
+         {
+            unsigned count = 0;
+            for (size_t pos = str.find(toFind); pos != std::string::npos; pos = str.find(toFind, pos + 1))
+            {
+               ++count;
+            }
+            return count;
+         }
+
+         unsigned CountEvents(const std::string& name)
+         {
+            std::ostringstream trace;
+            Tracer::WriteChromeTrace(trace);
+            return Count(trace.str(), "\"name\":\"" + name + "\"");
+         }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(TracerTests);
+}